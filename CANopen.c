@@ -51,6 +51,7 @@
     static CO_CANtx_t          *CO_CANmodule_txArray0;
     static CO_OD_extension_t   *CO_SDO_ODExtensions;
     static CO_HBconsNode_t     *CO_HBcons_monitoredNodes;
+    static CO_RPDO_t          **CO_RPDOmonitor_heap;
 #if CO_NO_TRACE > 0
     static uint32_t            *CO_traceTimeBuffers[CO_NO_TRACE];
     static int32_t             *CO_traceValueBuffers[CO_NO_TRACE];
@@ -155,6 +156,8 @@
 #endif
     static CO_RPDO_t            COO_RPDO[CO_NO_RPDO];
     static CO_TPDO_t            COO_TPDO[CO_NO_TPDO];
+    static CO_RPDOmonitor_t     COO_RPDOmonitor;
+    static CO_RPDO_t           *COO_RPDOmonitor_heap[CO_NO_RPDO];
     static CO_HBconsumer_t      COO_HBcons;
     static CO_HBconsNode_t      COO_HBcons_monitoredNodes[CO_NO_HB_CONS];
 #if CO_NO_LSS_SERVER == 1
@@ -257,6 +260,35 @@ CO_ReturnError_t CO_init(
 static uint32_t CO_traceBufferSize[CO_NO_TRACE];
 #endif
 
+/* Object Dictionary from CO_setOD() or NULL for CO_OD[] */
+static struct{
+    const CO_OD_entry_t *OD;
+    uint16_t            ODSize;
+    CO_OD_extension_t  *ODExtensions;
+    const uint16_t     *lookup;
+    uint16_t            lookupMask;
+}CO_ODuser;
+
+
+/******************************************************************************/
+void CO_setOD(
+        const CO_OD_entry_t    *OD,
+        uint16_t                ODSize,
+        CO_OD_extension_t      *ODExtensions,
+        const uint16_t         *lookup,
+        uint16_t                lookupMask)
+{
+    if(OD == NULL || ODSize == 0U || ODExtensions == NULL){
+        CO_ODuser.OD = NULL;
+        return;
+    }
+    CO_ODuser.OD = OD;
+    CO_ODuser.ODSize = ODSize;
+    CO_ODuser.ODExtensions = ODExtensions;
+    CO_ODuser.lookup = lookup;
+    CO_ODuser.lookupMask = lookupMask;
+}
+
 /******************************************************************************/
 CO_ReturnError_t CO_new(void)
 {
@@ -305,6 +337,8 @@ CO_ReturnError_t CO_new(void)
         CO->RPDO[i]                     = &COO_RPDO[i];
     for(i=0; i<CO_NO_TPDO; i++)
         CO->TPDO[i]                     = &COO_TPDO[i];
+    CO->RPDOmonitor                     = &COO_RPDOmonitor;
+    CO_RPDOmonitor_heap                 = &COO_RPDOmonitor_heap[0];
     CO->HBcons                          = &COO_HBcons;
     CO_HBcons_monitoredNodes            = &COO_HBcons_monitoredNodes[0];
   #if CO_NO_LSS_SERVER == 1
@@ -351,6 +385,8 @@ CO_ReturnError_t CO_new(void)
         for(i=0; i<CO_NO_TPDO; i++){
             CO->TPDO[i]                     = (CO_TPDO_t *)         calloc(1, sizeof(CO_TPDO_t));
         }
+        CO->RPDOmonitor                     = (CO_RPDOmonitor_t *)  calloc(1, sizeof(CO_RPDOmonitor_t));
+        CO_RPDOmonitor_heap                 = (CO_RPDO_t **)        calloc(CO_NO_RPDO, sizeof(CO_RPDO_t *));
         CO->HBcons                          = (CO_HBconsumer_t *)   calloc(1, sizeof(CO_HBconsumer_t));
         CO_HBcons_monitoredNodes            = (CO_HBconsNode_t *)   calloc(CO_NO_HB_CONS, sizeof(CO_HBconsNode_t));
       #if CO_NO_LSS_SERVER == 1
@@ -394,6 +430,8 @@ CO_ReturnError_t CO_new(void)
   #endif
                   + sizeof(CO_RPDO_t) * CO_NO_RPDO
                   + sizeof(CO_TPDO_t) * CO_NO_TPDO
+                  + sizeof(CO_RPDOmonitor_t)
+                  + sizeof(CO_RPDO_t *) * CO_NO_RPDO
                   + sizeof(CO_HBconsumer_t)
                   + sizeof(CO_HBconsNode_t) * CO_NO_HB_CONS
   #if CO_NO_LSS_SERVER == 1
@@ -436,6 +474,8 @@ CO_ReturnError_t CO_new(void)
     for(i=0; i<CO_NO_TPDO; i++){
         if(CO->TPDO[i]                  == NULL) errCnt++;
     }
+    if(CO->RPDOmonitor                  == NULL) errCnt++;
+    if(CO_RPDOmonitor_heap              == NULL) errCnt++;
     if(CO->HBcons                       == NULL) errCnt++;
     if(CO_HBcons_monitoredNodes         == NULL) errCnt++;
   #if CO_NO_LSS_SERVER == 1
@@ -514,6 +554,32 @@ CO_ReturnError_t CO_LSSinit(
 #endif /* CO_NO_LSS_SERVER == 1 */
 
 
+/*
+ * Copy OD variable for SDO server under sequence lock of the PDO, to which it
+ * is mapped. See CO_SDO_initPDOaccess().
+ */
+static int8_t CO_SDO_PDOaccess(void *object, uint8_t *ODdata, uint8_t *buffer, uint16_t length, bool_t write){
+    CO_t *co = (CO_t*)object;
+    int16_t i;
+    int8_t ret;
+
+    for(i=0; i<CO_NO_RPDO; i++){
+        ret = CO_RPDO_SDOaccess(co->RPDO[i], ODdata, buffer, length, write);
+        if(ret != 0){
+            return ret;
+        }
+    }
+    for(i=0; i<CO_NO_TPDO; i++){
+        ret = CO_TPDO_SDOaccess(co->TPDO[i], ODdata, buffer, length, write);
+        if(ret != 0){
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+
 /******************************************************************************/
 CO_ReturnError_t CO_CANopenInit(
         uint8_t                 nodeId)
@@ -545,14 +611,20 @@ CO_ReturnError_t CO_CANopenInit(
                 COB_IDServerToClient,
                 OD_H1200_SDO_SERVER_PARAM+i,
                 i==0 ? 0 : CO->SDO[0],
-               &CO_OD[0],
-                CO_OD_NoOfElements,
-                CO_SDO_ODExtensions,
+                CO_ODuser.OD != NULL ? CO_ODuser.OD : &CO_OD[0],
+                CO_ODuser.OD != NULL ? CO_ODuser.ODSize : CO_OD_NoOfElements,
+                CO_ODuser.OD != NULL ? CO_ODuser.ODExtensions : CO_SDO_ODExtensions,
                 nodeId,
                 CO->CANmodule[0],
                 CO_RXCAN_SDO_SRV+i,
                 CO->CANmodule[0],
                 CO_TXCAN_SDO_SRV+i);
+#if CO_OD_INDEX_LOOKUP
+        /* other SDO servers copy lookup from the first one */
+        if(i == 0 && CO_ODuser.OD != NULL && CO_ODuser.lookup != NULL){
+            CO_OD_setIndexLookup(CO->SDO[0], CO_ODuser.lookup, CO_ODuser.lookupMask);
+        }
+#endif
     }
 
     if(err){return err;}
@@ -630,6 +702,9 @@ CO_ReturnError_t CO_CANopenInit(
             CO_TXCAN_SYNC);
 
     if(err){return err;}
+  #ifdef CO_GET_TIME_US
+    CO_SYNC_initTimeSource(CO->SYNC, NULL, CO_GET_TIME_US);
+  #endif
 #endif
 
 #if CO_NO_TIME == 1
@@ -646,8 +721,19 @@ CO_ReturnError_t CO_CANopenInit(
             CO_TXCAN_TIME);
 
     if(err){return err;}
+  #ifdef CO_GET_TIME_US
+    CO_TIME_initTimeSource(CO->TIME, NULL, CO_GET_TIME_US);
+  #endif
 #endif
 
+    err = CO_RPDOmonitor_init(
+            CO->RPDOmonitor,
+            CO->em,
+            CO_RPDOmonitor_heap,
+            CO_NO_RPDO);
+
+    if(err){return err;}
+
     for(i=0; i<CO_NO_RPDO; i++){
         CO_CANmodule_t *CANdevRx = CO->CANmodule[0];
         uint16_t CANdevRxIdx = CO_RXCAN_RPDO + i;
@@ -669,6 +755,11 @@ CO_ReturnError_t CO_CANopenInit(
                 CANdevRxIdx);
 
         if(err){return err;}
+
+        /* timeout is disabled by default, application may enable it */
+        err = CO_RPDOmonitor_attach(CO->RPDOmonitor, CO->RPDO[i], 0);
+
+        if(err){return err;}
     }
 
     for(i=0; i<CO_NO_TPDO; i++){
@@ -691,6 +782,10 @@ CO_ReturnError_t CO_CANopenInit(
         if(err){return err;}
     }
 
+    for(i=0; i<CO_NO_SDO_SERVER; i++){
+        CO_SDO_initPDOaccess(CO->SDO[i], (void*)CO, CO_SDO_PDOaccess);
+    }
+
 
     err = CO_HBconsumer_init(
             CO->HBcons,
@@ -815,6 +910,8 @@ void CO_delete(void *CANdriverState){
     for(i=0; i<CO_NO_TPDO; i++){
         free(CO->TPDO[i]);
     }
+    free(CO_RPDOmonitor_heap);
+    free(CO->RPDOmonitor);
   #if CO_NO_SYNC == 1
     free(CO->SYNC);
   #endif
@@ -842,7 +939,9 @@ CO_NMT_reset_cmd_t CO_process(
         uint16_t                timeDifference_ms,
         uint16_t               *timerNext_ms)
 {
+#ifndef CO_SDO_PROCESS_SEPARATE
     uint8_t i;
+#endif
     bool_t NMTisPreOrOperational = false;
     CO_NMT_reset_cmd_t reset = CO_RESET_NOT;
 #ifdef CO_USE_LEDS
@@ -860,6 +959,7 @@ CO_NMT_reset_cmd_t CO_process(
     }
 #endif /* CO_USE_LEDS */
 
+#ifndef CO_SDO_PROCESS_SEPARATE
     for(i=0; i<CO_NO_SDO_SERVER; i++){
         CO_SDO_process(
                 co->SDO[i],
@@ -868,6 +968,7 @@ CO_NMT_reset_cmd_t CO_process(
                 1000,
                 timerNext_ms);
     }
+#endif
 
     CO_EM_process(
             co->emPr,
@@ -890,7 +991,13 @@ CO_NMT_reset_cmd_t CO_process(
     CO_HBconsumer_process(
             co->HBcons,
             NMTisPreOrOperational,
-            timeDifference_ms);
+            timeDifference_ms,
+            timerNext_ms);
+
+    CO_RPDOmonitor_process(
+            co->RPDOmonitor,
+            (uint32_t)timeDifference_ms * 1000,
+            timerNext_ms);
 
 #if CO_NO_TIME == 1
     CO_TIME_process(
@@ -902,15 +1009,39 @@ CO_NMT_reset_cmd_t CO_process(
 }
 
 
+/******************************************************************************/
+void CO_process_SDO(
+        CO_t                   *co,
+        uint32_t                timeDifference_us,
+        uint32_t               *timerNext_us)
+{
+    uint8_t i;
+    bool_t NMTisPreOrOperational = false;
+
+    if(co->NMT->operatingState == CO_NMT_PRE_OPERATIONAL || co->NMT->operatingState == CO_NMT_OPERATIONAL)
+        NMTisPreOrOperational = true;
+
+    for(i=0; i<CO_NO_SDO_SERVER; i++){
+        CO_SDO_process_us(
+                co->SDO[i],
+                NMTisPreOrOperational,
+                timeDifference_us,
+                1000000UL,
+                timerNext_us);
+    }
+}
+
+
 /******************************************************************************/
 #if CO_NO_SYNC == 1
 bool_t CO_process_SYNC(
         CO_t                   *co,
-        uint32_t                timeDifference_us)
+        uint32_t                timeDifference_us,
+        uint32_t               *timerNext_us)
 {
     bool_t syncWas = false;
 
-    switch(CO_SYNC_process(co->SYNC, timeDifference_us, OD_synchronousWindowLength)){
+    switch(CO_SYNC_process(co->SYNC, timeDifference_us, OD_synchronousWindowLength, timerNext_us)){
         case 1:     //immediately after the SYNC message
             syncWas = true;
             break;
@@ -128,6 +128,7 @@ typedef struct{
     CO_TIME_t          *TIME;           /**< TIME object */
     CO_RPDO_t          *RPDO[CO_NO_RPDO];/**< RPDO objects */
     CO_TPDO_t          *TPDO[CO_NO_TPDO];/**< TPDO objects */
+    CO_RPDOmonitor_t   *RPDOmonitor;    /**< RPDO reception timeout monitor */
     CO_HBconsumer_t    *HBcons;         /**<  Heartbeat consumer object*/
 #if CO_NO_LSS_SERVER == 1
     CO_LSSslave_t      *LSSslave;       /**< LSS server/slave object */
@@ -152,7 +153,8 @@ typedef struct{
  * Function CO_sendNMTcommand() is simple function, which sends CANopen message.
  * This part of code is an example of custom definition of simple CANopen
  * object. Follow the code in CANopen.c file. If macro CO_NO_NMT_MASTER is 1,
- * function CO_sendNMTcommand can be used to send NMT master message.
+ * function CO_sendNMTcommand can be used to send NMT master message. For
+ * boot-up of the whole network see @ref CO_NMTmaster.
  *
  * @param co CANopen object.
  * @param command NMT command.
@@ -240,6 +242,30 @@ CO_ReturnError_t CO_init(
 #endif /* CO_NO_LSS_SERVER == 1 */
 
 
+/**
+ * Use other Object Dictionary than CO_OD[] from CO_OD.c.
+ *
+ * Function may be called before CO_init() (or CO_CANopenInit()), for example
+ * with Object Dictionary loaded from EDS at runtime, see CO_OD_eds_t. It is
+ * then used by all SDO servers after each communication reset. Communication
+ * objects still use variables OD_* from CO_OD.c, so Object Dictionary must
+ * place its entries on them, see CO_OD_eds_bind().
+ *
+ * @param OD Object Dictionary, sorted by index, or NULL for CO_OD[].
+ * @param ODSize Number of entries in OD.
+ * @param ODExtensions Array of ODSize CO_OD_extension_t objects.
+ * @param lookup Index lookup table, see CO_OD_setIndexLookup(). Used if
+ * CO_OD_INDEX_LOOKUP is enabled and lookup is not NULL.
+ * @param lookupMask Size of the lookup table minus one.
+ */
+void CO_setOD(
+        const CO_OD_entry_t    *OD,
+        uint16_t                ODSize,
+        CO_OD_extension_t      *ODExtensions,
+        const uint16_t         *lookup,
+        uint16_t                lookupMask);
+
+
 /**
  * Delete CANopen object and free memory. Must be called at program exit.
  *
@@ -280,14 +306,41 @@ CO_NMT_reset_cmd_t CO_process(
  *
  * @param co CANopen object.
  * @param timeDifference_us Time difference from previous function call in [microseconds].
+ * @param timerNext_us Return value - info to OS - maximum delay after function
+ *        should be called next time in [microseconds]. If device is SYNC
+ *        producer, it is time to the next ideal SYNC moment. Initial value
+ *        must be set to something, interval of the thread typically. Output
+ *        will be equal or lower to initial value. Parameter is ignored if NULL.
  *
  * @return True, if CANopen SYNC message was just received or transmitted.
  */
 bool_t CO_process_SYNC(
         CO_t                   *co,
-        uint32_t                timeDifference_us);
+        uint32_t                timeDifference_us,
+        uint32_t               *timerNext_us);
 #endif
 
+/**
+ * Process CANopen SDO servers.
+ *
+ * If CO_SDO_PROCESS_SEPARATE is defined, SDO servers are not processed by
+ * CO_process(), but by this function. It may be called from a thread, which
+ * is woken by the callback from CO_SDO_initCallback(), and from a timer, so
+ * SDO responses are sent without waiting for the next CO_process() cycle and
+ * timeouts are measured with monotonic clock. Function must not be called
+ * concurrently with CO_process(). On Linux it is called by taskSDO, see
+ * stack/socketCAN/CO_Linux_tasks.h.
+ *
+ * @param co CANopen object.
+ * @param timeDifference_us Time difference from previous function call in [microseconds].
+ * @param timerNext_us Return value - info to OS - set to 0, if function should
+ *        be called again without delay. Parameter is ignored if NULL.
+ */
+void CO_process_SDO(
+        CO_t                   *co,
+        uint32_t                timeDifference_us,
+        uint32_t               *timerNext_us);
+
 /**
  * Process CANopen RPDO objects.
  *
@@ -48,6 +48,9 @@ struct sCO_OD_RAM CO_OD_RAM = {
 /*1003*/ {0x0L, 0x0L, 0x0L, 0x0L, 0x0L, 0x0L, 0x0L, 0x0L},
 /*1010*/ {0x3L},
 /*1011*/ {0x1L},
+#if CO_NO_SDO_CLIENT == 1
+/*1280*/ {{0x3, 0x80000000L, 0x80000000L, 0x0}},
+#endif
 /*2100*/ {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
 /*2103*/ 0x0,
 /*2104*/ 0x0,
@@ -135,6 +138,13 @@ struct sCO_OD_EEPROM CO_OD_EEPROM = {
            {(void*)&CO_OD_ROM.SDOServerParameter[0].maxSubIndex, 0x05,  1},
            {(void*)&CO_OD_ROM.SDOServerParameter[0].COB_IDClientToServer, 0x85,  4},
            {(void*)&CO_OD_ROM.SDOServerParameter[0].COB_IDServerToClient, 0x85,  4}};
+#if CO_NO_SDO_CLIENT == 1
+/*0x1280*/ const CO_OD_entryRecord_t OD_record1280[4] = {
+           {(void*)&CO_OD_RAM.SDOClientParameter[0].maxSubIndex, 0x06,  1},
+           {(void*)&CO_OD_RAM.SDOClientParameter[0].COB_IDClientToServer, 0x8E,  4},
+           {(void*)&CO_OD_RAM.SDOClientParameter[0].COB_IDServerToClient, 0x8E,  4},
+           {(void*)&CO_OD_RAM.SDOClientParameter[0].nodeIDOfTheSDOServer, 0x0E,  1}};
+#endif
 /*0x1400*/ const CO_OD_entryRecord_t OD_record1400[3] = {
            {(void*)&CO_OD_ROM.RPDOCommunicationParameter[0].maxSubIndex, 0x05,  1},
            {(void*)&CO_OD_ROM.RPDOCommunicationParameter[0].COB_IDUsedByRPDO, 0x8D,  4},
@@ -302,6 +312,9 @@ const CO_OD_entry_t CO_OD[CO_OD_NoOfElements] = {
 {0x1019, 0x00, 0x0D,  1, (void*)&CO_OD_ROM.synchronousCounterOverflowValue},
 {0x1029, 0x06, 0x0D,  1, (void*)&CO_OD_ROM.errorBehavior[0]},
 {0x1200, 0x02, 0x00,  0, (void*)&OD_record1200},
+#if CO_NO_SDO_CLIENT == 1
+{0x1280, 0x03, 0x00,  0, (void*)&OD_record1280},
+#endif
 {0x1400, 0x02, 0x00,  0, (void*)&OD_record1400},
 {0x1401, 0x02, 0x00,  0, (void*)&OD_record1401},
 {0x1402, 0x02, 0x00,  0, (void*)&OD_record1402},
@@ -131,7 +131,7 @@ static void tmrTask_thread(void){
             bool_t syncWas;
 
             /* Process Sync */
-            syncWas = CO_process_SYNC(CO, TMR_TASK_INTERVAL);
+            syncWas = CO_process_SYNC(CO, TMR_TASK_INTERVAL, NULL);
 
             /* Read inputs */
             CO_process_RPDO(CO, syncWas);
@@ -30,6 +30,222 @@
 #include "CANopen.h"
 
 
+/*
+ * Atomic compare-and-swap. Returns true, if *ptr was equal to oldValue and was
+ * replaced by newValue. See CO_EM_LOCK_FREE.
+ */
+static bool_t CO_EM_cas8(volatile uint8_t *ptr, uint8_t oldValue, uint8_t newValue){
+#if CO_EM_LOCK_FREE
+    return __sync_bool_compare_and_swap(ptr, oldValue, newValue) ? true : false;
+#else
+    bool_t ret = false;
+
+    CO_LOCK_EMCY();
+    if(*ptr == oldValue){
+        *ptr = newValue;
+        ret = true;
+    }
+    CO_UNLOCK_EMCY();
+    return ret;
+#endif
+}
+
+static bool_t CO_EM_cas32(volatile uint32_t *ptr, uint32_t oldValue, uint32_t newValue){
+#if CO_EM_LOCK_FREE
+    return __sync_bool_compare_and_swap(ptr, oldValue, newValue) ? true : false;
+#else
+    bool_t ret = false;
+
+    CO_LOCK_EMCY();
+    if(*ptr == oldValue){
+        *ptr = newValue;
+        ret = true;
+    }
+    CO_UNLOCK_EMCY();
+    return ret;
+#endif
+}
+
+/* Atomic increment of the statistics counter. */
+static void CO_EM_inc32(volatile uint32_t *ptr){
+    uint32_t value;
+
+    do{
+        value = *ptr;
+    }while(!CO_EM_cas32(ptr, value, value + 1U));
+}
+
+/* Atomic change of the error status bits. Returns previous value. */
+static uint8_t CO_EM_changeBits(uint8_t *ptr, uint8_t setMask, uint8_t clearMask){
+    uint8_t value;
+
+    do{
+        value = *(volatile uint8_t*)ptr;
+    }while(!CO_EM_cas8(ptr, value, (uint8_t)((value | setMask) & ~clearMask)));
+    return value;
+}
+
+
+/*
+ * Put emergency message into the queue of the CO_EM_t. Function may be called
+ * concurrently from any thread or interrupt.
+ */
+static void CO_EM_queue(CO_EM_t *em, const uint8_t msg[8]){
+    CO_EM_queueSlot_t *slot;
+    uint32_t pos;
+
+#if CO_EM_COALESCE
+    /* Verify, if the last queued message is identical and not yet taken by
+     * CO_EM_process(). Slot can not be rewritten, before bufWritePos changes. */
+    pos = em->bufWritePos;
+    slot = &em->buf[(pos - 1U) & (CO_EM_INTERNAL_BUFFER_SIZE - 1U)];
+    if(slot->seq == pos){
+        uint8_t i;
+
+        CO_EM_BARRIER();
+        for(i = 0U; i < 8U; i++){
+            if(slot->data[i] != msg[i]){
+                break;
+            }
+        }
+        CO_EM_BARRIER();
+        if(i == 8U && slot->seq == pos && em->bufWritePos == pos){
+            CO_EM_inc32(&em->coalescedCount);
+            return;
+        }
+    }
+#endif
+
+    /* reserve position */
+    pos = em->bufWritePos;
+    for(;;){
+        int32_t dif;
+
+        slot = &em->buf[pos & (CO_EM_INTERNAL_BUFFER_SIZE - 1U)];
+        dif = (int32_t)(slot->seq - pos);
+        if(dif == 0){
+            if(CO_EM_cas32(&em->bufWritePos, pos, pos + 1U)){
+                break;
+            }
+        }
+        else if(dif < 0){
+            /* queue full, message is lost */
+            em->bufFull = 1U;
+            CO_EM_inc32(&em->droppedCount);
+#if CO_EM_DROP_STATS
+            {
+                uint8_t cnt;
+                do{
+                    cnt = em->droppedBits[msg[3]];
+                }while(cnt < 255U && !CO_EM_cas8(&em->droppedBits[msg[3]], cnt, cnt + 1U));
+            }
+#endif
+            return;
+        }
+        pos = em->bufWritePos;
+    }
+
+    /* write message and make it available to CO_EM_process() */
+    CO_memcpy(slot->data, msg, 8U);
+    CO_EM_BARRIER();
+    slot->seq = pos + 1U;
+    CO_EM_inc32(&em->queuedCount);
+
+    /* Optional signal to RTOS, which can resume task, which handles CO_EM_process */
+    if(em->pFunctSignal != NULL) {
+        em->pFunctSignal();
+    }
+}
+
+
+/*
+ * Store received emergency message into history. Function is called from
+ * receive function, which is the only writer.
+ */
+static void CO_EMhistory_store(
+        CO_EMhistory_t         *hist,
+        uint16_t                ident,
+        uint16_t                errorCode,
+        uint8_t                 errorRegister,
+        uint8_t                 errorBit,
+        uint32_t                infoCode)
+{
+    uint8_t nodeId = (uint8_t)(ident & 0x7FU);
+    CO_EMhistoryNode_t *node;
+    CO_EMhistoryEntry_t *entry;
+    uint8_t i, j;
+
+    if(nodeId == 0U){
+        return;
+    }
+    if(nodeId > hist->maxNodeId){
+        hist->ignoredCount++;
+        return;
+    }
+    node = &hist->nodes[nodeId - 1U];
+
+    hist->seq++;
+    CO_EM_BARRIER();
+
+    /* add message to the ring of the node */
+    entry = &hist->entries[(uint16_t)(nodeId - 1U) * hist->depth + node->head];
+    entry->timestamp_ms = hist->timeNow_ms;
+    entry->infoCode = infoCode;
+    entry->errorCode = errorCode;
+    entry->errorRegister = errorRegister;
+    entry->errorBit = errorBit;
+    entry->nodeId = nodeId;
+    if(++node->head >= hist->depth){
+        node->head = 0U;
+    }
+    if(node->count < hist->depth){
+        node->count++;
+    }
+    node->rxCount++;
+    node->lastRx_ms = entry->timestamp_ms;
+    node->errorRegister = errorRegister;
+
+    /* update set of active errors */
+    if(errorCode != 0U){
+        for(i = 0U; i < node->activeCount; i++){
+            if(node->active[i].errorCode == errorCode && node->active[i].errorBit == errorBit){
+                break;
+            }
+        }
+        if(i == node->activeCount){
+            if(node->activeCount >= CO_EM_HISTORY_ACTIVE){
+                /* forget the oldest error */
+                for(j = 1U; j < node->activeCount; j++){
+                    node->active[j - 1U] = node->active[j];
+                }
+                node->activeCount--;
+                node->activeOverflow = true;
+            }
+            node->active[node->activeCount].errorCode = errorCode;
+            node->active[node->activeCount].errorBit = errorBit;
+            node->activeCount++;
+        }
+    }
+    else if(errorRegister == 0U){
+        /* no more errors */
+        node->activeCount = 0U;
+        node->activeOverflow = false;
+    }
+    else{
+        /* remove errors with the same errorBit */
+        for(i = 0U, j = 0U; i < node->activeCount; i++){
+            if(node->active[i].errorBit != errorBit){
+                node->active[j++] = node->active[i];
+            }
+        }
+        node->activeCount = j;
+    }
+
+    CO_EM_BARRIER();
+    hist->seq++;
+}
+
+
 /*
  * Read received message from CAN module.
  *
@@ -44,14 +260,22 @@ static void CO_EM_receive(void *object, const CO_CANrxMsg_t *msg){
 
     em = (CO_EM_t*)object;
 
-    if(em!=NULL && em->pFunctSignalRx!=NULL){
+    if(em!=NULL && (em->pFunctSignalRx!=NULL || em->history!=NULL)){
+        uint16_t ident = CO_CANrxMsg_readIdent(msg);
+
         CO_memcpySwap2(&errorCode, &msg->data[0]);
         CO_memcpySwap4(&infoCode, &msg->data[4]);
-        em->pFunctSignalRx(CO_CANrxMsg_readIdent(msg),
-                           errorCode,
-                           msg->data[2],
-                           msg->data[3],
-                           infoCode);
+        if(em->history != NULL){
+            CO_EMhistory_store(em->history, ident, errorCode,
+                               msg->data[2], msg->data[3], infoCode);
+        }
+        if(em->pFunctSignalRx != NULL){
+            em->pFunctSignalRx(ident,
+                               errorCode,
+                               msg->data[2],
+                               msg->data[3],
+                               infoCode);
+        }
     }
 }
 
@@ -80,6 +304,8 @@ static CO_SDO_abortCode_t CO_ODF_1003(CO_ODF_arg_t *ODF_arg){
             ret = CO_SDO_AB_NO_DATA;
         }
         else{
+            /* map sub-index to the position inside ring */
+            CO_setUint32(ODF_arg->data, CO_EM_getPreDefErr(emPr, ODF_arg->subIndex));
             ret = CO_SDO_AB_NONE;
         }
     }
@@ -142,6 +368,7 @@ CO_ReturnError_t CO_EM_init(
         uint16_t                CANidTxEM)
 {
     uint8_t i;
+    uint16_t j;
 
     /* verify arguments */
     if(em==NULL || emPr==NULL || SDO==NULL || errorStatusBits==NULL || errorStatusBitsSize<6U ||
@@ -152,18 +379,23 @@ CO_ReturnError_t CO_EM_init(
     /* Configure object variables */
     em->errorStatusBits         = errorStatusBits;
     em->errorStatusBitsSize     = errorStatusBitsSize;
-    em->bufEnd                  = em->buf + (CO_EM_INTERNAL_BUFFER_SIZE * 8);
-    em->bufWritePtr             = em->buf;
-    em->bufReadPtr              = em->buf;
+    em->bufWritePos             = 0U;
+    em->bufReadPos              = 0U;
     em->bufFull                 = 0U;
     em->wrongErrorReport        = 0U;
+    em->bufMaxLevel             = 0U;
+    em->queuedCount             = 0U;
+    em->coalescedCount          = 0U;
+    em->droppedCount            = 0U;
     em->pFunctSignal            = NULL;
     em->pFunctSignalRx          = NULL;
+    em->history                 = NULL;
     emPr->em                    = em;
     emPr->errorRegister         = errorRegister;
     emPr->preDefErr             = preDefErr;
     emPr->preDefErrSize         = preDefErrSize;
     emPr->preDefErrNoOfErrors   = 0U;
+    emPr->preDefErrHead         = 0U;
     emPr->inhibitEmTimer        = 0U;
 
     /* clear error status bits */
@@ -171,6 +403,16 @@ CO_ReturnError_t CO_EM_init(
         em->errorStatusBits[i] = 0U;
     }
 
+    /* clear queue */
+    for(j=0U; j<CO_EM_INTERNAL_BUFFER_SIZE; j++){
+        em->buf[j].seq = j;
+    }
+#if CO_EM_DROP_STATS
+    for(j=0U; j<256U; j++){
+        em->droppedBits[j] = 0U;
+    }
+#endif
+
     /* Configure Object dictionary entry at index 0x1003 and 0x1014 */
     CO_OD_configure(SDO, OD_H1003_PREDEF_ERR_FIELD, CO_ODF_1003, (void*)emPr, 0, 0U);
     CO_OD_configure(SDO, OD_H1014_COBID_EMERGENCY, CO_ODF_1014, (void*)&SDO->nodeId, 0, 0U);
@@ -226,6 +468,34 @@ void CO_EM_initCallbackRx(
 }
 
 
+/******************************************************************************/
+void CO_EM_initHistory(
+        CO_EM_t                *em,
+        CO_EMhistory_t         *hist)
+{
+    if(em != NULL){
+        em->history = hist;
+    }
+}
+
+
+/******************************************************************************/
+uint32_t CO_EM_getPreDefErr(CO_EMpr_t *emPr, uint8_t subIndex){
+    uint16_t pos;
+
+    if(emPr == NULL || subIndex == 0U || subIndex > emPr->preDefErrNoOfErrors){
+        return 0U;
+    }
+
+    /* sub-index 1 is at preDefErrHead, older errors are before it */
+    pos = (uint16_t)emPr->preDefErrHead + emPr->preDefErrSize - (subIndex - 1U);
+    if(pos >= emPr->preDefErrSize){
+        pos -= emPr->preDefErrSize;
+    }
+    return emPr->preDefErr[pos];
+}
+
+
 /******************************************************************************/
 void CO_EM_process(
         CO_EMpr_t              *emPr,
@@ -267,66 +537,84 @@ void CO_EM_process(
     }
     *emPr->errorRegister = (*emPr->errorRegister & errorMask) | errorRegister;
 
+    /* advance time of the emergency consumer history */
+    if(em->history != NULL){
+        CO_EMhistory_t *hist = em->history;
+        uint32_t t = (uint32_t)hist->time_100us + timeDifference_100us;
+
+        hist->timeNow_ms += t / 10U;
+        hist->time_100us = (uint16_t)(t % 10U);
+    }
+
     /* inhibit time */
     if(emPr->inhibitEmTimer < emInhTime){
         emPr->inhibitEmTimer += timeDifference_100us;
     }
 
-    /* send Emergency message. */
-    if(     NMTisPreOrOperational &&
-            !emPr->CANtxBuff->bufferFull &&
-            (em->bufReadPtr != em->bufWritePtr || em->bufFull))
+    /* queue statistics */
     {
-        uint32_t preDEF;    /* preDefinedErrorField */
-        uint16_t diff;
-
-        if (emPr->inhibitEmTimer >= emInhTime) {
-            /* inhibit time elapsed, send message */
+        uint16_t level = (uint16_t)(em->bufWritePos - em->bufReadPos);
+        if(level > em->bufMaxLevel){
+            em->bufMaxLevel = level;
+        }
+    }
 
-            /* add error register */
-            em->bufReadPtr[2] = *emPr->errorRegister;
+    /* send Emergency messages, all at once if inhibit time is zero */
+    while(NMTisPreOrOperational && !emPr->CANtxBuff->bufferFull){
+        CO_EM_queueSlot_t *slot = &em->buf[em->bufReadPos & (CO_EM_INTERNAL_BUFFER_SIZE - 1U)];
+        uint32_t preDEF;    /* preDefinedErrorField */
 
-            /* copy data to CAN emergency message */
-            CO_memcpy(emPr->CANtxBuff->data, em->bufReadPtr, 8U);
-            CO_memcpy((uint8_t*)&preDEF, em->bufReadPtr, 4U);
-            em->bufReadPtr += 8;
+        /* verify if message is available */
+        if(slot->seq != (em->bufReadPos + 1U)){
+            break;
+        }
 
-            /* Update read buffer pointer and reset inhibit timer */
-            if(em->bufReadPtr == em->bufEnd){
-                em->bufReadPtr = em->buf;
+        if (emPr->inhibitEmTimer < emInhTime) {
+            /* check again after inhibit time elapsed */
+            uint16_t diff = (emInhTime - emPr->inhibitEmTimer + 9) / 10; /* time difference in ms, always round up */
+            if (timerNext_ms != NULL && *timerNext_ms > diff) {
+                *timerNext_ms = diff;
             }
-            emPr->inhibitEmTimer = 0U;
+            break;
+        }
 
-            /* verify message buffer overflow, then clear full flag */
-            if(em->bufFull == 2U){
-                em->bufFull = 0U;    /* will be updated below */
-                CO_errorReport(em, CO_EM_EMERGENCY_BUFFER_FULL, CO_EMC_GENERIC, 0U);
-            }
-            else{
-                em->bufFull = 0;
-                CO_errorReset(em, CO_EM_EMERGENCY_BUFFER_FULL, 0);
-            }
+        /* inhibit time elapsed, send message */
+        CO_EM_BARRIER();
 
-            /* write to 'pre-defined error field' (object dictionary, index 0x1003) */
-            if(emPr->preDefErr){
-                uint8_t j;
+        /* add error register */
+        slot->data[2] = *emPr->errorRegister;
 
-                if(emPr->preDefErrNoOfErrors < emPr->preDefErrSize)
-                    emPr->preDefErrNoOfErrors++;
-                for(j=emPr->preDefErrNoOfErrors-1; j>0; j--)
-                    emPr->preDefErr[j] = emPr->preDefErr[j-1];
-                emPr->preDefErr[0] = preDEF;
-            }
+        /* copy data to CAN emergency message */
+        CO_memcpy(emPr->CANtxBuff->data, slot->data, 8U);
+        CO_memcpy((uint8_t*)&preDEF, slot->data, 4U);
+
+        /* release slot to the producers and reset inhibit timer */
+        CO_EM_BARRIER();
+        slot->seq = em->bufReadPos + CO_EM_INTERNAL_BUFFER_SIZE;
+        em->bufReadPos++;
+        emPr->inhibitEmTimer = 0U;
 
-            /* send CAN message */
-            CO_CANsend(emPr->CANdev, emPr->CANtxBuff);
+        /* verify message buffer overflow, then clear full flag */
+        if(em->bufFull != 0U){
+            em->bufFull = 0U;
+            CO_errorReport(em, CO_EM_EMERGENCY_BUFFER_FULL, CO_EMC_GENERIC, 0U);
+        }
+        else{
+            CO_errorReset(em, CO_EM_EMERGENCY_BUFFER_FULL, 0);
         }
 
-        /* check again after inhibit time elapsed */
-        diff = (emInhTime + 9) / 10; /* time difference in ms, always round up */
-        if (timerNext_ms != NULL && *timerNext_ms > diff) {
-            *timerNext_ms = diff;
+        /* write to 'pre-defined error field' (object dictionary, index 0x1003),
+         * overwrite the oldest error */
+        if(emPr->preDefErr && emPr->preDefErrSize > 0U){
+            if(emPr->preDefErrNoOfErrors < emPr->preDefErrSize)
+                emPr->preDefErrNoOfErrors++;
+            if(++emPr->preDefErrHead >= emPr->preDefErrSize)
+                emPr->preDefErrHead = 0U;
+            emPr->preDefErr[emPr->preDefErrHead] = preDEF;
         }
+
+        /* send CAN message */
+        CO_CANsend(emPr->CANdev, emPr->CANtxBuff);
     }
 
     return;
@@ -337,7 +625,6 @@ void CO_EM_process(
 void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCode, const uint32_t infoCode){
     uint8_t index = errorBit >> 3;
     uint8_t bitmask = 1 << (errorBit & 0x7);
-    uint8_t *errorStatusBits = 0;
     bool_t sendEmergency = true;
 
     if(em == NULL){
@@ -348,48 +635,24 @@ void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCod
         em->wrongErrorReport = errorBit;
         sendEmergency = false;
     }
-    else{
-        errorStatusBits = &em->errorStatusBits[index];
-        /* if error was already reported, do nothing */
-        if((*errorStatusBits & bitmask) != 0){
+    else if(errorBit){
+        /* set error bit (any error except NO_ERROR), if error was already
+         * reported, do nothing */
+        if((CO_EM_changeBits(&em->errorStatusBits[index], bitmask, 0U) & bitmask) != 0){
             sendEmergency = false;
         }
     }
 
     if(sendEmergency){
-        /* set error bit */
-        if(errorBit){
-            /* any error except NO_ERROR */
-            *errorStatusBits |= bitmask;
-        }
+        uint8_t bufCopy[8];
 
-        /* verify buffer full, set overflow */
-        if(em->bufFull){
-            em->bufFull = 2;
-        }
-        else{
-            uint8_t bufCopy[8];
-
-            /* prepare data for emergency message */
-            CO_memcpySwap2(&bufCopy[0], &errorCode);
-            bufCopy[2] = 0; /* error register will be set later */
-            bufCopy[3] = errorBit;
-            CO_memcpySwap4(&bufCopy[4], &infoCode);
-
-            /* copy data to the buffer, increment writePtr and verify buffer full */
-            CO_LOCK_EMCY();
-            CO_memcpy(em->bufWritePtr, &bufCopy[0], 8);
-            em->bufWritePtr += 8;
-
-            if(em->bufWritePtr == em->bufEnd) em->bufWritePtr = em->buf;
-            if(em->bufWritePtr == em->bufReadPtr) em->bufFull = 1;
-            CO_UNLOCK_EMCY();
-
-            /* Optional signal to RTOS, which can resume task, which handles CO_EM_process */
-            if(em->pFunctSignal != NULL) {
-                em->pFunctSignal();
-            }
-        }
+        /* prepare data for emergency message */
+        CO_memcpySwap2(&bufCopy[0], &errorCode);
+        bufCopy[2] = 0; /* error register will be set later */
+        bufCopy[3] = errorBit;
+        CO_memcpySwap4(&bufCopy[4], &infoCode);
+
+        CO_EM_queue(em, bufCopy);
     }
 }
 
@@ -398,7 +661,6 @@ void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCod
 void CO_errorReset(CO_EM_t *em, const uint8_t errorBit, const uint32_t infoCode){
     uint8_t index = errorBit >> 3;
     uint8_t bitmask = 1 << (errorBit & 0x7);
-    uint8_t *errorStatusBits = 0;
     bool_t sendEmergency = true;
 
     if(em == NULL){
@@ -409,46 +671,26 @@ void CO_errorReset(CO_EM_t *em, const uint8_t errorBit, const uint32_t infoCode)
         em->wrongErrorReport = errorBit;
         sendEmergency = false;
     }
-    else{
-        errorStatusBits = &em->errorStatusBits[index];
+    else if((em->errorStatusBits[index] & bitmask) == 0){
         /* if error was allready cleared, do nothing */
-        if((*errorStatusBits & bitmask) == 0){
-            sendEmergency = false;
-        }
+        sendEmergency = false;
+    }
+    else if((CO_EM_changeBits(&em->errorStatusBits[index], 0U, bitmask) & bitmask) == 0){
+        /* erase error bit, another thread was faster */
+        sendEmergency = false;
     }
 
     if(sendEmergency){
-        /* erase error bit */
-        *errorStatusBits &= ~bitmask;
+        uint8_t bufCopy[8];
 
-        /* verify buffer full */
-        if(em->bufFull){
-            em->bufFull = 2;
-        }
-        else{
-            uint8_t bufCopy[8];
-
-            /* prepare data for emergency message */
-            bufCopy[0] = 0;
-            bufCopy[1] = 0;
-            bufCopy[2] = 0; /* error register will be set later */
-            bufCopy[3] = errorBit;
-            CO_memcpySwap4(&bufCopy[4], &infoCode);
-
-            /* copy data to the buffer, increment writePtr and verify buffer full */
-            CO_LOCK_EMCY();
-            CO_memcpy(em->bufWritePtr, &bufCopy[0], 8);
-            em->bufWritePtr += 8;
-
-            if(em->bufWritePtr == em->bufEnd) em->bufWritePtr = em->buf;
-            if(em->bufWritePtr == em->bufReadPtr) em->bufFull = 1;
-            CO_UNLOCK_EMCY();
-
-            /* Optional signal to RTOS, which can resume task, which handles CO_EM_process */
-            if(em->pFunctSignal != NULL) {
-                em->pFunctSignal();
-            }
-        }
+        /* prepare data for emergency message */
+        bufCopy[0] = 0;
+        bufCopy[1] = 0;
+        bufCopy[2] = 0; /* error register will be set later */
+        bufCopy[3] = errorBit;
+        CO_memcpySwap4(&bufCopy[4], &infoCode);
+
+        CO_EM_queue(em, bufCopy);
     }
 }
 
@@ -467,3 +709,188 @@ bool_t CO_isError(CO_EM_t *em, const uint8_t errorBit){
 
     return ret;
 }
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_EMhistory_init(
+        CO_EMhistory_t         *hist,
+        CO_EMhistoryNode_t      nodes[],
+        uint8_t                 maxNodeId,
+        CO_EMhistoryEntry_t     entries[],
+        uint8_t                 depth)
+{
+    uint8_t i;
+
+    /* verify arguments */
+    if(hist==NULL || nodes==NULL || entries==NULL ||
+       maxNodeId==0U || maxNodeId>127U || depth==0U){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    /* Configure object variables */
+    hist->nodes = nodes;
+    hist->entries = entries;
+    hist->maxNodeId = maxNodeId;
+    hist->depth = depth;
+    hist->seq = 0U;
+    hist->timeNow_ms = 0U;
+    hist->time_100us = 0U;
+    hist->ignoredCount = 0U;
+    hist->readFailures = 0U;
+
+    for(i=0U; i<maxNodeId; i++){
+        nodes[i].rxCount = 0U;
+        nodes[i].lastRx_ms = 0U;
+        nodes[i].head = 0U;
+        nodes[i].count = 0U;
+        nodes[i].errorRegister = 0U;
+        nodes[i].activeCount = 0U;
+        nodes[i].activeOverflow = false;
+    }
+
+    return CO_ERROR_NO;
+}
+
+
+/*
+ * Copy messages of one node, the newest first, which match the query (NULL
+ * matches all). Caller verifies consistency with the sequence counter.
+ */
+static uint16_t CO_EMhistory_copyNode(
+        CO_EMhistory_t         *hist,
+        uint8_t                 nodeId,
+        const CO_EMhistoryQuery_t *query,
+        CO_EMhistoryEntry_t     result[],
+        uint16_t                maxResults)
+{
+    const CO_EMhistoryNode_t *node = &hist->nodes[nodeId - 1U];
+    const CO_EMhistoryEntry_t *entries = &hist->entries[(uint16_t)(nodeId - 1U) * hist->depth];
+    uint8_t pos = node->head;
+    uint8_t count = node->count;
+    uint16_t n = 0U;
+
+    if(pos >= hist->depth || count > hist->depth){
+        return 0U;  /* changed during copy, will be repeated */
+    }
+
+    while(count > 0U && n < maxResults){
+        const CO_EMhistoryEntry_t *entry;
+
+        pos = (pos == 0U) ? (hist->depth - 1U) : (pos - 1U);
+        entry = &entries[pos];
+        count--;
+
+        if(query != NULL){
+            if((int32_t)(entry->timestamp_ms - query->timeFrom_ms) < 0){
+                break;  /* all older messages are also outside window */
+            }
+            if((int32_t)(query->timeTo_ms - entry->timestamp_ms) < 0 ||
+               (entry->errorCode & query->errorCodeMask) != query->errorCode){
+                continue;
+            }
+        }
+        result[n++] = *entry;
+    }
+
+    return n;
+}
+
+
+/******************************************************************************/
+uint16_t CO_EMhistory_getNode(
+        CO_EMhistory_t         *hist,
+        uint8_t                 nodeId,
+        CO_EMhistoryEntry_t     result[],
+        uint16_t                maxResults)
+{
+    uint8_t retry;
+
+    if(hist==NULL || result==NULL || nodeId==0U || nodeId>hist->maxNodeId){
+        return 0U;
+    }
+
+    for(retry = 0U; retry < CO_EM_HISTORY_RETRIES; retry++){
+        uint32_t seq = hist->seq;
+        uint16_t n;
+
+        CO_EM_BARRIER();
+        if((seq & 1U) != 0U){
+            continue;
+        }
+        n = CO_EMhistory_copyNode(hist, nodeId, NULL, result, maxResults);
+        CO_EM_BARRIER();
+        if(hist->seq == seq){
+            return n;
+        }
+    }
+    CO_EM_inc32(&hist->readFailures);
+    return 0U;
+}
+
+
+/******************************************************************************/
+bool_t CO_EMhistory_getActive(
+        CO_EMhistory_t         *hist,
+        uint8_t                 nodeId,
+        CO_EMhistoryNode_t     *state)
+{
+    uint8_t retry;
+
+    if(hist==NULL || state==NULL || nodeId==0U || nodeId>hist->maxNodeId){
+        return false;
+    }
+
+    for(retry = 0U; retry < CO_EM_HISTORY_RETRIES; retry++){
+        uint32_t seq = hist->seq;
+
+        CO_EM_BARRIER();
+        if((seq & 1U) != 0U){
+            continue;
+        }
+        *state = hist->nodes[nodeId - 1U];
+        CO_EM_BARRIER();
+        if(hist->seq == seq){
+            return true;
+        }
+    }
+    CO_EM_inc32(&hist->readFailures);
+    return false;
+}
+
+
+/******************************************************************************/
+uint16_t CO_EMhistory_query(
+        CO_EMhistory_t         *hist,
+        const CO_EMhistoryQuery_t *query,
+        CO_EMhistoryEntry_t     result[],
+        uint16_t                maxResults)
+{
+    uint8_t first, last;
+    uint8_t retry;
+
+    if(hist==NULL || query==NULL || result==NULL || query->nodeId>hist->maxNodeId){
+        return 0U;
+    }
+    first = (query->nodeId == 0U) ? 1U : query->nodeId;
+    last = (query->nodeId == 0U) ? hist->maxNodeId : query->nodeId;
+
+    for(retry = 0U; retry < CO_EM_HISTORY_RETRIES; retry++){
+        uint32_t seq = hist->seq;
+        uint16_t n = 0U;
+        uint8_t nodeId;
+
+        CO_EM_BARRIER();
+        if((seq & 1U) != 0U){
+            continue;
+        }
+        for(nodeId = first; nodeId <= last && n < maxResults; nodeId++){
+            n += CO_EMhistory_copyNode(hist, nodeId, query, &result[n], maxResults - n);
+        }
+        CO_EM_BARRIER();
+        if(hist->seq == seq){
+            return n;
+        }
+    }
+    CO_EM_inc32(&hist->readFailures);
+    return 0U;
+}
@@ -68,6 +68,9 @@ extern "C" {
  * ####Contents of _Pre Defined Error Field_ (object dictionary, index 0x1003):
  * bytes 0..3 are equal to bytes 0..3 in the Emergency message.
  *
+ * Emergency messages from other nodes may be stored in optional
+ * CO_EMhistory_t.
+ *
  * @see #CO_Default_CAN_ID_t
  */
 
@@ -206,7 +209,7 @@ typedef enum{
 #define CO_EM_CAN_TX_OVERFLOW           0x14U /**< 0x14, communication, critical, CAN transmit buffer has overflowed */
 #define CO_EM_TPDO_OUTSIDE_WINDOW       0x15U /**< 0x15, communication, critical, TPDO is outside SYNC window */
 #define CO_EM_16_unused                 0x16U /**< 0x16, (unused) */
-#define CO_EM_17_unused                 0x17U /**< 0x17, (unused) */
+#define CO_EM_RPDO_TIME_OUT             0x17U /**< 0x17, communication, critical, RPDO timeout */
 #define CO_EM_SYNC_TIME_OUT             0x18U /**< 0x18, communication, critical, SYNC message timeout */
 #define CO_EM_SYNC_LENGTH               0x19U /**< 0x19, communication, critical, Unexpected SYNC data length */
 #define CO_EM_PDO_WRONG_MAPPING         0x1AU /**< 0x1A, communication, critical, Error with PDO mapping */
@@ -240,28 +243,204 @@ typedef enum{
 
 
 /**
- * Size of internal buffer, whwre emergencies are stored after CO_errorReport().
- * Buffer is cleared by CO_EM_process().
+ * Size of internal queue, where emergencies are stored after CO_errorReport().
+ * Queue is emptied by CO_EM_process(). Must be a power of two. Each slot
+ * takes 12 bytes of RAM (message and sequence number).
+ */
+#ifndef CO_EM_INTERNAL_BUFFER_SIZE
+    #define CO_EM_INTERNAL_BUFFER_SIZE      16
+#endif
+#if (CO_EM_INTERNAL_BUFFER_SIZE & (CO_EM_INTERNAL_BUFFER_SIZE - 1)) != 0
+    #error CO_EM_INTERNAL_BUFFER_SIZE must be a power of two
+#endif
+
+
+/**
+ * Use atomic compare-and-swap for the emergency queue and error status bits.
+ *
+ * If 1 (default, if compiler provides GCC __sync builtins for 8 and 32 bit
+ * variables), CO_errorReport() and CO_errorReset() are lock-free and may be
+ * called from any number of threads and interrupts concurrently. If 0, the
+ * same algorithm is used, but each compare-and-swap is a short critical
+ * section inside CO_LOCK_EMCY() and CO_UNLOCK_EMCY().
+ */
+#ifndef CO_EM_LOCK_FREE
+    #if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_1) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
+        #define CO_EM_LOCK_FREE 1
+    #else
+        #define CO_EM_LOCK_FREE 0
+    #endif
+#endif
+
+
+/** Memory barrier between message data and sequence number of the queue slot */
+#ifndef CO_EM_BARRIER
+    #if CO_EM_LOCK_FREE
+        #define CO_EM_BARRIER() __sync_synchronize()
+    #else
+        #define CO_EM_BARRIER() CANrxMemoryBarrier()
+    #endif
+#endif
+
+
+/**
+ * If 1, emergency, which is identical to the last queued and not yet sent
+ * emergency, is not queued again. It is only counted in CO_EM_t::coalescedCount.
+ */
+#ifndef CO_EM_COALESCE
+    #define CO_EM_COALESCE 1
+#endif
+
+
+/**
+ * If 1, CO_EM_t contains counter of lost emergencies for each error bit
+ * (256 bytes of RAM). Total number of lost emergencies is always counted.
+ */
+#ifndef CO_EM_DROP_STATS
+    #define CO_EM_DROP_STATS 0
+#endif
+
+
+/** Number of active errors remembered for each node in CO_EMhistoryNode_t */
+#ifndef CO_EM_HISTORY_ACTIVE
+    #define CO_EM_HISTORY_ACTIVE 4
+#endif
+
+/** Number of repeated copies of CO_EMhistory_t, before reader gives up. */
+#ifndef CO_EM_HISTORY_RETRIES
+    #define CO_EM_HISTORY_RETRIES 10
+#endif
+
+
+/**
+ * Emergency message received from remote node, stored in CO_EMhistory_t.
+ */
+typedef struct{
+    uint32_t            timestamp_ms;   /**< Time of reception, see CO_EMhistory_t */
+    uint32_t            infoCode;       /**< Bytes 4..7 of the Emergency message */
+    uint16_t            errorCode;      /**< @ref CO_EM_errorCodes */
+    uint8_t             errorRegister;  /**< #CO_errorRegisterBitmask_t */
+    uint8_t             errorBit;       /**< Byte 3 of the Emergency message */
+    uint8_t             nodeId;         /**< Node-ID of the producer */
+}CO_EMhistoryEntry_t;
+
+
+/**
+ * Active error of the remote node inside CO_EMhistoryNode_t.
+ */
+typedef struct{
+    uint16_t            errorCode;      /**< @ref CO_EM_errorCodes, not zero */
+    uint8_t             errorBit;       /**< Byte 3 of the Emergency message */
+}CO_EMhistoryActive_t;
+
+
+/**
+ * State of one remote node inside CO_EMhistory_t.
+ */
+typedef struct{
+    uint32_t            rxCount;        /**< Number of received emergencies */
+    uint32_t            lastRx_ms;      /**< Time of the last reception */
+    uint8_t             head;           /**< Position for the next entry in the ring */
+    uint8_t             count;          /**< Number of entries in the ring */
+    uint8_t             errorRegister;  /**< From the last emergency */
+    uint8_t             activeCount;    /**< Number of entries in active */
+    /** True, if more errors were active than fit into active */
+    bool_t              activeOverflow;
+    /** Currently active errors, the oldest first */
+    CO_EMhistoryActive_t active[CO_EM_HISTORY_ACTIVE];
+}CO_EMhistoryNode_t;
+
+
+/**
+ * Query for CO_EMhistory_query().
+ */
+typedef struct{
+    uint8_t             nodeId;         /**< Node-ID or 0 for all nodes */
+    uint16_t            errorCode;      /**< Entry matches, if (errorCode & errorCodeMask) ... */
+    uint16_t            errorCodeMask;  /**< ... == errorCode. Zero mask matches all. */
+    uint32_t            timeFrom_ms;    /**< Start of the time window, inclusive */
+    uint32_t            timeTo_ms;      /**< End of the time window, inclusive */
+}CO_EMhistoryQuery_t;
+
+
+/**
+ * Emergency consumer history, optional.
+ *
+ * Stores Emergency messages received from remote nodes: a ring of the latest
+ * messages and a set of currently active errors for each node. Error is added
+ * to the active set with error code different than zero. Message with error
+ * code 0 removes errors with the same errorBit or all errors, if error register
+ * is zero. All memory is provided by the application with CO_EMhistory_init(),
+ * history is attached to the emergency object with CO_EM_initHistory().
+ *
+ * History is written by the receive function, which is the only writer.
+ * Readers (CO_EMhistory_getNode(), CO_EMhistory_getActive(),
+ * CO_EMhistory_query()) may be called from any thread. They repeat the copy,
+ * if a message was received in the meantime, so they always return a
+ * consistent result without locking.
+ *
+ * Time is in [milliseconds] since CO_EMhistory_init(), advanced by
+ * CO_EM_process().
  */
-#define CO_EM_INTERNAL_BUFFER_SIZE      10
+typedef struct CO_EMhistory{
+    CO_EMhistoryNode_t *nodes;          /**< From CO_EMhistory_init() */
+    CO_EMhistoryEntry_t *entries;       /**< From CO_EMhistory_init() */
+    uint8_t             maxNodeId;      /**< From CO_EMhistory_init() */
+    uint8_t             depth;          /**< From CO_EMhistory_init() */
+    /** Sequence counter, odd while receive function writes */
+    volatile uint32_t   seq;
+    /** Monotonic time in [milliseconds], advanced by CO_EM_process() */
+    volatile uint32_t   timeNow_ms;
+    uint16_t            time_100us;     /**< Remainder of the time in [100 microseconds] */
+    uint32_t            ignoredCount;   /**< Messages from node-ID above maxNodeId */
+    uint32_t            readFailures;   /**< Reads abandoned after CO_EM_HISTORY_RETRIES */
+}CO_EMhistory_t;
 
 
 /**
- * Emergerncy object for CO_errorReport(). It contains error buffer, to which new emergency
+ * One entry of the emergency queue inside CO_EM_t.
+ */
+typedef struct{
+    /** Sequence number of the slot. It equals the queue position, when slot is
+    free for the producer, and position + 1, when message is ready for
+    CO_EM_process(). */
+    volatile uint32_t   seq;
+    /** Emergency message, error register is added by CO_EM_process() */
+    uint8_t             data[8];
+}CO_EM_queueSlot_t;
+
+
+/**
+ * Emergerncy object for CO_errorReport(). It contains error queue, to which new emergency
  * messages are written, when CO_errorReport() is called. This object is included in
  * CO_EMpr_t object.
+ *
+ * Queue is a bounded multi-producer, single-consumer ring. Producer reserves a
+ * position with compare-and-swap on bufWritePos, writes the message and then
+ * marks the slot ready with its sequence number. CO_EM_process() is the only
+ * consumer. If queue is full, message is lost, counted and
+ * CO_EM_EMERGENCY_BUFFER_FULL is reported later. Error status bits are
+ * also set and cleared atomically, so state of the errors is never lost.
  */
 typedef struct{
     uint8_t            *errorStatusBits;        /**< From CO_EM_init() */
     uint8_t             errorStatusBitsSize;    /**< From CO_EM_init() */
 
-    /** Internal buffer for storing unsent emergency messages.*/
-    uint8_t             buf[CO_EM_INTERNAL_BUFFER_SIZE * 8];
-    uint8_t            *bufEnd;             /**< End+1 address of the above buffer */
-    uint8_t            *bufWritePtr;        /**< Write pointer in the above buffer */
-    uint8_t            *bufReadPtr;         /**< Read pointer in the above buffer */
-    uint8_t             bufFull;            /**< True if above buffer is full */
+    /** Internal queue for storing unsent emergency messages.*/
+    CO_EM_queueSlot_t   buf[CO_EM_INTERNAL_BUFFER_SIZE];
+    volatile uint32_t   bufWritePos;        /**< Next position for the producers */
+    uint32_t            bufReadPos;         /**< Next position for CO_EM_process() */
+    volatile uint8_t    bufFull;            /**< True if message was lost because of full queue */
     uint8_t             wrongErrorReport;   /**< Error in arguments to CO_errorReport() */
+    /** Maximum number of messages inside queue, seen by CO_EM_process() */
+    uint16_t            bufMaxLevel;
+    volatile uint32_t   queuedCount;        /**< Number of queued messages */
+    volatile uint32_t   coalescedCount;     /**< Number of not queued identical messages */
+    volatile uint32_t   droppedCount;       /**< Number of messages lost because of full queue */
+#if CO_EM_DROP_STATS
+    /** Number of lost messages for each error bit, saturated at 255 */
+    volatile uint8_t    droppedBits[256];
+#endif
 
     /** From CO_EM_initCallback() or NULL */
     void              (*pFunctSignal)(void);
@@ -271,6 +450,8 @@ typedef struct{
                                         const uint8_t errorRegister,
                                         const uint8_t errorBit,
                                         const uint32_t infoCode);
+    /** From CO_EM_initHistory() or NULL */
+    CO_EMhistory_t     *history;
 }CO_EM_t;
 
 
@@ -282,7 +463,8 @@ typedef struct{
  * after the first occurance of specific error. In case of critical error, device
  * will not be able to stay in NMT_OPERATIONAL state.
  *
- * Function is short and may be used form any task or interrupt.
+ * Function is short and may be used form any task or interrupt, also
+ * concurrently, see #CO_EM_LOCK_FREE.
  *
  * @param em Emergency object.
  * @param errorBit from @ref CO_EM_errorStatusBits.
@@ -299,7 +481,8 @@ void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCod
  * Function is called if any error condition is solved. Emergency message is sent
  * with @ref CO_EM_errorCodes 0x0000.
  *
- * Function is short and may be used form any task or interrupt.
+ * Function is short and may be used form any task or interrupt, also
+ * concurrently, see #CO_EM_LOCK_FREE.
  *
  * @param em Emergency object.
  * @param errorBit from @ref CO_EM_errorStatusBits.
@@ -322,6 +505,79 @@ void CO_errorReset(CO_EM_t *em, const uint8_t errorBit, const uint32_t infoCode)
 bool_t CO_isError(CO_EM_t *em, const uint8_t errorBit);
 
 
+/**
+ * Initialize Emergency consumer history.
+ *
+ * History is cleared. It may be initialized once and attached with
+ * CO_EM_initHistory() after each CO_EM_init().
+ *
+ * @param hist This object will be initialized.
+ * @param nodes Pointer to externaly defined array of maxNodeId elements, index
+ * is node-ID - 1.
+ * @param maxNodeId Highest node-ID, which is stored, 1..127.
+ * @param entries Pointer to externaly defined array of maxNodeId * depth elements.
+ * @param depth Number of stored messages for each node, 1..255.
+ *
+ * @return #CO_ReturnError_t CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_EMhistory_init(
+        CO_EMhistory_t         *hist,
+        CO_EMhistoryNode_t      nodes[],
+        uint8_t                 maxNodeId,
+        CO_EMhistoryEntry_t     entries[],
+        uint8_t                 depth);
+
+
+/**
+ * Get stored messages of one node.
+ *
+ * @param hist This object.
+ * @param nodeId Node-ID of the remote node.
+ * @param [out] result Messages, the newest first.
+ * @param maxResults Size of the result array.
+ *
+ * @return Number of messages written to result.
+ */
+uint16_t CO_EMhistory_getNode(
+        CO_EMhistory_t         *hist,
+        uint8_t                 nodeId,
+        CO_EMhistoryEntry_t     result[],
+        uint16_t                maxResults);
+
+
+/**
+ * Get state of one node: active errors, error register and counters.
+ *
+ * @param hist This object.
+ * @param nodeId Node-ID of the remote node.
+ * @param [out] state Copy of the node state.
+ *
+ * @return True on success.
+ */
+bool_t CO_EMhistory_getActive(
+        CO_EMhistory_t         *hist,
+        uint8_t                 nodeId,
+        CO_EMhistoryNode_t     *state);
+
+
+/**
+ * Find stored messages by node, error code and time window.
+ *
+ * @param hist This object.
+ * @param query Search criteria.
+ * @param [out] result Matching messages, nodes in ascending order, the newest
+ * message of each node first.
+ * @param maxResults Size of the result array.
+ *
+ * @return Number of messages written to result.
+ */
+uint16_t CO_EMhistory_query(
+        CO_EMhistory_t         *hist,
+        const CO_EMhistoryQuery_t *query,
+        CO_EMhistoryEntry_t     result[],
+        uint16_t                maxResults);
+
+
 #ifdef CO_DOXYGEN
 /** Skip section, if CO_SDO.h is not included */
     #define CO_SDO_H
@@ -333,12 +589,18 @@ bool_t CO_isError(CO_EM_t *em, const uint8_t errorBit);
  * Error control and Emergency object. It controls internal error state and
  * sends emergency message, if error condition was reported. Object is initialized
  * by CO_EM_init(). It contains CO_EM_t object.
+ *
+ * _Pre defined error field_ (preDefErr) is used as a ring: new error is written
+ * over the oldest one at preDefErrHead. Order required by CANopen (sub-index 1
+ * is the newest error) is restored by the SDO server on reading. Application,
+ * which reads the array directly, must use CO_EM_getPreDefErr().
  */
 typedef struct{
     uint8_t            *errorRegister;  /**< From CO_EM_init() */
     uint32_t           *preDefErr;      /**< From CO_EM_init() */
     uint8_t             preDefErrSize;  /**< From CO_EM_init() */
     uint8_t             preDefErrNoOfErrors;/**< Number of active errors in preDefErr */
+    uint8_t             preDefErrHead;  /**< Position of the newest error in preDefErr */
     uint16_t            inhibitEmTimer; /**< Internal timer for emergency message */
     CO_EM_t            *em;             /**< CO_EM_t sub object is included here */
     CO_CANmodule_t     *CANdev;         /**< From CO_EM_init() */
@@ -423,12 +685,38 @@ void CO_EM_initCallbackRx(
                                                 const uint32_t infoCode));
 
 
+/**
+ * Attach Emergency consumer history.
+ *
+ * Received Emergency messages are then stored in history, before
+ * pFunctSignalRx is called. History time is advanced by CO_EM_process().
+ *
+ * @param em This object.
+ * @param hist History initialized by CO_EMhistory_init() or NULL.
+ */
+void CO_EM_initHistory(
+        CO_EM_t                *em,
+        CO_EMhistory_t         *hist);
+
+
+/**
+ * Get error from _Pre defined error field_.
+ *
+ * @param emPr This object.
+ * @param subIndex Sub-index of the object 0x1003, 1 is the newest error.
+ *
+ * @return Error code and additional information or 0, if there is no such error.
+ */
+uint32_t CO_EM_getPreDefErr(CO_EMpr_t *emPr, uint8_t subIndex);
+
+
 /**
  * Process Error control and Emergency object.
  *
  * Function must be called cyclically. It verifies some communication errors,
- * calculates bit 0 and bit 4 from _Error register_ and sends emergency message
- * if necessary.
+ * calculates bit 0 and bit 4 from _Error register_ and sends emergency messages
+ * if necessary. All queued messages are sent in one call, as long as CAN
+ * transmit buffer is free and _Inhibit time EMCY_ allows.
  *
  * @param emPr This object.
  * @param NMTisPreOrOperational True if this node is NMT_PRE_OPERATIONAL or NMT_OPERATIONAL.
@@ -26,12 +26,30 @@
 #include "CANopen.h"
 #include "CO_HBconsumer.h"
 
+/*
+ * Position inside receive queue. Positions run modulo 2*numberOfMonitoredNodes,
+ * so full and empty queue can be distinguished.
+ */
+static uint8_t CO_HBcons_rxQueueSlot(const CO_HBconsumer_t *HBcons, uint8_t pos){
+    return (pos < HBcons->numberOfMonitoredNodes) ?
+           pos : (uint8_t)(pos - HBcons->numberOfMonitoredNodes);
+}
+
+static uint8_t CO_HBcons_rxQueueNext(const CO_HBconsumer_t *HBcons, uint8_t pos){
+    pos++;
+    return (pos < (uint8_t)(HBcons->numberOfMonitoredNodes * 2U)) ? pos : 0U;
+}
+
+
 /*
  * Read received message from CAN module.
  *
  * Function will be called (by CAN receive interrupt) every time, when CAN
  * message with correct identifier will be received. For more information and
  * description of parameters see file CO_driver.h.
+ *
+ * Node is put into the receive queue, if it is not there already, so queue
+ * can not overflow.
  */
 static void CO_HBcons_receive(void *object, const CO_CANrxMsg_t *msg){
     CO_HBconsNode_t *HBconsNode;
@@ -42,8 +60,213 @@ static void CO_HBcons_receive(void *object, const CO_CANrxMsg_t *msg){
     if(msg->DLC == 1){
         /* copy data and set 'new message' flag. */
         HBconsNode->NMTstate = (CO_NMT_internalState_t)msg->data[0];
-        SET_CANrxNew(HBconsNode->CANrxNew);
+        if(!IS_CANrxNew(HBconsNode->CANrxNew)){
+            CO_HBconsumer_t *HBcons = HBconsNode->HBcons;
+            uint8_t head = HBcons->rxQueueHead;
+
+            HBcons->monitoredNodes[CO_HBcons_rxQueueSlot(HBcons, head)].rxQueueNode = HBconsNode->idx;
+            SET_CANrxNew(HBconsNode->CANrxNew);
+            CANrxMemoryBarrier();
+            HBcons->rxQueueHead = CO_HBcons_rxQueueNext(HBcons, head);
+        }
+    }
+}
+
+
+/*
+ * Take the next node from the receive queue, which must not be empty. Node is
+ * removed from the queue before its 'new message' flag is cleared, so it can
+ * be queued again by the next reception.
+ */
+static CO_HBconsNode_t *CO_HBcons_rxQueuePop(CO_HBconsumer_t *HBcons){
+    uint8_t tail = HBcons->rxQueueTail;
+    CO_HBconsNode_t *monitoredNode;
+
+    CANrxMemoryBarrier();
+    monitoredNode = &HBcons->monitoredNodes[
+                    HBcons->monitoredNodes[CO_HBcons_rxQueueSlot(HBcons, tail)].rxQueueNode];
+    HBcons->rxQueueTail = CO_HBcons_rxQueueNext(HBcons, tail);
+    CLEAR_CANrxNew(monitoredNode->CANrxNew);
+    CANrxMemoryBarrier();
+
+    return monitoredNode;
+}
+
+
+/*
+ * Helper functions for the binary min-heap of active nodes. Heap is ordered
+ * by deadline_ms, comparison is safe against overflow of the time counter.
+ * Heap position 'pos' is stored in monitoredNodes[pos].heapNode.
+ */
+static bool_t CO_HBheap_before(const CO_HBconsumer_t *HBcons, uint8_t a, uint8_t b){
+    return ((int32_t)(HBcons->monitoredNodes[a].deadline_ms -
+                      HBcons->monitoredNodes[b].deadline_ms) < 0) ? true : false;
+}
+
+static void CO_HBheap_set(CO_HBconsumer_t *HBcons, uint8_t pos, uint8_t idx){
+    HBcons->monitoredNodes[pos].heapNode = idx;
+    HBcons->monitoredNodes[idx].heapIdx = pos;
+}
+
+static void CO_HBheap_siftUp(CO_HBconsumer_t *HBcons, uint8_t pos){
+    uint8_t idx = HBcons->monitoredNodes[pos].heapNode;
+
+    while(pos > 0U){
+        uint8_t parent = (uint8_t)((pos - 1U) / 2U);
+        if(!CO_HBheap_before(HBcons, idx, HBcons->monitoredNodes[parent].heapNode)){
+            break;
+        }
+        CO_HBheap_set(HBcons, pos, HBcons->monitoredNodes[parent].heapNode);
+        pos = parent;
+    }
+    CO_HBheap_set(HBcons, pos, idx);
+}
+
+static void CO_HBheap_siftDown(CO_HBconsumer_t *HBcons, uint8_t pos){
+    uint8_t idx = HBcons->monitoredNodes[pos].heapNode;
+
+    for(;;){
+        uint16_t child = pos * 2U + 1U;
+        if(child >= HBcons->heapCount){
+            break;
+        }
+        if((child + 1U) < HBcons->heapCount &&
+           CO_HBheap_before(HBcons, HBcons->monitoredNodes[child + 1U].heapNode,
+                                    HBcons->monitoredNodes[child].heapNode)){
+            child++;
+        }
+        if(!CO_HBheap_before(HBcons, HBcons->monitoredNodes[child].heapNode, idx)){
+            break;
+        }
+        CO_HBheap_set(HBcons, pos, HBcons->monitoredNodes[child].heapNode);
+        pos = (uint8_t)child;
+    }
+    CO_HBheap_set(HBcons, pos, idx);
+}
+
+static void CO_HBheap_remove(CO_HBconsumer_t *HBcons, uint8_t idx){
+    uint8_t pos = HBcons->monitoredNodes[idx].heapIdx;
+    uint8_t last;
+
+    if(pos >= HBcons->heapCount){
+        return;
+    }
+    HBcons->monitoredNodes[idx].heapIdx = CO_HBCONS_HEAP_NONE;
+    last = HBcons->monitoredNodes[--HBcons->heapCount].heapNode;
+    if(last != idx){
+        CO_HBheap_set(HBcons, pos, last);
+        CO_HBheap_siftUp(HBcons, pos);
+        CO_HBheap_siftDown(HBcons, HBcons->monitoredNodes[last].heapIdx);
+    }
+}
+
+/* Insert node into heap or move it to the new position after deadline change. */
+static void CO_HBheap_update(CO_HBconsumer_t *HBcons, uint8_t idx){
+    uint8_t pos = HBcons->monitoredNodes[idx].heapIdx;
+
+    if(pos >= HBcons->heapCount){
+        pos = HBcons->heapCount++;
+        CO_HBheap_set(HBcons, pos, idx);
+        CO_HBheap_siftUp(HBcons, pos);
+    }
+    else{
+        CO_HBheap_siftUp(HBcons, pos);
+        CO_HBheap_siftDown(HBcons, HBcons->monitoredNodes[idx].heapIdx);
+    }
+}
+
+
+/*
+ * Set NMT operational flag of the node and update the counter.
+ */
+static void CO_HBcons_setOperational(
+        CO_HBconsumer_t        *HBcons,
+        CO_HBconsNode_t        *monitoredNode,
+        bool_t                  operational)
+{
+    if(operational && !monitoredNode->operational){
+        HBcons->operationalCount++;
+    }
+    else if(!operational && monitoredNode->operational){
+        HBcons->operationalCount--;
     }
+    monitoredNode->operational = operational;
+}
+
+
+/*
+ * Set or clear the bit of node-ID inside 128-bit bitmap.
+ */
+static void CO_HBcons_setBit(uint32_t bitmap[], uint8_t nodeId, bool_t set){
+    uint32_t mask = 1UL << (nodeId & 0x1FU);
+
+    if(set){
+        bitmap[(nodeId >> 5) & 0x03U] |= mask;
+    }
+    else{
+        bitmap[(nodeId >> 5) & 0x03U] &= ~mask;
+    }
+}
+
+
+/*
+ * Update network state from the current state of the node. It will be
+ * published at the end of CO_HBconsumer_process().
+ */
+static void CO_HBcons_updateState(
+        CO_HBconsumer_t        *HBcons,
+        const CO_HBconsNode_t  *monitoredNode)
+{
+    CO_HBconsumer_networkState_t *state = &HBcons->stateShadow;
+    uint8_t nodeId = monitoredNode->nodeId & 0x7FU;
+    CO_HBconsumer_state_t HBstate = monitoredNode->HBstate;
+
+    CO_HBcons_setBit(state->monitored, nodeId,
+        (HBstate != CO_HBconsumer_UNCONFIGURED) ? true : false);
+    CO_HBcons_setBit(state->active, nodeId,
+        (HBstate == CO_HBconsumer_ACTIVE) ? true : false);
+    CO_HBcons_setBit(state->timeout, nodeId,
+        (HBstate == CO_HBconsumer_TIMEOUT) ? true : false);
+    CO_HBcons_setBit(state->operational, nodeId, monitoredNode->operational);
+    if(HBstate == CO_HBconsumer_UNCONFIGURED){
+        CO_HBcons_setBit(state->rebooted, nodeId, false);
+    }
+    state->monitoredCount = HBcons->monitoredCount;
+    state->operationalCount = HBcons->operationalCount;
+    state->timeoutCount = HBcons->timeoutCount;
+    state->timeChanged_ms = HBcons->timeNow_ms;
+    HBcons->stateChanged = true;
+}
+
+
+/*
+ * Publish network state, if it was changed.
+ */
+static void CO_HBcons_publishState(CO_HBconsumer_t *HBcons){
+    if(HBcons->stateChanged){
+        HBcons->stateChanged = false;
+        CO_OD_snapshot_publish(&HBcons->stateSnapshot);
+    }
+}
+
+
+/*
+ * Clear state of the monitored node to CO_HBconsumer_UNKNOWN, if configured.
+ */
+static void CO_HBcons_clearNode(
+        CO_HBconsumer_t        *HBcons,
+        CO_HBconsNode_t        *monitoredNode)
+{
+    CO_HBheap_remove(HBcons, monitoredNode->idx);
+    CO_HBcons_setOperational(HBcons, monitoredNode, false);
+    monitoredNode->NMTstate = CO_NMT_INITIALIZING;
+    if(monitoredNode->HBstate == CO_HBconsumer_TIMEOUT){
+        HBcons->timeoutCount--;
+    }
+    if(monitoredNode->HBstate != CO_HBconsumer_UNCONFIGURED){
+        monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
+    }
+    CO_HBcons_updateState(HBcons, monitoredNode);
 }
 
 
@@ -62,6 +285,18 @@ static void CO_HBcons_monitoredNodeConfig(
     if(idx >= HBcons->numberOfMonitoredNodes) return;
 
     monitoredNode = &HBcons->monitoredNodes[idx];
+
+    /* remove previous configuration */
+    CO_HBcons_clearNode(HBcons, monitoredNode);
+    if(monitoredNode->HBstate != CO_HBconsumer_UNCONFIGURED){
+        HBcons->monitoredCount--;
+        monitoredNode->HBstate = CO_HBconsumer_UNCONFIGURED;
+        CO_HBcons_updateState(HBcons, monitoredNode);
+    }
+    if(HBcons->nodeIdx[monitoredNode->nodeId & 0x7FU] == idx){
+        HBcons->nodeIdx[monitoredNode->nodeId & 0x7FU] = CO_HBCONS_IDX_NONE;
+    }
+
     monitoredNode->nodeId = nodeId;
     monitoredNode->time = time;
     monitoredNode->NMTstate = CO_NMT_INITIALIZING;
@@ -71,12 +306,15 @@ static void CO_HBcons_monitoredNodeConfig(
     if(monitoredNode->nodeId && monitoredNode->time){
         COB_ID = monitoredNode->nodeId + CO_CAN_ID_HEARTBEAT;
         monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
-
+        HBcons->monitoredCount++;
+        HBcons->nodeIdx[nodeId] = idx;
+        CO_HBcons_updateState(HBcons, monitoredNode);
     }
     else{
         COB_ID = 0;
         monitoredNode->time = 0;
     }
+    CO_HBcons_publishState(HBcons);
 
     /* configure Heartbeat consumer CAN reception */
     if (monitoredNode->HBstate != CO_HBconsumer_UNCONFIGURED) {
@@ -141,7 +379,8 @@ CO_ReturnError_t CO_HBconsumer_init(
 
     /* verify arguments */
     if(HBcons==NULL || em==NULL || SDO==NULL || HBconsTime==NULL ||
-        monitoredNodes==NULL || CANdevRx==NULL){
+        monitoredNodes==NULL || CANdevRx==NULL ||
+        numberOfMonitoredNodes > CO_HBCONS_MAX_NODES){
         return CO_ERROR_ILLEGAL_ARGUMENT;
     }
 
@@ -151,9 +390,46 @@ CO_ReturnError_t CO_HBconsumer_init(
     HBcons->monitoredNodes = monitoredNodes;
     HBcons->numberOfMonitoredNodes = numberOfMonitoredNodes;
     HBcons->allMonitoredOperational = 0;
+    HBcons->monitoredCount = 0;
+    HBcons->operationalCount = 0;
+    HBcons->timeoutCount = 0;
+    HBcons->heapCount = 0;
+    HBcons->rxQueueHead = 0;
+    HBcons->rxQueueTail = 0;
+    HBcons->NMTisPreOrOperationalPrev = false;
+    HBcons->timeNow_ms = 0;
     HBcons->CANdevRx = CANdevRx;
     HBcons->CANdevRxIdxStart = CANdevRxIdxStart;
 
+    /* Clear network state */
+    for(i=0; i<128U; i++) {
+        HBcons->nodeIdx[i] = CO_HBCONS_IDX_NONE;
+    }
+    for(i=0; i<4U; i++) {
+        HBcons->stateShadow.monitored[i] = 0;
+        HBcons->stateShadow.active[i] = 0;
+        HBcons->stateShadow.timeout[i] = 0;
+        HBcons->stateShadow.operational[i] = 0;
+        HBcons->stateShadow.rebooted[i] = 0;
+    }
+    HBcons->stateShadow.monitoredCount = 0;
+    HBcons->stateShadow.operationalCount = 0;
+    HBcons->stateShadow.timeoutCount = 0;
+    HBcons->stateShadow.timeChanged_ms = 0;
+    HBcons->stateChanged = true;
+    CO_OD_snapshot_init(&HBcons->stateSnapshot, &HBcons->state,
+                        &HBcons->stateShadow, sizeof(HBcons->state));
+
+    for(i=0; i<HBcons->numberOfMonitoredNodes; i++) {
+        CO_HBconsNode_t *monitoredNode = &HBcons->monitoredNodes[i];
+        monitoredNode->HBcons = HBcons;
+        monitoredNode->idx = i;
+        monitoredNode->HBstate = CO_HBconsumer_UNCONFIGURED;
+        monitoredNode->heapIdx = CO_HBCONS_HEAP_NONE;
+        monitoredNode->operational = false;
+        CLEAR_CANrxNew(monitoredNode->CANrxNew);
+    }
+
     for(i=0; i<HBcons->numberOfMonitoredNodes; i++) {
         uint8_t nodeId = (HBcons->HBconsTime[i] >> 16U) & 0xFFU;
         uint16_t time = HBcons->HBconsTime[i] & 0xFFFFU;
@@ -177,7 +453,7 @@ CO_ReturnError_t CO_HBconsumer_initEntry(
     CO_ReturnError_t ret = CO_ERROR_NO;
 
     /* verify arguments */
-    if(HBcons==NULL){
+    if(HBcons==NULL || nodeId>127U){
         return CO_ERROR_ILLEGAL_ARGUMENT;
     }
 
@@ -262,99 +538,117 @@ void CO_HBconsumer_initCallbackRemoteReset(
 void CO_HBconsumer_process(
         CO_HBconsumer_t        *HBcons,
         bool_t                  NMTisPreOrOperational,
-        uint16_t                timeDifference_ms)
+        uint16_t                timeDifference_ms,
+        uint16_t               *timerNext_ms)
 {
-    uint8_t i;
-    uint8_t emcyHeartbeatTimeoutActive = 0;
     uint8_t emcyRemoteResetActive = 0;
-    uint8_t AllMonitoredOperationalCopy;
+    uint32_t now = HBcons->timeNow_ms + timeDifference_ms;
     CO_HBconsNode_t *monitoredNode;
 
-    AllMonitoredOperationalCopy = 5;
-    monitoredNode = &HBcons->monitoredNodes[0];
+    HBcons->timeNow_ms = now;
 
     if(NMTisPreOrOperational){
-        for(i=0; i<HBcons->numberOfMonitoredNodes; i++){
-            uint16_t timeDifference_ms_copy = timeDifference_ms;
-            if(monitoredNode->time > 0){/* is node monitored */
-                /* Verify if received message is heartbeat or bootup */
-                if(IS_CANrxNew(monitoredNode->CANrxNew)){
-                    if(monitoredNode->NMTstate == CO_NMT_INITIALIZING){
-                        /* bootup message, call callback */
-                        if (monitoredNode->pFunctSignalRemoteReset != NULL) {
-                            monitoredNode->pFunctSignalRemoteReset(monitoredNode->nodeId, i,
-                                monitoredNode->functSignalObjectRemoteReset);
-                        }
-                    }
-                    else {
-                        /* heartbeat message */
-                        if (monitoredNode->HBstate!=CO_HBconsumer_ACTIVE &&
-                            monitoredNode->pFunctSignalHbStarted!=NULL) {
-                            monitoredNode->pFunctSignalHbStarted(monitoredNode->nodeId, i,
-                                monitoredNode->functSignalObjectHbStarted);
-                        }
-                        monitoredNode->HBstate = CO_HBconsumer_ACTIVE;
-                        monitoredNode->timeoutTimer = 0;  /* reset timer */
-                        timeDifference_ms_copy = 0;
-                    }
-                    CLEAR_CANrxNew(monitoredNode->CANrxNew);
-                }
+        /* Process received messages */
+        while(HBcons->rxQueueTail != HBcons->rxQueueHead){
+            monitoredNode = CO_HBcons_rxQueuePop(HBcons);
 
-                /* Verify timeout */
-                if(monitoredNode->timeoutTimer < monitoredNode->time) {
-                    monitoredNode->timeoutTimer += timeDifference_ms_copy;
+            if(monitoredNode->HBstate == CO_HBconsumer_UNCONFIGURED){
+                continue;
+            }
+            if(monitoredNode->NMTstate == CO_NMT_INITIALIZING){
+                /* bootup message, call callback */
+                if (monitoredNode->pFunctSignalRemoteReset != NULL) {
+                    monitoredNode->pFunctSignalRemoteReset(monitoredNode->nodeId, monitoredNode->idx,
+                        monitoredNode->functSignalObjectRemoteReset);
                 }
-                if(monitoredNode->HBstate!=CO_HBconsumer_UNCONFIGURED &&
-                   monitoredNode->HBstate!=CO_HBconsumer_UNKNOWN) {
-                    if(monitoredNode->timeoutTimer >= monitoredNode->time){
-                        /* timeout expired */
-                        CO_errorReport(HBcons->em, CO_EM_HEARTBEAT_CONSUMER, CO_EMC_HEARTBEAT, i);
-                        emcyHeartbeatTimeoutActive = 1;
-
-                        monitoredNode->NMTstate = CO_NMT_INITIALIZING;
-                        if (monitoredNode->HBstate!=CO_HBconsumer_TIMEOUT &&
-                            monitoredNode->pFunctSignalTimeout!=NULL) {
-                            monitoredNode->pFunctSignalTimeout(monitoredNode->nodeId, i,
-                                monitoredNode->functSignalObjectTimeout);
-                        }
-                        monitoredNode->HBstate = CO_HBconsumer_TIMEOUT;
-                    }
-                    else if(monitoredNode->NMTstate == CO_NMT_INITIALIZING){
-                        /* there was a bootup message */
-                        CO_errorReport(HBcons->em, CO_EM_HB_CONSUMER_REMOTE_RESET, CO_EMC_HEARTBEAT, i);
-                        emcyRemoteResetActive = 1;
-
-                        monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
-                    }
+                CO_HBcons_setBit(HBcons->stateShadow.rebooted, monitoredNode->nodeId, true);
+                if(monitoredNode->HBstate == CO_HBconsumer_ACTIVE){
+                    /* there was a bootup message */
+                    CO_errorReport(HBcons->em, CO_EM_HB_CONSUMER_REMOTE_RESET, CO_EMC_HEARTBEAT, monitoredNode->idx);
+                    emcyRemoteResetActive = 1;
+
+                    CO_HBheap_remove(HBcons, monitoredNode->idx);
+                    monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
                 }
-                if(monitoredNode->NMTstate != CO_NMT_OPERATIONAL) {
-                    AllMonitoredOperationalCopy = 0;
+            }
+            else {
+                /* heartbeat message */
+                if (monitoredNode->HBstate!=CO_HBconsumer_ACTIVE &&
+                    monitoredNode->pFunctSignalHbStarted!=NULL) {
+                    monitoredNode->pFunctSignalHbStarted(monitoredNode->nodeId, monitoredNode->idx,
+                        monitoredNode->functSignalObjectHbStarted);
                 }
+                if(monitoredNode->HBstate == CO_HBconsumer_TIMEOUT){
+                    HBcons->timeoutCount--;
+                }
+                monitoredNode->HBstate = CO_HBconsumer_ACTIVE;
+                monitoredNode->deadline_ms = now + monitoredNode->time;
+                CO_HBheap_update(HBcons, monitoredNode->idx);
+            }
+            CO_HBcons_setOperational(HBcons, monitoredNode,
+                (monitoredNode->NMTstate == CO_NMT_OPERATIONAL) ? true : false);
+            CO_HBcons_updateState(HBcons, monitoredNode);
+        }
+
+        /* Process only nodes with expired deadline, they are removed from heap */
+        while(HBcons->heapCount > 0U){
+            monitoredNode = &HBcons->monitoredNodes[HBcons->monitoredNodes[0].heapNode];
+
+            if((int32_t)(now - monitoredNode->deadline_ms) < 0){
+                break;
+            }
+
+            /* timeout expired */
+            CO_HBheap_remove(HBcons, monitoredNode->idx);
+            CO_errorReport(HBcons->em, CO_EM_HEARTBEAT_CONSUMER, CO_EMC_HEARTBEAT, monitoredNode->idx);
+
+            monitoredNode->NMTstate = CO_NMT_INITIALIZING;
+            CO_HBcons_setOperational(HBcons, monitoredNode, false);
+            if (monitoredNode->pFunctSignalTimeout!=NULL) {
+                monitoredNode->pFunctSignalTimeout(monitoredNode->nodeId, monitoredNode->idx,
+                    monitoredNode->functSignalObjectTimeout);
+            }
+            monitoredNode->HBstate = CO_HBconsumer_TIMEOUT;
+            HBcons->timeoutCount++;
+            CO_HBcons_updateState(HBcons, monitoredNode);
+        }
+
+        HBcons->allMonitoredOperational =
+            (HBcons->operationalCount == HBcons->monitoredCount) ? true : false;
+
+        /* inform OS about the next deadline */
+        if(timerNext_ms != NULL && HBcons->heapCount > 0U){
+            uint32_t diff = HBcons->monitoredNodes[HBcons->monitoredNodes[0].heapNode].deadline_ms - now;
+            if(*timerNext_ms > diff){
+                *timerNext_ms = (uint16_t)diff;
             }
-            monitoredNode++;
         }
     }
     else{ /* not in (pre)operational state */
-        for(i=0; i<HBcons->numberOfMonitoredNodes; i++){
-            monitoredNode->NMTstate = CO_NMT_INITIALIZING;
-            CLEAR_CANrxNew(monitoredNode->CANrxNew);
-            if(monitoredNode->HBstate != CO_HBconsumer_UNCONFIGURED){
-                monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
+        uint8_t i;
+
+        if(HBcons->NMTisPreOrOperationalPrev){
+            for(i=0; i<HBcons->numberOfMonitoredNodes; i++){
+                CO_HBcons_clearNode(HBcons, &HBcons->monitoredNodes[i]);
             }
-            monitoredNode++;
         }
-        AllMonitoredOperationalCopy = 0;
+        while(HBcons->rxQueueTail != HBcons->rxQueueHead){
+            monitoredNode = CO_HBcons_rxQueuePop(HBcons);
+            monitoredNode->NMTstate = CO_NMT_INITIALIZING;
+        }
+        HBcons->allMonitoredOperational = 0;
     }
+    HBcons->NMTisPreOrOperationalPrev = NMTisPreOrOperational;
+    CO_HBcons_publishState(HBcons);
+
     /* clear emergencies. We only have one emergency index for all
      * monitored nodes! */
-    if ( ! emcyHeartbeatTimeoutActive) {
+    if (HBcons->timeoutCount == 0U) {
         CO_errorReset(HBcons->em, CO_EM_HEARTBEAT_CONSUMER, 0);
     }
     if ( ! emcyRemoteResetActive) {
         CO_errorReset(HBcons->em, CO_EM_HB_CONSUMER_REMOTE_RESET, 0);
     }
-
-    HBcons->allMonitoredOperational = AllMonitoredOperationalCopy;
 }
 
 
@@ -363,23 +657,11 @@ int8_t CO_HBconsumer_getIdxByNodeId(
         CO_HBconsumer_t        *HBcons,
         uint8_t                 nodeId)
 {
-    uint8_t i;
-    CO_HBconsNode_t *monitoredNode;
-
-    if (HBcons == NULL) {
+    if (HBcons == NULL || nodeId > 127U ||
+        HBcons->nodeIdx[nodeId] == CO_HBCONS_IDX_NONE) {
         return -1;
     }
-
-    /* linear search for the node */
-    monitoredNode = &HBcons->monitoredNodes[0];
-    for(i=0; i<HBcons->numberOfMonitoredNodes; i++){
-        if (monitoredNode->nodeId == nodeId) {
-            return i;
-        }
-        monitoredNode ++;
-    }
-    /* not found */
-    return -1;
+    return (int8_t)HBcons->nodeIdx[nodeId];
 }
 
 
@@ -419,3 +701,39 @@ int8_t CO_HBconsumer_getNmtState(
     }
     return -1;
 }
+
+
+/******************************************************************************/
+bool_t CO_HBconsumer_getNetworkState(
+        CO_HBconsumer_t        *HBcons,
+        CO_HBconsumer_networkState_t *state)
+{
+    if (HBcons==NULL || state==NULL) {
+        return false;
+    }
+    return CO_OD_snapshot_read(&HBcons->stateSnapshot, state, 0, sizeof(*state));
+}
+
+
+/******************************************************************************/
+void CO_HBconsumer_clearRebooted(
+        CO_HBconsumer_t        *HBcons,
+        uint8_t                 nodeId)
+{
+    uint8_t i;
+
+    if (HBcons==NULL || nodeId>127U) {
+        return;
+    }
+
+    if (nodeId == 0U) {
+        for(i=0; i<4U; i++) {
+            HBcons->stateShadow.rebooted[i] = 0;
+        }
+    }
+    else {
+        CO_HBcons_setBit(HBcons->stateShadow.rebooted, nodeId, false);
+    }
+    HBcons->stateChanged = true;
+    CO_HBcons_publishState(HBcons);
+}
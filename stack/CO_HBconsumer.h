@@ -47,6 +47,14 @@ extern "C" {
  * Heartbeat set up is done by writing to the OD registers 0x1016 or by using
  * the function _CO_HBconsumer_initEntry()_
  *
+ * Processing is event driven. Receive function puts the node into a receive
+ * queue, only once until it is processed. Active nodes are kept in a binary
+ * min-heap, ordered by the time of their heartbeat timeout.
+ * CO_HBconsumer_process() only touches nodes, which were received or whose
+ * deadline has expired, so cost per event is O(log n) regardless of the number
+ * of monitored nodes. It also informs OS about the next deadline with
+ * timerNext_ms. Receive queue and heap are stored inside CO_HBconsNode_t array.
+ *
  * @see  @ref CO_NMT_Heartbeat
  */
 
@@ -61,16 +69,70 @@ typedef enum {
 } CO_HBconsumer_state_t;
 
 
+/** Maximum number of monitored nodes, limited by the receive queue */
+#define CO_HBCONS_MAX_NODES 127U
+
+
+/** Node is not in the deadline heap of the CO_HBconsumer_t */
+#define CO_HBCONS_HEAP_NONE 0xFFU
+
+
+/** Value of CO_HBconsumer_t::nodeIdx for node-ID, which is not monitored */
+#define CO_HBCONS_IDX_NONE 0xFFU
+
+
+/** True, if bit for nodeId is set in the bitmap of CO_HBconsumer_networkState_t */
+#define CO_HBCONS_BIT(bitmap, nodeId) \
+    ((((bitmap)[((nodeId) >> 5) & 0x03U] >> ((nodeId) & 0x1FU)) & 1U) != 0U)
+
+
+/**
+ * State of all monitored nodes, see CO_HBconsumer_getNetworkState().
+ *
+ * Bit _n_ of each bitmap corresponds to node-ID _n_, see CO_HBCONS_BIT().
+ */
+typedef struct{
+    uint32_t            monitored[4];     /**< Node is configured in 0x1016 */
+    uint32_t            active[4];        /**< State is CO_HBconsumer_ACTIVE */
+    uint32_t            timeout[4];       /**< State is CO_HBconsumer_TIMEOUT */
+    uint32_t            operational[4];   /**< Node is NMT operational */
+    /** Bootup message received, cleared by CO_HBconsumer_clearRebooted() */
+    uint32_t            rebooted[4];
+    uint8_t             monitoredCount;   /**< Number of configured nodes */
+    uint8_t             operationalCount; /**< Number of NMT operational nodes */
+    uint8_t             timeoutCount;     /**< Number of nodes in timeout */
+    /** Time of the last change in [milliseconds], see CO_HBconsumer_t */
+    uint32_t            timeChanged_ms;
+}CO_HBconsumer_networkState_t;
+
+
+/** Heartbeat consumer object, see below */
+typedef struct CO_HBconsumer CO_HBconsumer_t;
+
+
 /**
  * One monitored node inside CO_HBconsumer_t.
  */
 typedef struct{
+    CO_HBconsumer_t        *HBcons;       /**< From CO_HBconsumer_init() */
+    uint8_t                 idx;          /**< Index of this node in monitoredNodes */
     uint8_t                 nodeId;       /**< Node Id of the monitored node */
     CO_NMT_internalState_t  NMTstate;     /**< Of the remote node (Heartbeat payload) */
     CO_HBconsumer_state_t   HBstate;      /**< Current heartbeat state */
-    uint16_t                timeoutTimer; /**< Time since last heartbeat received */
     uint16_t                time;         /**< Consumer heartbeat time from OD */
-    volatile void          *CANrxNew;     /**< Indication if new Heartbeat message received from the CAN bus */
+    /** Time of the heartbeat timeout in [milliseconds], valid inside heap */
+    uint32_t                deadline_ms;
+    /** Position of this node inside deadline heap or CO_HBCONS_HEAP_NONE */
+    uint8_t                 heapIdx;
+    /** Heap storage: index of the node at this position of the heap */
+    uint8_t                 heapNode;
+    /** Receive queue storage: index of the node at this position of the queue */
+    volatile uint8_t        rxQueueNode;
+    /** True, if node was NMT operational, when processed last time */
+    bool_t                  operational;
+    /** Indication if new Heartbeat message received from the CAN bus. Set
+    together with insertion into the receive queue. */
+    volatile void          *CANrxNew;
     /** Callback for heartbeat state change to active event */
     void                  (*pFunctSignalHbStarted)(uint8_t nodeId, uint8_t idx, void *object); /**< From CO_HBconsumer_initTimeoutCallback() or NULL */
     void                   *functSignalObjectHbStarted;/**< Pointer to object */
@@ -89,7 +151,7 @@ typedef struct{
  * Object is initilaized by CO_HBconsumer_init(). It contains an array of
  * CO_HBconsNode_t objects.
  */
-typedef struct{
+struct CO_HBconsumer{
     CO_EM_t            *em;               /**< From CO_HBconsumer_init() */
     const uint32_t     *HBconsTime;       /**< From CO_HBconsumer_init() */
     CO_HBconsNode_t    *monitoredNodes;   /**< From CO_HBconsumer_init() */
@@ -97,9 +159,32 @@ typedef struct{
     /** True, if all monitored nodes are NMT operational or no node is
         monitored. Can be read by the application */
     uint8_t             allMonitoredOperational;
+    uint8_t             monitoredCount;   /**< Number of configured nodes */
+    uint8_t             operationalCount; /**< Number of NMT operational nodes */
+    uint8_t             timeoutCount;     /**< Number of nodes in timeout */
+    uint8_t             heapCount;        /**< Number of nodes inside heap */
+    /** Receive queue write position modulo 2*numberOfMonitoredNodes, written
+    by receive function */
+    volatile uint8_t    rxQueueHead;
+    /** Receive queue read position, written by CO_HBconsumer_process() */
+    volatile uint8_t    rxQueueTail;
+    /** NMTisPreOrOperational from the previous CO_HBconsumer_process() */
+    bool_t              NMTisPreOrOperationalPrev;
+    /** Monotonic time in [milliseconds], advanced by CO_HBconsumer_process() */
+    uint32_t            timeNow_ms;
+    /** Index inside monitoredNodes for each node-ID or CO_HBCONS_IDX_NONE */
+    uint8_t             nodeIdx[128];
+    /** Network state, published from stateShadow, see stateSnapshot */
+    CO_HBconsumer_networkState_t state;
+    /** Network state, updated incrementally by each state change */
+    CO_HBconsumer_networkState_t stateShadow;
+    /** Publishes stateShadow into state */
+    CO_OD_snapshot_t    stateSnapshot;
+    /** True, if stateShadow was changed and not yet published */
+    bool_t              stateChanged;
     CO_CANmodule_t     *CANdevRx;         /**< From CO_HBconsumer_init() */
     uint16_t            CANdevRxIdxStart; /**< From CO_HBconsumer_init() */
-}CO_HBconsumer_t;
+};
 
 
 /**
@@ -114,7 +199,8 @@ typedef struct{
  * from Object Dictionary (index 0x1016). Size of array is equal to numberOfMonitoredNodes.
  * @param monitoredNodes Pointer to the externaly defined array of the same size
  * as numberOfMonitoredNodes.
- * @param numberOfMonitoredNodes Total size of the above arrays.
+ * @param numberOfMonitoredNodes Total size of the above arrays, maximum
+ * CO_HBCONS_MAX_NODES.
  * @param CANdevRx CAN device for Heartbeat reception.
  * @param CANdevRxIdxStart Starting index of receive buffer in the above CAN device.
  * Number of used indexes is equal to numberOfMonitoredNodes.
@@ -209,20 +295,25 @@ void CO_HBconsumer_initCallbackRemoteReset(
 /**
  * Process Heartbeat consumer object.
  *
- * Function must be called cyclically.
+ * Function must be called cyclically or after the reception of the Heartbeat
+ * message and after the time, returned in timerNext_ms, has elapsed.
  *
  * @param HBcons This object.
  * @param NMTisPreOrOperational True if this node is NMT_PRE_OPERATIONAL or NMT_OPERATIONAL.
  * @param timeDifference_ms Time difference from previous function call in [milliseconds].
+ * @param timerNext_ms Return value - info to OS - see CO_process().
  */
 void CO_HBconsumer_process(
         CO_HBconsumer_t        *HBcons,
         bool_t                  NMTisPreOrOperational,
-        uint16_t                timeDifference_ms);
+        uint16_t                timeDifference_ms,
+        uint16_t               *timerNext_ms);
 
 /**
  * Get the heartbeat producer object index by node ID
  *
+ * Lookup is done in constant time.
+ *
  * @param HBcons This object.
  * @param nodeId producer node ID
  * @return index. -1 if not found
@@ -259,6 +350,37 @@ int8_t CO_HBconsumer_getNmtState(
         CO_NMT_internalState_t *nmtState);
 
 
+/**
+ * Get the state of all monitored nodes with single call.
+ *
+ * Bitmaps and counters are updated incrementally on each state change inside
+ * CO_HBconsumer_process() and published once per call. Function may be called
+ * from any thread, it never blocks. Copy is consistent, all values belong to
+ * the same version.
+ *
+ * @param HBcons This object.
+ * @param [out] state Network state.
+ *
+ * @return True on success, false if arguments are wrong or consistent copy was
+ * not possible, because state was changing all the time.
+ */
+bool_t CO_HBconsumer_getNetworkState(
+        CO_HBconsumer_t        *HBcons,
+        CO_HBconsumer_networkState_t *state);
+
+/**
+ * Clear _rebooted_ bit of the network state.
+ *
+ * Function must be called from the same thread as CO_HBconsumer_process().
+ *
+ * @param HBcons This object.
+ * @param nodeId Node-ID of the remote node or 0 for all nodes.
+ */
+void CO_HBconsumer_clearRebooted(
+        CO_HBconsumer_t        *HBcons,
+        uint8_t                 nodeId);
+
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
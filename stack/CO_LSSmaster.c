@@ -55,6 +55,7 @@ typedef enum {
   CO_LSSmaster_COMMAND_INQUIRE_SERIAL,
   CO_LSSmaster_COMMAND_INQUIRE_NODE_ID,
   CO_LSSmaster_COMMAND_IDENTIFY_FASTSCAN,
+  CO_LSSmaster_COMMAND_FASTSCAN_ASSIGN_ALL,
 } CO_LSSmaster_command_t;
 
 /*
@@ -66,6 +67,20 @@ typedef enum {
   CO_LSSmaster_FS_STATE_VERIFY
 } CO_LSSmaster_fs_t;
 
+/*
+ * LSS master fastscan assign all state machine
+ */
+typedef enum {
+  CO_LSSmaster_FSA_IDLE = 0,
+  CO_LSSmaster_FSA_CHECK,
+  CO_LSSmaster_FSA_SCAN,
+  CO_LSSmaster_FSA_BIT0,
+  CO_LSSmaster_FSA_VERIFY,
+  CO_LSSmaster_FSA_CFG_NODE_ID,
+  CO_LSSmaster_FSA_CFG_STORE,
+  CO_LSSmaster_FSA_DESELECT
+} CO_LSSmaster_fsa_t;
+
 /*
  * Read received message from CAN module.
  *
@@ -145,6 +160,11 @@ CO_ReturnError_t CO_LSSmaster_init(
     LSSmaster->state = CO_LSSmaster_STATE_WAITING;
     LSSmaster->command = CO_LSSmaster_COMMAND_WAITING;
     LSSmaster->timeoutTimer = 0;
+    LSSmaster->fsTimer_us = 0;
+    LSSmaster->fsTimeout_us = (uint32_t)timeout_ms * 1000U;
+    LSSmaster->fsTimeoutMin_us = CO_LSSmaster_FS_TIMEOUT_MIN_US;
+    LSSmaster->fsLatencyMax_us = 0;
+    LSSmaster->fsAck = false;
     CLEAR_CANrxNew(LSSmaster->CANrxNew);
     CO_memset(LSSmaster->CANrxData, 0, sizeof(LSSmaster->CANrxData));
     LSSmaster->pFunctSignal = NULL;
@@ -966,24 +986,18 @@ static CO_LSS_fastscan_lss_sub_next CO_LSSmaster_FsSearchNext(
     return CO_LSS_FASTSCAN_VENDOR_ID;
 }
 
-/******************************************************************************/
-CO_LSSmaster_return_t CO_LSSmaster_IdentifyFastscan(
-        CO_LSSmaster_t          *LSSmaster,
-        uint16_t                 timeDifference_ms,
-        CO_LSSmaster_fastscan_t *fastscan)
+/*
+ * Helper function - check scan types for fastscan
+ */
+static bool_t CO_LSSmaster_FsValid(
+        const CO_LSSmaster_fastscan_t   *fastscan)
 {
     uint8_t i;
     uint8_t count;
-    CO_LSSmaster_return_t ret = CO_LSSmaster_INVALID_STATE;
-    CO_LSS_fastscan_lss_sub_next next;
 
-    /* parameter validation */
-    if (LSSmaster==NULL || fastscan==NULL){
-        return CO_LSSmaster_ILLEGAL_ARGUMENT;
-    }
     if (fastscan->scan[0] == CO_LSSmaster_FS_SKIP) {
         /* vendor ID scan cannot be skipped */
-        return CO_LSSmaster_ILLEGAL_ARGUMENT;
+        return false;
     }
     count = 0;
     for (i = 0; i < (sizeof(fastscan->scan) / sizeof(fastscan->scan[0])); i++) {
@@ -992,9 +1006,26 @@ CO_LSSmaster_return_t CO_LSSmaster_IdentifyFastscan(
         }
         if (count > 2) {
             /* Node selection needs the Vendor ID and at least one other value */
-            return CO_LSSmaster_ILLEGAL_ARGUMENT;
+            return false;
         }
     }
+    return true;
+}
+
+/******************************************************************************/
+CO_LSSmaster_return_t CO_LSSmaster_IdentifyFastscan(
+        CO_LSSmaster_t          *LSSmaster,
+        uint16_t                 timeDifference_ms,
+        CO_LSSmaster_fastscan_t *fastscan)
+{
+    CO_LSSmaster_return_t ret = CO_LSSmaster_INVALID_STATE;
+    CO_LSS_fastscan_lss_sub_next next;
+
+    /* parameter validation */
+    if (LSSmaster==NULL || fastscan==NULL ||
+        !CO_LSSmaster_FsValid(fastscan)){
+        return CO_LSSmaster_ILLEGAL_ARGUMENT;
+    }
 
     /* state machine validation */
     if (LSSmaster->state!=CO_LSSmaster_STATE_WAITING ||
@@ -1104,4 +1135,414 @@ CO_LSSmaster_return_t CO_LSSmaster_IdentifyFastscan(
 }
 
 
+/*
+ * Helper function - calculate adaptive timeout of fastscan probes from the
+ * largest measured latency
+ */
+static void CO_LSSmaster_FsaAdapt(
+        CO_LSSmaster_t                  *LSSmaster)
+{
+    uint32_t timeoutMax_us = (uint32_t)LSSmaster->timeout * 1000U;
+    uint32_t timeout_us = LSSmaster->fsLatencyMax_us * CO_LSSmaster_FS_TIMEOUT_FACTOR
+                        + CO_LSSmaster_FS_TIMEOUT_MARGIN_US;
+
+    if (timeout_us < LSSmaster->fsTimeoutMin_us) {
+        timeout_us = LSSmaster->fsTimeoutMin_us;
+    }
+    if (timeout_us > timeoutMax_us) {
+        timeout_us = timeoutMax_us;
+    }
+    LSSmaster->fsTimeout_us = timeout_us;
+}
+
+/*
+ * Helper function - send fastscan probe for the current part of LSS address
+ */
+static void CO_LSSmaster_FsaProbe(
+        CO_LSSmaster_t                  *LSSmaster,
+        CO_LSSmaster_fsAssign_t         *fsAssign,
+        uint32_t                         idNumber,
+        uint8_t                          bitCheck,
+        uint8_t                          lssNext)
+{
+    LSSmaster->fsTimer_us = 0;
+    LSSmaster->fsAck = false;
+    LSSmaster->fsLssNext = lssNext;
+    fsAssign->stats.probes ++;
+
+    CO_LSSmaster_FsSendMsg(LSSmaster, idNumber, bitCheck,
+        LSSmaster->fsLssSub, lssNext);
+}
+
+/*
+ * Helper function - timeout of the current fastscan probe without response.
+ * Probe, which switches nodes to the next part of LSS address, uses the full
+ * timeout, because missing response is not verified before the switch.
+ */
+static uint32_t CO_LSSmaster_FsaTimeout(
+        CO_LSSmaster_t                  *LSSmaster,
+        uint32_t                         timeoutMax_us)
+{
+    return (LSSmaster->fsLssNext != LSSmaster->fsLssSub) ?
+           timeoutMax_us : LSSmaster->fsTimeout_us;
+}
+
+/*
+ * Helper function - wait for response to fastscan probe with microsecond time
+ * base. Responses of multiple nodes are serialized on the bus, so the largest
+ * latency of all responses is measured. Probe is finished after the response
+ * and after the largest latency plus margin, so late responses of other nodes to the same
+ * probe are not mistaken for responses to the next probe. If waitFull is true,
+ * probe is finished after timeout_us, to measure latency of all responses.
+ * Without response probe is finished after timeout_us.
+ */
+static CO_LSSmaster_return_t CO_LSSmaster_FsaWait(
+        CO_LSSmaster_t                  *LSSmaster,
+        CO_LSSmaster_fsAssign_t         *fsAssign,
+        uint32_t                         timeDifference_us,
+        uint32_t                         timeout_us,
+        bool_t                           waitFull)
+{
+    CO_LSSmaster_fsStats_t *stats = &fsAssign->stats;
+
+    LSSmaster->fsTimer_us += timeDifference_us;
+
+    if (IS_CANrxNew(LSSmaster->CANrxNew)) {
+        uint8_t cs = LSSmaster->CANrxData[0];
+        CLEAR_CANrxNew(LSSmaster->CANrxNew);
+
+        if (cs != CO_LSS_IDENT_SLAVE) {
+            /* wrong response received. Can not continue */
+            return CO_LSSmaster_SCAN_FAILED;
+        }
+        if (!LSSmaster->fsAck) {
+            uint32_t latency_us = LSSmaster->fsTimer_us;
+
+            LSSmaster->fsAck = true;
+            if (stats->latencyCount == 0 || latency_us < stats->latencyMin_us) {
+                stats->latencyMin_us = latency_us;
+            }
+            if (latency_us > stats->latencyMax_us) {
+                stats->latencyMax_us = latency_us;
+            }
+            stats->latencySum_us += latency_us;
+            stats->latencyCount ++;
+        }
+        if (LSSmaster->fsTimer_us > LSSmaster->fsLatencyMax_us) {
+            LSSmaster->fsLatencyMax_us = LSSmaster->fsTimer_us;
+            CO_LSSmaster_FsaAdapt(LSSmaster);
+        }
+    }
+
+    if (LSSmaster->fsAck) {
+        uint32_t settle_us = waitFull ? timeout_us
+                           : LSSmaster->fsLatencyMax_us + CO_LSSmaster_FS_TIMEOUT_MARGIN_US;
+
+        return (LSSmaster->fsTimer_us >= settle_us) ?
+               CO_LSSmaster_SCAN_FINISHED : CO_LSSmaster_WAIT_SLAVE;
+    }
+    if (LSSmaster->fsTimer_us >= timeout_us) {
+        stats->noAck ++;
+        return CO_LSSmaster_SCAN_NOACK;
+    }
+    return CO_LSSmaster_WAIT_SLAVE;
+}
+
+/*
+ * Helper function - check for unconfigured nodes, reset their fastscan
+ */
+static void CO_LSSmaster_FsaCheck(
+        CO_LSSmaster_t                  *LSSmaster,
+        CO_LSSmaster_fsAssign_t         *fsAssign)
+{
+    LSSmaster->command = CO_LSSmaster_COMMAND_FASTSCAN_ASSIGN_ALL;
+    LSSmaster->fsLssSub = CO_LSS_FASTSCAN_VENDOR_ID;
+    CO_memset((uint8_t*)&fsAssign->fastscan.found, 0,
+              sizeof(fsAssign->fastscan.found));
+
+    CO_LSSmaster_FsaProbe(LSSmaster, fsAssign, 0, CO_LSS_FASTSCAN_CONFIRM, 0);
+    fsAssign->phase = CO_LSSmaster_FSA_CHECK;
+}
+
+/*
+ * Helper function - start scan or verification of the current part of LSS
+ * address
+ */
+static void CO_LSSmaster_FsaFieldStart(
+        CO_LSSmaster_t                  *LSSmaster,
+        CO_LSSmaster_fsAssign_t         *fsAssign)
+{
+    const CO_LSSmaster_fastscan_t *fastscan = &fsAssign->fastscan;
+
+    if (fastscan->scan[LSSmaster->fsLssSub] == CO_LSSmaster_FS_MATCH) {
+        /* value is known, verify it and switch to the next part */
+        LSSmaster->fsIdNumber = fastscan->match.addr[LSSmaster->fsLssSub];
+        LSSmaster->fsBitChecked = CO_LSS_FASTSCAN_BIT0;
+        CO_LSSmaster_FsaProbe(LSSmaster, fsAssign, LSSmaster->fsIdNumber,
+            LSSmaster->fsBitChecked, CO_LSSmaster_FsSearchNext(LSSmaster, fastscan));
+        fsAssign->phase = CO_LSSmaster_FSA_VERIFY;
+    }
+    else {
+        LSSmaster->fsIdNumber = 0;
+        LSSmaster->fsBitChecked = CO_LSS_FASTSCAN_BIT31;
+        CO_LSSmaster_FsaProbe(LSSmaster, fsAssign, LSSmaster->fsIdNumber,
+            LSSmaster->fsBitChecked, LSSmaster->fsLssSub);
+        fsAssign->phase = CO_LSSmaster_FSA_SCAN;
+    }
+}
+
+/*
+ * Helper function - current part of LSS address is verified and nodes have
+ * switched to the next part. Continue with it or assign node-ID, if node is
+ * selected.
+ */
+static CO_LSSmaster_return_t CO_LSSmaster_FsaFieldDone(
+        CO_LSSmaster_t                  *LSSmaster,
+        CO_LSSmaster_fsAssign_t         *fsAssign)
+{
+    CO_LSS_fastscan_lss_sub_next next;
+
+    fsAssign->fastscan.found.addr[LSSmaster->fsLssSub] = LSSmaster->fsIdNumber;
+
+    next = CO_LSSmaster_FsSearchNext(LSSmaster, &fsAssign->fastscan);
+    if (next != CO_LSS_FASTSCAN_VENDOR_ID) {
+        LSSmaster->fsLssSub = next;
+        CO_LSSmaster_FsaFieldStart(LSSmaster, fsAssign);
+        return CO_LSSmaster_WAIT_SLAVE;
+    }
+
+    /* one node is now in LSS configuration mode */
+    LSSmaster->state = CO_LSSmaster_STATE_CFG_SLECTIVE;
+    LSSmaster->command = CO_LSSmaster_COMMAND_WAITING;
+    fsAssign->phase = CO_LSSmaster_FSA_CFG_NODE_ID;
+
+    return CO_LSSmaster_configureNodeId(LSSmaster, 0,
+        fsAssign->nodeIdFirst + fsAssign->nodeCount);
+}
+
+/*
+ * Helper function - node is configured, deselect it
+ */
+static CO_LSSmaster_return_t CO_LSSmaster_FsaNodeDone(
+        CO_LSSmaster_t                  *LSSmaster,
+        CO_LSSmaster_fsAssign_t         *fsAssign)
+{
+    if (fsAssign->addresses != NULL) {
+        fsAssign->addresses[fsAssign->nodeCount] = fsAssign->fastscan.found;
+    }
+    fsAssign->nodeCount ++;
+    fsAssign->stats.nodeTime_us = fsAssign->nodeTimer_us;
+    fsAssign->nodeTimer_us = 0;
+    fsAssign->retriesLeft = fsAssign->retries;
+
+    CO_LSSmaster_switchStateDeselect(LSSmaster);
+    LSSmaster->command = CO_LSSmaster_COMMAND_FASTSCAN_ASSIGN_ALL;
+
+    if (fsAssign->nodeCount >= fsAssign->maxNodes ||
+        (fsAssign->nodeIdFirst + fsAssign->nodeCount) > 0x7F) {
+        return CO_LSSmaster_SCAN_FINISHED;
+    }
+
+    /* check for next node after switch state global is sent */
+    fsAssign->phase = CO_LSSmaster_FSA_DESELECT;
+    return CO_LSSmaster_WAIT_SLAVE;
+}
+
+/******************************************************************************/
+CO_LSSmaster_return_t CO_LSSmaster_FastscanAssignAll(
+        CO_LSSmaster_t                  *LSSmaster,
+        uint32_t                         timeDifference_us,
+        CO_LSSmaster_fsAssign_t         *fsAssign)
+{
+    CO_LSSmaster_return_t ret = CO_LSSmaster_INVALID_STATE;
+    uint32_t timeoutMax_us;
+    uint32_t time_ms;
+    uint16_t timeDifference_ms;
+    uint8_t nodeId;
+
+    /* parameter validation */
+    if (LSSmaster==NULL || fsAssign==NULL ||
+        !CO_LSSmaster_FsValid(&fsAssign->fastscan) ||
+        fsAssign->nodeIdFirst < 1 || fsAssign->nodeIdFirst > 0x7F ||
+        fsAssign->maxNodes == 0) {
+        return CO_LSSmaster_ILLEGAL_ARGUMENT;
+    }
+
+    timeoutMax_us = (uint32_t)LSSmaster->timeout * 1000U;
+
+    /* start */
+    if (fsAssign->phase == CO_LSSmaster_FSA_IDLE) {
+        if (LSSmaster->state!=CO_LSSmaster_STATE_WAITING ||
+            LSSmaster->command!=CO_LSSmaster_COMMAND_WAITING) {
+            /* state machine not ready, other command is already processed */
+            return CO_LSSmaster_INVALID_STATE;
+        }
+
+        fsAssign->nodeCount = 0;
+        fsAssign->retriesLeft = fsAssign->retries;
+        fsAssign->nodeTimer_us = 0;
+        fsAssign->remainder_us = 0;
+        fsAssign->fullCheck = true;
+        CO_memset((uint8_t*)&fsAssign->stats, 0, sizeof(fsAssign->stats));
+
+        /* timeout is adapted after the first response */
+        LSSmaster->fsLatencyMax_us = 0;
+        LSSmaster->fsTimeoutMin_us = CO_LSSmaster_FS_TIMEOUT_MIN_US;
+        LSSmaster->fsTimeout_us = timeoutMax_us;
+
+        CO_LSSmaster_FsaCheck(LSSmaster, fsAssign);
+        return CO_LSSmaster_WAIT_SLAVE;
+    }
+
+    fsAssign->stats.totalTime_us += timeDifference_us;
+    fsAssign->nodeTimer_us += timeDifference_us;
+
+    /* configuration services have millisecond time base */
+    fsAssign->remainder_us += timeDifference_us;
+    time_ms = fsAssign->remainder_us / 1000U;
+    fsAssign->remainder_us -= time_ms * 1000U;
+    timeDifference_ms = (time_ms > 0xFFFFU) ? 0xFFFFU : (uint16_t)time_ms;
+
+    nodeId = fsAssign->nodeIdFirst + fsAssign->nodeCount;
+
+    /* Evaluate fastscan assign state machine. For each node:
+     * - check for non-configured nodes. At start and after failed scan wait
+     *   full timeout to measure latency of responses from all nodes
+     * - for each part of LSS address: scan bits 31 to 1 with adaptive
+     *   timeout, probe bit 0 and switch node state together. If there is no
+     *   response, verify with bit 0 set. Known values are only verified.
+     * - configure node-ID and optionally store it
+     * - deselect node */
+    switch (fsAssign->phase) {
+        case CO_LSSmaster_FSA_CHECK:
+            ret = CO_LSSmaster_FsaWait(LSSmaster, fsAssign,
+                      timeDifference_us, timeoutMax_us, fsAssign->fullCheck);
+            if (ret == CO_LSSmaster_SCAN_FINISHED) {
+                /* at least one node is waiting for fastscan */
+                fsAssign->fullCheck = false;
+                CO_LSSmaster_FsaFieldStart(LSSmaster, fsAssign);
+                ret = CO_LSSmaster_WAIT_SLAVE;
+            }
+            else if (ret == CO_LSSmaster_SCAN_NOACK) {
+                /* all nodes are configured */
+                ret = CO_LSSmaster_SCAN_FINISHED;
+            }
+            break;
+        case CO_LSSmaster_FSA_SCAN:
+            ret = CO_LSSmaster_FsaWait(LSSmaster, fsAssign, timeDifference_us,
+                      CO_LSSmaster_FsaTimeout(LSSmaster, timeoutMax_us), false);
+            if (ret == CO_LSSmaster_SCAN_NOACK) {
+                /* no response received, bit is 1 */
+                LSSmaster->fsIdNumber |= 1UL << LSSmaster->fsBitChecked;
+                ret = CO_LSSmaster_SCAN_FINISHED;
+            }
+            if (ret == CO_LSSmaster_SCAN_FINISHED) {
+                LSSmaster->fsBitChecked --;
+                if (LSSmaster->fsBitChecked == CO_LSS_FASTSCAN_BIT0) {
+                    /* probe bit 0 together with switch to the next part */
+                    CO_LSSmaster_FsaProbe(LSSmaster, fsAssign,
+                        LSSmaster->fsIdNumber, LSSmaster->fsBitChecked,
+                        CO_LSSmaster_FsSearchNext(LSSmaster, &fsAssign->fastscan));
+                    fsAssign->phase = CO_LSSmaster_FSA_BIT0;
+                }
+                else {
+                    CO_LSSmaster_FsaProbe(LSSmaster, fsAssign,
+                        LSSmaster->fsIdNumber, LSSmaster->fsBitChecked,
+                        LSSmaster->fsLssSub);
+                }
+                ret = CO_LSSmaster_WAIT_SLAVE;
+            }
+            break;
+        case CO_LSSmaster_FSA_BIT0:
+            ret = CO_LSSmaster_FsaWait(LSSmaster, fsAssign, timeDifference_us,
+                      CO_LSSmaster_FsaTimeout(LSSmaster, timeoutMax_us), false);
+            if (ret == CO_LSSmaster_SCAN_FINISHED) {
+                ret = CO_LSSmaster_FsaFieldDone(LSSmaster, fsAssign);
+            }
+            else if (ret == CO_LSSmaster_SCAN_NOACK) {
+                /* bit 0 is 1, verify it and switch to the next part */
+                LSSmaster->fsIdNumber |= 1UL;
+                CO_LSSmaster_FsaProbe(LSSmaster, fsAssign,
+                    LSSmaster->fsIdNumber, LSSmaster->fsBitChecked,
+                    CO_LSSmaster_FsSearchNext(LSSmaster, &fsAssign->fastscan));
+                fsAssign->phase = CO_LSSmaster_FSA_VERIFY;
+                ret = CO_LSSmaster_WAIT_SLAVE;
+            }
+            break;
+        case CO_LSSmaster_FSA_VERIFY:
+            ret = CO_LSSmaster_FsaWait(LSSmaster, fsAssign,
+                      timeDifference_us, timeoutMax_us, false);
+            if (ret == CO_LSSmaster_SCAN_FINISHED) {
+                ret = CO_LSSmaster_FsaFieldDone(LSSmaster, fsAssign);
+            }
+            else if (ret == CO_LSSmaster_SCAN_NOACK) {
+                if (fsAssign->fastscan.scan[LSSmaster->fsLssSub] == CO_LSSmaster_FS_MATCH) {
+                    /* no more unconfigured nodes with the given value */
+                    ret = CO_LSSmaster_SCAN_FINISHED;
+                }
+                else {
+                    /* scanned value is wrong, response was missed */
+                    ret = CO_LSSmaster_SCAN_FAILED;
+                }
+            }
+            break;
+        case CO_LSSmaster_FSA_CFG_NODE_ID:
+            ret = CO_LSSmaster_configureNodeId(LSSmaster, timeDifference_ms, nodeId);
+            if (ret == CO_LSSmaster_OK) {
+                if (fsAssign->store) {
+                    fsAssign->phase = CO_LSSmaster_FSA_CFG_STORE;
+                    ret = CO_LSSmaster_configureStore(LSSmaster, 0);
+                }
+                else {
+                    ret = CO_LSSmaster_FsaNodeDone(LSSmaster, fsAssign);
+                }
+            }
+            break;
+        case CO_LSSmaster_FSA_CFG_STORE:
+            ret = CO_LSSmaster_configureStore(LSSmaster, timeDifference_ms);
+            if (ret == CO_LSSmaster_OK) {
+                ret = CO_LSSmaster_FsaNodeDone(LSSmaster, fsAssign);
+            }
+            break;
+        case CO_LSSmaster_FSA_DESELECT:
+            if (!LSSmaster->TXbuff->bufferFull) {
+                CO_LSSmaster_FsaCheck(LSSmaster, fsAssign);
+            }
+            ret = CO_LSSmaster_WAIT_SLAVE;
+            break;
+        default:
+            break;
+    }
+
+    if (ret == CO_LSSmaster_SCAN_FAILED && fsAssign->retriesLeft > 0) {
+        /* repeat scan of the node with longer timeout */
+        fsAssign->retriesLeft --;
+        fsAssign->stats.retries ++;
+        LSSmaster->fsTimeoutMin_us =
+            (LSSmaster->fsTimeoutMin_us < timeoutMax_us / 2U) ?
+            LSSmaster->fsTimeoutMin_us * 2U : timeoutMax_us;
+        CO_LSSmaster_FsaAdapt(LSSmaster);
+
+        /* nodes may be partially scanned or selected, reset them and check
+         * for unconfigured nodes after switch state global is sent */
+        CO_LSSmaster_switchStateDeselect(LSSmaster);
+        LSSmaster->command = CO_LSSmaster_COMMAND_FASTSCAN_ASSIGN_ALL;
+        fsAssign->fullCheck = true;
+        fsAssign->phase = CO_LSSmaster_FSA_DESELECT;
+        ret = CO_LSSmaster_WAIT_SLAVE;
+    }
+
+    if (ret != CO_LSSmaster_WAIT_SLAVE) {
+        /* finished */
+        if (LSSmaster->state != CO_LSSmaster_STATE_WAITING) {
+            CO_LSSmaster_switchStateDeselect(LSSmaster);
+        }
+        fsAssign->stats.timeout_us = LSSmaster->fsTimeout_us;
+        fsAssign->phase = CO_LSSmaster_FSA_IDLE;
+        LSSmaster->command = CO_LSSmaster_COMMAND_WAITING;
+    }
+    return ret;
+}
+
+
 #endif
@@ -116,8 +116,14 @@ typedef struct{
 
     uint8_t          fsState;          /**< Current state of fastscan master state machine */
     uint8_t          fsLssSub;         /**< Current state of node state machine */
+    uint8_t          fsLssNext;        /**< lssNext of the current fastscan probe */
     uint8_t          fsBitChecked;     /**< Current scan bit position */
     uint32_t         fsIdNumber;       /**< Current scan result */
+    uint32_t         fsTimer_us;       /**< Time since the last fastscan probe, see CO_LSSmaster_FastscanAssignAll() */
+    uint32_t         fsTimeout_us;     /**< Adaptive timeout for fastscan probes, which are not acknowledged */
+    uint32_t         fsTimeoutMin_us;  /**< Lower limit for fsTimeout_us, raised after failed scan */
+    uint32_t         fsLatencyMax_us;  /**< Largest measured response latency */
+    bool_t           fsAck;            /**< Current fastscan probe was acknowledged */
 
     volatile void   *CANrxNew;         /**< Indication if new LSS message is received from CAN bus. It needs to be cleared when received message is completely processed. */
     uint8_t          CANrxData[8];     /**< 8 data bytes of the received message */
@@ -137,6 +143,26 @@ typedef struct{
 #define CO_LSSmaster_DEFAULT_TIMEOUT 1000U /* ms */
 
 
+/**
+ * Adaptive timeout of fastscan probes in CO_LSSmaster_FastscanAssignAll() is
+ * largest measured response latency multiplied by this factor, plus
+ * #CO_LSSmaster_FS_TIMEOUT_MARGIN_US.
+ */
+#ifndef CO_LSSmaster_FS_TIMEOUT_FACTOR
+#define CO_LSSmaster_FS_TIMEOUT_FACTOR 3U
+#endif
+
+/** See #CO_LSSmaster_FS_TIMEOUT_FACTOR, in microseconds. */
+#ifndef CO_LSSmaster_FS_TIMEOUT_MARGIN_US
+#define CO_LSSmaster_FS_TIMEOUT_MARGIN_US 500U
+#endif
+
+/** Minimum adaptive timeout of fastscan probes in microseconds. */
+#ifndef CO_LSSmaster_FS_TIMEOUT_MIN_US
+#define CO_LSSmaster_FS_TIMEOUT_MIN_US 1000U
+#endif
+
+
 /**
  * Initialize LSS object.
  *
@@ -464,6 +490,95 @@ CO_LSSmaster_return_t CO_LSSmaster_IdentifyFastscan(
         CO_LSSmaster_fastscan_t         *fastscan);
 
 
+/**
+ * Timing statistics of #CO_LSSmaster_FastscanAssignAll()
+ */
+typedef struct{
+    uint32_t probes;          /**< Number of sent fastscan messages */
+    uint32_t noAck;           /**< Number of probes without response */
+    uint32_t retries;         /**< Number of repeated scans */
+    uint32_t latencyMin_us;   /**< Minimum response latency */
+    uint32_t latencyMax_us;   /**< Maximum response latency */
+    uint32_t latencySum_us;   /**< Sum of response latencies, for average */
+    uint32_t latencyCount;    /**< Number of measured responses */
+    uint32_t timeout_us;      /**< Adaptive timeout at the end of scanning */
+    uint32_t nodeTime_us;     /**< Time to identify and configure the last node */
+    uint32_t totalTime_us;    /**< Time since start */
+} CO_LSSmaster_fsStats_t;
+
+/**
+ * Parameters and results of #CO_LSSmaster_FastscanAssignAll()
+ */
+typedef struct{
+    CO_LSSmaster_fastscan_t fastscan; /**< Scan and match values, set by application, see CO_LSSmaster_IdentifyFastscan() */
+    uint8_t                 nodeIdFirst; /**< Node-ID assigned to the first found node, next nodes get consecutive node-IDs. Set by application */
+    uint8_t                 maxNodes; /**< Maximum number of nodes to configure, set by application */
+    bool_t                  store;    /**< If true, configuration is stored on each node. Set by application */
+    uint8_t                 retries;  /**< Number of repeated scans after failure, set by application */
+    CO_LSS_address_t       *addresses;/**< Array of maxNodes elements for LSS addresses of configured nodes or NULL, set by application */
+    uint8_t                 nodeCount;/**< Number of configured nodes, node-IDs are nodeIdFirst to nodeIdFirst + nodeCount - 1 */
+    CO_LSSmaster_fsStats_t  stats;    /**< Timing statistics */
+    uint8_t                 phase;    /**< Internal state */
+    uint8_t                 retriesLeft; /**< Internal */
+    uint32_t                nodeTimer_us; /**< Internal */
+    uint32_t                remainder_us; /**< Internal */
+    bool_t                  fullCheck;/**< Internal */
+} CO_LSSmaster_fsAssign_t;
+
+/**
+ * Identify all unconfigured nodes by LSS fastscan and assign node-IDs to them
+ *
+ * Function repeats CO_LSSmaster_IdentifyFastscan(),
+ * CO_LSSmaster_configureNodeId(), optionally CO_LSSmaster_configureStore()
+ * and CO_LSSmaster_switchStateDeselect(), until no unconfigured node responds.
+ * Fastscan is faster than with CO_LSSmaster_IdentifyFastscan():
+ * - Probe is finished as soon as the response arrives. After the response
+ *   master only waits until the largest measured latency plus
+ *   #CO_LSSmaster_FS_TIMEOUT_MARGIN_US, so late responses
+ *   of other nodes are not mistaken for responses to the next probe. Latency
+ *   of responses from all unconfigured nodes is measured at the start, with
+ *   timeout from CO_LSSmaster_changeTimeout().
+ * - Probe without response, which is expected for each bit with value 1, is
+ *   finished after adaptive timeout, see #CO_LSSmaster_FS_TIMEOUT_FACTOR.
+ *   Probes, whose missing response ends the scan, and probes, which switch
+ *   nodes to the next part of the LSS address, use the timeout from
+ *   CO_LSSmaster_changeTimeout().
+ * - Bit 0 is probed together with the request to switch to the next part of
+ *   the LSS address. If it is acknowledged, separate verification is not
+ *   needed.
+ * - Values known in advance should be set to #CO_LSSmaster_FS_MATCH, they are
+ *   only verified.
+ *
+ * If verification of scanned value fails (because of a too short timeout,
+ * for example), switch state global to waiting is sent, so partially scanned
+ * or selected nodes start from the beginning, and scan of the node is
+ * repeated with doubled minimum timeout.
+ *
+ * Function should be called from a thread woken by the callback from
+ * CO_LSSmaster_initCallback(), with time taken from a monotonic clock, so the
+ * latency is measured accurately.
+ *
+ * This function needs that no node is selected when starting the scan process.
+ * Function must be called cyclically until it returns != #CO_LSSmaster_WAIT_SLAVE.
+ * Function is non-blocking.
+ *
+ * @param LSSmaster This object.
+ * @param timeDifference_us Time difference from previous function call in
+ * [microseconds]. Zero when request is started.
+ * @param fsAssign Parameters and results, see #CO_LSSmaster_fsAssign_t.
+ * Internal state must be zero, when request is started.
+ * @return #CO_LSSmaster_ILLEGAL_ARGUMENT, #CO_LSSmaster_INVALID_STATE,
+ * #CO_LSSmaster_WAIT_SLAVE, #CO_LSSmaster_SCAN_FINISHED (no more unconfigured
+ * nodes found or maxNodes configured), #CO_LSSmaster_SCAN_FAILED,
+ * #CO_LSSmaster_TIMEOUT, #CO_LSSmaster_OK_ILLEGAL_ARGUMENT,
+ * #CO_LSSmaster_OK_MANUFACTURER
+ */
+CO_LSSmaster_return_t CO_LSSmaster_FastscanAssignAll(
+        CO_LSSmaster_t                  *LSSmaster,
+        uint32_t                         timeDifference_us,
+        CO_LSSmaster_fsAssign_t         *fsAssign);
+
+
 #else /* CO_NO_LSS_CLIENT == 1 */
 
 /**
@@ -0,0 +1,498 @@
+/*
+ * CANopen NMT master network boot-up.
+ *
+ * @file        CO_NMTmaster.c
+ * @ingroup     CO_NMTmaster
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CANopen.h"
+#include "CO_NMTmaster.h"
+
+#if CO_NO_NMT_MASTER == 1 && CO_NO_SDO_CLIENT != 0
+
+/* Size of the header of concise DCF entry: index, sub-index and size */
+#define CO_NMTM_DCF_HEADER      7U
+
+
+/*
+ * Read little-endian UNSIGNED32 or UNSIGNED16 from byte array.
+ */
+static uint32_t CO_NMTmaster_le32(const uint8_t *p){
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t CO_NMTmaster_le16(const uint8_t *p){
+    return (uint16_t)((uint16_t)p[0] | (uint16_t)((uint16_t)p[1] << 8));
+}
+
+
+static void CO_NMTmaster_sdoDone(void *object, CO_SDOclientReq_t *req);
+
+
+/*
+ * Submit SDO transfer for the node.
+ */
+static bool_t CO_NMTmaster_submit(
+        CO_NMTmaster_node_t    *node,
+        uint16_t                index,
+        uint8_t                 subIndex,
+        bool_t                  upload,
+        uint8_t                *buffer,
+        uint32_t                bufferSize)
+{
+    CO_SDOclientReq_t *req = &node->req;
+    uint32_t i;
+
+    /* server may send less bytes than buffer size */
+    if(upload){
+        for(i=0; i<bufferSize; i++){
+            buffer[i] = 0;
+        }
+    }
+
+    req->nodeId = node->nodeId;
+    req->index = index;
+    req->subIndex = subIndex;
+    req->upload = upload;
+    req->blockEnable = (!upload && bufferSize > CO_NMTM_BLOCK_THRESHOLD) ? true : false;
+    req->completeAccess = false;
+    req->buffer = buffer;
+    req->bufferSize = bufferSize;
+    req->retries = node->nmtm->retries;
+    req->pFunctDone = CO_NMTmaster_sdoDone;
+    req->object = (void*)node;
+
+    node->sdoCount++;
+    return (CO_SDOclientSched_submit(node->nmtm->sched, req, 1) == CO_ERROR_NO) ? true : false;
+}
+
+
+/*
+ * Finish boot-up of the node with error.
+ */
+static void CO_NMTmaster_fail(
+        CO_NMTmaster_node_t    *node,
+        CO_NMTmaster_error_t    error,
+        uint16_t                index,
+        uint8_t                 subIndex)
+{
+    CO_NMTmaster_t *nmtm = node->nmtm;
+
+    node->state = CO_NMTM_NODE_ERROR;
+    node->error = (uint8_t)error;
+    node->errorIndex = index;
+    node->errorSubIndex = subIndex;
+    node->bootTime_ms = nmtm->time_ms;
+    nmtm->errorCount++;
+    if(node->mandatory){
+        nmtm->mandatoryFailed = true;
+    }
+
+    if(nmtm->pFunctSignal != NULL){
+        nmtm->pFunctSignal(nmtm->functSignalObject, node);
+    }
+}
+
+
+/*
+ * Submit the next entry from the concise DCF of the current state. Returns
+ * false, if there are no more entries.
+ */
+static bool_t CO_NMTmaster_nextDCF(CO_NMTmaster_node_t *node){
+    const uint8_t *dcf;
+    uint32_t dcfSize;
+    const uint8_t *entry;
+    uint32_t size;
+
+    if(node->state == CO_NMTM_NODE_CONFIG){
+        dcf = node->configDCF;
+        dcfSize = node->configDCFSize;
+    }
+    else{
+        dcf = node->pdoDCF;
+        dcfSize = node->pdoDCFSize;
+    }
+
+    if(node->entriesLeft == 0U){
+        return false;
+    }
+
+    /* verify entry header and data are inside DCF */
+    if((dcfSize - node->step) < CO_NMTM_DCF_HEADER){
+        CO_NMTmaster_fail(node, CO_NMTM_ERR_DCF, 0, 0);
+        return true;
+    }
+    entry = &dcf[node->step];
+    size = CO_NMTmaster_le32(&entry[3]);
+    if(size == 0U || size > (dcfSize - node->step - CO_NMTM_DCF_HEADER)){
+        CO_NMTmaster_fail(node, CO_NMTM_ERR_DCF, CO_NMTmaster_le16(&entry[0]), entry[2]);
+        return true;
+    }
+
+    node->step += CO_NMTM_DCF_HEADER + size;
+    node->entriesLeft--;
+
+    /* SDO client does not write into download buffer */
+    if(!CO_NMTmaster_submit(node, CO_NMTmaster_le16(&entry[0]), entry[2], false,
+                            (uint8_t*)&entry[CO_NMTM_DCF_HEADER], size))
+    {
+        CO_NMTmaster_fail(node, CO_NMTM_ERR_DCF, CO_NMTmaster_le16(&entry[0]), entry[2]);
+    }
+    return true;
+}
+
+
+/*
+ * Enter configuration state with DCF. Returns false, if DCF is empty.
+ */
+static bool_t CO_NMTmaster_beginDCF(
+        CO_NMTmaster_node_t    *node,
+        uint8_t                 state,
+        const uint8_t          *dcf,
+        uint32_t                dcfSize)
+{
+    node->state = state;
+    node->step = 4U;
+    node->entriesLeft = 0U;
+
+    if(dcf == NULL || dcfSize == 0U){
+        return false;
+    }
+    if(dcfSize < 4U){
+        CO_NMTmaster_fail(node, CO_NMTM_ERR_DCF, 0, 0);
+        return true;
+    }
+    node->entriesLeft = CO_NMTmaster_le32(dcf);
+
+    return CO_NMTmaster_nextDCF(node);
+}
+
+
+/*
+ * Advance state machine of the node, until SDO transfer is submitted or
+ * boot-up of the node ends.
+ */
+static void CO_NMTmaster_advance(CO_NMTmaster_node_t *node){
+    CO_NMTmaster_t *nmtm = node->nmtm;
+
+    /* identity, sub-index 1 to 4, skip not expected values */
+    if(node->state == CO_NMTM_NODE_IDENTITY){
+        while(node->step < 4U && node->identity[node->step] == 0U){
+            node->step++;
+        }
+        if(node->step < 4U){
+            node->step++;
+            if(!CO_NMTmaster_submit(node, 0x1018, (uint8_t)node->step, true,
+                                    node->buf, sizeof(node->buf)))
+            {
+                CO_NMTmaster_fail(node, CO_NMTM_ERR_SDO, 0x1018, (uint8_t)node->step);
+            }
+            return;
+        }
+        if(CO_NMTmaster_beginDCF(node, CO_NMTM_NODE_CONFIG,
+                                 node->configDCF, node->configDCFSize))
+        {
+            return;
+        }
+    }
+
+    if(node->state == CO_NMTM_NODE_CONFIG){
+        if(CO_NMTmaster_nextDCF(node)){
+            return;
+        }
+        if(CO_NMTmaster_beginDCF(node, CO_NMTM_NODE_PDO,
+                                 node->pdoDCF, node->pdoDCFSize))
+        {
+            return;
+        }
+    }
+
+    if(node->state == CO_NMTM_NODE_PDO){
+        if(CO_NMTmaster_nextDCF(node)){
+            return;
+        }
+    }
+
+    /* configured, NMT start is sent from CO_NMTmaster_process() */
+    node->state = CO_NMTM_NODE_WAIT_START;
+    node->bootTime_ms = nmtm->time_ms;
+    nmtm->configuredCount++;
+    if(nmtm->pFunctSignal != NULL){
+        nmtm->pFunctSignal(nmtm->functSignalObject, node);
+    }
+}
+
+
+/*
+ * Called by SDO client scheduler after SDO transfer is finished.
+ */
+static void CO_NMTmaster_sdoDone(void *object, CO_SDOclientReq_t *req){
+    CO_NMTmaster_node_t *node = (CO_NMTmaster_node_t*)object;
+
+    if(req->result != CO_SDOcli_ok_communicationEnd){
+        node->abortCode = req->abortCode;
+        CO_NMTmaster_fail(node, CO_NMTM_ERR_SDO, req->index, req->subIndex);
+        return;
+    }
+
+    if(node->state == CO_NMTM_NODE_IDENTITY){
+        uint32_t value = CO_NMTmaster_le32(node->buf);
+
+        if(req->index == 0x1000){
+            node->actualDeviceType = value;
+            if(node->deviceType != 0U && node->deviceType != value){
+                CO_NMTmaster_fail(node, CO_NMTM_ERR_DEVICE_TYPE, 0x1000, 0);
+                return;
+            }
+        }
+        else{
+            uint8_t i = (uint8_t)(req->subIndex - 1U);
+
+            node->actualIdentity[i] = value;
+            if(node->identity[i] != value){
+                CO_NMTmaster_fail(node, (CO_NMTmaster_error_t)(CO_NMTM_ERR_VENDOR + i),
+                                  0x1018, req->subIndex);
+                return;
+            }
+        }
+    }
+
+    CO_NMTmaster_advance(node);
+}
+
+
+/*
+ * Start boot-up of one node with reading device type.
+ */
+static void CO_NMTmaster_startNode(CO_NMTmaster_node_t *node){
+    uint8_t i;
+
+    node->state = CO_NMTM_NODE_IDENTITY;
+    node->error = CO_NMTM_ERR_NONE;
+    node->errorIndex = 0;
+    node->errorSubIndex = 0;
+    node->abortCode = 0;
+    node->actualDeviceType = 0;
+    for(i=0; i<4; i++){
+        node->actualIdentity[i] = 0;
+    }
+    node->bootTime_ms = 0;
+    node->sdoCount = 0;
+    node->step = 0;
+    node->entriesLeft = 0;
+
+    if(!CO_NMTmaster_submit(node, 0x1000, 0, true, node->buf, sizeof(node->buf))){
+        CO_NMTmaster_fail(node, CO_NMTM_ERR_SDO, 0x1000, 0);
+    }
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_NMTmaster_init(
+        CO_NMTmaster_t         *nmtm,
+        CO_t                   *co,
+        CO_SDOclientSched_t    *sched,
+        CO_NMTmaster_node_t     nodes[],
+        uint8_t                 numNodes,
+        uint8_t                 retries)
+{
+    uint8_t i;
+
+    /* verify arguments */
+    if(nmtm==NULL || co==NULL || sched==NULL || nodes==NULL || numNodes==0){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    for(i=0; i<numNodes; i++){
+        if(nodes[i].nodeId == 0 || nodes[i].nodeId > 127){
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+    }
+
+    /* Configure object variables */
+    nmtm->co = co;
+    nmtm->sched = sched;
+    nmtm->nodes = nodes;
+    nmtm->numNodes = numNodes;
+    nmtm->retries = retries;
+    nmtm->startAll = false;
+    nmtm->running = false;
+    nmtm->mandatoryFailed = false;
+    nmtm->configuredCount = 0;
+    nmtm->errorCount = 0;
+    nmtm->time_ms = 0;
+    nmtm->bootTime_ms = 0;
+    nmtm->pFunctSignal = NULL;
+    nmtm->functSignalObject = NULL;
+
+    for(i=0; i<numNodes; i++){
+        nodes[i].nmtm = nmtm;
+        nodes[i].state = CO_NMTM_NODE_IDLE;
+        nodes[i].error = CO_NMTM_ERR_NONE;
+    }
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+void CO_NMTmaster_initCallback(
+        CO_NMTmaster_t         *nmtm,
+        void                   *object,
+        void                  (*pFunctSignal)(void *object, CO_NMTmaster_node_t *node))
+{
+    if(nmtm != NULL){
+        nmtm->functSignalObject = object;
+        nmtm->pFunctSignal = pFunctSignal;
+    }
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_NMTmaster_start(CO_NMTmaster_t *nmtm, bool_t startAll){
+    uint8_t i;
+
+    if(nmtm == NULL || nmtm->running){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    nmtm->startAll = startAll;
+    nmtm->running = true;
+    nmtm->mandatoryFailed = false;
+    nmtm->configuredCount = 0;
+    nmtm->errorCount = 0;
+    nmtm->time_ms = 0;
+    nmtm->bootTime_ms = 0;
+
+    /* all identity checks are queued at once, scheduler runs them in parallel */
+    for(i=0; i<nmtm->numNodes; i++){
+        CO_NMTmaster_startNode(&nmtm->nodes[i]);
+    }
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_NMTmaster_restartNode(CO_NMTmaster_t *nmtm, uint8_t nodeId){
+    uint8_t i;
+
+    if(nmtm == NULL){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    for(i=0; i<nmtm->numNodes; i++){
+        CO_NMTmaster_node_t *node = &nmtm->nodes[i];
+
+        if(node->nodeId == nodeId){
+            if(node->state != CO_NMTM_NODE_IDLE && node->state != CO_NMTM_NODE_ERROR &&
+               node->state != CO_NMTM_NODE_STARTED)
+            {
+                return CO_ERROR_ILLEGAL_ARGUMENT;
+            }
+            if(node->state == CO_NMTM_NODE_ERROR){
+                nmtm->errorCount--;
+            }
+            else if(node->state == CO_NMTM_NODE_STARTED){
+                nmtm->configuredCount--;
+            }
+            if(!nmtm->running){
+                /* single node, started individually */
+                nmtm->running = true;
+                nmtm->startAll = false;
+                nmtm->time_ms = 0;
+            }
+            CO_NMTmaster_startNode(node);
+            return CO_ERROR_NO;
+        }
+    }
+
+    return CO_ERROR_ILLEGAL_ARGUMENT;
+}
+
+
+/******************************************************************************/
+bool_t CO_NMTmaster_process(
+        CO_NMTmaster_t         *nmtm,
+        uint16_t                timeDifference_ms,
+        uint16_t               *timerNext_ms)
+{
+    uint8_t i;
+    bool_t waiting = false;
+
+    if(nmtm == NULL){
+        return true;
+    }
+    if(!nmtm->running){
+        return true;
+    }
+
+    nmtm->time_ms += timeDifference_ms;
+
+    /* SDO transfers, callbacks advance node state machines */
+    CO_SDOclientSched_process(nmtm->sched, timeDifference_ms, timerNext_ms);
+
+    /* start configured nodes individually */
+    for(i=0; i<nmtm->numNodes; i++){
+        CO_NMTmaster_node_t *node = &nmtm->nodes[i];
+
+        if(node->state == CO_NMTM_NODE_WAIT_START && !nmtm->startAll){
+            if(CO_sendNMTcommand(nmtm->co, CO_NMT_ENTER_OPERATIONAL, node->nodeId) == CO_ERROR_NO){
+                node->state = CO_NMTM_NODE_STARTED;
+                if(nmtm->pFunctSignal != NULL){
+                    nmtm->pFunctSignal(nmtm->functSignalObject, node);
+                }
+            }
+            else{
+                /* transmit buffer busy, try again */
+                waiting = true;
+            }
+        }
+    }
+
+    /* all nodes finished */
+    if(!waiting && ((uint16_t)nmtm->configuredCount + nmtm->errorCount) >= nmtm->numNodes){
+        if(nmtm->startAll && !nmtm->mandatoryFailed){
+            if(CO_sendNMTcommand(nmtm->co, CO_NMT_ENTER_OPERATIONAL, 0) != CO_ERROR_NO){
+                return false;
+            }
+            for(i=0; i<nmtm->numNodes; i++){
+                CO_NMTmaster_node_t *node = &nmtm->nodes[i];
+
+                if(node->state == CO_NMTM_NODE_WAIT_START){
+                    node->state = CO_NMTM_NODE_STARTED;
+                    if(nmtm->pFunctSignal != NULL){
+                        nmtm->pFunctSignal(nmtm->functSignalObject, node);
+                    }
+                }
+            }
+        }
+        nmtm->bootTime_ms = nmtm->time_ms;
+        nmtm->running = false;
+        return true;
+    }
+
+    if(waiting && timerNext_ms != NULL){
+        *timerNext_ms = 0;
+    }
+
+    return false;
+}
+
+#endif /* CO_NO_NMT_MASTER == 1 && CO_NO_SDO_CLIENT != 0 */
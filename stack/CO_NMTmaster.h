@@ -0,0 +1,294 @@
+/**
+ * CANopen NMT master network boot-up.
+ *
+ * @file        CO_NMTmaster.h
+ * @ingroup     CO_NMTmaster
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CO_NMT_MASTER_H
+#define CO_NMT_MASTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (CO_NO_NMT_MASTER == 1 && CO_NO_SDO_CLIENT != 0) || defined CO_DOXYGEN
+
+/**
+ * @defgroup CO_NMTmaster NMT master boot-up
+ * @ingroup CO_CANopen
+ * @{
+ *
+ * Boot-up of the CANopen network, similar to CiA 302.
+ *
+ * NMT master runs boot-up of all expected nodes concurrently. Each node has
+ * its own state machine:
+ *  - Identity check: device type (0x1000) is read from each node, which also
+ *    verifies its presence. Identity (0x1018) sub-indexes, which are expected
+ *    with nonzero value, are read and compared.
+ *  - Configuration: entries from configDCF are downloaded.
+ *  - PDO setup: entries from pdoDCF are downloaded.
+ *  - Start: node is started individually or, with startAll, all nodes are
+ *    started with one NMT command after all nodes are configured.
+ *
+ * All SDO transfers are submitted to the SDO client scheduler
+ * (#CO_SDOclientSched_t), which executes them on all SDO clients in parallel.
+ * Requests of different nodes are interleaved, so boot-up time of the network
+ * is approximately the time of the slowest node multiplied by number of nodes
+ * divided by number of SDO clients, instead of the sum of the times of all
+ * nodes.
+ *
+ * Header is not included by CANopen.h, it must be included after it. Module
+ * is compiled only with CO_NO_NMT_MASTER and at least one SDO client, with
+ * example Object Dictionary build it with "make master".
+ *
+ * Configuration is in concise DCF format (as object 0x1F22 from CiA 302):
+ * UNSIGNED32 number of entries, then for each entry UNSIGNED16 index,
+ * UNSIGNED8 sub-index, UNSIGNED32 data size and data, all little-endian.
+ *
+ * ~~~{.c}
+ * CO_NMTmaster_t nmtm;
+ * CO_NMTmaster_node_t nodes[60]; // nodeId, identity and DCFs set by application
+ *
+ * CO_SDOclientSched_init(&sched, CO->SDOclient, CO_NO_SDO_CLIENT, 500);
+ * CO_NMTmaster_init(&nmtm, CO, &sched, nodes, 60, 2);
+ * CO_NMTmaster_start(&nmtm, true);
+ * while(!CO_NMTmaster_process(&nmtm, timeDifference_ms, &timerNext_ms)) {
+ *     ...
+ * }
+ * printf("network boot time: %u ms\n", nmtm.bootTime_ms);
+ * ~~~
+ */
+
+
+/** Entries larger than this are downloaded with SDO block transfer. */
+#ifndef CO_NMTM_BLOCK_THRESHOLD
+#define CO_NMTM_BLOCK_THRESHOLD     64U
+#endif
+
+
+/**
+ * State of the node boot-up.
+ */
+typedef enum{
+    CO_NMTM_NODE_IDLE           = 0,    /**< Boot-up not started */
+    CO_NMTM_NODE_IDENTITY       = 1,    /**< Reading device type and identity */
+    CO_NMTM_NODE_CONFIG         = 2,    /**< Downloading configDCF */
+    CO_NMTM_NODE_PDO            = 3,    /**< Downloading pdoDCF */
+    CO_NMTM_NODE_WAIT_START     = 4,    /**< Configured, waiting for NMT start */
+    CO_NMTM_NODE_STARTED        = 5,    /**< NMT start was sent */
+    CO_NMTM_NODE_ERROR          = 6     /**< Boot-up failed, see error */
+}CO_NMTmaster_nodeState_t;
+
+
+/**
+ * Reason for failed boot-up of the node.
+ */
+typedef enum{
+    CO_NMTM_ERR_NONE            = 0,    /**< No error */
+    CO_NMTM_ERR_SDO             = 1,    /**< SDO transfer failed, see abortCode */
+    CO_NMTM_ERR_DEVICE_TYPE     = 2,    /**< Device type does not match */
+    CO_NMTM_ERR_VENDOR          = 3,    /**< Vendor-ID does not match */
+    CO_NMTM_ERR_PRODUCT         = 4,    /**< Product code does not match */
+    CO_NMTM_ERR_REVISION        = 5,    /**< Revision number does not match */
+    CO_NMTM_ERR_SERIAL          = 6,    /**< Serial number does not match */
+    CO_NMTM_ERR_DCF             = 7     /**< Concise DCF is malformed */
+}CO_NMTmaster_error_t;
+
+
+typedef struct CO_NMTmaster CO_NMTmaster_t;
+
+
+/**
+ * Expected node and its boot-up state.
+ *
+ * Configuration part is set by application before CO_NMTmaster_init(), result
+ * part is written by NMT master.
+ */
+typedef struct{
+    /** Node-ID, 1 to 127, set by application */
+    uint8_t             nodeId;
+    /** If true, network is not started with startAll, if boot-up of this node
+    fails. Set by application. */
+    bool_t              mandatory;
+    /** Expected device type or 0 for any, set by application */
+    uint32_t            deviceType;
+    /** Expected vendor-ID, product code, revision number and serial number
+    (0x1018, sub-index 1 to 4). Zero values are not read. Set by application. */
+    uint32_t            identity[4];
+    /** Configuration in concise DCF format or NULL, set by application */
+    const uint8_t      *configDCF;
+    uint32_t            configDCFSize;  /**< Size of configDCF */
+    /** PDO configuration in concise DCF format or NULL, set by application */
+    const uint8_t      *pdoDCF;
+    uint32_t            pdoDCFSize;     /**< Size of pdoDCF */
+    /** #CO_NMTmaster_nodeState_t */
+    uint8_t             state;
+    /** #CO_NMTmaster_error_t */
+    uint8_t             error;
+    /** Index of the object, which failed */
+    uint16_t            errorIndex;
+    /** Sub-index of the object, which failed */
+    uint8_t             errorSubIndex;
+    /** #CO_SDO_abortCode_t of the failed SDO transfer */
+    uint32_t            abortCode;
+    /** Device type read from the node */
+    uint32_t            actualDeviceType;
+    /** Identity read from the node, zero if not read */
+    uint32_t            actualIdentity[4];
+    /** Time from CO_NMTmaster_start() until node was configured or failed
+    in [milliseconds] */
+    uint32_t            bootTime_ms;
+    /** Number of SDO transfers to this node */
+    uint16_t            sdoCount;
+    /** Internal: sub-index of identity or offset of the next DCF entry */
+    uint32_t            step;
+    /** Internal: number of remaining DCF entries */
+    uint32_t            entriesLeft;
+    /** Internal: data buffer for uploads */
+    uint8_t             buf[4];
+    /** Internal: SDO client request */
+    CO_SDOclientReq_t   req;
+    /** Internal: From CO_NMTmaster_init() */
+    CO_NMTmaster_t     *nmtm;
+}CO_NMTmaster_node_t;
+
+
+/**
+ * NMT master object.
+ */
+struct CO_NMTmaster{
+    CO_t               *co;             /**< From CO_NMTmaster_init() */
+    CO_SDOclientSched_t *sched;         /**< From CO_NMTmaster_init() */
+    CO_NMTmaster_node_t *nodes;         /**< From CO_NMTmaster_init() */
+    uint8_t             numNodes;       /**< From CO_NMTmaster_init() */
+    uint8_t             retries;        /**< From CO_NMTmaster_init() */
+    /** From CO_NMTmaster_start() */
+    bool_t              startAll;
+    /** True between CO_NMTmaster_start() and end of boot-up */
+    bool_t              running;
+    /** True, if boot-up of mandatory node failed, network was not started */
+    bool_t              mandatoryFailed;
+    /** Number of nodes, which are configured or started */
+    uint8_t             configuredCount;
+    /** Number of nodes with failed boot-up */
+    uint8_t             errorCount;
+    /** Time since CO_NMTmaster_start() in [milliseconds] */
+    uint32_t            time_ms;
+    /** Total network boot time in [milliseconds], valid after boot-up ended */
+    uint32_t            bootTime_ms;
+    /** From CO_NMTmaster_initCallback() or NULL */
+    void              (*pFunctSignal)(void *object, CO_NMTmaster_node_t *node);
+    void               *functSignalObject;/**< From CO_NMTmaster_initCallback() */
+};
+
+
+/**
+ * Initialize NMT master object.
+ *
+ * @param nmtm This object will be initialized.
+ * @param co CANopen object, used for sending NMT commands.
+ * @param sched Initialized SDO client scheduler. It is processed by
+ * CO_NMTmaster_process() and must not be processed by application.
+ * @param nodes Array of expected nodes, configured by application.
+ * @param numNodes Number of nodes.
+ * @param retries Number of repeats of SDO transfer after timeout.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_NMTmaster_init(
+        CO_NMTmaster_t         *nmtm,
+        CO_t                   *co,
+        CO_SDOclientSched_t    *sched,
+        CO_NMTmaster_node_t     nodes[],
+        uint8_t                 numNodes,
+        uint8_t                 retries);
+
+
+/**
+ * Initialize NMT master callback function.
+ *
+ * Function is called after node is configured, started or its boot-up failed.
+ *
+ * @param nmtm This object.
+ * @param object Pointer to object, which will be passed to pFunctSignal(). Can be NULL.
+ * @param pFunctSignal Pointer to the callback function. Not called if NULL.
+ */
+void CO_NMTmaster_initCallback(
+        CO_NMTmaster_t         *nmtm,
+        void                   *object,
+        void                  (*pFunctSignal)(void *object, CO_NMTmaster_node_t *node));
+
+
+/**
+ * Start boot-up of all nodes.
+ *
+ * @param nmtm This object.
+ * @param startAll If true, nodes are started with one NMT command after all
+ * nodes are configured, if no mandatory node failed. If false, each node is
+ * started immediately after its configuration.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT, if
+ * boot-up is already running.
+ */
+CO_ReturnError_t CO_NMTmaster_start(CO_NMTmaster_t *nmtm, bool_t startAll);
+
+
+/**
+ * Repeat boot-up of one node.
+ *
+ * For example, if node was reset (see CO_HBconsumer_initCallbackRemoteReset())
+ * or if its boot-up failed. Node is started individually after configuration.
+ *
+ * @param nmtm This object.
+ * @param nodeId Node-ID.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT, if node
+ * is unknown or its boot-up is in progress.
+ */
+CO_ReturnError_t CO_NMTmaster_restartNode(CO_NMTmaster_t *nmtm, uint8_t nodeId);
+
+
+/**
+ * Process NMT master.
+ *
+ * Function must be called cyclically, for example from mainline. It also
+ * processes SDO client scheduler.
+ *
+ * @param nmtm This object.
+ * @param timeDifference_ms Time difference from previous function call in [milliseconds].
+ * @param [out] timerNext_ms info to OS - see CO_process().
+ *
+ * @return true, if boot-up is not running.
+ */
+bool_t CO_NMTmaster_process(
+        CO_NMTmaster_t         *nmtm,
+        uint16_t                timeDifference_ms,
+        uint16_t               *timerNext_ms);
+
+/** @} */
+
+#endif /* CO_NO_NMT_MASTER == 1 && CO_NO_SDO_CLIENT != 0 */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif
@@ -49,7 +49,40 @@ static void CO_PDO_receive(void *object, const CO_CANrxMsg_t *msg){
         (*RPDO->operatingState == CO_NMT_OPERATIONAL) &&
         (msg->DLC >= RPDO->dataLength))
     {
-        if(RPDO->SYNC && RPDO->synchronous && RPDO->SYNC->CANrxToggle) {
+        if(RPDO->MPDOmode != 0U) {
+            uint8_t addr = msg->data[0];
+
+            /* verify address mode (bit 7) and destination of DAM MPDO, 0 is broadcast */
+            if(RPDO->MPDOmode == CO_PDO_MPDO_DAM) {
+                if((addr & 0x80U) == 0U ||
+                   ((addr & 0x7FU) != 0U && (addr & 0x7FU) != RPDO->nodeId)) {
+                    return;
+                }
+            }
+            else if((addr & 0x80U) != 0U) {
+                return;
+            }
+
+            /* MPDOs may come in bursts, so they are queued */
+            CO_MPDOqueue_t *queue = RPDO->MPDOqueue;
+            if(queue == NULL || (uint8_t)(queue->head - queue->tail) >= CO_MPDO_RX_QUEUE) {
+                RPDO->MPDOoverflowCount++;
+            }
+            else {
+                uint8_t *frame = &queue->frame[queue->head & (CO_MPDO_RX_QUEUE - 1U)][0];
+                frame[0] = msg->data[0];
+                frame[1] = msg->data[1];
+                frame[2] = msg->data[2];
+                frame[3] = msg->data[3];
+                frame[4] = msg->data[4];
+                frame[5] = msg->data[5];
+                frame[6] = msg->data[6];
+                frame[7] = msg->data[7];
+
+                queue->head++;
+            }
+        }
+        else if(RPDO->SYNC && RPDO->synchronous && RPDO->SYNC->CANrxToggle) {
             /* copy data into second buffer and set 'new message' flag */
             RPDO->CANrxData[1][0] = msg->data[0];
             RPDO->CANrxData[1][1] = msg->data[1];
@@ -75,6 +108,12 @@ static void CO_PDO_receive(void *object, const CO_CANrxMsg_t *msg){
 
             SET_CANrxNew(RPDO->CANrxNew[0]);
         }
+
+        /* timestamp for monitor, counter is incremented last */
+        if(RPDO->monitor != NULL){
+            RPDO->timestamp_us = RPDO->monitor->timeNow_us;
+        }
+        RPDO->rxCount++;
     }
 }
 
@@ -281,8 +320,8 @@ static uint32_t CO_PDOfindMap(
  *
  * Function is called from communication reset or when parameter changes.
  *
- * Function configures following variables from CO_RPDO_t: _dataLength_ and
- * _mapPointer_.
+ * Function configures following variables from CO_RPDO_t: _dataLength_,
+ * _mapPointer_ and _MPDOmode_.
  *
  * @param RPDO RPDO object.
  * @param noOfMappedObjects Number of mapped object (from OD).
@@ -295,6 +334,17 @@ static uint32_t CO_RPDOconfigMap(CO_RPDO_t* RPDO, uint8_t noOfMappedObjects){
     uint32_t ret = 0;
     const uint32_t* pMap = &RPDO->RPDOMapPar->mappedObject1;
 
+    /* MPDO has fixed length, its data are dispatched by CO_RPDO_process() */
+    if(noOfMappedObjects == CO_PDO_MPDO_SAM || noOfMappedObjects == CO_PDO_MPDO_DAM){
+        RPDO->MPDOmode = noOfMappedObjects;
+        if(RPDO->MPDOqueue != NULL){
+            RPDO->MPDOqueue->tail = RPDO->MPDOqueue->head;
+        }
+        RPDO->dataLength = 8;
+        return 0;
+    }
+    RPDO->MPDOmode = 0;
+
     for(i=noOfMappedObjects; i>0; i--){
         int16_t j;
         uint8_t* pData;
@@ -348,7 +398,8 @@ static uint32_t CO_RPDOconfigMap(CO_RPDO_t* RPDO, uint8_t noOfMappedObjects){
  * Function is called from communication reset or when parameter changes.
  *
  * Function configures following variables from CO_TPDO_t: _dataLength_,
- * _mapPointer_ and _sendIfCOSFlags_.
+ * _mapPointer_, _sendIfCOSFlags_, _MPDOmode_ and _MPDOdataLength_. DAM MPDO
+ * uses first mapped object as the source of data.
  *
  * @param TPDO TPDO object.
  * @param noOfMappedObjects Number of mapped object (from OD).
@@ -360,8 +411,24 @@ static uint32_t CO_TPDOconfigMap(CO_TPDO_t* TPDO, uint8_t noOfMappedObjects){
     uint8_t length = 0;
     uint32_t ret = 0;
     const uint32_t* pMap = &TPDO->TPDOMapPar->mappedObject1;
+    uint8_t MPDOmode = 0;
 
     TPDO->sendIfCOSFlags = 0;
+    TPDO->mapEntries = 0;
+    TPDO->MPDOmode = 0;
+    TPDO->MPDOdataLength = 0;
+    TPDO->MPDOscanning = false;
+
+    if(noOfMappedObjects == CO_PDO_MPDO_SAM){
+        /* SAM MPDO has fixed length, objects are from scanner list */
+        TPDO->MPDOmode = CO_PDO_MPDO_SAM;
+        TPDO->dataLength = 8;
+        return 0;
+    }
+    else if(noOfMappedObjects == CO_PDO_MPDO_DAM){
+        MPDOmode = CO_PDO_MPDO_DAM;
+        noOfMappedObjects = 1;
+    }
 
     for(i=noOfMappedObjects; i>0; i--){
         int16_t j;
@@ -381,10 +448,20 @@ static uint32_t CO_TPDOconfigMap(CO_TPDO_t* TPDO, uint8_t noOfMappedObjects){
                 &MBvar);
         if(ret){
             length = 0;
+            TPDO->mapEntries = 0;
             CO_errorReport(TPDO->em, CO_EM_PDO_WRONG_MAPPING, CO_EMC_PROTOCOL_ERROR, map);
             break;
         }
 
+        /* entry of the mapped object, if not dummy */
+        if(length > prevLength){
+            uint16_t entryNo = CO_OD_find(TPDO->SDO, (uint16_t)(map>>16));
+
+            if(entryNo != 0xFFFFU){
+                TPDO->mapEntryNo[TPDO->mapEntries++] = entryNo;
+            }
+        }
+
         /* write PDO data pointers */
 #ifdef CO_BIG_ENDIAN
         if(MBvar){
@@ -403,6 +480,23 @@ static uint32_t CO_TPDOconfigMap(CO_TPDO_t* TPDO, uint8_t noOfMappedObjects){
 
     }
 
+    /* DAM MPDO has four data bytes, the rest is multiplexer */
+    if(MPDOmode != 0U){
+        if(ret == 0 && length > 4){
+            ret = CO_SDO_AB_MAP_LEN;
+            CO_errorReport(TPDO->em, CO_EM_PDO_WRONG_MAPPING, CO_EMC_PROTOCOL_ERROR, TPDO->TPDOMapPar->mappedObject1);
+        }
+        if(ret == 0 && length > 0){
+            TPDO->MPDOmode = MPDOmode;
+            TPDO->MPDOdataLength = length;
+            TPDO->sendIfCOSFlags = 0;
+            length = 8;
+        }
+        else{
+            length = 0;
+        }
+    }
+
     TPDO->dataLength = length;
 
     return ret;
@@ -611,7 +705,7 @@ static CO_SDO_abortCode_t CO_ODF_RPDOmap(CO_ODF_arg_t *ODF_arg){
     if(ODF_arg->subIndex == 0){
         uint8_t *value = (uint8_t*) ODF_arg->data;
 
-        if(*value > 8)
+        if(*value > 8 && *value != CO_PDO_MPDO_SAM && *value != CO_PDO_MPDO_DAM)
             return CO_SDO_AB_MAP_LEN;  /* Number and length of object to be mapped exceeds PDO length. */
 
         /* configure mapping */
@@ -677,7 +771,7 @@ static CO_SDO_abortCode_t CO_ODF_TPDOmap(CO_ODF_arg_t *ODF_arg){
     if(ODF_arg->subIndex == 0){
         uint8_t *value = (uint8_t*) ODF_arg->data;
 
-        if(*value > 8)
+        if(*value > 8 && *value != CO_PDO_MPDO_SAM && *value != CO_PDO_MPDO_DAM)
             return CO_SDO_AB_MAP_LEN;  /* Number and length of object to be mapped exceeds PDO length. */
 
         /* configure mapping */
@@ -710,6 +804,294 @@ static CO_SDO_abortCode_t CO_ODF_TPDOmap(CO_ODF_arg_t *ODF_arg){
 }
 
 
+/*
+ * Initialize sequence lock and its statistics.
+ */
+static void CO_PDOseqlock_init(CO_PDOseqlock_t *seqlock){
+    seqlock->seq = 0;
+    seqlock->writeCount = 0;
+    seqlock->readCount = 0;
+    seqlock->readRetries = 0;
+    seqlock->readFailures = 0;
+    seqlock->readRetriesMax = 0;
+}
+
+
+/*
+ * Copy data through PDO map pointers under sequence lock.
+ *
+ * @param seqlock Sequence lock.
+ * @param dest Destination buffer.
+ * @param mapPointer Pointers to mapped variables.
+ * @param length Number of bytes.
+ *
+ * @return True, if copy is consistent.
+ */
+static bool_t CO_PDOseqlock_read(CO_PDOseqlock_t *seqlock, uint8_t dest[], uint8_t *const mapPointer[], uint8_t length){
+    uint8_t retry;
+
+    for(retry=0; retry<=CO_PDO_SEQLOCK_RETRIES; retry++){
+        uint32_t seq = seqlock->seq;
+        uint8_t i;
+
+        CO_PDO_SEQLOCK_BARRIER();
+        if((seq & 1U) == 0U){
+            for(i=0; i<length; i++){
+                dest[i] = *mapPointer[i];
+            }
+            CO_PDO_SEQLOCK_BARRIER();
+            if(seqlock->seq == seq){
+                seqlock->readCount++;
+                if(retry > seqlock->readRetriesMax){
+                    seqlock->readRetriesMax = retry;
+                }
+                return true;
+            }
+        }
+        if(retry < CO_PDO_SEQLOCK_RETRIES){
+            seqlock->readRetries++;
+        }
+    }
+    seqlock->readFailures++;
+    seqlock->readRetriesMax = CO_PDO_SEQLOCK_RETRIES;
+
+    return false;
+}
+
+
+/******************************************************************************/
+void CO_PDOseqlock_writeBegin(CO_PDOseqlock_t *seqlock){
+    seqlock->seq++;
+    CO_PDO_SEQLOCK_BARRIER();
+}
+
+
+/******************************************************************************/
+void CO_PDOseqlock_writeEnd(CO_PDOseqlock_t *seqlock){
+    CO_PDO_SEQLOCK_BARRIER();
+    seqlock->seq++;
+    seqlock->writeCount++;
+}
+
+
+/*
+ * Copy data of TPDO through its map pointers. Copy is consistent with TPDO
+ * sequence lock and with snapshot regions of the mapped objects. Regions are
+ * looked up here, because application configures them after the mapping, see
+ * CO_OD_configureSnapshot().
+ *
+ * @param TPDO TPDO object.
+ * @param dest Destination buffer.
+ * @param length Number of bytes.
+ *
+ * @return True, if copy is consistent.
+ */
+static bool_t CO_TPDOreadImage(CO_TPDO_t *TPDO, uint8_t dest[], uint8_t length){
+    CO_OD_snapshot_t *snap[8];
+    uint32_t seq[8];
+    uint8_t noOfSnap = 0;
+    uint8_t retry, i;
+
+    if(TPDO->SDO->ODExtensions != NULL){
+        for(i=0; i<TPDO->mapEntries; i++){
+            CO_OD_snapshot_t *s = TPDO->SDO->ODExtensions[TPDO->mapEntryNo[i]].snapshot;
+
+            if(s != NULL){
+                snap[noOfSnap++] = s;
+            }
+        }
+    }
+    if(noOfSnap == 0U){
+        return CO_PDOseqlock_read(&TPDO->seqlock, dest, TPDO->mapPointer, length);
+    }
+
+    for(retry=0; retry<=CO_OD_SNAPSHOT_RETRIES; retry++){
+        bool_t consistent = true;
+
+        for(i=0; i<noOfSnap; i++){
+            seq[i] = snap[i]->seq;
+            if((seq[i] & 1U) != 0U){
+                consistent = false;
+            }
+        }
+        CO_OD_SNAPSHOT_BARRIER();
+        if(consistent && CO_PDOseqlock_read(&TPDO->seqlock, dest, TPDO->mapPointer, length)){
+            CO_OD_SNAPSHOT_BARRIER();
+            for(i=0; i<noOfSnap; i++){
+                if(snap[i]->seq != seq[i]){
+                    consistent = false;
+                }
+            }
+            if(consistent){
+                return true;
+            }
+        }
+        if(retry < CO_OD_SNAPSHOT_RETRIES){
+            for(i=0; i<noOfSnap; i++){
+                snap[i]->readRetries++;
+            }
+        }
+    }
+    for(i=0; i<noOfSnap; i++){
+        snap[i]->readFailures++;
+    }
+
+    return false;
+}
+
+
+/******************************************************************************/
+int16_t CO_RPDO_readImage(CO_RPDO_t *RPDO, uint8_t data[]){
+    uint8_t length;
+
+    if(RPDO == NULL || data == NULL || RPDO->MPDOmode != 0U){
+        return -1;
+    }
+
+    length = RPDO->dataLength;
+    if(!CO_PDOseqlock_read(&RPDO->seqlock, data, RPDO->mapPointer, length)){
+        return -1;
+    }
+
+    return length;
+}
+
+
+/*
+ * Verify, if any of the mapPointers points inside the OD variable.
+ */
+static bool_t CO_PDOisMapped(uint8_t *const mapPointer[], uint8_t dataLength, const uint8_t *ODdata, uint16_t length){
+    uint8_t i;
+
+    for(i=0; i<dataLength; i++){
+        if(mapPointer[i] >= ODdata && mapPointer[i] < (ODdata + length)){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+ * Copy OD variable to SDO buffer under sequence lock.
+ *
+ * @return True, if copy is consistent.
+ */
+static bool_t CO_PDOseqlock_copy(CO_PDOseqlock_t *seqlock, uint8_t dest[], const uint8_t src[], uint16_t length){
+    uint8_t retry;
+
+    for(retry=0; retry<=CO_PDO_SEQLOCK_RETRIES; retry++){
+        uint32_t seq = seqlock->seq;
+        uint16_t i;
+
+        CO_PDO_SEQLOCK_BARRIER();
+        if((seq & 1U) == 0U){
+            for(i=0; i<length; i++){
+                dest[i] = src[i];
+            }
+            CO_PDO_SEQLOCK_BARRIER();
+            if(seqlock->seq == seq){
+                seqlock->readCount++;
+                if(retry > seqlock->readRetriesMax){
+                    seqlock->readRetriesMax = retry;
+                }
+                return true;
+            }
+        }
+        if(retry < CO_PDO_SEQLOCK_RETRIES){
+            seqlock->readRetries++;
+        }
+    }
+    seqlock->readFailures++;
+    seqlock->readRetriesMax = CO_PDO_SEQLOCK_RETRIES;
+
+    return false;
+}
+
+
+/******************************************************************************/
+int8_t CO_RPDO_SDOaccess(CO_RPDO_t *RPDO, uint8_t *ODdata, uint8_t *buffer, uint16_t length, bool_t write){
+    uint8_t retry;
+    uint16_t i;
+
+    if(RPDO->MPDOmode != 0U || !CO_PDOisMapped(RPDO->mapPointer, RPDO->dataLength, ODdata, length)){
+        return 0;
+    }
+
+    if(!write){
+        return CO_PDOseqlock_copy(&RPDO->seqlock, buffer, ODdata, length) ? 1 : -1;
+    }
+
+    /* SDO server is the second writer. Claim the variables first and back
+     * off, if CO_RPDO_process() is writing them. Timer thread never waits. */
+    for(retry=0; retry<=CO_PDO_SEQLOCK_RETRIES; retry++){
+        RPDO->writingSDO = true;
+        CO_PDO_SEQLOCK_BARRIER();
+        if(!RPDO->writingPDO){
+            CO_PDOseqlock_writeBegin(&RPDO->seqlock);
+            for(i=0; i<length; i++){
+                ODdata[i] = buffer[i];
+            }
+            CO_PDOseqlock_writeEnd(&RPDO->seqlock);
+            CO_PDO_SEQLOCK_BARRIER();
+            RPDO->writingSDO = false;
+            return 1;
+        }
+        RPDO->writingSDO = false;
+        CO_PDO_SEQLOCK_BARRIER();
+    }
+
+    return -1;
+}
+
+
+/******************************************************************************/
+int8_t CO_TPDO_SDOaccess(CO_TPDO_t *TPDO, uint8_t *ODdata, uint8_t *buffer, uint16_t length, bool_t write){
+    uint16_t i;
+
+    if(TPDO->MPDOmode != 0U || !CO_PDOisMapped(TPDO->mapPointer, TPDO->dataLength, ODdata, length)){
+        return 0;
+    }
+
+    if(!write){
+        return CO_PDOseqlock_copy(&TPDO->seqlock, buffer, ODdata, length) ? 1 : -1;
+    }
+
+    /* Sequence lock has single writer, the thread of CO_TPDO_process(). Write
+     * is deferred to it, previous write must be already applied. */
+    if(TPDO->SDOwritePending || length > sizeof(TPDO->SDOwriteData)){
+        return -1;
+    }
+    for(i=0; i<length; i++){
+        TPDO->SDOwriteData[i] = buffer[i];
+    }
+    TPDO->SDOwritePtr = ODdata;
+    TPDO->SDOwriteLength = (uint8_t)length;
+    CO_PDO_SEQLOCK_BARRIER();
+    TPDO->SDOwritePending = true;
+
+    return 1;
+}
+
+
+/*
+ * Apply write of the SDO server, deferred by CO_TPDO_SDOaccess().
+ */
+static void CO_TPDO_applySDOwrite(CO_TPDO_t *TPDO){
+    uint8_t i;
+
+    CO_PDO_SEQLOCK_BARRIER();
+    CO_TPDO_writeBegin(TPDO);
+    for(i=0; i<TPDO->SDOwriteLength; i++){
+        TPDO->SDOwritePtr[i] = TPDO->SDOwriteData[i];
+    }
+    CO_TPDO_writeEnd(TPDO);
+    CO_PDO_SEQLOCK_BARRIER();
+    TPDO->SDOwritePending = false;
+}
+
+
 /******************************************************************************/
 CO_ReturnError_t CO_RPDO_init(
         CO_RPDO_t              *RPDO,
@@ -754,6 +1136,26 @@ CO_ReturnError_t CO_RPDO_init(
     RPDO->CANdevRx = CANdevRx;
     RPDO->CANdevRxIdx = CANdevRxIdx;
 
+    /* not monitored until CO_RPDOmonitor_attach() */
+    RPDO->timestamp_us = 0;
+    RPDO->rxCount = 0;
+    RPDO->monitor = NULL;
+    RPDO->timeoutTime_us = 0;
+    RPDO->deadline_us = 0;
+    RPDO->rxCountChecked = 0;
+    RPDO->heapIdx = CO_RPDO_HEAP_NONE;
+    RPDO->timeoutStarted = false;
+    RPDO->timedOut = false;
+
+    RPDO->MPDOmode = 0;
+    RPDO->MPDOdispatcher = NULL;
+    RPDO->MPDOqueue = NULL;
+    RPDO->MPDOoverflowCount = 0;
+    RPDO->MPDOdroppedCount = 0;
+    CO_PDOseqlock_init(&RPDO->seqlock);
+    RPDO->writingPDO = false;
+    RPDO->writingSDO = false;
+
     CO_RPDOconfigMap(RPDO, RPDOMapPar->numberOfMappedObjects);
     CO_RPDOconfigCom(RPDO, RPDOCommPar->COB_IDUsedByRPDO);
 
@@ -806,6 +1208,12 @@ CO_ReturnError_t CO_TPDO_init(
     TPDO->inhibitTimer = 0;
     TPDO->eventTimer = ((uint32_t) TPDOCommPar->eventTimer) * 1000;
     if(TPDOCommPar->transmissionType>=254) TPDO->sendRequest = 1;
+    TPDO->MPDOscanList = NULL;
+    TPDO->MPDOscanListSize = 0;
+    TPDO->MPDOscanPos = 0;
+    TPDO->MPDOscanSub = 0;
+    CO_PDOseqlock_init(&TPDO->seqlock);
+    TPDO->SDOwritePending = false;
 
     CO_TPDOconfigMap(TPDO, TPDOMapPar->numberOfMappedObjects);
     CO_TPDOconfigCom(TPDO, TPDOCommPar->COB_IDUsedByTPDO, ((TPDOCommPar->transmissionType<=240) ? 1 : 0));
@@ -827,6 +1235,11 @@ uint8_t CO_TPDOisCOS(CO_TPDO_t *TPDO){
     uint8_t* pPDOdataByte;
     uint8_t** ppODdataByte;
 
+    /* MPDO has no Change of State detection */
+    if(TPDO->MPDOmode != 0U){
+        return 0;
+    }
+
     pPDOdataByte = &TPDO->CANtxBuff->data[TPDO->dataLength];
     ppODdataByte = &TPDO->mapPointer[TPDO->dataLength];
 
@@ -844,12 +1257,174 @@ uint8_t CO_TPDOisCOS(CO_TPDO_t *TPDO){
     return 0;
 }
 
+/*
+ * Read object from Object Dictionary into MPDO data bytes.
+ *
+ * @param SDO SDO object.
+ * @param entryNo Entry in Object Dictionary.
+ * @param subIndex Sub-index of the object.
+ * @param data Four data bytes of MPDO, filled with object in little endian.
+ *
+ * @return Length of the object or 0, if object can not be sent with MPDO.
+ */
+static uint8_t CO_MPDOread(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex, uint8_t data[]){
+    uint16_t attr;
+    uint16_t length;
+    const uint8_t *pData;
+    uint8_t i;
+
+    if(entryNo == 0xFFFF || subIndex > SDO->OD[entryNo].maxSubIndex){
+        return 0;
+    }
+    attr = CO_OD_getAttribute(SDO, entryNo, subIndex);
+    if(!((attr&CO_ODA_TPDO_MAPABLE) && (attr&CO_ODA_READABLE))){
+        return 0;
+    }
+    length = CO_OD_getLength(SDO, entryNo, subIndex);
+    if(length == 0 || length > 4){
+        return 0;
+    }
+
+    pData = (const uint8_t*) CO_OD_getDataPointer(SDO, entryNo, subIndex);
+    for(i=0; i<4; i++){
+        data[i] = 0;
+    }
+#ifdef CO_BIG_ENDIAN
+    if(attr&CO_ODA_MB_VALUE){
+        for(i=0; i<length; i++){
+            data[i] = pData[length - 1 - i];
+        }
+        return (uint8_t)length;
+    }
+#endif
+    for(i=0; i<length; i++){
+        data[i] = pData[i];
+    }
+
+    return (uint8_t)length;
+}
+
+
+/*
+ * Write MPDO data bytes into object in Object Dictionary.
+ *
+ * @param SDO SDO object.
+ * @param entryNo Entry in Object Dictionary.
+ * @param subIndex Sub-index of the object.
+ * @param data Four data bytes of MPDO.
+ *
+ * @return True, if object was written.
+ */
+static bool_t CO_MPDOwrite(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex, const uint8_t data[]){
+    uint16_t attr;
+    uint16_t length;
+    uint8_t *pData;
+    uint8_t i;
+
+    if(entryNo == 0xFFFF || subIndex > SDO->OD[entryNo].maxSubIndex){
+        return false;
+    }
+    attr = CO_OD_getAttribute(SDO, entryNo, subIndex);
+    if(!((attr&CO_ODA_RPDO_MAPABLE) && (attr&CO_ODA_WRITEABLE))){
+        return false;
+    }
+    length = CO_OD_getLength(SDO, entryNo, subIndex);
+    if(length == 0 || length > 4){
+        return false;
+    }
+
+    pData = (uint8_t*) CO_OD_getDataPointer(SDO, entryNo, subIndex);
+#ifdef CO_BIG_ENDIAN
+    if(attr&CO_ODA_MB_VALUE){
+        for(i=0; i<length; i++){
+            pData[length - 1 - i] = data[i];
+        }
+        return true;
+    }
+#endif
+    for(i=0; i<length; i++){
+        pData[i] = data[i];
+    }
+
+    return true;
+}
+
+
+/*
+ * Prepare MPDO message in CAN transmit buffer and send it.
+ */
+static CO_ReturnError_t CO_TPDOsendMPDOframe(CO_TPDO_t *TPDO, uint8_t addr, uint16_t index, uint8_t subIndex, const uint8_t data[]){
+    uint8_t *frame = &TPDO->CANtxBuff->data[0];
+
+    frame[0] = addr;
+    frame[1] = (uint8_t) index;
+    frame[2] = (uint8_t) (index >> 8);
+    frame[3] = subIndex;
+    frame[4] = data[0];
+    frame[5] = data[1];
+    frame[6] = data[2];
+    frame[7] = data[3];
+
+    return CO_CANsend(TPDO->CANdevTx, TPDO->CANtxBuff);
+}
+
+
+/*
+ * Transmit objects from the MPDO scanner list, until CAN transmit buffer is
+ * full or all objects are transmitted.
+ */
+static void CO_TPDOstreamMPDO(CO_TPDO_t *TPDO){
+    while(TPDO->MPDOscanning && !TPDO->CANtxBuff->bufferFull){
+        const CO_MPDOscan_t *scan;
+        uint8_t data[4];
+        uint8_t subIndex;
+        uint8_t blockSize;
+
+        if(TPDO->MPDOscanPos >= TPDO->MPDOscanListSize){
+            TPDO->MPDOscanning = false;
+            break;
+        }
+
+        scan = &TPDO->MPDOscanList[TPDO->MPDOscanPos];
+        subIndex = scan->subIndex + TPDO->MPDOscanSub;
+        blockSize = (scan->blockSize == 0U) ? 1U : scan->blockSize;
+
+        if(CO_MPDOread(TPDO->SDO, scan->entryNo, subIndex, data) != 0U){
+            if(CO_TPDOsendMPDOframe(TPDO, TPDO->nodeId & 0x7FU, scan->index, subIndex, data) != CO_ERROR_NO){
+                break;
+            }
+        }
+
+        /* next object */
+        if(++TPDO->MPDOscanSub >= blockSize){
+            TPDO->MPDOscanSub = 0;
+            TPDO->MPDOscanPos++;
+        }
+    }
+}
+
+
 //#define TPDO_CALLS_EXTENSION
 /******************************************************************************/
 int16_t CO_TPDOsend(CO_TPDO_t *TPDO){
     int16_t i;
     uint8_t* pPDOdataByte;
-    uint8_t** ppODdataByte;
+    uint8_t* pImageByte;
+    uint8_t image[8];
+
+    /* SAM MPDO starts transmission of the scanner list, DAM MPDO is sent only
+     * by CO_TPDOsendMPDO(), because destination is not known here. */
+    if(TPDO->MPDOmode != 0U){
+        TPDO->sendRequest = 0;
+        if(TPDO->MPDOmode != CO_PDO_MPDO_SAM || TPDO->MPDOscanListSize == 0U){
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+        TPDO->MPDOscanning = true;
+        TPDO->MPDOscanPos = 0;
+        TPDO->MPDOscanSub = 0;
+        CO_TPDOstreamMPDO(TPDO);
+        return CO_ERROR_NO;
+    }
 
 #ifdef TPDO_CALLS_EXTENSION
     if(TPDO->SDO->ODExtensions){
@@ -879,13 +1454,19 @@ int16_t CO_TPDOsend(CO_TPDO_t *TPDO){
         }
     }
 #endif
-    i = TPDO->dataLength;
-    pPDOdataByte = &TPDO->CANtxBuff->data[0];
-    ppODdataByte = &TPDO->mapPointer[0];
-
-    /* Copy data from Object dictionary. */
-    for(; i>0; i--) {
-        *(pPDOdataByte++) = **(ppODdataByte++);
+    /* Copy data from Object dictionary. CAN buffer is written only with
+     * consistent data. */
+    if(CO_TPDOreadImage(TPDO, image, TPDO->dataLength)){
+        i = TPDO->dataLength;
+        pPDOdataByte = &TPDO->CANtxBuff->data[0];
+        pImageByte = &image[0];
+        for(; i>0; i--) {
+            *(pPDOdataByte++) = *(pImageByte++);
+        }
+    }
+    else if(TPDO->TPDOCommPar->transmissionType > 240){
+        /* try again later, synchronous TPDO is sent with previous data */
+        return CO_ERROR_TX_BUSY;
     }
 
     TPDO->sendRequest = 0;
@@ -893,6 +1474,47 @@ int16_t CO_TPDOsend(CO_TPDO_t *TPDO){
     return CO_CANsend(TPDO->CANdevTx, TPDO->CANtxBuff);
 }
 
+/*
+ * Write all queued MPDO messages to Object Dictionary.
+ */
+static void CO_RPDOdispatchMPDO(CO_RPDO_t *RPDO){
+    CO_MPDOqueue_t *queue = RPDO->MPDOqueue;
+
+    if(queue == NULL){
+        return;
+    }
+    while(queue->tail != queue->head){
+        const uint8_t *frame = &queue->frame[queue->tail & (CO_MPDO_RX_QUEUE - 1U)][0];
+        uint16_t index = (uint16_t)frame[1] | ((uint16_t)frame[2] << 8);
+        uint8_t subIndex = frame[3];
+        uint16_t entryNo = 0xFFFF;
+
+        if(RPDO->MPDOmode == CO_PDO_MPDO_DAM){
+            /* multiplexer addresses object in this device */
+            entryNo = CO_OD_find(RPDO->SDO, index);
+        }
+        else{
+            /* multiplexer addresses object in producer */
+            const CO_MPDOdispatch_t *dispatch = CO_MPDOdispatcher_find(
+                    RPDO->MPDOdispatcher, frame[0] & 0x7FU, index, subIndex);
+
+            if(dispatch != NULL){
+                entryNo = dispatch->entryNo;
+                subIndex = dispatch->localSubIndex + (subIndex - dispatch->subIndex);
+            }
+        }
+
+        CO_PDOseqlock_writeBegin(&RPDO->seqlock);
+        if(!CO_MPDOwrite(RPDO->SDO, entryNo, subIndex, &frame[4])){
+            RPDO->MPDOdroppedCount++;
+        }
+        CO_PDOseqlock_writeEnd(&RPDO->seqlock);
+
+        queue->tail++;
+    }
+}
+
+
 //#define RPDO_CALLS_EXTENSION
 /******************************************************************************/
 void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas){
@@ -901,6 +1523,15 @@ void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas){
     {
         CLEAR_CANrxNew(RPDO->CANrxNew[0]);
         CLEAR_CANrxNew(RPDO->CANrxNew[1]);
+        if(RPDO->MPDOqueue != NULL){
+            RPDO->MPDOqueue->tail = RPDO->MPDOqueue->head;
+        }
+    }
+    else if(RPDO->MPDOmode != 0U)
+    {
+        if(!RPDO->synchronous || syncWas){
+            CO_RPDOdispatchMPDO(RPDO);
+        }
     }
     else if(!RPDO->synchronous || syncWas)
     {
@@ -915,7 +1546,11 @@ void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas){
             bufNo = 1;
         }
 
-        while(IS_CANrxNew(RPDO->CANrxNew[bufNo])){
+        /* Claim the mapped variables. If SDO server is writing them, leave
+         * the message for the next call. */
+        RPDO->writingPDO = true;
+        CO_PDO_SEQLOCK_BARRIER();
+        while(!RPDO->writingSDO && IS_CANrxNew(RPDO->CANrxNew[bufNo])){
             int16_t i;
             uint8_t* pPDOdataByte;
             uint8_t** ppODdataByte;
@@ -927,13 +1562,17 @@ void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas){
             /* Copy data to Object dictionary. If between the copy operation CANrxNew
              * is set to true by receive thread, then copy the latest data again. */
             CLEAR_CANrxNew(RPDO->CANrxNew[bufNo]);
+            CO_PDOseqlock_writeBegin(&RPDO->seqlock);
             for(; i>0; i--) {
                 **(ppODdataByte++) = *(pPDOdataByte++);
             }
+            CO_PDOseqlock_writeEnd(&RPDO->seqlock);
 #if defined(RPDO_CALLS_EXTENSION)
             update = true;
 #endif /* defined(RPDO_CALLS_EXTENSION) */
         }
+        CO_PDO_SEQLOCK_BARRIER();
+        RPDO->writingPDO = false;
 #ifdef RPDO_CALLS_EXTENSION
         if(update && RPDO->SDO->ODExtensions){
             int16_t i;
@@ -967,16 +1606,458 @@ void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas){
 }
 
 
+/*
+ * Hash function for the MPDO dispatcher, key is (producer nodeId, index).
+ */
+static uint16_t CO_MPDOhash(uint8_t nodeId, uint16_t index){
+    uint32_t key = ((uint32_t)nodeId << 16) | index;
+
+    key *= 0x9E3779B1UL;
+    return (uint16_t)(key >> 16);
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_MPDOdispatcher_init(
+        CO_MPDOdispatcher_t    *dispatcher,
+        CO_SDO_t               *SDO,
+        CO_MPDOdispatch_t       list[],
+        uint16_t                listSize,
+        uint16_t                hashTable[],
+        uint16_t                hashSize)
+{
+    uint16_t i;
+
+    /* verify arguments, hash table must have at least one empty slot */
+    if(dispatcher==NULL || SDO==NULL || (list==NULL && listSize!=0) || hashTable==NULL ||
+       hashSize==0 || (hashSize & (hashSize - 1U))!=0 || hashSize<=listSize){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    /* Configure object variables */
+    dispatcher->SDO = SDO;
+    dispatcher->list = list;
+    dispatcher->listSize = 0;
+    dispatcher->hashTable = hashTable;
+    dispatcher->hashMask = hashSize - 1U;
+
+    for(i=0; i<hashSize; i++){
+        hashTable[i] = CO_MPDO_HASH_EMPTY;
+    }
+
+    /* resolve local objects and insert them into hash table */
+    for(i=0; i<listSize; i++){
+        uint16_t h;
+
+        list[i].entryNo = CO_OD_find(SDO, list[i].localIndex);
+        if(list[i].entryNo == 0xFFFF){
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+
+        h = CO_MPDOhash(list[i].nodeId, list[i].index) & dispatcher->hashMask;
+        while(hashTable[h] != CO_MPDO_HASH_EMPTY){
+            h = (h + 1U) & dispatcher->hashMask;
+        }
+        hashTable[h] = i;
+    }
+    dispatcher->listSize = listSize;
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+const CO_MPDOdispatch_t *CO_MPDOdispatcher_find(
+        const CO_MPDOdispatcher_t *dispatcher,
+        uint8_t                 nodeId,
+        uint16_t                index,
+        uint8_t                 subIndex)
+{
+    uint16_t h;
+
+    if(dispatcher == NULL || dispatcher->listSize == 0U){
+        return NULL;
+    }
+
+    /* linear probing, entries with the same key differ in sub-index range */
+    h = CO_MPDOhash(nodeId, index) & dispatcher->hashMask;
+    while(dispatcher->hashTable[h] != CO_MPDO_HASH_EMPTY){
+        const CO_MPDOdispatch_t *dispatch = &dispatcher->list[dispatcher->hashTable[h]];
+        uint8_t blockSize = (dispatch->blockSize == 0U) ? 1U : dispatch->blockSize;
+
+        if(dispatch->nodeId == nodeId && dispatch->index == index &&
+           subIndex >= dispatch->subIndex &&
+           (uint16_t)(subIndex - dispatch->subIndex) < blockSize){
+            return dispatch;
+        }
+        h = (h + 1U) & dispatcher->hashMask;
+    }
+
+    return NULL;
+}
+
+
+/******************************************************************************/
+void CO_RPDO_initMPDOdispatcher(
+        CO_RPDO_t              *RPDO,
+        CO_MPDOdispatcher_t    *dispatcher)
+{
+    if(RPDO != NULL){
+        RPDO->MPDOdispatcher = dispatcher;
+    }
+}
+
+
+/******************************************************************************/
+void CO_RPDO_initMPDOqueue(
+        CO_RPDO_t              *RPDO,
+        CO_MPDOqueue_t         *queue)
+{
+    if(RPDO != NULL){
+        if(queue != NULL){
+            queue->head = 0;
+            queue->tail = 0;
+        }
+        RPDO->MPDOqueue = queue;
+    }
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_TPDO_initMPDOscanner(
+        CO_TPDO_t              *TPDO,
+        CO_MPDOscan_t           scanList[],
+        uint16_t                scanListSize)
+{
+    uint16_t i;
+
+    /* verify arguments */
+    if(TPDO==NULL || (scanList==NULL && scanListSize!=0)){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    TPDO->MPDOscanning = false;
+    TPDO->MPDOscanList = scanList;
+    TPDO->MPDOscanListSize = 0;
+
+    for(i=0; i<scanListSize; i++){
+        scanList[i].entryNo = CO_OD_find(TPDO->SDO, scanList[i].index);
+        if(scanList[i].entryNo == 0xFFFF){
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+    }
+    TPDO->MPDOscanListSize = scanListSize;
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_TPDOsendMPDO(
+        CO_TPDO_t              *TPDO,
+        uint8_t                 nodeId,
+        uint16_t                index,
+        uint8_t                 subIndex)
+{
+    uint8_t data[4] = {0, 0, 0, 0};
+    uint8_t addr;
+
+    /* verify arguments */
+    if(TPDO==NULL || TPDO->MPDOmode==0U || nodeId>127){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    if(!TPDO->valid){
+        return CO_ERROR_TX_UNCONFIGURED;
+    }
+    if(*TPDO->operatingState != CO_NMT_OPERATIONAL){
+        return CO_ERROR_WRONG_NMT_STATE;
+    }
+
+    if(TPDO->MPDOmode == CO_PDO_MPDO_DAM){
+        /* data from the mapped object */
+        if(!CO_TPDOreadImage(TPDO, data, TPDO->MPDOdataLength)){
+            return CO_ERROR_TX_BUSY;
+        }
+        addr = 0x80U | nodeId;
+    }
+    else{
+        if(CO_MPDOread(TPDO->SDO, CO_OD_find(TPDO->SDO, index), subIndex, data) == 0U){
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+        addr = TPDO->nodeId & 0x7FU;
+    }
+
+    return CO_TPDOsendMPDOframe(TPDO, addr, index, subIndex, data);
+}
+
+
+/*
+ * Helper functions for the binary min-heap of the RPDO monitor. Heap is ordered
+ * by deadline_us, comparison is safe against overflow of the time counter.
+ */
+static bool_t CO_RPDOheap_before(const CO_RPDO_t *a, const CO_RPDO_t *b){
+    return ((int32_t)(a->deadline_us - b->deadline_us) < 0) ? true : false;
+}
+
+static void CO_RPDOheap_set(CO_RPDOmonitor_t *monitor, uint16_t idx, CO_RPDO_t *RPDO){
+    monitor->heap[idx] = RPDO;
+    RPDO->heapIdx = idx;
+}
+
+static void CO_RPDOheap_siftUp(CO_RPDOmonitor_t *monitor, uint16_t idx){
+    CO_RPDO_t *RPDO = monitor->heap[idx];
+
+    while(idx > 0U){
+        uint16_t parent = (idx - 1U) / 2U;
+        if(!CO_RPDOheap_before(RPDO, monitor->heap[parent])){
+            break;
+        }
+        CO_RPDOheap_set(monitor, idx, monitor->heap[parent]);
+        idx = parent;
+    }
+    CO_RPDOheap_set(monitor, idx, RPDO);
+}
+
+static void CO_RPDOheap_siftDown(CO_RPDOmonitor_t *monitor, uint16_t idx){
+    CO_RPDO_t *RPDO = monitor->heap[idx];
+
+    for(;;){
+        uint16_t child = idx * 2U + 1U;
+        if(child >= monitor->heapCount){
+            break;
+        }
+        if((child + 1U) < monitor->heapCount &&
+           CO_RPDOheap_before(monitor->heap[child + 1U], monitor->heap[child])){
+            child++;
+        }
+        if(!CO_RPDOheap_before(monitor->heap[child], RPDO)){
+            break;
+        }
+        CO_RPDOheap_set(monitor, idx, monitor->heap[child]);
+        idx = child;
+    }
+    CO_RPDOheap_set(monitor, idx, RPDO);
+}
+
+static void CO_RPDOheap_remove(CO_RPDOmonitor_t *monitor, CO_RPDO_t *RPDO){
+    uint16_t idx = RPDO->heapIdx;
+    CO_RPDO_t *last;
+
+    if(idx >= monitor->heapCount || monitor->heap[idx] != RPDO){
+        return;
+    }
+    RPDO->heapIdx = CO_RPDO_HEAP_NONE;
+    last = monitor->heap[--monitor->heapCount];
+    if(last != RPDO){
+        CO_RPDOheap_set(monitor, idx, last);
+        CO_RPDOheap_siftUp(monitor, idx);
+        CO_RPDOheap_siftDown(monitor, last->heapIdx);
+    }
+}
+
+
+/*
+ * Clear timeout of the RPDO. Emergency is reset, when no RPDO is timed out.
+ */
+static void CO_RPDOmonitor_clearTimeout(CO_RPDOmonitor_t *monitor, CO_RPDO_t *RPDO){
+    if(RPDO->timedOut){
+        RPDO->timedOut = false;
+        if(monitor->timedOutCount > 0U){
+            monitor->timedOutCount--;
+        }
+        if(monitor->timedOutCount == 0U){
+            CO_errorReset(monitor->em, CO_EM_RPDO_TIME_OUT, 0);
+        }
+    }
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_RPDOmonitor_init(
+        CO_RPDOmonitor_t       *monitor,
+        CO_EM_t                *em,
+        CO_RPDO_t              *heap[],
+        uint16_t                heapSize)
+{
+    /* verify arguments */
+    if(monitor==NULL || em==NULL || heap==NULL || heapSize>=CO_RPDO_HEAP_NONE){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    /* Configure object variables */
+    monitor->em = em;
+    monitor->heap = heap;
+    monitor->heapSize = heapSize;
+    monitor->heapCount = 0;
+    monitor->timedOutCount = 0;
+    monitor->timeNow_us = 0;
+    monitor->pFunctSignalTimeout = NULL;
+    monitor->functSignalObjectTimeout = NULL;
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+void CO_RPDOmonitor_initCallbackTimeout(
+        CO_RPDOmonitor_t       *monitor,
+        void                   *object,
+        void                  (*pFunctSignal)(CO_RPDO_t *RPDO, void *object))
+{
+    if(monitor != NULL){
+        monitor->pFunctSignalTimeout = pFunctSignal;
+        monitor->functSignalObjectTimeout = object;
+    }
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_RPDOmonitor_attach(
+        CO_RPDOmonitor_t       *monitor,
+        CO_RPDO_t              *RPDO,
+        uint16_t                timeoutTime_ms)
+{
+    /* verify arguments */
+    if(monitor==NULL || RPDO==NULL || (RPDO->monitor!=NULL && RPDO->monitor!=monitor)){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    /* remove previous configuration */
+    if(RPDO->monitor == monitor){
+        CO_RPDOheap_remove(monitor, RPDO);
+        CO_RPDOmonitor_clearTimeout(monitor, RPDO);
+    }
+    else{
+        RPDO->heapIdx = CO_RPDO_HEAP_NONE;
+        RPDO->timedOut = false;
+    }
+
+    RPDO->monitor = monitor;
+    RPDO->timeoutTime_us = ((uint32_t) timeoutTime_ms) * 1000;
+    RPDO->timeoutStarted = false;
+
+    if(RPDO->timeoutTime_us != 0U){
+        if(monitor->heapCount >= monitor->heapSize){
+            RPDO->timeoutTime_us = 0;
+            return CO_ERROR_OUT_OF_MEMORY;
+        }
+        RPDO->rxCountChecked = RPDO->rxCount;
+        RPDO->deadline_us = monitor->timeNow_us + RPDO->timeoutTime_us;
+        CO_RPDOheap_set(monitor, monitor->heapCount++, RPDO);
+        CO_RPDOheap_siftUp(monitor, RPDO->heapIdx);
+    }
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+void CO_RPDOmonitor_process(
+        CO_RPDOmonitor_t       *monitor,
+        uint32_t                timeDifference_us,
+        uint16_t               *timerNext_ms)
+{
+    uint32_t now = monitor->timeNow_us + timeDifference_us;
+
+    monitor->timeNow_us = now;
+
+    /* Process only RPDOs with expired deadline. Each of them gets new deadline
+     * in the future, so loop ends. */
+    while(monitor->heapCount > 0U){
+        CO_RPDO_t *RPDO = monitor->heap[0];
+        uint32_t rxCount;
+        bool_t received;
+
+        if((int32_t)(now - RPDO->deadline_us) < 0){
+            break;
+        }
+
+        rxCount = RPDO->rxCount;
+        received = (rxCount != RPDO->rxCountChecked) ? true : false;
+        RPDO->rxCountChecked = rxCount;
+
+        if(!RPDO->valid || *RPDO->operatingState != CO_NMT_OPERATIONAL){
+            /* monitoring starts again after the first reception */
+            CO_RPDOmonitor_clearTimeout(monitor, RPDO);
+            RPDO->timeoutStarted = false;
+        }
+        else if(received){
+            CO_RPDOmonitor_clearTimeout(monitor, RPDO);
+            RPDO->timeoutStarted = true;
+        }
+
+        RPDO->deadline_us = now + RPDO->timeoutTime_us;
+
+        if(RPDO->timeoutStarted && !RPDO->timedOut){
+            uint32_t deadline = RPDO->timestamp_us + RPDO->timeoutTime_us;
+
+            if((int32_t)(now - deadline) < 0){
+                /* RPDO was received in time */
+                RPDO->deadline_us = deadline;
+            }
+            else{
+                /* timeout expired */
+                RPDO->timedOut = true;
+                monitor->timedOutCount++;
+                CO_errorReport(monitor->em, CO_EM_RPDO_TIME_OUT, CO_EMC_RPDO_TIMEOUT,
+                               RPDO->RPDOCommPar->COB_IDUsedByRPDO);
+                if(monitor->pFunctSignalTimeout != NULL){
+                    monitor->pFunctSignalTimeout(RPDO, monitor->functSignalObjectTimeout);
+                }
+            }
+        }
+
+        CO_RPDOheap_siftDown(monitor, 0);
+    }
+
+    /* inform OS about the next deadline */
+    if(timerNext_ms != NULL && monitor->heapCount > 0U){
+        uint32_t diff = ((monitor->heap[0]->deadline_us - now) + 999U) / 1000U;
+        if(*timerNext_ms > diff){
+            *timerNext_ms = (uint16_t)diff;
+        }
+    }
+}
+
+
+/******************************************************************************/
+uint32_t CO_RPDO_getAge_us(const CO_RPDO_t *RPDO){
+    if(RPDO == NULL || RPDO->monitor == NULL || RPDO->rxCount == 0U){
+        return 0xFFFFFFFFUL;
+    }
+    return RPDO->monitor->timeNow_us - RPDO->timestamp_us;
+}
+
+
+/*
+ * Send synchronous TPDO and record its latency from the SYNC.
+ */
+static void CO_TPDOsendSync(CO_TPDO_t *TPDO){
+    if(CO_TPDOsend(TPDO) == CO_ERROR_NO){
+        CO_SYNC_recordTPDO(TPDO->SYNC);
+    }
+}
+
+
 /******************************************************************************/
 void CO_TPDO_process(
         CO_TPDO_t              *TPDO,
         bool_t                  syncWas,
         uint32_t                timeDifference_us)
 {
+    if(TPDO->SDOwritePending){
+        CO_TPDO_applySDOwrite(TPDO);
+    }
+
     if(TPDO->valid && *TPDO->operatingState == CO_NMT_OPERATIONAL){
 
+        /* DAM MPDO is sent only by CO_TPDOsendMPDO(), destination is not known here */
+        if(TPDO->MPDOmode == CO_PDO_MPDO_DAM){
+            TPDO->sendRequest = 0;
+        }
+
         /* Send PDO by application request or by Event timer */
-        if(TPDO->TPDOCommPar->transmissionType >= 253){
+        else if(TPDO->TPDOCommPar->transmissionType >= 253){
             if(TPDO->inhibitTimer == 0 && (TPDO->sendRequest || (TPDO->TPDOCommPar->eventTimer && TPDO->eventTimer == 0))){
                 if(CO_TPDOsend(TPDO) == CO_ERROR_NO){
                     /* successfully sent */
@@ -990,7 +2071,7 @@ void CO_TPDO_process(
         else if(TPDO->SYNC && syncWas){
             /* send synchronous acyclic PDO */
             if(TPDO->TPDOCommPar->transmissionType == 0){
-                if(TPDO->sendRequest) CO_TPDOsend(TPDO);
+                if(TPDO->sendRequest) CO_TPDOsendSync(TPDO);
             }
             /* send synchronous cyclic PDO */
             else{
@@ -1005,22 +2086,27 @@ void CO_TPDO_process(
                 if(TPDO->syncCounter == 254){
                     if(TPDO->SYNC->counter == TPDO->TPDOCommPar->SYNCStartValue){
                         TPDO->syncCounter = TPDO->TPDOCommPar->transmissionType;
-                        CO_TPDOsend(TPDO);
+                        CO_TPDOsendSync(TPDO);
                     }
                 }
                 /* Send PDO after every N-th Sync */
                 else if(--TPDO->syncCounter == 0){
                     TPDO->syncCounter = TPDO->TPDOCommPar->transmissionType;
-                    CO_TPDOsend(TPDO);
+                    CO_TPDOsendSync(TPDO);
                 }
             }
         }
 
+        /* continue with transmission of the MPDO scanner list */
+        if(TPDO->MPDOscanning){
+            CO_TPDOstreamMPDO(TPDO);
+        }
     }
     else{
         /* Not operational or valid. Force TPDO first send after operational or valid. */
         if(TPDO->TPDOCommPar->transmissionType>=254) TPDO->sendRequest = 1;
         else                                         TPDO->sendRequest = 0;
+        TPDO->MPDOscanning = false;
     }
 
     /* update timers */
@@ -57,6 +57,27 @@ extern "C" {
  *  - Function CO_TPDO_process() (called by application) sends TPDO if
  *    necessary. There are possible different transmission types, including
  *    automatic detection of Change of State of specific variable.
+ *  - Each received RPDO is timestamped. Optional RPDO timeout monitoring
+ *    (CiA 301 RPDO event timer) is done by CO_RPDOmonitor_t, see
+ *    CO_RPDOmonitor_process().
+ *  - Multiplexed PDOs (MPDO) in destination address mode (DAM) and source
+ *    address mode (SAM). PDO is configured as MPDO, if _numberOfMappedObjects_
+ *    in mapping parameter is CO_PDO_MPDO_SAM or CO_PDO_MPDO_DAM. SAM producer
+ *    streams objects from the object scanner list (CO_MPDOscan_t), SAM
+ *    consumer dispatches received objects through the object dispatcher list
+ *    (CO_MPDOdispatcher_t), which is indexed by hash table. MPDO consumer
+ *    needs receive queue (CO_MPDOqueue_t), which is allocated only for RPDOs
+ *    used as MPDO. DAM producer is triggered only by CO_TPDOsendMPDO().
+ *  - Data of each PDO is protected by sequence lock (CO_PDOseqlock_t) instead
+ *    of CO_LOCK_OD(). Timer thread never blocks: RPDO is written with
+ *    CO_RPDO_process() and may be read consistently from other threads with
+ *    CO_RPDO_readImage(). Application writes variables mapped to TPDO from
+ *    the thread of CO_TPDO_process() and encloses the write with
+ *    CO_TPDO_writeBegin() and CO_TPDO_writeEnd().
+ *    If mapped variables are inside snapshot region (CO_OD_snapshot_t),
+ *    CO_TPDOsend() copies them also consistently with the region.
+ *    SDO server accesses mapped variables through the same sequence locks,
+ *    see CO_RPDO_SDOaccess() and CO_TPDO_SDOaccess().
  */
 
 
@@ -159,6 +180,133 @@ typedef struct{
 }CO_TPDOMapPar_t;
 
 
+/** Value of _numberOfMappedObjects_, which configures source address mode MPDO */
+#define CO_PDO_MPDO_SAM 0xFEU
+/** Value of _numberOfMappedObjects_, which configures destination address mode MPDO */
+#define CO_PDO_MPDO_DAM 0xFFU
+
+/** Number of MPDO messages, which CO_MPDOqueue_t can buffer between two
+calls to CO_RPDO_process(). Must be power of 2, not larger than 128. */
+#ifndef CO_MPDO_RX_QUEUE
+    #define CO_MPDO_RX_QUEUE    4
+#endif
+#if CO_MPDO_RX_QUEUE < 1 || CO_MPDO_RX_QUEUE > 128 || (CO_MPDO_RX_QUEUE & (CO_MPDO_RX_QUEUE - 1)) != 0
+    #error CO_MPDO_RX_QUEUE must be power of 2, not larger than 128
+#endif
+
+/** Empty slot in the hash table of the CO_MPDOdispatcher_t */
+#define CO_MPDO_HASH_EMPTY 0xFFFFU
+
+
+/**
+ * MPDO object scanner list entry, used by SAM MPDO producer. The same as
+ * sub-entry of CiA 301 object 0x1FA0+, split into fields.
+ */
+typedef struct{
+    uint16_t            index;          /**< Index of the transmitted object */
+    uint8_t             subIndex;       /**< Sub-index of the first transmitted object */
+    /** Number of consecutive sub-indexes to transmit, 0 is the same as 1 */
+    uint8_t             blockSize;
+    /** Entry in Object Dictionary, calculated by CO_TPDO_initMPDOscanner() */
+    uint16_t            entryNo;
+}CO_MPDOscan_t;
+
+
+/**
+ * MPDO object dispatcher list entry, used by SAM MPDO consumer. The same as
+ * sub-entry of CiA 301 object 0x1FD0+, split into fields.
+ */
+typedef struct{
+    uint8_t             nodeId;         /**< Node-ID of the MPDO producer */
+    uint16_t            index;          /**< Index of the object in producer */
+    uint8_t             subIndex;       /**< Sub-index of the first object in producer */
+    /** Number of consecutive sub-indexes, 0 is the same as 1 */
+    uint8_t             blockSize;
+    uint16_t            localIndex;     /**< Index of the object in this device */
+    uint8_t             localSubIndex;  /**< Sub-index of the first object in this device */
+    /** Entry in Object Dictionary, calculated by CO_MPDOdispatcher_init() */
+    uint16_t            entryNo;
+}CO_MPDOdispatch_t;
+
+
+/**
+ * MPDO object dispatcher.
+ *
+ * Dispatcher list is indexed by open addressing hash table with key
+ * (producer nodeId, index), so lookup of received SAM MPDO takes constant
+ * time, regardless of the size of the list. One dispatcher may be shared by
+ * many RPDOs.
+ */
+typedef struct{
+    CO_SDO_t           *SDO;            /**< From CO_MPDOdispatcher_init() */
+    CO_MPDOdispatch_t  *list;           /**< From CO_MPDOdispatcher_init() */
+    uint16_t            listSize;       /**< From CO_MPDOdispatcher_init() */
+    uint16_t           *hashTable;      /**< From CO_MPDOdispatcher_init() */
+    uint16_t            hashMask;       /**< Size of the hashTable minus one */
+}CO_MPDOdispatcher_t;
+
+
+/**
+ * Receive queue of the MPDO consumer.
+ *
+ * Queue is allocated by application only for RPDOs, which are configured as
+ * MPDO, see CO_RPDO_initMPDOqueue().
+ */
+typedef struct{
+    /** Received MPDO messages, waiting for CO_RPDO_process() */
+    uint8_t             frame[CO_MPDO_RX_QUEUE][8];
+    /** Free running write counter, written by receive function */
+    volatile uint8_t    head;
+    /** Free running read counter, written by CO_RPDO_process() */
+    volatile uint8_t    tail;
+}CO_MPDOqueue_t;
+
+
+/** Number of repeated reads of the PDO data image, before reader gives up. */
+#ifndef CO_PDO_SEQLOCK_RETRIES
+    #define CO_PDO_SEQLOCK_RETRIES  3
+#endif
+
+/** Memory barrier between sequence counter and data access of CO_PDOseqlock_t */
+#ifndef CO_PDO_SEQLOCK_BARRIER
+    #define CO_PDO_SEQLOCK_BARRIER() CO_SEQLOCK_BARRIER()
+#endif
+
+
+/**
+ * Sequence lock for the data image of the PDO.
+ *
+ * Writer increments sequence counter before and after the update, so odd value
+ * means write in progress. Reader copies the data and verifies, that sequence
+ * counter was even and did not change, otherwise it repeats the copy. Writer
+ * never waits, reader waits at most CO_PDO_SEQLOCK_RETRIES copies. There must
+ * be only one writer at a time.
+ *
+ * Counters show contention between threads. They count repeated copies, not
+ * time: if readRetriesMax stays zero, reader never had to repeat the copy
+ * because of the writer.
+ */
+typedef struct{
+    volatile uint32_t   seq;            /**< Sequence counter, odd while writing */
+    uint32_t            writeCount;     /**< Number of published updates */
+    uint32_t            readCount;      /**< Number of consistent reads */
+    /** Number of copies repeated because of concurrent write */
+    uint32_t            readRetries;
+    /** Number of reads abandoned after CO_PDO_SEQLOCK_RETRIES */
+    uint32_t            readFailures;
+    /** Maximum number of repeated copies inside single read (retry count) */
+    uint8_t             readRetriesMax;
+}CO_PDOseqlock_t;
+
+
+/** RPDO is not in the heap of the CO_RPDOmonitor_t */
+#define CO_RPDO_HEAP_NONE 0xFFFFU
+
+
+/** RPDO timeout monitor, see below */
+typedef struct CO_RPDOmonitor CO_RPDOmonitor_t;
+
+
 /**
  * RPDO object.
  */
@@ -184,11 +332,75 @@ typedef struct{
     volatile void      *CANrxNew[2];
     /** 8 data bytes of the received message. */
     uint8_t             CANrxData[2][8];
+    /** Time of the last accepted RPDO reception in [microseconds]. Taken from
+    the clock of the monitor inside receive function. */
+    volatile uint32_t   timestamp_us;
+    /** Number of accepted RPDO receptions, incremented by receive function */
+    volatile uint32_t   rxCount;
+    CO_RPDOmonitor_t   *monitor;        /**< From CO_RPDOmonitor_attach() or NULL */
+    /** RPDO timeout time in [microseconds]. Zero disables monitoring. */
+    uint32_t            timeoutTime_us;
+    /** Time, when monitor will check this RPDO next time, in [microseconds] */
+    uint32_t            deadline_us;
+    /** Value of rxCount at the previous check by the monitor */
+    uint32_t            rxCountChecked;
+    /** Position inside monitor heap or CO_RPDO_HEAP_NONE */
+    uint16_t            heapIdx;
+    /** True, if RPDO was received after activation, so monitoring is running */
+    bool_t              timeoutStarted;
+    /** True, if RPDO timeout is currently active */
+    bool_t              timedOut;
+    /** 0 for classic PDO, CO_PDO_MPDO_SAM or CO_PDO_MPDO_DAM. Calculated from mapping */
+    uint8_t             MPDOmode;
+    /** From CO_RPDO_initMPDOdispatcher() or NULL */
+    CO_MPDOdispatcher_t *MPDOdispatcher;
+    /** From CO_RPDO_initMPDOqueue() or NULL */
+    CO_MPDOqueue_t     *MPDOqueue;
+    /** Number of MPDO messages lost because of full or missing MPDOqueue */
+    volatile uint32_t   MPDOoverflowCount;
+    /** Number of MPDO messages, which had no matching object in this device */
+    uint32_t            MPDOdroppedCount;
+    /** Sequence lock of the mapped variables, written by CO_RPDO_process() */
+    CO_PDOseqlock_t     seqlock;
+    /** True while CO_RPDO_process() writes the mapped variables */
+    volatile bool_t     writingPDO;
+    /** True while SDO server writes the mapped variables, see CO_RPDO_SDOaccess() */
+    volatile bool_t     writingSDO;
     CO_CANmodule_t     *CANdevRx;       /**< From CO_RPDO_init() */
     uint16_t            CANdevRxIdx;    /**< From CO_RPDO_init() */
 }CO_RPDO_t;
 
 
+/**
+ * RPDO timeout monitor.
+ *
+ * Monitor keeps RPDOs with enabled timeout in a binary min-heap, ordered by
+ * the time of their next check. CO_RPDOmonitor_process() only touches RPDOs,
+ * whose deadline has expired, so cost per event is O(log n) regardless of the
+ * number of monitored RPDOs.
+ *
+ * Receive function only writes timestamp and increments reception counter, heap
+ * is updated lazily: when deadline of the RPDO expires and RPDO was received in
+ * the meantime, its deadline is moved to _timestamp + timeout_. Otherwise
+ * timeout is signaled with emergency message (CO_EM_RPDO_TIME_OUT) and with
+ * optional callback. Monitoring of each RPDO starts after its first reception
+ * in NMT operational state. Timeout is cleared after the next reception, at
+ * the latest after one timeout period.
+ */
+struct CO_RPDOmonitor{
+    CO_EM_t            *em;             /**< From CO_RPDOmonitor_init() */
+    CO_RPDO_t         **heap;           /**< From CO_RPDOmonitor_init() */
+    uint16_t            heapSize;       /**< From CO_RPDOmonitor_init() */
+    uint16_t            heapCount;      /**< Number of RPDOs inside heap */
+    uint16_t            timedOutCount;  /**< Number of RPDOs with active timeout */
+    /** Monotonic time in [microseconds], advanced by CO_RPDOmonitor_process() */
+    volatile uint32_t   timeNow_us;
+    /** From CO_RPDOmonitor_initCallbackTimeout() or NULL */
+    void              (*pFunctSignalTimeout)(CO_RPDO_t *RPDO, void *object);
+    void               *functSignalObjectTimeout;/**< Pointer to object */
+};
+
+
 /**
  * TPDO object.
  */
@@ -210,6 +422,11 @@ typedef struct{
     uint8_t             sendRequest;
     /** Pointers to 8 data objects, where PDO will be copied */
     uint8_t            *mapPointer[8];
+    /** Entries of the mapped objects in Object Dictionary, CO_OD_find(), used
+    to find their snapshot regions. Calculated from mapping */
+    uint16_t            mapEntryNo[8];
+    /** Number of used mapEntryNo. Calculated from mapping */
+    uint8_t             mapEntries;
     /** Each flag bit is connected with one mapPointer. If flag bit
     is true, CO_TPDO_process() functiuon will send PDO if
     Change of State is detected on value pointed by that mapPointer */
@@ -220,6 +437,28 @@ typedef struct{
     uint32_t            inhibitTimer;
     /** Event timer used for PDO sending translated to microseconds */
     uint32_t            eventTimer;
+    /** 0 for classic PDO, CO_PDO_MPDO_SAM or CO_PDO_MPDO_DAM. Calculated from mapping */
+    uint8_t             MPDOmode;
+    /** Length of the object mapped to DAM MPDO, calculated from mapping */
+    uint8_t             MPDOdataLength;
+    /** True, while objects from the MPDOscanList are being transmitted */
+    bool_t              MPDOscanning;
+    /** Offset of the current sub-index inside the block of the scanner entry */
+    uint8_t             MPDOscanSub;
+    /** Index of the current entry inside MPDOscanList */
+    uint16_t            MPDOscanPos;
+    uint16_t            MPDOscanListSize;/**< From CO_TPDO_initMPDOscanner() */
+    CO_MPDOscan_t      *MPDOscanList;   /**< From CO_TPDO_initMPDOscanner() or NULL */
+    /** Sequence lock of the mapped variables, read by CO_TPDOsend() */
+    CO_PDOseqlock_t     seqlock;
+    /** Mapped variable written by SDO server, see CO_TPDO_SDOaccess() */
+    uint8_t            *SDOwritePtr;
+    /** Data written by SDO server, copied to SDOwritePtr by CO_TPDO_process() */
+    uint8_t             SDOwriteData[8];
+    /** Length of SDOwriteData */
+    uint8_t             SDOwriteLength;
+    /** Set by SDO server, cleared by CO_TPDO_process() after the write */
+    volatile bool_t     SDOwritePending;
     CO_CANmodule_t     *CANdevTx;       /**< From CO_TPDO_init() */
     CO_CANtx_t         *CANtxBuff;      /**< CAN transmit buffer inside CANdev */
     uint16_t            CANdevTxIdx;    /**< From CO_TPDO_init() */
@@ -339,12 +578,16 @@ uint8_t CO_TPDOisCOS(CO_TPDO_t *TPDO);
  * Send TPDO message.
  *
  * Function prepares TPDO data from Object Dictionary variables. It should not
- * be called by application, it is called from CO_TPDO_process().
+ * be called by application, it is called from CO_TPDO_process(). For SAM MPDO
+ * it starts transmission of the object scanner list.
  *
+ * Data are copied under sequence lock. If application is writing mapped
+ * variables all the time, synchronous TPDO is sent with previous data and
+ * other TPDOs are postponed.
  *
  * @param TPDO TPDO object.
  *
- * @return Same as CO_CANsend().
+ * @return Same as CO_CANsend() or CO_ERROR_TX_BUSY, if TPDO is postponed.
  */
 int16_t CO_TPDOsend(CO_TPDO_t *TPDO);
 
@@ -362,12 +605,317 @@ int16_t CO_TPDOsend(CO_TPDO_t *TPDO);
 void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas);
 
 
+/**
+ * Start writing of the sequence locked data.
+ *
+ * @param seqlock This object.
+ */
+void CO_PDOseqlock_writeBegin(CO_PDOseqlock_t *seqlock);
+
+
+/**
+ * Finish writing of the sequence locked data and publish it.
+ *
+ * @param seqlock This object.
+ */
+void CO_PDOseqlock_writeEnd(CO_PDOseqlock_t *seqlock);
+
+
+/**
+ * Read consistent copy of the variables mapped to RPDO.
+ *
+ * Function may be called from any thread, except the one, which calls
+ * CO_RPDO_process(). It never blocks, it may only repeat the copy up to
+ * CO_PDO_SEQLOCK_RETRIES times.
+ *
+ * @param RPDO RPDO object.
+ * @param data Buffer of 8 bytes, where data are copied in the same order as
+ * in received PDO.
+ *
+ * @return Number of copied bytes or -1, if copy was not consistent.
+ */
+int16_t CO_RPDO_readImage(CO_RPDO_t *RPDO, uint8_t data[]);
+
+
+/**
+ * Copy variable mapped to RPDO between Object Dictionary and SDO buffer.
+ *
+ * Function is used by SDO server through CO_SDO_initPDOaccess(). Read is
+ * consistent copy under sequence lock. Write makes SDO server the second
+ * writer of the RPDO: it claims the variables and backs off, if
+ * CO_RPDO_process() is writing them. CO_RPDO_process() never waits, it leaves
+ * the received message for the next call, if SDO server is writing.
+ *
+ * @param RPDO RPDO object.
+ * @param ODdata Pointer to OD variable.
+ * @param buffer SDO buffer.
+ * @param length Length of OD variable.
+ * @param write True for SDO download, false for upload.
+ *
+ * @return 0, if variable is not mapped to RPDO, 1 if copied, -1 if consistent
+ * copy was not possible.
+ */
+int8_t CO_RPDO_SDOaccess(CO_RPDO_t *RPDO, uint8_t *ODdata, uint8_t *buffer, uint16_t length, bool_t write);
+
+
+/**
+ * Copy variable mapped to TPDO between Object Dictionary and SDO buffer.
+ *
+ * Read is the same as in CO_RPDO_SDOaccess(). Sequence lock of TPDO must have
+ * single writer, the thread of CO_TPDO_process(), so write is deferred: data
+ * are stored in the TPDO object and next CO_TPDO_process() writes them with
+ * CO_TPDO_writeBegin() and CO_TPDO_writeEnd(). Until then SDO upload returns
+ * the old value. If previous write is not applied yet, function returns -1.
+ *
+ * @param TPDO TPDO object.
+ * @param ODdata Pointer to OD variable.
+ * @param buffer SDO buffer.
+ * @param length Length of OD variable.
+ * @param write True for SDO download, false for upload.
+ *
+ * @return 0, if variable is not mapped to TPDO, 1 if copied, -1 if consistent
+ * copy was not possible.
+ */
+int8_t CO_TPDO_SDOaccess(CO_TPDO_t *TPDO, uint8_t *ODdata, uint8_t *buffer, uint16_t length, bool_t write);
+
+
+/**
+ * Start writing of the variables mapped to TPDO.
+ *
+ * Application writes variables mapped to TPDO from the same thread as
+ * CO_TPDO_process() (realtime thread), for example between CO_process_RPDO()
+ * and CO_process_TPDO(). It encloses the write with CO_TPDO_writeBegin() and
+ * CO_TPDO_writeEnd() instead of CO_LOCK_OD() and CO_UNLOCK_OD(), so other
+ * threads (SDO server) read the variables consistently. Sequence lock allows
+ * only one writer thread, other threads must not write the variables.
+ *
+ * @param TPDO TPDO object.
+ */
+#define CO_TPDO_writeBegin(TPDO)   CO_PDOseqlock_writeBegin(&(TPDO)->seqlock)
+
+
+/**
+ * Finish writing of the variables mapped to TPDO.
+ *
+ * @param TPDO TPDO object.
+ */
+#define CO_TPDO_writeEnd(TPDO)     CO_PDOseqlock_writeEnd(&(TPDO)->seqlock)
+
+
+/**
+ * Initialize RPDO timeout monitor.
+ *
+ * Function must be called in the communication reset section, before
+ * CO_RPDOmonitor_attach().
+ *
+ * @param monitor This object will be initialized.
+ * @param em Emergency object.
+ * @param heap Pointer to externaly defined array of RPDO pointers, used for heap.
+ * @param heapSize Size of the above array, maximum number of monitored RPDOs.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_RPDOmonitor_init(
+        CO_RPDOmonitor_t       *monitor,
+        CO_EM_t                *em,
+        CO_RPDO_t              *heap[],
+        uint16_t                heapSize);
+
+
+/**
+ * Initialize RPDO timeout callback function.
+ *
+ * Function initializes optional callback function, which is called, when
+ * monitored RPDO was not received inside its timeout time. Function is called
+ * from CO_RPDOmonitor_process().
+ *
+ * @param monitor This object.
+ * @param object Pointer to object, which will be passed to pFunctSignal(). Can be NULL
+ * @param pFunctSignal Pointer to the callback function. Not called if NULL.
+ */
+void CO_RPDOmonitor_initCallbackTimeout(
+        CO_RPDOmonitor_t       *monitor,
+        void                   *object,
+        void                  (*pFunctSignal)(CO_RPDO_t *RPDO, void *object));
+
+
+/**
+ * Attach RPDO to the monitor and set its timeout.
+ *
+ * After the RPDO is attached, its receptions are timestamped with the monitor
+ * clock. If timeoutTime_ms is different than zero, RPDO is also inserted into
+ * monitor heap. Function may be called again to change or disable the timeout.
+ * It must be called from the same thread as CO_RPDOmonitor_process().
+ *
+ * Object dictionary in this project does not contain _event timer_ (sub-index 5)
+ * in _RPDO communication parameter_ (index 0x1400+), so timeout is configured
+ * by the application.
+ *
+ * @param monitor RPDO monitor object.
+ * @param RPDO RPDO object, initialized by CO_RPDO_init().
+ * @param timeoutTime_ms RPDO timeout time in [milliseconds], 0 disables monitoring.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or
+ * CO_ERROR_OUT_OF_MEMORY (heap is full).
+ */
+CO_ReturnError_t CO_RPDOmonitor_attach(
+        CO_RPDOmonitor_t       *monitor,
+        CO_RPDO_t              *RPDO,
+        uint16_t                timeoutTime_ms);
+
+
+/**
+ * Process RPDO timeout monitor.
+ *
+ * Function must be called cyclically. It advances monitor clock and verifies
+ * RPDOs with expired deadline.
+ *
+ * @param monitor This object.
+ * @param timeDifference_us Time difference from previous function call in [microseconds].
+ * @param timerNext_ms Return value - info to OS - see CO_process().
+ */
+void CO_RPDOmonitor_process(
+        CO_RPDOmonitor_t       *monitor,
+        uint32_t                timeDifference_us,
+        uint16_t               *timerNext_ms);
+
+
+/**
+ * Get time since the last reception of the RPDO.
+ *
+ * @param RPDO RPDO object.
+ *
+ * @return Age of the last received RPDO in [microseconds], measured with the
+ * monitor clock. 0xFFFFFFFF if RPDO is not attached to monitor or was not
+ * received yet.
+ */
+uint32_t CO_RPDO_getAge_us(const CO_RPDO_t *RPDO);
+
+
+/**
+ * Initialize MPDO object dispatcher.
+ *
+ * Function resolves local objects from the dispatcher list and builds hash
+ * table. It must be called in the communication reset section, before
+ * dispatcher is used by CO_RPDO_initMPDOdispatcher().
+ *
+ * @param dispatcher This object will be initialized.
+ * @param SDO SDO server object.
+ * @param list Pointer to externaly defined dispatcher list.
+ * @param listSize Number of entries in the above list.
+ * @param hashTable Pointer to externaly defined array, used for hash table.
+ * @param hashSize Size of the above array. Must be power of 2 and larger
+ * than listSize.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT (also
+ * if local object does not exist in Object Dictionary).
+ */
+CO_ReturnError_t CO_MPDOdispatcher_init(
+        CO_MPDOdispatcher_t    *dispatcher,
+        CO_SDO_t               *SDO,
+        CO_MPDOdispatch_t       list[],
+        uint16_t                listSize,
+        uint16_t                hashTable[],
+        uint16_t                hashSize);
+
+
+/**
+ * Find entry in the MPDO object dispatcher list.
+ *
+ * @param dispatcher This object.
+ * @param nodeId Node-ID of the MPDO producer.
+ * @param index Index of the object in producer.
+ * @param subIndex Sub-index of the object in producer.
+ *
+ * @return Pointer to dispatcher list entry, which contains the object or NULL.
+ */
+const CO_MPDOdispatch_t *CO_MPDOdispatcher_find(
+        const CO_MPDOdispatcher_t *dispatcher,
+        uint8_t                 nodeId,
+        uint16_t                index,
+        uint8_t                 subIndex);
+
+
+/**
+ * Set MPDO object dispatcher for the SAM MPDO consumer.
+ *
+ * If dispatcher is not set, received SAM MPDOs are dropped.
+ *
+ * @param RPDO RPDO object.
+ * @param dispatcher Initialized dispatcher object or NULL.
+ */
+void CO_RPDO_initMPDOdispatcher(
+        CO_RPDO_t              *RPDO,
+        CO_MPDOdispatcher_t    *dispatcher);
+
+
+/**
+ * Set receive queue for the MPDO consumer (SAM or DAM).
+ *
+ * Function must be called in the communication reset section, before CAN is
+ * set to normal mode. If queue is not set, received MPDOs are dropped and
+ * counted in _MPDOoverflowCount_.
+ *
+ * @param RPDO RPDO object.
+ * @param queue Queue object or NULL.
+ */
+void CO_RPDO_initMPDOqueue(
+        CO_RPDO_t              *RPDO,
+        CO_MPDOqueue_t         *queue);
+
+
+/**
+ * Set MPDO object scanner list for the SAM MPDO producer.
+ *
+ * When SAM MPDO is triggered by its transmission type (event timer, SYNC or
+ * sendRequest), all objects from the scanner list are transmitted, one MPDO
+ * for each sub-index. CO_TPDO_process() transmits them as fast as CAN transmit
+ * buffer gets free.
+ *
+ * @param TPDO TPDO object.
+ * @param scanList Pointer to externaly defined scanner list or NULL.
+ * @param scanListSize Number of entries in the above list.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT (also
+ * if object does not exist in Object Dictionary).
+ */
+CO_ReturnError_t CO_TPDO_initMPDOscanner(
+        CO_TPDO_t              *TPDO,
+        CO_MPDOscan_t           scanList[],
+        uint16_t                scanListSize);
+
+
+/**
+ * Send single MPDO message.
+ *
+ * For DAM MPDO function sends value of the object, mapped to the TPDO, to the
+ * object (index, subIndex) in the device nodeId. For SAM MPDO function sends
+ * value of own object (index, subIndex), nodeId is not used. Object must be
+ * mappable to TPDO and not longer than 4 bytes.
+ *
+ * @param TPDO TPDO object, configured as MPDO.
+ * @param nodeId DAM: destination node-ID, 0 for all nodes.
+ * @param index Index of the object, see above.
+ * @param subIndex Sub-index of the object, see above.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_ILLEGAL_ARGUMENT, CO_ERROR_TX_UNCONFIGURED,
+ * CO_ERROR_WRONG_NMT_STATE, CO_ERROR_TX_BUSY (data of DAM MPDO was not
+ * consistent, try again) or the same as CO_CANsend().
+ */
+CO_ReturnError_t CO_TPDOsendMPDO(
+        CO_TPDO_t              *TPDO,
+        uint8_t                 nodeId,
+        uint16_t                index,
+        uint8_t                 subIndex);
+
+
 /**
  * Process transmitting PDO messages.
  *
  * Function must be called cyclically in any NMT state. It prepares and sends
  * TPDO if necessary. If Change of State needs to be detected, function
- * CO_TPDOisCOS() must be called before.
+ * CO_TPDOisCOS() must be called before. Latency of each sent synchronous
+ * TPDO is recorded with CO_SYNC_recordTPDO().
  *
  * @param TPDO This object.
  * @param SYNC SYNC object. Ignored if NULL.
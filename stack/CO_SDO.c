@@ -219,17 +219,37 @@ static void CO_SDO_receive(void *object, const CO_CANrxMsg_t *msg){
             /* check correct sequence number. */
             if(seqno == (SDO->sequence + 1U)) {
                 /* sequence is correct */
+#if CO_SDO_BLK_RX_SEGMENTS > 0
+                uint8_t head = SDO->blkRxHead;
+                uint8_t next = head + 1U;
 
+                if (next >= CO_SDO_BLK_RX_SEGMENTS)
+                    next = 0U;
+
+                /* check if ring can store the segment, data are consumed by CO_SDO_process() */
+                if (next != SDO->blkRxTail) {
+                    uint8_t i;
+
+                    SDO->sequence++;
+
+                    /* copy data */
+                    for(i=1; i<8; i++) {
+                        SDO->blkRxRing[head][i-1] = msg->data[i];
+                    }
+                    CANrxMemoryBarrier();
+                    SDO->blkRxHead = next;
+#else
                 /* check if buffer can store whole message just in case */
-                if (CO_SDO_BUFFER_SIZE - SDO->bufferOffset >= 7) {
+                if (SDO->bufferSize - SDO->bufferOffset >= 7) {
                     uint8_t i;
 
                     SDO->sequence++;
 
                     /* copy data */
                     for(i=1; i<8; i++) {
-                        SDO->ODF_arg.data[SDO->bufferOffset++] = msg->data[i]; //SDO->ODF_arg.data is equal as SDO->databuffer
+                        SDO->ODF_arg.data[SDO->bufferOffset++] = msg->data[i]; //SDO->ODF_arg.data is SDO->databuffer or window of the stream
                     }
+#endif
 
                     /* break reception if last segment, block ends or block sequence is too large */
                     if(((CANrxData[0] & 0x80U) == 0x80U) || (SDO->sequence >= SDO->blksize)) {
@@ -309,6 +329,12 @@ CO_ReturnError_t CO_SDO_init(
     if(parentSDO == NULL){
         uint16_t i;
 
+#if CO_OD_INDEX_LOOKUP
+        /* lookup table is kept across communication reset, if OD is the same */
+        if(SDO->OD != OD || SDO->ODSize != ODSize){
+            SDO->ODlookup = NULL;
+        }
+#endif
         SDO->ownOD = true;
         SDO->OD = OD;
         SDO->ODSize = ODSize;
@@ -319,6 +345,8 @@ CO_ReturnError_t CO_SDO_init(
             SDO->ODExtensions[i].pODFunc = NULL;
             SDO->ODExtensions[i].object = NULL;
             SDO->ODExtensions[i].flags = NULL;
+            SDO->ODExtensions[i].stream = NULL;
+            SDO->ODExtensions[i].snapshot = NULL;
         }
     }
     /* copy object dictionary from parent */
@@ -327,11 +355,23 @@ CO_ReturnError_t CO_SDO_init(
         SDO->OD = parentSDO->OD;
         SDO->ODSize = parentSDO->ODSize;
         SDO->ODExtensions = parentSDO->ODExtensions;
+#if CO_OD_INDEX_LOOKUP
+        SDO->ODlookup = parentSDO->ODlookup;
+        SDO->ODlookupMask = parentSDO->ODlookupMask;
+#endif
     }
 
     /* Configure object variables */
     SDO->nodeId = nodeId;
     SDO->state = CO_SDO_ST_IDLE;
+    SDO->bufferSize = CO_SDO_BUFFER_SIZE;
+    SDO->stream = NULL;
+    SDO->completeAccess = false;
+    CO_SDO_blkAdaptInit(&SDO->blkAdapt, 127);
+#if CO_SDO_BLK_RX_SEGMENTS > 0
+    SDO->blkRxHead = 0U;
+    SDO->blkRxTail = 0U;
+#endif
 
     uint8_t i;
     for(i=0U; i<CO_SDO_RX_DATA_SIZE; i++){
@@ -341,6 +381,8 @@ CO_ReturnError_t CO_SDO_init(
     SDO->CANrxProc = 0;
 
     SDO->pFunctSignal = NULL;
+    SDO->pFunctPDOaccess = NULL;
+    SDO->functPDOaccessObject = NULL;
 
 
     /* Configure Object dictionary entry at index 0x1200 */
@@ -388,6 +430,19 @@ void CO_SDO_initCallback(
 }
 
 
+/******************************************************************************/
+void CO_SDO_initPDOaccess(
+        CO_SDO_t               *SDO,
+        void                   *object,
+        int8_t                (*pFunctPDOaccess)(void *object, uint8_t *ODdata, uint8_t *buffer, uint16_t length, bool_t write))
+{
+    if(SDO != NULL){
+        SDO->functPDOaccessObject = object;
+        SDO->pFunctPDOaccess = pFunctPDOaccess;
+    }
+}
+
+
 /******************************************************************************/
 void CO_OD_configure(
         CO_SDO_t               *SDO,
@@ -420,6 +475,127 @@ void CO_OD_configure(
 }
 
 
+/******************************************************************************/
+void CO_OD_configureStream(
+        CO_SDO_t               *SDO,
+        uint16_t                index,
+        const CO_SDO_stream_t  *stream)
+{
+    uint16_t entryNo;
+
+    entryNo = CO_OD_find(SDO, index);
+    if(entryNo < 0xFFFFU){
+        SDO->ODExtensions[entryNo].stream = stream;
+    }
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_OD_snapshot_init(
+        CO_OD_snapshot_t       *snap,
+        void                   *data,
+        void                   *shadow,
+        uint16_t                size)
+{
+    uint16_t i;
+
+    if(snap == NULL || data == NULL || shadow == NULL || size == 0U){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    snap->seq = 0;
+    snap->data = (uint8_t*)data;
+    snap->shadow = (uint8_t*)shadow;
+    snap->size = size;
+    snap->publishCount = 0;
+    snap->readRetries = 0;
+    snap->readFailures = 0;
+
+    for(i=0; i<size; i++){
+        snap->shadow[i] = snap->data[i];
+    }
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+void CO_OD_snapshot_publish(CO_OD_snapshot_t *snap){
+    uint16_t i;
+
+    snap->seq++;
+    CO_OD_SNAPSHOT_BARRIER();
+    for(i=0; i<snap->size; i++){
+        snap->data[i] = snap->shadow[i];
+    }
+    CO_OD_SNAPSHOT_BARRIER();
+    snap->seq++;
+    snap->publishCount++;
+}
+
+
+/******************************************************************************/
+bool_t CO_OD_snapshot_read(
+        CO_OD_snapshot_t       *snap,
+        void                   *dest,
+        uint16_t                offset,
+        uint16_t                length)
+{
+    uint8_t *d = (uint8_t*)dest;
+    uint8_t retry;
+
+    if(((uint32_t)offset + length) > snap->size){
+        return false;
+    }
+
+    for(retry=0; retry<=CO_OD_SNAPSHOT_RETRIES; retry++){
+        uint32_t seq = snap->seq;
+        uint16_t i;
+
+        CO_OD_SNAPSHOT_BARRIER();
+        if((seq & 1U) == 0U){
+            for(i=0; i<length; i++){
+                d[i] = snap->data[offset + i];
+            }
+            CO_OD_SNAPSHOT_BARRIER();
+            if(snap->seq == seq){
+                return true;
+            }
+        }
+        if(retry < CO_OD_SNAPSHOT_RETRIES){
+            snap->readRetries++;
+        }
+    }
+    snap->readFailures++;
+
+    return false;
+}
+
+
+/******************************************************************************/
+void CO_OD_configureSnapshot(
+        CO_SDO_t               *SDO,
+        uint16_t                index,
+        CO_OD_snapshot_t       *snap)
+{
+    uint16_t entryNo;
+
+    entryNo = CO_OD_find(SDO, index);
+    if(entryNo < 0xFFFFU){
+        SDO->ODExtensions[entryNo].snapshot = snap;
+    }
+}
+
+
+#if CO_OD_INDEX_LOOKUP
+/******************************************************************************/
+void CO_OD_setIndexLookup(CO_SDO_t *SDO, const uint16_t *table, uint16_t mask){
+    SDO->ODlookup = table;
+    SDO->ODlookupMask = mask;
+}
+#endif
+
+
 /******************************************************************************/
 uint16_t CO_OD_find(CO_SDO_t *SDO, uint16_t index){
     /* Fast search in ordered Object Dictionary. If indexes are mixed, this won't work. */
@@ -427,6 +603,22 @@ uint16_t CO_OD_find(CO_SDO_t *SDO, uint16_t index){
     uint16_t cur, min, max;
     const CO_OD_entry_t* object;
 
+#if CO_OD_INDEX_LOOKUP
+    if(SDO->ODlookup != NULL){
+        /* linear probing until empty slot */
+        uint16_t slot = CO_OD_LOOKUP_SLOT(index, SDO->ODlookupMask);
+
+        while(SDO->ODlookup[slot] != 0U){
+            cur = SDO->ODlookup[slot] - 1U;
+            if(SDO->OD[cur].index == index){
+                return cur;
+            }
+            slot = (slot + 1U) & SDO->ODlookupMask;
+        }
+        return 0xFFFFU;
+    }
+#endif
+
     min = 0U;
     max = SDO->ODSize - 1U;
     while(min < max){
@@ -456,6 +648,14 @@ uint16_t CO_OD_find(CO_SDO_t *SDO, uint16_t index){
 }
 
 
+#if CO_OD_PACKED
+/* Member of record in packed Object Dictionary layout */
+static const CO_OD_entryRecord_t *CO_OD_recordMember(const CO_OD_entry_t *object, uint8_t subIndex){
+    return &((const CO_OD_record_t*)(object->pData))->pMembers[subIndex];
+}
+#endif
+
+
 /******************************************************************************/
 uint16_t CO_OD_getLength(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
     const CO_OD_entry_t* object = &SDO->OD[entryNo];
@@ -485,6 +685,17 @@ uint16_t CO_OD_getLength(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
         }
     }
     else{                            /* Object type is Record */
+#if CO_OD_PACKED
+        const CO_OD_entryRecord_t *member = CO_OD_recordMember(object, subIndex);
+
+        if(member->offset == 0xFFFFU){
+            /* data type is domain */
+            return CO_SDO_BUFFER_SIZE;
+        }
+        else{
+            return member->length;
+        }
+#else
         if(((const CO_OD_entryRecord_t*)(object->pData))[subIndex].pData == 0){
             /* data type is domain */
             return CO_SDO_BUFFER_SIZE;
@@ -492,6 +703,7 @@ uint16_t CO_OD_getLength(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
         else{
             return ((const CO_OD_entryRecord_t*)(object->pData))[subIndex].length;
         }
+#endif
     }
 }
 
@@ -525,7 +737,11 @@ uint16_t CO_OD_getAttribute(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
         return attr;
     }
     else{                            /* Object type is Record */
+#if CO_OD_PACKED
+        return CO_OD_recordMember(object, subIndex)->attribute;
+#else
         return ((const CO_OD_entryRecord_t*)(object->pData))[subIndex].attribute;
+#endif
     }
 }
 
@@ -559,7 +775,17 @@ void* CO_OD_getDataPointer(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
         }
     }
     else{                            /* Object Type is Record */
+#if CO_OD_PACKED
+        const CO_OD_entryRecord_t *member = CO_OD_recordMember(object, subIndex);
+
+        if(member->offset == 0xFFFFU){
+            /* data type is domain */
+            return 0;
+        }
+        return (void*)(((uint8_t*)((const CO_OD_record_t*)(object->pData))->pBase) + member->offset);
+#else
         return ((const CO_OD_entryRecord_t*)(object->pData))[subIndex].pData;
+#endif
     }
 }
 
@@ -607,6 +833,7 @@ uint32_t CO_SDO_initTransfer(CO_SDO_t *SDO, uint16_t index, uint8_t subIndex){
         SDO->ODF_arg.object = ext->object;
     }
     SDO->ODF_arg.data = SDO->databuffer;
+    SDO->bufferSize = CO_SDO_BUFFER_SIZE;
     SDO->ODF_arg.dataLength = CO_OD_getLength(SDO, SDO->entryNo, subIndex);
     SDO->ODF_arg.attribute = CO_OD_getAttribute(SDO, SDO->entryNo, subIndex);
     SDO->ODF_arg.pFlags = CO_OD_getFlagsPointer(SDO, SDO->entryNo, subIndex);
@@ -619,6 +846,24 @@ uint32_t CO_SDO_initTransfer(CO_SDO_t *SDO, uint16_t index, uint8_t subIndex){
 
     SDO->ODF_arg.offset = 0U;
 
+    SDO->completeAccess = false;
+
+    /* streaming domain */
+    SDO->stream = NULL;
+    if((SDO->ODF_arg.ODdataStorage == NULL) && (SDO->ODExtensions != NULL) &&
+       (SDO->ODExtensions[SDO->entryNo].stream != NULL) &&
+       (SDO->ODExtensions[SDO->entryNo].stream->getWindow != NULL))
+    {
+        SDO->stream = SDO->ODExtensions[SDO->entryNo].stream;
+        SDO->window = NULL;
+        SDO->windowOffset = 0U;
+        SDO->windowSize = 0U;
+        SDO->streamOffset = 0U;
+        SDO->streamMark = 0U;
+        SDO->crcOffset = 0U;
+        SDO->streamDirect = false;
+    }
+
     /* verify length */
     if(SDO->ODF_arg.dataLength > CO_SDO_BUFFER_SIZE){
         return CO_SDO_AB_DEVICE_INCOMPAT;     /* general internal incompatibility in the device */
@@ -634,6 +879,7 @@ uint32_t CO_SDO_readOD(CO_SDO_t *SDO, uint16_t SDOBufferSize){
     uint8_t *ODdata = (uint8_t*)SDO->ODF_arg.ODdataStorage;
     uint16_t length = SDO->ODF_arg.dataLength;
     CO_OD_extension_t *ext = 0;
+    bool_t copied = false;
 
     /* is object readable? */
     if((SDO->ODF_arg.attribute & CO_ODA_READABLE) == 0)
@@ -644,37 +890,61 @@ uint32_t CO_SDO_readOD(CO_SDO_t *SDO, uint16_t SDOBufferSize){
         ext = &SDO->ODExtensions[SDO->entryNo];
     }
 
-    CO_LOCK_OD();
+    /* consistent copy from snapshot region, without CO_LOCK_OD() */
+    if(ext != NULL && ext->snapshot != NULL && ODdata != NULL &&
+       ODdata >= ext->snapshot->data &&
+       (uint32_t)(ODdata - ext->snapshot->data) + length <= ext->snapshot->size)
+    {
+        if(!CO_OD_snapshot_read(ext->snapshot, SDObuffer,
+                                (uint16_t)(ODdata - ext->snapshot->data), length))
+        {
+            return CO_SDO_AB_DATA_LOC_CTRL;
+        }
+        copied = true;
+    }
 
-    /* copy data from OD to SDO buffer if not domain */
-    if(ODdata != NULL){
-        while(length--) *(SDObuffer++) = *(ODdata++);
+    /* consistent copy of the variable mapped to PDO, without CO_LOCK_OD() */
+    if(!copied && ODdata != NULL && SDO->pFunctPDOaccess != NULL){
+        int8_t ret = SDO->pFunctPDOaccess(SDO->functPDOaccessObject,
+                                          ODdata, SDObuffer, length, false);
+        if(ret < 0){
+            return CO_SDO_AB_DATA_LOC_CTRL;
+        }
+        copied = ret > 0;
     }
+
     /* if domain, Object dictionary function MUST exist */
-    else{
-        if(ext->pODFunc == NULL){
-            CO_UNLOCK_OD();
-            return CO_SDO_AB_DEVICE_INCOMPAT;     /* general internal incompatibility in the device */
-        }
+    if(ODdata == NULL && ext->pODFunc == NULL){
+        return CO_SDO_AB_DEVICE_INCOMPAT;     /* general internal incompatibility in the device */
     }
 
-    /* call Object dictionary function if registered */
+    /* consistent copy without Object dictionary function needs no lock */
     SDO->ODF_arg.reading = true;
-    if(ext->pODFunc != NULL){
-        uint32_t abortCode = ext->pODFunc(&SDO->ODF_arg);
-        if(abortCode != 0U){
-            CO_UNLOCK_OD();
-            return abortCode;
+    if(!copied || ext->pODFunc != NULL){
+        CO_LOCK_OD();
+
+        /* copy data from OD to SDO buffer if not domain */
+        if(ODdata != NULL && !copied){
+            while(length--) *(SDObuffer++) = *(ODdata++);
         }
 
-        /* dataLength (upadted by pODFunc) must be inside limits */
-        if((SDO->ODF_arg.dataLength == 0U) || (SDO->ODF_arg.dataLength > SDOBufferSize)){
-            CO_UNLOCK_OD();
-            return CO_SDO_AB_DEVICE_INCOMPAT;     /* general internal incompatibility in the device */
+        /* call Object dictionary function if registered */
+        if(ext->pODFunc != NULL){
+            uint32_t abortCode = ext->pODFunc(&SDO->ODF_arg);
+            if(abortCode != 0U){
+                CO_UNLOCK_OD();
+                return abortCode;
+            }
+
+            /* dataLength (upadted by pODFunc) must be inside limits */
+            if((SDO->ODF_arg.dataLength == 0U) || (SDO->ODF_arg.dataLength > SDOBufferSize)){
+                CO_UNLOCK_OD();
+                return CO_SDO_AB_DEVICE_INCOMPAT;     /* general internal incompatibility in the device */
+            }
         }
-    }
 
-    CO_UNLOCK_OD();
+        CO_UNLOCK_OD();
+    }
 
     SDO->ODF_arg.offset += SDO->ODF_arg.dataLength;
     SDO->ODF_arg.firstSegment = false;
@@ -693,134 +963,733 @@ uint32_t CO_SDO_readOD(CO_SDO_t *SDO, uint16_t SDOBufferSize){
             *(buf2--) = b;
         }
     }
-#endif
+#endif
+
+    return 0U;
+}
+
+
+/******************************************************************************/
+uint32_t CO_SDO_writeOD(CO_SDO_t *SDO, uint16_t length){
+    uint8_t *SDObuffer = SDO->ODF_arg.data;
+    uint8_t *ODdata = (uint8_t*)SDO->ODF_arg.ODdataStorage;
+    bool_t exception_1003 = false;
+
+    /* is object writeable? */
+    if((SDO->ODF_arg.attribute & CO_ODA_WRITEABLE) == 0){
+        return CO_SDO_AB_READONLY;     /* attempt to write a read-only object */
+    }
+
+    /* length of domain data is application specific and not verified */
+    if(ODdata == 0){
+        SDO->ODF_arg.dataLength = length;
+    }
+
+    /* verify length except for domain data type */
+    else if(SDO->ODF_arg.dataLength != length){
+        return CO_SDO_AB_TYPE_MISMATCH;     /* Length of service parameter does not match */
+    }
+
+    /* swap data if processor is not little endian (CANopen is) */
+#ifdef CO_BIG_ENDIAN
+    if((SDO->ODF_arg.attribute & CO_ODA_MB_VALUE) != 0){
+        uint16_t len = SDO->ODF_arg.dataLength;
+        uint8_t *buf1 = SDO->ODF_arg.data;
+        uint8_t *buf2 = buf1 + len - 1;
+
+        len /= 2;
+        while(len--){
+            uint8_t b = *buf1;
+            *(buf1++) = *buf2;
+            *(buf2--) = b;
+        }
+    }
+#endif
+
+    CO_LOCK_OD();
+
+    /* call Object dictionary function if registered */
+    SDO->ODF_arg.reading = false;
+    if(SDO->ODExtensions != NULL){
+        CO_OD_extension_t *ext = &SDO->ODExtensions[SDO->entryNo];
+
+        if(ext->pODFunc != NULL){
+            uint32_t abortCode = ext->pODFunc(&SDO->ODF_arg);
+            if(abortCode != 0U){
+                CO_UNLOCK_OD();
+                return abortCode;
+            }
+        }
+    }
+    SDO->ODF_arg.offset += SDO->ODF_arg.dataLength;
+    SDO->ODF_arg.firstSegment = false;
+
+    /* Special exception: 1003,00 is writable from network, but not in OD  */
+    if(SDO->ODF_arg.index == 0x1003 && SDO->ODF_arg.subIndex == 0) {
+        exception_1003 = true;
+    }
+
+    /* copy data from SDO buffer to OD if not domain */
+    if((ODdata != NULL) && !exception_1003){
+        CO_OD_snapshot_t *snap = (SDO->ODExtensions != NULL) ?
+                                 SDO->ODExtensions[SDO->entryNo].snapshot : NULL;
+
+        if(snap != NULL && ODdata >= snap->data &&
+           (uint32_t)(ODdata - snap->data) + length <= snap->size)
+        {
+            /* write shadow of the snapshot region and publish it */
+            uint8_t *shadow = &snap->shadow[ODdata - snap->data];
+
+            while(length--){
+                *(shadow++) = *(SDObuffer++);
+            }
+            CO_OD_snapshot_publish(snap);
+        }
+        else{
+            /* variable mapped to PDO is written under its sequence lock */
+            int8_t ret = 0;
+
+            if(SDO->pFunctPDOaccess != NULL){
+                ret = SDO->pFunctPDOaccess(SDO->functPDOaccessObject,
+                                           ODdata, SDObuffer, length, true);
+            }
+            if(ret < 0){
+                CO_UNLOCK_OD();
+                return CO_SDO_AB_DATA_LOC_CTRL;
+            }
+            if(ret == 0){
+                while(length--){
+                    *(ODdata++) = *(SDObuffer++);
+                }
+            }
+        }
+    }
+
+    CO_UNLOCK_OD();
+
+    return 0;
+}
+
+/******************************************************************************/
+static void CO_SDO_process_done(CO_SDO_t *SDO, uint32_t *timerNext_us) {
+#if CO_SDO_RX_DATA_SIZE > 1
+    uint8_t proc = SDO->CANrxProc;
+    uint8_t newProc = proc;
+
+    /* check if buffer needs to be free */
+    if (!IS_CANrxNew(SDO->CANrxNew[proc])){
+        return;
+    }
+
+    if (++newProc >= CO_SDO_RX_DATA_SIZE)
+        newProc = 0;
+
+    SDO->CANrxProc = newProc;
+    CLEAR_CANrxNew(SDO->CANrxNew[proc]);
+
+    if ((timerNext_us != NULL) && (IS_CANrxNew(SDO->CANrxNew[newProc]))){
+        /* Set timerNext_us to 0 to inform OS to call CO_SDO_process function again without delay */
+        *timerNext_us = 0;
+    }
+#else
+    (void)(timerNext_us);
+    CLEAR_CANrxNew(SDO->CANrxNew[0]);
+#endif
+}
+
+/******************************************************************************/
+void CO_SDO_blkAdaptInit(CO_SDO_blkAdapt_t *blkAdapt, uint8_t blksizeMax){
+    if(blksizeMax < 1U || blksizeMax > 127U){
+        blksizeMax = 127U;
+    }
+    blkAdapt->blksize = blksizeMax;
+    blkAdapt->blksizeMax = blksizeMax;
+    blkAdapt->blksizeMin = 1U;
+    blkAdapt->increase = CO_SDO_BLKSIZE_INCREASE;
+    CO_SDO_blkAdaptStart(blkAdapt);
+}
+
+
+/******************************************************************************/
+void CO_SDO_blkAdaptStart(CO_SDO_blkAdapt_t *blkAdapt){
+    blkAdapt->bytes = 0U;
+    blkAdapt->segments = 0U;
+    blkAdapt->segmentsLost = 0U;
+    blkAdapt->subblocks = 0U;
+    blkAdapt->subblocksLost = 0U;
+    blkAdapt->time_us = 0U;
+}
+
+
+/******************************************************************************/
+bool_t CO_SDO_blkAdaptStats(
+        CO_SDO_blkAdapt_t      *blkAdapt,
+        uint8_t                 blksize,
+        uint8_t                 ackseq,
+        bool_t                  lastSubblock)
+{
+    bool_t lost = false;
+
+    if(ackseq > blksize){
+        ackseq = blksize;
+    }
+    blkAdapt->bytes += (uint32_t)ackseq * 7U;
+    blkAdapt->subblocks++;
+
+    if(lastSubblock){
+        /* sub-block may be shorter */
+        blkAdapt->segments += ackseq;
+    }
+    else{
+        blkAdapt->segments += blksize;
+        if(ackseq < blksize){
+            blkAdapt->segmentsLost += blksize - ackseq;
+            blkAdapt->subblocksLost++;
+            lost = true;
+        }
+    }
+
+    return lost;
+}
+
+
+/******************************************************************************/
+uint8_t CO_SDO_blkAdaptUpdate(
+        CO_SDO_blkAdapt_t      *blkAdapt,
+        uint8_t                 blksize,
+        uint8_t                 ackseq,
+        bool_t                  lastSubblock)
+{
+    uint8_t window = blkAdapt->blksize;
+
+    if(CO_SDO_blkAdaptStats(blkAdapt, blksize, ackseq, lastSubblock)){
+        /* multiplicative decrease */
+        window /= 2U;
+    }
+    else if(!lastSubblock){
+        /* additive increase, shorter last sub-block does not change block size */
+        window = (window > (127U - blkAdapt->increase)) ? 127U : (window + blkAdapt->increase);
+    }
+
+    if(window > blkAdapt->blksizeMax){
+        window = blkAdapt->blksizeMax;
+    }
+    if(window < blkAdapt->blksizeMin){
+        window = blkAdapt->blksizeMin;
+    }
+    if(window < 1U){
+        window = 1U;
+    }
+    blkAdapt->blksize = window;
+
+    return window;
+}
+
+
+/******************************************************************************/
+uint32_t CO_SDO_blkAdaptGoodput(const CO_SDO_blkAdapt_t *blkAdapt){
+    uint32_t time_ms;
+
+    if(blkAdapt->time_us == 0U){
+        return 0U;
+    }
+    if(blkAdapt->bytes <= (0xFFFFFFFFUL / 1000000UL)){
+        return blkAdapt->bytes * 1000000UL / blkAdapt->time_us;
+    }
+    time_ms = (blkAdapt->time_us < 1000U) ? 1U : (blkAdapt->time_us / 1000U);
+    if(blkAdapt->bytes > (0xFFFFFFFFUL / 1000U)){
+        return blkAdapt->bytes / time_ms * 1000U;
+    }
+    return blkAdapt->bytes * 1000U / time_ms;
+}
+
+
+/******************************************************************************/
+static void CO_SDO_abort(CO_SDO_t *SDO, uint32_t code){
+    SDO->CANtxBuff->data[0] = 0x80;
+    SDO->CANtxBuff->data[1] = SDO->ODF_arg.index & 0xFF;
+    SDO->CANtxBuff->data[2] = (SDO->ODF_arg.index>>8) & 0xFF;
+    SDO->CANtxBuff->data[3] = SDO->ODF_arg.subIndex;
+    CO_memcpySwap4(&SDO->CANtxBuff->data[4], &code);
+    SDO->state = CO_SDO_ST_IDLE;
+
+    /* skip all received message in queue if any */
+    while (IS_CANrxNew(SDO->CANrxNew[SDO->CANrxProc]))
+        CO_SDO_process_done(SDO, NULL);
+
+    CO_CANsend(SDO->CANdevTx, SDO->CANtxBuff);
+}
+
+
+/*
+ * Complete access to the entry protected with snapshot region: read all
+ * sub-indexes from subIndex on into the buffer with one consistent copy, so
+ * array or record is never mixed from two published versions. Entry with
+ * Object dictionary function or larger than CO_SDO_BUFFER_SIZE is not
+ * loaded here, its sub-indexes are read one by one.
+ *
+ * @param loaded Set to true, if all sub-indexes are in the buffer.
+ *
+ * @return 0 or SDO abort code.
+ */
+static uint32_t CO_SDO_caLoadSnapshot(CO_SDO_t *SDO, uint8_t subIndex, bool_t *loaded){
+    CO_OD_extension_t *ext;
+    CO_OD_snapshot_t *snap;
+    uint8_t maxSubIndex = SDO->OD[SDO->entryNo].maxSubIndex;
+    uint16_t total = 0U;
+    uint8_t retry;
+    uint16_t i;
+
+    *loaded = false;
+    if(SDO->ODExtensions == NULL){
+        return 0U;
+    }
+    ext = &SDO->ODExtensions[SDO->entryNo];
+    snap = ext->snapshot;
+    if(snap == NULL || ext->pODFunc != NULL){
+        return 0U;
+    }
+
+    /* verify sub-indexes and size */
+    for(i=subIndex; i<=maxSubIndex; i++){
+        if((CO_OD_getAttribute(SDO, SDO->entryNo, (uint8_t)i) & CO_ODA_READABLE) == 0){
+            return CO_SDO_AB_WRITEONLY;     /* attempt to read a write-only object */
+        }
+        if(CO_OD_getDataPointer(SDO, SDO->entryNo, (uint8_t)i) == NULL){
+            return CO_SDO_AB_UNSUPPORTED_ACCESS; /* domain has no fixed length */
+        }
+        total += CO_OD_getLength(SDO, SDO->entryNo, (uint8_t)i);
+        if(total > CO_SDO_BUFFER_SIZE){
+            return 0U;
+        }
+    }
+
+    for(retry=0; retry<=CO_OD_SNAPSHOT_RETRIES; retry++){
+        uint32_t seq = snap->seq;
+
+        CO_OD_SNAPSHOT_BARRIER();
+        if((seq & 1U) == 0U){
+            uint8_t *buf = SDO->databuffer;
+
+            /* variables outside the region (subIndex 0 of array) are constant */
+            for(i=subIndex; i<=maxSubIndex; i++){
+                const uint8_t *ODdata = (const uint8_t*)CO_OD_getDataPointer(SDO, SDO->entryNo, (uint8_t)i);
+                uint16_t length = CO_OD_getLength(SDO, SDO->entryNo, (uint8_t)i);
+
+                while(length--) *(buf++) = *(ODdata++);
+            }
+            CO_OD_SNAPSHOT_BARRIER();
+            if(snap->seq == seq){
+                break;
+            }
+        }
+        if(retry < CO_OD_SNAPSHOT_RETRIES){
+            snap->readRetries++;
+        }
+    }
+    if(retry > CO_OD_SNAPSHOT_RETRIES){
+        snap->readFailures++;
+        return CO_SDO_AB_DATA_LOC_CTRL;
+    }
+
+    /* swap data if processor is not little endian (CANopen is) */
+#ifdef CO_BIG_ENDIAN
+    {
+        uint8_t *buf = SDO->databuffer;
+
+        for(i=subIndex; i<=maxSubIndex; i++){
+            uint16_t len = CO_OD_getLength(SDO, SDO->entryNo, (uint8_t)i);
+
+            if((CO_OD_getAttribute(SDO, SDO->entryNo, (uint8_t)i) & CO_ODA_MB_VALUE) != 0){
+                uint8_t *buf1 = buf;
+                uint8_t *buf2 = buf + len - 1;
+                uint16_t n = len / 2;
+
+                while(n--){
+                    uint8_t b = *buf1;
+                    *(buf1++) = *buf2;
+                    *(buf2--) = b;
+                }
+            }
+            buf += len;
+        }
+    }
+#endif
+
+    SDO->ODF_arg.dataLength = total;
+    *loaded = true;
+
+    return 0U;
+}
+
+
+/*
+ * Complete access: read the subIndex of the current array or record into the
+ * buffer. Entry with snapshot region is read whole at once. Size of the whole
+ * transfer is not indicated.
+ *
+ * @return 0 or SDO abort code.
+ */
+static uint32_t CO_SDO_caLoad(CO_SDO_t *SDO, uint8_t subIndex){
+    uint32_t abortCode;
+    bool_t loaded = false;
+
+    abortCode = CO_SDO_initTransfer(SDO, SDO->ODF_arg.index, subIndex);
+    if((abortCode == 0U) && (SDO->ODF_arg.ODdataStorage == NULL)){
+        abortCode = CO_SDO_AB_UNSUPPORTED_ACCESS; /* domain has no fixed length */
+    }
+    if(abortCode == 0U){
+        abortCode = CO_SDO_caLoadSnapshot(SDO, subIndex, &loaded);
+    }
+    if((abortCode == 0U) && !loaded){
+        abortCode = CO_SDO_readOD(SDO, CO_SDO_BUFFER_SIZE);
+    }
+
+    SDO->ODF_arg.dataLengthTotal = 0U;
+    SDO->completeAccess = true;
+    SDO->caSubIndex = loaded ? SDO->OD[SDO->entryNo].maxSubIndex : subIndex;
+    SDO->bufferOffset = 0U;
+
+    return abortCode;
+}
+
+
+/*
+ * Helper functions for streaming domain, see CO_SDO_stream_t.
+ *
+ * Get number of bytes available in the window of the stream at absolute
+ * offset. New window is requested from application, if offset is outside
+ * the current window.
+ *
+ * @return 0 or SDO abort code.
+ */
+static uint32_t CO_SDO_streamAvailable(CO_SDO_t *SDO, uint32_t offset, uint32_t *available){
+    uint32_t total = SDO->ODF_arg.dataLengthTotal;
+
+    *available = 0U;
+
+    /* end of data by upload, if size is known */
+    if(SDO->ODF_arg.reading && (total != 0U) && (offset >= total)){
+        return 0U;
+    }
+
+    if((SDO->window == NULL) || (offset < SDO->windowOffset) ||
+       ((offset - SDO->windowOffset) >= SDO->windowSize))
+    {
+        uint8_t *window = NULL;
+        uint32_t windowSize = 0U;
+        uint32_t abortCode;
+
+        abortCode = SDO->stream->getWindow(SDO->stream->object, &SDO->ODF_arg,
+                                           offset, &window, &windowSize);
+        if(abortCode != 0U){
+            return abortCode;
+        }
+        if((window == NULL) && (windowSize != 0U)){
+            return CO_SDO_AB_DEVICE_INCOMPAT;
+        }
+        SDO->window = window;
+        SDO->windowOffset = offset;
+        SDO->windowSize = windowSize;
+        total = SDO->ODF_arg.dataLengthTotal;
+        if(windowSize == 0U){
+            return 0U;
+        }
+    }
+
+    *available = SDO->windowSize - (offset - SDO->windowOffset);
+    if(SDO->ODF_arg.reading && (total != 0U) && (*available > (total - offset))){
+        *available = total - offset;
+    }
+
+    return 0U;
+}
+
+/*
+ * Copy up to 7 bytes from the stream at absolute offset into segment.
+ *
+ * @param pLen Returns number of copied bytes.
+ * @param pLast Returns true, if there are no more data after the segment.
+ *
+ * @return 0 or SDO abort code.
+ */
+static uint32_t CO_SDO_streamReadSegment(CO_SDO_t *SDO, uint32_t offset, uint8_t segment[], uint16_t *pLen, bool_t *pLast){
+    uint16_t len = 0U;
+    uint32_t available = 0U;
+    uint32_t abortCode;
+
+    while(len < 7U){
+        const uint8_t *src;
+
+        abortCode = CO_SDO_streamAvailable(SDO, offset + len, &available);
+        if(abortCode != 0U){
+            return abortCode;
+        }
+        if(available == 0U){
+            break;
+        }
+        src = &SDO->window[offset + len - SDO->windowOffset];
+        while((len < 7U) && (available > 0U)){
+            segment[len++] = *(src++);
+            available--;
+        }
+    }
+
+    *pLen = len;
+    if(len < 7U){
+        *pLast = true;
+    }
+    else{
+        /* look ahead for the end of data */
+        abortCode = CO_SDO_streamAvailable(SDO, offset + 7U, &available);
+        if(abortCode != 0U){
+            return abortCode;
+        }
+        *pLast = (available == 0U) ? true : false;
+    }
+
+    return 0U;
+}
+
+/*
+ * Inform application about data written into the stream since previous call.
+ *
+ * @return 0 or SDO abort code.
+ */
+static uint32_t CO_SDO_streamCommit(CO_SDO_t *SDO){
+    uint32_t abortCode = 0U;
+    uint32_t length = SDO->streamOffset - SDO->streamMark;
+
+    if((SDO->stream->commit != NULL) && ((length != 0U) || SDO->ODF_arg.lastSegment)){
+        abortCode = SDO->stream->commit(SDO->stream->object, &SDO->ODF_arg,
+                                        SDO->streamMark, length);
+        SDO->ODF_arg.firstSegment = false;
+    }
+    SDO->ODF_arg.offset = SDO->streamOffset;
+    SDO->streamMark = SDO->streamOffset;
+
+    return abortCode;
+}
+
+/*
+ * Write data into the stream at streamOffset. Full windows are committed.
+ *
+ * @return 0 or SDO abort code.
+ */
+static uint32_t CO_SDO_streamWrite(CO_SDO_t *SDO, const uint8_t data[], uint16_t length){
+    while(length > 0U){
+        uint32_t available;
+        uint32_t abortCode;
+        uint8_t *dest;
+
+        abortCode = CO_SDO_streamAvailable(SDO, SDO->streamOffset, &available);
+        if(abortCode != 0U){
+            return abortCode;
+        }
+        if(available == 0U){
+            return CO_SDO_AB_DATA_LONG;  /* Length of service parameter too high */
+        }
+
+        dest = &SDO->window[SDO->streamOffset - SDO->windowOffset];
+        if(available > length){
+            available = length;
+        }
+        length -= (uint16_t)available;
+        SDO->streamOffset += available;
+        while(available-- > 0U){
+            *(dest++) = *(data++);
+        }
+
+        /* window is full */
+        if((SDO->streamOffset - SDO->windowOffset) >= SDO->windowSize){
+            abortCode = CO_SDO_streamCommit(SDO);
+            if(abortCode != 0U){
+                return abortCode;
+            }
+        }
+    }
+
+    return 0U;
+}
+
+/*
+ * Prepare buffer for next sub-block of stream block download. Segments are
+ * written directly into the window, if there is space for at least one
+ * segment, otherwise into databuffer.
+ *
+ * @return 0 or SDO abort code.
+ */
+static uint32_t CO_SDO_streamPrepareBlock(CO_SDO_t *SDO){
+    uint32_t available;
+    uint32_t abortCode;
+
+    abortCode = CO_SDO_streamAvailable(SDO, SDO->streamOffset, &available);
+    if(abortCode != 0U){
+        return abortCode;
+    }
+
+    if(available >= 7U){
+        SDO->ODF_arg.data = &SDO->window[SDO->streamOffset - SDO->windowOffset];
+        SDO->bufferSize = (available > (7U*127U)) ? (7U*127U) : (uint16_t)available;
+        SDO->streamDirect = true;
+    }
+    else{
+        SDO->ODF_arg.data = SDO->databuffer;
+        SDO->bufferSize = CO_SDO_BUFFER_SIZE;
+        SDO->streamDirect = false;
+    }
+    SDO->bufferOffset = 0U;
+
+    return 0U;
+}
+
+/*
+ * Move received sub-block of stream block download into the stream.
+ *
+ * @return 0 or SDO abort code.
+ */
+static uint32_t CO_SDO_streamFlushBlock(CO_SDO_t *SDO){
+    uint32_t abortCode = 0U;
+
+    if(SDO->crcEnabled){
+        SDO->crc = crc16_ccitt_CO(SDO->ODF_arg.data, SDO->bufferOffset, SDO->crc);
+    }
+
+    if(SDO->streamDirect){
+        /* data are already in the window */
+        SDO->streamOffset += SDO->bufferOffset;
+        if(((SDO->streamOffset - SDO->windowOffset) >= SDO->windowSize) || SDO->ODF_arg.lastSegment){
+            abortCode = CO_SDO_streamCommit(SDO);
+        }
+    }
+    else{
+        abortCode = CO_SDO_streamWrite(SDO, SDO->databuffer, SDO->bufferOffset);
+        if((abortCode == 0U) && SDO->ODF_arg.lastSegment){
+            abortCode = CO_SDO_streamCommit(SDO);
+        }
+    }
+    SDO->bufferOffset = 0U;
 
-    return 0U;
+    return abortCode;
 }
 
 
-/******************************************************************************/
-uint32_t CO_SDO_writeOD(CO_SDO_t *SDO, uint16_t length){
-    uint8_t *SDObuffer = SDO->ODF_arg.data;
-    uint8_t *ODdata = (uint8_t*)SDO->ODF_arg.ODdataStorage;
-    bool_t exception_1003 = false;
-
-    /* is object writeable? */
-    if((SDO->ODF_arg.attribute & CO_ODA_WRITEABLE) == 0){
-        return CO_SDO_AB_READONLY;     /* attempt to write a read-only object */
+/*
+ * Get number of segments for the next sub-block of block download.
+ */
+static uint8_t CO_SDO_downloadBlksize(CO_SDO_t *SDO){
+    uint16_t len = SDO->bufferSize - SDO->bufferOffset;
+    uint8_t blksize = (len > (7*127)) ? 127 : (uint8_t)(len / 7);
+
+#if CO_SDO_BLK_RX_SEGMENTS > 0
+    /* domain is emptied by CO_SDO_blkRxConsume(), so whole ring can be used */
+    if((SDO->ODF_arg.ODdataStorage == 0) || (blksize > (CO_SDO_BLK_RX_SEGMENTS - 1))){
+        blksize = CO_SDO_BLK_RX_SEGMENTS - 1;
     }
+#endif
 
-    /* length of domain data is application specific and not verified */
-    if(ODdata == 0){
-        SDO->ODF_arg.dataLength = length;
+    /* adapted block size */
+    if((blksize > SDO->blkAdapt.blksize) && (SDO->blkAdapt.blksize != 0U)){
+        blksize = SDO->blkAdapt.blksize;
     }
 
-    /* verify length except for domain data type */
-    else if(SDO->ODF_arg.dataLength != length){
-        return CO_SDO_AB_TYPE_MISMATCH;     /* Length of service parameter does not match */
-    }
+    return blksize;
+}
 
-    /* swap data if processor is not little endian (CANopen is) */
-#ifdef CO_BIG_ENDIAN
-    if((SDO->ODF_arg.attribute & CO_ODA_MB_VALUE) != 0){
-        uint16_t len = SDO->ODF_arg.dataLength;
-        uint8_t *buf1 = SDO->ODF_arg.data;
-        uint8_t *buf2 = buf1 + len - 1;
 
-        len /= 2;
-        while(len--){
-            uint8_t b = *buf1;
-            *(buf1++) = *buf2;
-            *(buf2--) = b;
-        }
-    }
-#endif
+#if CO_SDO_BLK_RX_SEGMENTS > 0
+/*
+ * Consume all segments from the block download ring into the SDO buffer.
+ * Domain data are passed to the Object dictionary (or stream) whenever the
+ * buffer becomes full, CRC is calculated on each passed part.
+ *
+ * @return 0 or SDO abort code.
+ */
+static uint32_t CO_SDO_blkRxConsume(CO_SDO_t *SDO){
+    uint8_t tail = SDO->blkRxTail;
+    uint8_t head = SDO->blkRxHead;
 
-    CO_LOCK_OD();
+    CANrxMemoryBarrier();
 
-    /* call Object dictionary function if registered */
-    SDO->ODF_arg.reading = false;
-    if(SDO->ODExtensions != NULL){
-        CO_OD_extension_t *ext = &SDO->ODExtensions[SDO->entryNo];
+    while(tail != head){
+        const uint8_t *segment = SDO->blkRxRing[tail];
+        uint8_t i;
 
-        if(ext->pODFunc != NULL){
-            uint32_t abortCode = ext->pODFunc(&SDO->ODF_arg);
+        /* make space in the buffer */
+        if((SDO->bufferSize - SDO->bufferOffset) < 7){
+            uint32_t abortCode;
+
+            if(SDO->stream != NULL){
+                SDO->ODF_arg.lastSegment = false;
+                abortCode = CO_SDO_streamFlushBlock(SDO);
+                if(abortCode == 0U){
+                    abortCode = CO_SDO_streamPrepareBlock(SDO);
+                }
+            }
+            else if(SDO->ODF_arg.ODdataStorage == 0){
+                if(SDO->crcEnabled){
+                    SDO->crc = crc16_ccitt_CO(SDO->ODF_arg.data, SDO->bufferOffset, SDO->crc);
+                }
+                SDO->ODF_arg.lastSegment = false;
+                abortCode = CO_SDO_writeOD(SDO, SDO->bufferOffset);
+                SDO->ODF_arg.dataLength = CO_SDO_BUFFER_SIZE;
+                SDO->bufferOffset = 0U;
+            }
+            else{
+                abortCode = CO_SDO_AB_DATA_LONG;  /* Length of service parameter too high */
+            }
             if(abortCode != 0U){
-                CO_UNLOCK_OD();
                 return abortCode;
             }
         }
-    }
-    SDO->ODF_arg.offset += SDO->ODF_arg.dataLength;
-    SDO->ODF_arg.firstSegment = false;
 
-    /* Special exception: 1003,00 is writable from network, but not in OD  */
-    if(SDO->ODF_arg.index == 0x1003 && SDO->ODF_arg.subIndex == 0) {
-        exception_1003 = true;
-    }
+        for(i=0U; i<7U; i++){
+            SDO->ODF_arg.data[SDO->bufferOffset++] = segment[i];
+        }
 
-    /* copy data from SDO buffer to OD if not domain */
-    if((ODdata != NULL) && !exception_1003){
-        while(length--){
-            *(ODdata++) = *(SDObuffer++);
+        if(++tail >= CO_SDO_BLK_RX_SEGMENTS){
+            tail = 0U;
         }
+        CANrxMemoryBarrier();
+        SDO->blkRxTail = tail;
     }
 
-    CO_UNLOCK_OD();
-
-    return 0;
+    return 0U;
 }
+#endif
 
-/******************************************************************************/
-static void CO_SDO_process_done(CO_SDO_t *SDO, uint16_t *timerNext_ms) {
-#if CO_SDO_RX_DATA_SIZE > 1
-    uint8_t proc = SDO->CANrxProc;
-    uint8_t newProc = proc;
-
-    /* check if buffer needs to be free */
-    if (!IS_CANrxNew(SDO->CANrxNew[proc])){
-        return;
-    }
 
-    if (++newProc >= CO_SDO_RX_DATA_SIZE)
-        newProc = 0;
+/******************************************************************************/
+int8_t CO_SDO_process(
+        CO_SDO_t               *SDO,
+        bool_t                  NMTisPreOrOperational,
+        uint16_t                timeDifference_ms,
+        uint16_t                SDOtimeoutTime,
+        uint16_t               *timerNext_ms)
+{
+    uint32_t timerNext_us = 1U;
+    int8_t ret;
 
-    SDO->CANrxProc = newProc;
-    CLEAR_CANrxNew(SDO->CANrxNew[proc]);
+    ret = CO_SDO_process_us(SDO, NMTisPreOrOperational,
+                            (uint32_t)timeDifference_ms * 1000U,
+                            (uint32_t)SDOtimeoutTime * 1000U,
+                            (timerNext_ms != NULL) ? &timerNext_us : NULL);
 
-    if ((timerNext_ms != NULL) && (IS_CANrxNew(SDO->CANrxNew[newProc]))){
-        /* Set timerNext_ms to 0 to inform OS to call CO_SDO_process function again without delay */
-        timerNext_ms = 0;
+    if((timerNext_ms != NULL) && (timerNext_us == 0U)){
+        *timerNext_ms = 0U;
     }
-#else
-    (void)(timerNext_ms);
-    CLEAR_CANrxNew(SDO->CANrxNew[0]);
-#endif
-}
-
-/******************************************************************************/
-static void CO_SDO_abort(CO_SDO_t *SDO, uint32_t code){
-    SDO->CANtxBuff->data[0] = 0x80;
-    SDO->CANtxBuff->data[1] = SDO->ODF_arg.index & 0xFF;
-    SDO->CANtxBuff->data[2] = (SDO->ODF_arg.index>>8) & 0xFF;
-    SDO->CANtxBuff->data[3] = SDO->ODF_arg.subIndex;
-    CO_memcpySwap4(&SDO->CANtxBuff->data[4], &code);
-    SDO->state = CO_SDO_ST_IDLE;
-
-    /* skip all received message in queue if any */
-    while (IS_CANrxNew(SDO->CANrxNew[SDO->CANrxProc]))
-        CO_SDO_process_done(SDO, NULL);
 
-    CO_CANsend(SDO->CANdevTx, SDO->CANtxBuff);
+    return ret;
 }
 
+
 /******************************************************************************/
-int8_t CO_SDO_process(
+int8_t CO_SDO_process_us(
         CO_SDO_t               *SDO,
         bool_t                  NMTisPreOrOperational,
-        uint16_t                timeDifference_ms,
-        uint16_t                SDOtimeoutTime,
-        uint16_t               *timerNext_ms)
+        uint32_t                timeDifference_us,
+        uint32_t                SDOtimeoutTime_us,
+        uint32_t               *timerNext_us)
 {
     CO_SDO_state_t state = CO_SDO_ST_IDLE;
     bool_t sendResponse = false;
@@ -840,10 +1709,21 @@ int8_t CO_SDO_process(
         SDO->state = CO_SDO_ST_IDLE;
 
         /* free receive buffer if it is not empty */
-        CO_SDO_process_done(SDO, timerNext_ms);
+        CO_SDO_process_done(SDO, timerNext_us);
         return 0;
     }
 
+#if CO_SDO_BLK_RX_SEGMENTS > 0
+    /* consume segments of the sub-block being received */
+    if(SDO->state == CO_SDO_ST_DOWNLOAD_BL_SUBBLOCK){
+        uint32_t abortCode = CO_SDO_blkRxConsume(SDO);
+        if(abortCode != 0U){
+            CO_SDO_abort(SDO, abortCode);
+            return -1;
+        }
+    }
+#endif
+
     CANrxData = SDO->CANrxData[proc];
 
     /* Is something new to process? */
@@ -859,7 +1739,7 @@ int8_t CO_SDO_process(
         /* Is abort from client? */
         if(isNew && (CANrxData[0] == CCS_ABORT)){
             SDO->state = CO_SDO_ST_IDLE;
-            CO_SDO_process_done(SDO, timerNext_ms);
+            CO_SDO_process_done(SDO, timerNext_us);
             return -1;
         }
 
@@ -882,6 +1762,7 @@ int8_t CO_SDO_process(
             /* init ODF_arg */
             index = CANrxData[2];
             index = index << 8 | CANrxData[1];
+            CO_SDO_blkAdaptStart(&SDO->blkAdapt);
             abortCode = CO_SDO_initTransfer(SDO, index, CANrxData[3]);
             if(abortCode != 0U){
                 CO_SDO_abort(SDO, abortCode);
@@ -906,14 +1787,37 @@ int8_t CO_SDO_process(
 
             /* upload */
             else{
-                abortCode = CO_SDO_readOD(SDO, CO_SDO_BUFFER_SIZE);
+                uint32_t dataLength;
+
+                if((CCS == CCS_UPLOAD_INITIATE) && ((CANrxData[0] & 0x10U) != 0U)){
+                    /* complete access, only arrays and records from subIndex 0 or 1 */
+                    if((SDO->OD[SDO->entryNo].maxSubIndex == 0U) || (CANrxData[3] > 1U)){
+                        abortCode = CO_SDO_AB_UNSUPPORTED_ACCESS;
+                    }
+                    else{
+                        abortCode = CO_SDO_caLoad(SDO, CANrxData[3]);
+                    }
+                    dataLength = 0xFFFFFFFFUL;
+                }
+                else if(SDO->stream != NULL){
+                    /* get the first window, application may set dataLengthTotal */
+                    SDO->ODF_arg.reading = true;
+                    abortCode = CO_SDO_streamAvailable(SDO, 0U, &dataLength);
+                    if((abortCode == 0U) && (SDO->ODF_arg.dataLengthTotal == 0U) && (dataLength != 0U)){
+                        dataLength = 0xFFFFFFFFUL; /* size is not known */
+                    }
+                }
+                else{
+                    abortCode = CO_SDO_readOD(SDO, CO_SDO_BUFFER_SIZE);
+                    dataLength = SDO->ODF_arg.dataLength;
+                }
                 if(abortCode != 0U){
                     CO_SDO_abort(SDO, abortCode);
                     return -1;
                 }
 
                 /* if data size is large enough set state machine to block upload, otherwise set to normal transfer */
-                if((CCS == CCS_UPLOAD_BLOCK) && (SDO->ODF_arg.dataLength > CANrxData[5])){
+                if((CCS == CCS_UPLOAD_BLOCK) && (dataLength > CANrxData[5])){
                     state = CO_SDO_ST_UPLOAD_BL_INITIATE;
                 }
                 else{
@@ -923,11 +1827,16 @@ int8_t CO_SDO_process(
         }
     }
 
+    /* duration of the transfer */
+    if(SDO->state != CO_SDO_ST_IDLE){
+        SDO->blkAdapt.time_us += timeDifference_us;
+    }
+
     /* verify SDO timeout */
-    if(SDO->timeoutTimer < SDOtimeoutTime){
-        SDO->timeoutTimer += timeDifference_ms;
+    if(SDO->timeoutTimer < SDOtimeoutTime_us){
+        SDO->timeoutTimer += timeDifference_us;
     }
-    if(SDO->timeoutTimer >= SDOtimeoutTime){
+    if(SDO->timeoutTimer >= SDOtimeoutTime_us){
         if((SDO->state == CO_SDO_ST_DOWNLOAD_BL_SUBBLOCK) && (!SDO->timeoutSubblockDownolad) && (!SDO->CANtxBuff->bufferFull)){
             /* set indication timeout in sub-block transfer and reset timeout */
             SDO->timeoutSubblockDownolad = true;
@@ -976,7 +1885,17 @@ int8_t CO_SDO_process(
                 SDO->ODF_arg.data[3] = CANrxData[7];
 
                 /* write data to the Object dictionary */
-                abortCode = CO_SDO_writeOD(SDO, len);
+                if(SDO->stream != NULL){
+                    SDO->ODF_arg.reading = false;
+                    SDO->ODF_arg.lastSegment = true;
+                    abortCode = CO_SDO_streamWrite(SDO, SDO->ODF_arg.data, len);
+                    if(abortCode == 0U){
+                        abortCode = CO_SDO_streamCommit(SDO);
+                    }
+                }
+                else{
+                    abortCode = CO_SDO_writeOD(SDO, len);
+                }
                 if(abortCode != 0U){
                     CO_SDO_abort(SDO, abortCode);
                     return -1;
@@ -1026,6 +1945,27 @@ int8_t CO_SDO_process(
             /* get size of data in message */
             len = 7U - ((CANrxData[0] >> 1U) & 0x07U);
 
+            /* streaming domain, write data directly into the window */
+            if(SDO->stream != NULL){
+                SDO->ODF_arg.reading = false;
+                SDO->ODF_arg.lastSegment = ((CANrxData[0] & 0x01U) != 0U) ? true : false;
+                abortCode = CO_SDO_streamWrite(SDO, &CANrxData[1], len);
+                if((abortCode == 0U) && SDO->ODF_arg.lastSegment){
+                    abortCode = CO_SDO_streamCommit(SDO);
+                    SDO->state = CO_SDO_ST_IDLE;
+                }
+                if(abortCode != 0U){
+                    CO_SDO_abort(SDO, abortCode);
+                    return -1;
+                }
+
+                /* download segment response and alternate toggle bit */
+                SDO->CANtxBuff->data[0] = 0x20 | (SDO->sequence ? 0x10 : 0x00);
+                SDO->sequence = (SDO->sequence) ? 0 : 1;
+                sendResponse = true;
+                break;
+            }
+
             /* verify length. Domain data type enables length larger than SDO buffer size */
             if((SDO->bufferOffset + len) > SDO->ODF_arg.dataLength){
                 if(SDO->ODF_arg.ODdataStorage != 0){
@@ -1083,8 +2023,24 @@ int8_t CO_SDO_process(
             SDO->CANtxBuff->data[2] = CANrxData[2];
             SDO->CANtxBuff->data[3] = CANrxData[3];
 
+            /* streaming domain writes segments directly into the window */
+            SDO->bufferOffset = 0U;
+            if(SDO->stream != NULL){
+                SDO->ODF_arg.reading = false;
+                SDO->ODF_arg.lastSegment = false;
+                abortCode = CO_SDO_streamPrepareBlock(SDO);
+                if(abortCode != 0U){
+                    CO_SDO_abort(SDO, abortCode);
+                    return -1;
+                }
+            }
+
             /* blksize */
-            SDO->blksize = (CO_SDO_BUFFER_SIZE > (7*127)) ? 127 : (CO_SDO_BUFFER_SIZE / 7);
+#if CO_SDO_BLK_RX_SEGMENTS > 0
+            SDO->blkRxHead = 0U;
+            SDO->blkRxTail = 0U;
+#endif
+            SDO->blksize = CO_SDO_downloadBlksize(SDO);
             SDO->CANtxBuff->data[4] = SDO->blksize;
 
             /* is CRC enabled */
@@ -1104,7 +2060,6 @@ int8_t CO_SDO_process(
                 }
             }
 
-            SDO->bufferOffset = 0U;
             SDO->sequence = 0U;
             SDO->timeoutSubblockDownolad = false;
             SDO->state = CO_SDO_ST_DOWNLOAD_BL_SUBBLOCK;
@@ -1129,12 +2084,35 @@ int8_t CO_SDO_process(
             SDO->CANtxBuff->data[0] = 0xA2;
             SDO->CANtxBuff->data[1] = SDO->sequence;
 
+            /* adapt block size to the number of segments received */
+            CO_SDO_blkAdaptUpdate(&SDO->blkAdapt, SDO->blksize, SDO->sequence, lastSegmentInSubblock);
+
             /* reset sequence on reception break */
             if (state == CO_SDO_ST_DOWNLOAD_BL_SUB_RESP)
                 SDO->sequence = 0U;
 
+#if CO_SDO_BLK_RX_SEGMENTS > 0
+            /* consume the rest of the sub-block, domain buffer is emptied only when full */
+            abortCode = CO_SDO_blkRxConsume(SDO);
+            if(abortCode != 0U){
+                CO_SDO_abort(SDO, abortCode);
+                return -1;
+            }
+#else
+            /* streaming domain, move data into the stream and prepare next window */
+            if((SDO->stream != NULL) && !lastSegmentInSubblock){
+                abortCode = CO_SDO_streamFlushBlock(SDO);
+                if(abortCode == 0U){
+                    abortCode = CO_SDO_streamPrepareBlock(SDO);
+                }
+                if(abortCode != 0U){
+                    CO_SDO_abort(SDO, abortCode);
+                    return -1;
+                }
+            }
+
             /* empty buffer in domain data type if not last segment */
-            if((SDO->ODF_arg.ODdataStorage == 0) && (SDO->bufferOffset != 0) && !lastSegmentInSubblock){
+            else if((SDO->ODF_arg.ODdataStorage == 0) && (SDO->bufferOffset != 0) && !lastSegmentInSubblock){
                 /* calculate CRC on next bytes, if enabled */
                 if(SDO->crcEnabled){
                     SDO->crc = crc16_ccitt_CO(SDO->ODF_arg.data, SDO->bufferOffset, SDO->crc);
@@ -1151,17 +2129,17 @@ int8_t CO_SDO_process(
                 SDO->ODF_arg.dataLength = CO_SDO_BUFFER_SIZE;
                 SDO->bufferOffset = 0U;
             }
+#endif
 
             /* blksize */
-            len = CO_SDO_BUFFER_SIZE - SDO->bufferOffset;
-            SDO->blksize = (len > (7*127)) ? 127 : (len / 7);
+            SDO->blksize = CO_SDO_downloadBlksize(SDO);
             SDO->CANtxBuff->data[2] = SDO->blksize;
 
             /* set next state */
             if(lastSegmentInSubblock) {
                 SDO->state = CO_SDO_ST_DOWNLOAD_BL_END;
             }
-            else if(SDO->bufferOffset >= CO_SDO_BUFFER_SIZE) {
+            else if(SDO->blksize == 0U) {
                 CO_SDO_abort(SDO, CO_SDO_AB_DEVICE_INCOMPAT);
                 return -1;
             }
@@ -1185,6 +2163,30 @@ int8_t CO_SDO_process(
             /* number of bytes in the last segment of the last block that do not contain data. */
             len = (CANrxData[0]>>2U) & 0x07U;
             SDO->bufferOffset -= len;
+            SDO->blkAdapt.bytes -= len;
+
+            /* streaming domain, CRC is calculated by flush */
+            if(SDO->stream != NULL){
+                uint16_t crc;
+
+                SDO->ODF_arg.lastSegment = true;
+                abortCode = CO_SDO_streamFlushBlock(SDO);
+                if(abortCode != 0U){
+                    CO_SDO_abort(SDO, abortCode);
+                    return -1;
+                }
+
+                CO_memcpySwap2(&crc, &CANrxData[1]);
+                if(SDO->crcEnabled && (SDO->crc != crc)){
+                    CO_SDO_abort(SDO, CO_SDO_AB_CRC);   /* CRC error (block mode only). */
+                    return -1;
+                }
+
+                SDO->CANtxBuff->data[0] = 0xA1;
+                SDO->state = CO_SDO_ST_IDLE;
+                sendResponse = true;
+                break;
+            }
 
             /* calculate and verify CRC, if enabled */
             if(SDO->crcEnabled){
@@ -1220,8 +2222,8 @@ int8_t CO_SDO_process(
             SDO->CANtxBuff->data[2] = CANrxData[2];
             SDO->CANtxBuff->data[3] = CANrxData[3];
 
-            /* Expedited transfer */
-            if(SDO->ODF_arg.dataLength <= 4U){
+            /* Expedited transfer, streaming domain and complete access are always segmented */
+            if((SDO->stream == NULL) && (!SDO->completeAccess) && (SDO->ODF_arg.dataLength <= 4U)){
                 for(i=0U; i<SDO->ODF_arg.dataLength; i++)
                     SDO->CANtxBuff->data[4U+i] = SDO->ODF_arg.data[i];
 
@@ -1267,6 +2269,59 @@ int8_t CO_SDO_process(
                 return -1;
             }
 
+            /* streaming domain, read segment directly from the window */
+            if(SDO->stream != NULL){
+                bool_t last;
+
+                abortCode = CO_SDO_streamReadSegment(SDO, SDO->streamOffset, &SDO->CANtxBuff->data[1], &len, &last);
+                if(abortCode != 0U){
+                    CO_SDO_abort(SDO, abortCode);
+                    return -1;
+                }
+                SDO->streamOffset += len;
+
+                SDO->CANtxBuff->data[0] = 0x00 | (SDO->sequence ? 0x10 : 0x00) | ((7-len)<<1);
+                SDO->sequence = (SDO->sequence) ? 0 : 1;
+                if(last){
+                    SDO->CANtxBuff->data[0] |= 0x01;
+                    SDO->state = CO_SDO_ST_IDLE;
+                }
+                sendResponse = true;
+                break;
+            }
+
+            /* complete access, fill segment from consecutive sub-indexes */
+            if(SDO->completeAccess){
+                uint8_t maxSubIndex = SDO->OD[SDO->entryNo].maxSubIndex;
+
+                len = 0U;
+                while(len < 7U){
+                    if(SDO->bufferOffset < SDO->ODF_arg.dataLength){
+                        SDO->CANtxBuff->data[1U+len] = SDO->ODF_arg.data[SDO->bufferOffset++];
+                        len++;
+                    }
+                    else if(SDO->caSubIndex < maxSubIndex){
+                        abortCode = CO_SDO_caLoad(SDO, SDO->caSubIndex + 1U);
+                        if(abortCode != 0U){
+                            CO_SDO_abort(SDO, abortCode);
+                            return -1;
+                        }
+                    }
+                    else{
+                        break;
+                    }
+                }
+
+                SDO->CANtxBuff->data[0] = 0x00 | (SDO->sequence ? 0x10 : 0x00) | ((7-len)<<1);
+                SDO->sequence = (SDO->sequence) ? 0 : 1;
+                if((SDO->bufferOffset == SDO->ODF_arg.dataLength) && (SDO->caSubIndex == maxSubIndex)){
+                    SDO->CANtxBuff->data[0] |= 0x01;
+                    SDO->state = CO_SDO_ST_IDLE;
+                }
+                sendResponse = true;
+                break;
+            }
+
             /* calculate length to be sent */
             len = SDO->ODF_arg.dataLength - SDO->bufferOffset;
             if(len > 7U) len = 7U;
@@ -1324,10 +2379,11 @@ int8_t CO_SDO_process(
             SDO->CANtxBuff->data[2] = CANrxData[2];
             SDO->CANtxBuff->data[3] = CANrxData[3];
 
-            /* calculate CRC, if enabled */
+            /* calculate CRC, if enabled (streaming domain calculates it while sending) */
             if((CANrxData[0] & 0x04U) != 0U){
                 SDO->crcEnabled = true;
-                SDO->crc = crc16_ccitt_CO(SDO->ODF_arg.data, SDO->ODF_arg.dataLength, 0);
+                SDO->crc = (SDO->stream != NULL) ? 0 :
+                           crc16_ccitt_CO(SDO->ODF_arg.data, SDO->ODF_arg.dataLength, 0);
             }
             else{
                 SDO->crcEnabled = false;
@@ -1345,7 +2401,7 @@ int8_t CO_SDO_process(
 
             /* verify blksize and if SDO data buffer is large enough */
             if((SDO->blksize < 1U) || (SDO->blksize > 127U) ||
-               (((SDO->blksize*7U) > SDO->ODF_arg.dataLength) && (!SDO->ODF_arg.lastSegment))){
+               ((SDO->stream == NULL) && ((SDO->blksize*7U) > SDO->ODF_arg.dataLength) && (!SDO->ODF_arg.lastSegment))){
                 CO_SDO_abort(SDO, CO_SDO_AB_BLOCK_SIZE); /* Invalid block size (block mode only). */
                 return -1;
             }
@@ -1374,9 +2430,11 @@ int8_t CO_SDO_process(
             }
 
             SDO->bufferOffset = 0U;
+            SDO->streamOffset = 0U;
+            SDO->streamMark = 0U;
             SDO->sequence = 0U;
             SDO->endOfTransfer = false;
-            CO_SDO_process_done(SDO, timerNext_ms);
+            CO_SDO_process_done(SDO, timerNext_us);
             isNew = false;
             SDO->state = CO_SDO_ST_UPLOAD_BL_SUBBLOCK;
             /* continue in next case */
@@ -1403,8 +2461,13 @@ int8_t CO_SDO_process(
                     return -1;
                 }
 
+                /* statistics only, block size is determined by client */
+                CO_SDO_blkAdaptStats(&SDO->blkAdapt, SDO->sequence, ackseq, SDO->endOfTransfer);
+
                 /* end of transfer */
                 if((SDO->endOfTransfer) && (ackseq == SDO->blksize)){
+                    SDO->blkAdapt.bytes -= 7U - SDO->lastLen;
+
                     /* first response byte */
                     SDO->CANtxBuff->data[0] = 0xC1 | ((7 - SDO->lastLen) << 2);
 
@@ -1419,49 +2482,63 @@ int8_t CO_SDO_process(
                     break;
                 }
 
-                /* move remaining data to the beginning */
-                for(i=ackseq*7, j=0; i<SDO->ODF_arg.dataLength; i++, j++)
-                    SDO->ODF_arg.data[j] = SDO->ODF_arg.data[i];
-
-                /* set remaining data length in buffer */
-                SDO->ODF_arg.dataLength -= ackseq * 7U;
-
-                /* new block size */
-                SDO->blksize = CANrxData[2];
-
-                /* If data type is domain, re-fill the data buffer if necessary and indicated so. */
-                if((SDO->ODF_arg.ODdataStorage == 0) && (SDO->ODF_arg.dataLength < (SDO->blksize*7U)) && (!SDO->ODF_arg.lastSegment)){
-                    /* move the beginning of the data buffer */
-                    len = SDO->ODF_arg.dataLength; /* length of valid data in buffer */
-                    SDO->ODF_arg.data += len;
-                    SDO->ODF_arg.dataLength = CO_OD_getLength(SDO, SDO->entryNo, SDO->ODF_arg.subIndex) - len;
-
-                    /* read next data from Object dictionary function */
-                    abortCode = CO_SDO_readOD(SDO, CO_SDO_BUFFER_SIZE);
-                    if(abortCode != 0U){
-                        CO_SDO_abort(SDO, abortCode);
+                /* streaming domain, repeat sub-block from the first not acknowledged segment */
+                if(SDO->stream != NULL){
+                    SDO->streamOffset = SDO->streamMark + ackseq * 7U;
+                    SDO->streamMark = SDO->streamOffset;
+                    SDO->blksize = CANrxData[2];
+                    if((SDO->blksize < 1U) || (SDO->blksize > 127U)){
+                        CO_SDO_abort(SDO, CO_SDO_AB_BLOCK_SIZE); /* Invalid block size (block mode only). */
                         return -1;
                     }
-
-                    /* calculate CRC on next bytes, if enabled */
-                    if(SDO->crcEnabled){
-                        SDO->crc = crc16_ccitt_CO(SDO->ODF_arg.data, SDO->ODF_arg.dataLength, SDO->crc);
+                    SDO->sequence = 0U;
+                    SDO->endOfTransfer = false;
+                }
+                else{
+                    /* move remaining data to the beginning */
+                    for(i=ackseq*7, j=0; i<SDO->ODF_arg.dataLength; i++, j++)
+                        SDO->ODF_arg.data[j] = SDO->ODF_arg.data[i];
+
+                    /* set remaining data length in buffer */
+                    SDO->ODF_arg.dataLength -= ackseq * 7U;
+
+                    /* new block size */
+                    SDO->blksize = CANrxData[2];
+
+                    /* If data type is domain, re-fill the data buffer if necessary and indicated so. */
+                    if((SDO->ODF_arg.ODdataStorage == 0) && (SDO->ODF_arg.dataLength < (SDO->blksize*7U)) && (!SDO->ODF_arg.lastSegment)){
+                        /* move the beginning of the data buffer */
+                        len = SDO->ODF_arg.dataLength; /* length of valid data in buffer */
+                        SDO->ODF_arg.data += len;
+                        SDO->ODF_arg.dataLength = CO_OD_getLength(SDO, SDO->entryNo, SDO->ODF_arg.subIndex) - len;
+
+                        /* read next data from Object dictionary function */
+                        abortCode = CO_SDO_readOD(SDO, CO_SDO_BUFFER_SIZE);
+                        if(abortCode != 0U){
+                            CO_SDO_abort(SDO, abortCode);
+                            return -1;
+                        }
+
+                        /* calculate CRC on next bytes, if enabled */
+                        if(SDO->crcEnabled){
+                            SDO->crc = crc16_ccitt_CO(SDO->ODF_arg.data, SDO->ODF_arg.dataLength, SDO->crc);
+                        }
+
+                      /* return to the original data buffer */
+                        SDO->ODF_arg.data -= len;
+                        SDO->ODF_arg.dataLength +=  len;
                     }
 
-                  /* return to the original data buffer */
-                    SDO->ODF_arg.data -= len;
-                    SDO->ODF_arg.dataLength +=  len;
-                }
+                    /* verify if SDO data buffer is large enough */
+                    if(((SDO->blksize*7U) > SDO->ODF_arg.dataLength) && (!SDO->ODF_arg.lastSegment)){
+                        CO_SDO_abort(SDO, CO_SDO_AB_BLOCK_SIZE); /* Invalid block size (block mode only). */
+                        return -1;
+                    }
 
-                /* verify if SDO data buffer is large enough */
-                if(((SDO->blksize*7U) > SDO->ODF_arg.dataLength) && (!SDO->ODF_arg.lastSegment)){
-                    CO_SDO_abort(SDO, CO_SDO_AB_BLOCK_SIZE); /* Invalid block size (block mode only). */
-                    return -1;
+                    SDO->bufferOffset = 0U;
+                    SDO->sequence = 0U;
+                    SDO->endOfTransfer = false;
                 }
-
-                SDO->bufferOffset = 0U;
-                SDO->sequence = 0U;
-                SDO->endOfTransfer = false;
             }
 
             /* return, if all segments was already transfered or on end of transfer */
@@ -1472,6 +2549,37 @@ int8_t CO_SDO_process(
             /* reset timeout */
             SDO->timeoutTimer = 0;
 
+            /* streaming domain, read segment directly from the window */
+            if(SDO->stream != NULL){
+                bool_t last;
+
+                abortCode = CO_SDO_streamReadSegment(SDO, SDO->streamOffset, &SDO->CANtxBuff->data[1], &len, &last);
+                if(abortCode != 0U){
+                    CO_SDO_abort(SDO, abortCode);
+                    return -1;
+                }
+
+                /* calculate CRC only the first time, segment is sent */
+                if(SDO->crcEnabled && (SDO->streamOffset == SDO->crcOffset)){
+                    SDO->crc = crc16_ccitt_CO(&SDO->CANtxBuff->data[1], len, SDO->crc);
+                    SDO->crcOffset += len;
+                }
+                SDO->streamOffset += len;
+
+                SDO->CANtxBuff->data[0] = ++SDO->sequence;
+                if(last){
+                    SDO->CANtxBuff->data[0] |= 0x80;
+                    SDO->lastLen = len;
+                    SDO->blksize = SDO->sequence;
+                    SDO->endOfTransfer = true;
+                }
+                sendResponse = true;
+                if(timerNext_us != NULL){
+                    *timerNext_us = 0;
+                }
+                break;
+            }
+
             /* calculate length to be sent */
             len = SDO->ODF_arg.dataLength - SDO->bufferOffset;
             if(len > 7U){
@@ -1497,9 +2605,9 @@ int8_t CO_SDO_process(
             /* send response */
             sendResponse = true;
 
-            /* Set timerNext_ms to 0 to inform OS to call this function again without delay. */
-            if(timerNext_ms != NULL){
-                *timerNext_ms = 0;
+            /* Set timerNext_us to 0 to inform OS to call this function again without delay. */
+            if(timerNext_us != NULL){
+                *timerNext_us = 0;
             }
 
             break;
@@ -1529,7 +2637,7 @@ int8_t CO_SDO_process(
     }
 
     /* free receive buffer if it is not empty */
-    CO_SDO_process_done(SDO, timerNext_ms);
+    CO_SDO_process_done(SDO, timerNext_us);
 
     /* send message */
     if(sendResponse) {
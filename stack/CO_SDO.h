@@ -103,9 +103,10 @@ extern "C" {
  *  - byte 1..7:    Reserved.
  *
  * ####Initiate SDO upload (client request)
- *  - byte 0:       SDO command specifier. 8 bits: `01000000`.
+ *  - byte 0:       SDO command specifier. 8 bits: `010x0000` (x=1 for
+ *                  complete access).
  *  - byte 1..2:    Object index.
- *  - byte 3:       Object subIndex.
+ *  - byte 3:       Object subIndex, 0 or 1 for complete access.
  *  - byte 4..7:    Reserved.
  *
  * ####Initiate SDO upload (server response)
@@ -133,6 +134,12 @@ extern "C" {
  *  - byte 3:       Object subIndex.
  *  - byte 4..7:    #CO_SDO_abortCode_t.
  *
+ * ####Complete access
+ * With complete access all sub-indexes of the array or record are uploaded in
+ * one segmented transfer, starting with subIndex 0 or 1. Values are packed
+ * back-to-back with their lengths from the Object dictionary, subIndex 0 is
+ * one byte. Data size is not indicated. Domains can not be accessed this way.
+ *
  * ####Block transfer
  *     See DS301 V4.2.
  */
@@ -314,6 +321,15 @@ typedef enum{
  *     data, which are longer than #CO_SDO_BUFFER_SIZE. In that case
  *     Object dictionary function is called multiple times between SDO transfer.
  *
+ * ####Streaming domain
+ *     Large domains may be transferred without the internal buffer, see
+ *     CO_SDO_stream_t. Then Object dictionary function is not called for
+ *     the domain.
+ *
+ * ####Snapshot region
+ *     Variables written from other thread may be protected with
+ *     CO_OD_snapshot_t. Then SDO server copies them without CO_LOCK_OD().
+ *
  * ####Parameter to function:
  *     ODF_arg     - Pointer to CO_ODF_arg_t object filled before function call.
  *
@@ -351,6 +367,64 @@ typedef enum{
         #define CO_SDO_RX_DATA_SIZE   2
     #endif
 
+/**
+ * Layout of Object Dictionary tables.
+ *
+ * If 0, tables have the traditional layout: CO_OD_entry_t and
+ * CO_OD_entryRecord_t contain pointers to each variable.
+ *
+ * If 1, Object Dictionary must be generated with tools/eds2od.py --packed.
+ * Attribute is one byte, CO_OD_entry_t is reordered to avoid padding and
+ * members of record are described with offsets from the base of the record
+ * (see CO_OD_record_t). This saves flash on 32-bit targets, tables are
+ * constant in both layouts.
+ */
+    #ifndef CO_OD_PACKED
+        #define CO_OD_PACKED          0
+    #endif
+
+/**
+ * Enable CO_OD_setIndexLookup().
+ *
+ * If 1, CO_OD_find() may use a hash table, which maps index to entry number
+ * in constant time instead of binary search. Table is built by application or
+ * by Object Dictionary loader (see socketCAN/CO_OD_eds.h).
+ */
+    #ifndef CO_OD_INDEX_LOOKUP
+        #define CO_OD_INDEX_LOOKUP    0
+    #endif
+
+/**
+ * Size of the ring for segments received in SDO block download.
+ *
+ * If 0 (default), segments are copied by CAN receive interrupt directly into
+ * the SDO data buffer and blksize is limited by #CO_SDO_BUFFER_SIZE. Domain
+ * data are then passed to the application only between sub-blocks.
+ *
+ * If larger than 0, receive interrupt only stores the segments into the
+ * lock-free ring (7 bytes per segment) and CO_SDO_process() consumes all
+ * pending segments in one pass, while the sub-block is still being received.
+ * Domains and streams then negotiate blksize equal to the ring capacity
+ * (one slot is kept free), so the whole sub-block fits into the ring, even if
+ * CO_SDO_process() is called only once per sub-block.
+ *
+ * Value can be 0 or in range from 2 to 128.
+ */
+    #ifndef CO_SDO_BLK_RX_SEGMENTS
+        #define CO_SDO_BLK_RX_SEGMENTS   0
+    #endif
+    #if CO_SDO_BLK_RX_SEGMENTS == 1 || CO_SDO_BLK_RX_SEGMENTS > 128
+        #error CO_SDO_BLK_RX_SEGMENTS must be 0 or in range from 2 to 128
+    #endif
+
+/**
+ * Default additive increase of block size after sub-block without loss, see
+ * CO_SDO_blkAdapt_t.
+ */
+    #ifndef CO_SDO_BLKSIZE_INCREASE
+        #define CO_SDO_BLKSIZE_INCREASE   8
+    #endif
+
 /**
  * Object Dictionary attributes. Bit masks for attribute in CO_OD_entry_t.
  */
@@ -481,6 +555,44 @@ typedef enum {
 } CO_SDO_state_t;
 
 
+#if CO_OD_PACKED
+/**
+ * Object for one entry with specific index in @ref CO_SDO_objectDictionary,
+ * packed layout. Members have the same meaning as in the traditional layout
+ * below. If object type is record, pData is pointer to CO_OD_record_t.
+ */
+typedef struct {
+    void               *pData;       /**< Pointer to data or to CO_OD_record_t */
+    uint16_t            index;       /**< Index of Object */
+    uint16_t            length;      /**< Length of variable or array member */
+    uint8_t             maxSubIndex; /**< Number of (sub-objects - 1) */
+    uint8_t             attribute;   /**< See #CO_SDO_OD_attributes_t */
+}CO_OD_entry_t;
+
+
+/**
+ * Member of record type entry in @ref CO_SDO_objectDictionary, packed layout.
+ */
+typedef struct{
+    /** Offset of variable from CO_OD_record_t::pBase. If object type is
+    Domain, offset is 0xFFFF */
+    uint16_t            offset;
+    /** See #CO_SDO_OD_attributes_t */
+    uint8_t             attribute;
+    /** Length of variable in bytes. If object type is Domain, length is zero */
+    uint8_t             length;
+}CO_OD_entryRecord_t;
+
+
+/**
+ * Record type entry in @ref CO_SDO_objectDictionary, packed layout.
+ */
+typedef struct{
+    void               *pBase;       /**< Pointer to the record variable */
+    const CO_OD_entryRecord_t *pMembers; /**< Array of maxSubIndex+1 members */
+}CO_OD_record_t;
+
+#else
 /**
  * Object for one entry with specific index in @ref CO_SDO_objectDictionary.
  */
@@ -525,6 +637,7 @@ typedef struct{
     /** Pointer to data. If object type is Domain, pData is null */
     uint16_t            length;
 }CO_OD_entryRecord_t;
+#endif
 
 
 /**
@@ -579,6 +692,113 @@ typedef struct{
 }CO_ODF_arg_t;
 
 
+/**
+ * Streaming access to the domain object.
+ *
+ * Application lends SDO server windows into own memory (for example flash
+ * image or buffer of the file). SDO server then reads (upload) or writes
+ * (download) segments directly from/to the window, without copying them
+ * through the SDO databuffer and without calling @ref CO_SDO_OD_function
+ * for each buffer fill. For memory mapped data one window may contain the
+ * whole domain. Stream is registered with CO_OD_configureStream() and is used
+ * for sub-indexes of domain data type. Callbacks are called from
+ * CO_SDO_process() without CO_LOCK_OD().
+ */
+typedef struct{
+    /** Get window into application memory, which starts at absolute offset
+    inside the domain. Function is required.
+     - object: From this structure.
+     - ODF_arg: Info about the transfer. By upload application may set
+       _dataLengthTotal_, when called with offset 0.
+     - offset: Absolute offset of the first byte of the window.
+     - window: Return value, pointer to the window.
+     - windowSize: Return value, by upload number of valid data bytes in
+       window, 0 if there are no more data. By download size of free space in
+       window, 0 if there is no more space. Block download may write up to six
+       bytes of padding after the end of data, if window is large enough.
+     - Return value: 0 or #CO_SDO_abortCode_t. */
+    CO_SDO_abortCode_t (*getWindow)(void *object, CO_ODF_arg_t *ODF_arg,
+                                    uint32_t offset, uint8_t **window,
+                                    uint32_t *windowSize);
+    /** Optional function, called by download after data in the window are
+    complete (window is full or transfer is finished). _ODF_arg->lastSegment_
+    indicates the end of transfer. Not called, if transfer is aborted.
+     - object: From this structure.
+     - ODF_arg: Info about the transfer.
+     - offset: Absolute offset of the first written byte.
+     - length: Number of bytes written since previous call.
+     - Return value: 0 or #CO_SDO_abortCode_t. */
+    CO_SDO_abortCode_t (*commit)(void *object, CO_ODF_arg_t *ODF_arg,
+                                 uint32_t offset, uint32_t length);
+    /** Pointer to object, which will be passed to above functions */
+    void               *object;
+}CO_SDO_stream_t;
+
+
+/** Number of repeated copies of CO_OD_snapshot_t, before reader gives up. */
+#ifndef CO_OD_SNAPSHOT_RETRIES
+    #define CO_OD_SNAPSHOT_RETRIES  10
+#endif
+
+/**
+ * Full memory barrier for sequence locks, default of #CO_OD_SNAPSHOT_BARRIER
+ * and #CO_PDO_SEQLOCK_BARRIER. CANrxMemoryBarrier() can not be used, because
+ * it is empty on targets with CAN receive in IRQ (mbed, drvTemplate), while
+ * sequence locks are used between threads. Without GCC builtins or CMSIS
+ * __DMB() it is at least a compiler barrier.
+ */
+#ifndef CO_SEQLOCK_BARRIER
+    #if defined __GNUC__ || defined __clang__
+        #define CO_SEQLOCK_BARRIER() __sync_synchronize()
+    #elif defined __DMB
+        #define CO_SEQLOCK_BARRIER() __DMB()
+    #else
+        #define CO_SEQLOCK_BARRIER() __asm volatile("" ::: "memory")
+    #endif
+#endif
+
+/** Memory barrier between sequence counter and data access of CO_OD_snapshot_t */
+#ifndef CO_OD_SNAPSHOT_BARRIER
+    #define CO_OD_SNAPSHOT_BARRIER() CO_SEQLOCK_BARRIER()
+#endif
+
+
+/**
+ * Snapshot region of the Object Dictionary.
+ *
+ * Region is a block of OD variables (for example a record, trace
+ * configuration or PDO parameters), which must be always read as a whole
+ * consistent version, without holding CO_LOCK_OD() for long time.
+ *
+ * Writer never modifies _data_ directly. It modifies _shadow_ copy and then
+ * publishes it with CO_OD_snapshot_publish(), which copies shadow to data
+ * between two increments of the sequence counter. Reader copies with
+ * CO_OD_snapshot_read(), which verifies that sequence counter was even and
+ * did not change during the copy, otherwise it repeats the copy. Neither
+ * writer nor reader ever blocks.
+ *
+ * There must be only one writer context. If region is registered with
+ * CO_OD_configureSnapshot(), SDO download is a writer too: it writes into
+ * shadow and publishes, so application must write from the same thread as
+ * CO_SDO_process() (mainline). SDO upload reads each sub-index consistently
+ * and complete access reads the whole array or record from one version, if
+ * it fits into the SDO buffer and has no @ref CO_SDO_OD_function. Variables
+ * of the region must not be mapped to RPDO. If they are mapped to TPDO,
+ * CO_TPDOsend() copies them consistently with the region too.
+ */
+typedef struct{
+    volatile uint32_t   seq;            /**< Sequence counter, odd while publishing */
+    uint8_t            *data;           /**< From CO_OD_snapshot_init(), OD variables */
+    uint8_t            *shadow;         /**< From CO_OD_snapshot_init(), writer's copy */
+    uint16_t            size;           /**< From CO_OD_snapshot_init() */
+    uint32_t            publishCount;   /**< Number of published versions */
+    /** Number of copies repeated because of concurrent publish */
+    uint32_t            readRetries;
+    /** Number of reads abandoned after CO_OD_SNAPSHOT_RETRIES */
+    uint32_t            readFailures;
+}CO_OD_snapshot_t;
+
+
 /**
  * Object is used as array inside CO_SDO_t, parallel to @ref CO_SDO_objectDictionary.
  *
@@ -593,9 +813,53 @@ typedef struct{
     /** Pointer to #CO_SDO_OD_flags_t. If object type is array or record, this
     variable points to array with length equal to number of subindexes. */
     uint8_t            *flags;
+    /** From CO_OD_configureStream() or NULL */
+    const CO_SDO_stream_t *stream;
+    /** From CO_OD_configureSnapshot() or NULL */
+    CO_OD_snapshot_t   *snapshot;
 }CO_OD_extension_t;
 
 
+/**
+ * Block size adaptation and statistics of SDO block transfer.
+ *
+ * Used by SDO server and SDO client. Block size is adapted with AIMD
+ * (additive increase, multiplicative decrease) algorithm: after each sub-block,
+ * which was acknowledged completely, block size is increased by _increase_,
+ * after sub-block with lost segments (wrong sequence or sub-block timeout) it
+ * is halved. So large blocks are used on clean bus and short blocks on noisy
+ * bus, where a lost segment repeats the rest of the sub-block.
+ *
+ * Block size is adapted only by the side, which determines it: SDO server in
+ * block download and SDO client in block upload. Statistics are collected in
+ * both directions. They are cleared at start of each transfer and kept after
+ * its end, so application can read them.
+ */
+typedef struct{
+    /** Current block size, from 1 to blksizeMax */
+    uint8_t             blksize;
+    /** Upper limit for blksize, may be changed by application */
+    uint8_t             blksizeMax;
+    /** Lower limit for blksize, may be changed by application */
+    uint8_t             blksizeMin;
+    /** Increase of blksize after sub-block without loss, may be changed by
+    application. Default is #CO_SDO_BLKSIZE_INCREASE. */
+    uint8_t             increase;
+    /** Number of data bytes acknowledged in the transfer */
+    uint32_t            bytes;
+    /** Number of segments transferred, including repeated */
+    uint32_t            segments;
+    /** Number of segments, which were not acknowledged and had to be repeated */
+    uint32_t            segmentsLost;
+    /** Number of sub-blocks */
+    uint16_t            subblocks;
+    /** Number of sub-blocks with lost segments */
+    uint16_t            subblocksLost;
+    /** Duration of the transfer in microseconds */
+    uint32_t            time_us;
+}CO_SDO_blkAdapt_t;
+
+
 /**
  * SDO server object.
  */
@@ -613,8 +877,37 @@ typedef struct{
     /** Pointer to array of CO_OD_extension_t objects. Size of the array is
     equal to ODSize. */
     CO_OD_extension_t  *ODExtensions;
+#if CO_OD_INDEX_LOOKUP
+    /** Hash table from CO_OD_setIndexLookup() or NULL */
+    const uint16_t     *ODlookup;
+    /** Size of the ODlookup table minus one */
+    uint16_t            ODlookupMask;
+#endif
     /** Offset in buffer of next data segment being read/written */
     uint16_t            bufferOffset;
+    /** Size of the buffer, to which ODF_arg.data points in block download */
+    uint16_t            bufferSize;
+    /** Stream of the current transfer or NULL, see CO_SDO_stream_t */
+    const CO_SDO_stream_t *stream;
+    /** Current window of the stream */
+    uint8_t            *window;
+    /** Absolute offset of the current window */
+    uint32_t            windowOffset;
+    /** Size of the current window */
+    uint32_t            windowSize;
+    /** Absolute offset of the next byte in stream transfer */
+    uint32_t            streamOffset;
+    /** Stream download: absolute offset of data not yet committed.
+    Stream block upload: absolute offset of the current sub-block. */
+    uint32_t            streamMark;
+    /** Stream block upload: number of bytes already included in CRC */
+    uint32_t            crcOffset;
+    /** True, if block download writes directly into the window */
+    bool_t              streamDirect;
+    /** True for complete access upload of the array or record */
+    bool_t              completeAccess;
+    /** Complete access: subIndex, which is currently in the buffer */
+    uint8_t             caSubIndex;
     /** Sequence number of OD entry as returned from CO_OD_find() */
     uint16_t            entryNo;
     /** CO_ODF_arg_t object with additional variables. Reference to this object
@@ -626,8 +919,8 @@ typedef struct{
     CO_SDO_state_t      state;
     /** Toggle bit in segmented transfer or block sequence in block transfer */
     uint8_t             sequence;
-    /** Timeout timer for SDO communication */
-    uint16_t            timeoutTimer;
+    /** Timeout timer for SDO communication in microseconds */
+    uint32_t            timeoutTimer;
     /** Number of segments per block with 1 <= blksize <= 127 */
     uint8_t             blksize;
     /** True, if CRC calculation by block transfer is enabled */
@@ -640,6 +933,16 @@ typedef struct{
     bool_t              timeoutSubblockDownolad;
     /** Indication end of block transfer */
     bool_t              endOfTransfer;
+    /** Block size adaptation and statistics of the current or last transfer */
+    CO_SDO_blkAdapt_t   blkAdapt;
+#if CO_SDO_BLK_RX_SEGMENTS > 0
+    /** Ring of segments received in block download, see #CO_SDO_BLK_RX_SEGMENTS */
+    uint8_t             blkRxRing[CO_SDO_BLK_RX_SEGMENTS][7];
+    /** Index of the next free slot in blkRxRing, written by receive interrupt */
+    volatile uint8_t    blkRxHead;
+    /** Index of the next segment to consume, written by CO_SDO_process() */
+    volatile uint8_t    blkRxTail;
+#endif
     /** Variables indicates, if new SDO message received from CAN bus */
     volatile void      *CANrxNew[CO_SDO_RX_DATA_SIZE];
     /** Index of CANrxData for new received SDO message */
@@ -650,6 +953,10 @@ typedef struct{
     uint8_t             CANrxSize;
     /** From CO_SDO_initCallback() or NULL */
     void              (*pFunctSignal)(void);
+    /** From CO_SDO_initPDOaccess() or NULL */
+    int8_t            (*pFunctPDOaccess)(void *object, uint8_t *ODdata, uint8_t *buffer, uint16_t length, bool_t write);
+    /** From CO_SDO_initPDOaccess() or NULL */
+    void               *functPDOaccessObject;
     /** From CO_SDO_init() */
     CO_CANmodule_t     *CANdevTx;
     /** CAN transmit buffer inside CANdev for CAN tx message */
@@ -812,6 +1119,30 @@ void CO_SDO_initCallback(
         void                  (*pFunctSignal)(void));
 
 
+/**
+ * Initialize access to the variables mapped to PDO.
+ *
+ * Variables mapped to PDO are not protected by CO_LOCK_OD(), because PDOs are
+ * processed from the timer thread, which never blocks. Instead of copying
+ * such variable directly, SDO server calls pFunctPDOaccess, which copies it
+ * under sequence lock of the PDO, see CO_PDOseqlock_t. Function is called
+ * with length bytes of OD variable in ODdata and SDO buffer in buffer. If
+ * write is true, it copies from buffer to ODdata, otherwise from ODdata to
+ * buffer. It returns 0, if variable is not mapped to any PDO (SDO server then
+ * copies it directly), 1 if variable was copied or -1, if consistent copy was
+ * not possible (SDO transfer is then aborted with CO_SDO_AB_DATA_LOC_CTRL).
+ *
+ * @param SDO This object.
+ * @param object Pointer to object, which will be passed to pFunctPDOaccess.
+ * @param pFunctPDOaccess Pointer to the function, see CO_RPDO_SDOaccess()
+ * and CO_TPDO_SDOaccess().
+ */
+void CO_SDO_initPDOaccess(
+        CO_SDO_t               *SDO,
+        void                   *object,
+        int8_t                (*pFunctPDOaccess)(void *object, uint8_t *ODdata, uint8_t *buffer, uint16_t length, bool_t write));
+
+
 /**
  * Process SDO communication.
  *
@@ -836,6 +1167,32 @@ int8_t CO_SDO_process(
         uint16_t               *timerNext_ms);
 
 
+/**
+ * Process SDO communication with microsecond time base.
+ *
+ * Same as CO_SDO_process(), which calls this function. It may be called from
+ * a thread, which is woken by the callback from CO_SDO_initCallback(), so the
+ * response is sent immediately after the request is received and not at the
+ * next cycle of the mainline. Time is then taken from a monotonic clock.
+ * Function must not be called concurrently with CO_SDO_process().
+ *
+ * @param SDO This object.
+ * @param NMTisPreOrOperational See CO_SDO_process().
+ * @param timeDifference_us Time difference from previous function call in [microseconds].
+ * @param SDOtimeoutTime_us Timeout time for SDO communication in microseconds.
+ * @param timerNext_us Return value - info to OS - set to 0, if function
+ * should be called again without delay. Ignored if NULL.
+ *
+ * @return Same as CO_SDO_process().
+ */
+int8_t CO_SDO_process_us(
+        CO_SDO_t               *SDO,
+        bool_t                  NMTisPreOrOperational,
+        uint32_t                timeDifference_us,
+        uint32_t                SDOtimeoutTime_us,
+        uint32_t               *timerNext_us);
+
+
 /**
  * Configure additional functionality to one @ref CO_SDO_objectDictionary entry.
  *
@@ -863,6 +1220,116 @@ void CO_OD_configure(
         uint8_t                 flagsSize);
 
 
+/**
+ * Configure streaming access to the domain in @ref CO_SDO_objectDictionary entry.
+ *
+ * If OD entry does not exist, function returns silently.
+ *
+ * @param SDO This object.
+ * @param index Index of object in the Object dictionary.
+ * @param stream Pointer to externaly defined stream object or NULL to
+ * disable streaming.
+ */
+void CO_OD_configureStream(
+        CO_SDO_t               *SDO,
+        uint16_t                index,
+        const CO_SDO_stream_t  *stream);
+
+
+/**
+ * Initialize snapshot region.
+ *
+ * Shadow is initialized from data.
+ *
+ * @param snap This object.
+ * @param data Block of OD variables, for example &OD_traceConfig[0].
+ * @param shadow Memory block of the same size, owned by the writer.
+ * @param size Size of data and shadow in bytes.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_OD_snapshot_init(
+        CO_OD_snapshot_t       *snap,
+        void                   *data,
+        void                   *shadow,
+        uint16_t                size);
+
+
+/**
+ * Publish shadow copy of the snapshot region.
+ *
+ * Called by the writer after it modified _shadow_.
+ *
+ * @param snap This object.
+ */
+void CO_OD_snapshot_publish(CO_OD_snapshot_t *snap);
+
+
+/**
+ * Read consistent copy from the snapshot region.
+ *
+ * Function may be called from any thread. It never blocks, it may only repeat
+ * the copy up to CO_OD_SNAPSHOT_RETRIES times.
+ *
+ * @param snap This object.
+ * @param dest Destination buffer.
+ * @param offset Offset inside region.
+ * @param length Number of bytes.
+ *
+ * @return True, if copy is consistent.
+ */
+bool_t CO_OD_snapshot_read(
+        CO_OD_snapshot_t       *snap,
+        void                   *dest,
+        uint16_t                offset,
+        uint16_t                length);
+
+
+/**
+ * Protect @ref CO_SDO_objectDictionary entry with snapshot region.
+ *
+ * All variables of the entry must be inside the region. SDO upload then
+ * copies data with CO_OD_snapshot_read(), SDO download writes into shadow
+ * and calls CO_OD_snapshot_publish(). If OD entry does not exist, function
+ * returns silently.
+ *
+ * @param SDO This object.
+ * @param index Index of object in the Object dictionary.
+ * @param snap Pointer to initialized snapshot region or NULL.
+ */
+void CO_OD_configureSnapshot(
+        CO_SDO_t               *SDO,
+        uint16_t                index,
+        CO_OD_snapshot_t       *snap);
+
+
+/**
+ * Slot in the index lookup table, where search for index starts. See
+ * CO_OD_setIndexLookup().
+ */
+#define CO_OD_LOOKUP_SLOT(index, mask) ((uint16_t)((index) ^ ((index) >> 8)) & (mask))
+
+
+#if CO_OD_INDEX_LOOKUP
+/**
+ * Set hash table for CO_OD_find().
+ *
+ * Table has (mask + 1) slots, mask must be 2^N - 1 and table must have at
+ * least one empty slot. Each slot contains entry number plus one or zero, if
+ * empty. Entry with index is stored in the first free slot, starting from
+ * CO_OD_LOOKUP_SLOT(index, mask) (linear probing).
+ *
+ * Table is kept by CO_SDO_init() after communication reset, if OD is the
+ * same. SDO servers initialized with parentSDO copy it from the parent.
+ *
+ * @param SDO This object.
+ * @param table Hash table or NULL to use binary search.
+ * @param mask Size of the table minus one.
+ */
+void CO_OD_setIndexLookup(CO_SDO_t *SDO, const uint16_t *table, uint16_t mask);
+#endif
+
+
 /**
  * Find object with specific index in Object dictionary.
  *
@@ -971,6 +1438,75 @@ uint32_t CO_SDO_readOD(CO_SDO_t *SDO, uint16_t SDOBufferSize);
  */
 uint32_t CO_SDO_writeOD(CO_SDO_t *SDO, uint16_t length);
 
+
+/**
+ * Initialize block size adaptation.
+ *
+ * @param blkAdapt This object.
+ * @param blksizeMax Upper limit and initial value for block size, 1 to 127.
+ */
+void CO_SDO_blkAdaptInit(CO_SDO_blkAdapt_t *blkAdapt, uint8_t blksizeMax);
+
+
+/**
+ * Clear statistics at start of new transfer. Block size is preserved.
+ *
+ * @param blkAdapt This object.
+ */
+void CO_SDO_blkAdaptStart(CO_SDO_blkAdapt_t *blkAdapt);
+
+
+/**
+ * Update statistics after acknowledged sub-block, block size is not changed.
+ *
+ * Used by the side of the transfer, which does not determine the block size
+ * (SDO server upload, SDO client download). CO_SDO_blkAdaptUpdate() calls it.
+ *
+ * @param blkAdapt This object.
+ * @param blksize Number of segments sent in the sub-block.
+ * @param ackseq Number of segments acknowledged by receiver.
+ * @param lastSubblock True, if sub-block contains the last segment. Shorter
+ * last sub-block is not considered as loss.
+ *
+ * @return True, if segments of the sub-block were lost.
+ */
+bool_t CO_SDO_blkAdaptStats(
+        CO_SDO_blkAdapt_t      *blkAdapt,
+        uint8_t                 blksize,
+        uint8_t                 ackseq,
+        bool_t                  lastSubblock);
+
+
+/**
+ * Update block size and statistics after acknowledged sub-block.
+ *
+ * Used by the side of the transfer, which determines the block size (SDO
+ * server download, SDO client upload).
+ *
+ * @param blkAdapt This object.
+ * @param blksize Number of segments sent in the sub-block.
+ * @param ackseq Number of segments acknowledged by receiver.
+ * @param lastSubblock True, if sub-block contains the last segment. Shorter
+ * last sub-block is not considered as loss and does not change block size.
+ *
+ * @return New block size.
+ */
+uint8_t CO_SDO_blkAdaptUpdate(
+        CO_SDO_blkAdapt_t      *blkAdapt,
+        uint8_t                 blksize,
+        uint8_t                 ackseq,
+        bool_t                  lastSubblock);
+
+
+/**
+ * Get goodput of the current or last transfer.
+ *
+ * @param blkAdapt This object.
+ *
+ * @return Acknowledged data bytes per second or 0, if time is not known.
+ */
+uint32_t CO_SDO_blkAdaptGoodput(const CO_SDO_blkAdapt_t *blkAdapt);
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
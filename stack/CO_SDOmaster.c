@@ -69,6 +69,7 @@
 #define SDO_STATE_UPLOAD_INITIATED      20
 #define SDO_STATE_UPLOAD_REQUEST        21
 #define SDO_STATE_UPLOAD_RESPONSE       22
+#define SDO_STATE_UPLOAD_SINK_END       23
 
 /* DOWNLOAD BLOCK */
 #define SDO_STATE_BLOCKDOWNLOAD_INITIATE        100
@@ -188,11 +189,20 @@ CO_ReturnError_t CO_SDOclient_init(
 
     SDO_C->pst    = 21; /*  block transfer */
     SDO_C->block_size_max = 127; /*  block transfer */
+    CO_SDO_blkAdaptInit(&SDO_C->blkAdapt, SDO_C->block_size_max);
+    SDO_C->rtt.last_us = 0;
+    SDO_C->rtt.min_us = 0;
+    SDO_C->rtt.max_us = 0;
+    SDO_C->rtt.sum_us = 0;
+    SDO_C->rtt.count = 0;
 
     SDO_C->SDO = SDO;
     SDO_C->SDOClientPar = SDOClientPar;
 
     SDO_C->pFunctSignal = NULL;
+    SDO_C->schedReq = NULL;
+    SDO_C->pFunctSink = NULL;
+    SDO_C->pFunctSource = NULL;
 
     SDO_C->CANdevRx = CANdevRx;
     SDO_C->CANdevRxIdx = CANdevRxIdx;
@@ -322,22 +332,62 @@ static void CO_SDOTxBufferClear(CO_SDOclient_t *SDO_C) {
  *
  *
  ******************************************************************************/
-CO_SDOclient_return_t CO_SDOclientDownloadInitiate(
+/*
+ * Copy data at offset from the source.
+ *
+ * @return true, if all data are available.
+ */
+static bool_t CO_SDOclient_sourceRead(CO_SDOclient_t *SDO_C, uint32_t offset, uint8_t data[], uint32_t length){
+    uint32_t i = 0;
+
+    while(i < length){
+        uint32_t pos = offset + i;
+
+        if(SDO_C->srcWindow == NULL || pos < SDO_C->srcWindowOffset ||
+           (pos - SDO_C->srcWindowOffset) >= SDO_C->srcWindowSize)
+        {
+            uint32_t size = 0;
+            const uint8_t *window = SDO_C->pFunctSource(SDO_C->sourceObject, pos, &size);
+
+            if(window == NULL || size == 0){
+                SDO_C->srcWindow = NULL;
+                return false;
+            }
+            SDO_C->srcWindow = window;
+            SDO_C->srcWindowOffset = pos;
+            SDO_C->srcWindowSize = size;
+        }
+        data[i++] = SDO_C->srcWindow[pos - SDO_C->srcWindowOffset];
+    }
+
+    return true;
+}
+
+
+static CO_SDOclient_return_t CO_SDOclientDownloadInitiateInt(
         CO_SDOclient_t         *SDO_C,
         uint16_t                index,
         uint8_t                 subIndex,
         uint8_t                *dataTx,
+        const uint8_t*        (*pFunctSource)(void *object, uint32_t offset, uint32_t *length),
+        void                   *object,
         uint32_t                dataSize,
         uint8_t                 blockEnable)
 {
     /* verify parameters */
-    if(SDO_C == NULL || dataTx == 0 || dataSize == 0) {
+    if(SDO_C == NULL || (dataTx == 0 && pFunctSource == NULL) || dataSize == 0) {
         return CO_SDOcli_wrongArguments;
     }
 
     /* save parameters */
     SDO_C->buffer = dataTx;
     SDO_C->bufferSize = dataSize;
+    SDO_C->pFunctSource = pFunctSource;
+    SDO_C->sourceObject = object;
+    SDO_C->srcWindow = NULL;
+    SDO_C->srcCrcOffset = 0;
+    SDO_C->srcCrc = 0;
+    CO_SDO_blkAdaptStart(&SDO_C->blkAdapt);
 
     SDO_C->state = SDO_STATE_DOWNLOAD_INITIATE;
 
@@ -367,7 +417,15 @@ CO_SDOclient_return_t CO_SDOclientDownloadInitiate(
         SDO_C->CANtxBuff->data[0] = 0x23 | ((4-dataSize) << 2);
 
         /* copy data */
-        for(i=dataSize+3; i>=4; i--) SDO_C->CANtxBuff->data[i] = dataTx[i-4];
+        if(pFunctSource != NULL){
+            if(!CO_SDOclient_sourceRead(SDO_C, 0, &SDO_C->CANtxBuff->data[4], dataSize)){
+                SDO_C->state = SDO_STATE_NOTDEFINED;
+                return CO_SDOcli_wrongArguments;
+            }
+        }
+        else{
+            for(i=dataSize+3; i>=4; i--) SDO_C->CANtxBuff->data[i] = dataTx[i-4];
+        }
     }
     else if((SDO_C->bufferSize > SDO_C->pst) && blockEnable != 0){ /*  BLOCK transfer */
         /*  set state of block transfer */
@@ -404,12 +462,86 @@ CO_SDOclient_return_t CO_SDOclientDownloadInitiate(
 }
 
 
+/******************************************************************************/
+CO_SDOclient_return_t CO_SDOclientDownloadInitiate(
+        CO_SDOclient_t         *SDO_C,
+        uint16_t                index,
+        uint8_t                 subIndex,
+        uint8_t                *dataTx,
+        uint32_t                dataSize,
+        uint8_t                 blockEnable)
+{
+    return CO_SDOclientDownloadInitiateInt(SDO_C, index, subIndex, dataTx,
+                                           NULL, NULL, dataSize, blockEnable);
+}
+
+
+/******************************************************************************/
+CO_SDOclient_return_t CO_SDOclientDownloadInitiateSource(
+        CO_SDOclient_t         *SDO_C,
+        uint16_t                index,
+        uint8_t                 subIndex,
+        const uint8_t*        (*pFunctSource)(void *object, uint32_t offset, uint32_t *length),
+        void                   *object,
+        uint32_t                dataSize,
+        uint8_t                 blockEnable)
+{
+    if(pFunctSource == NULL){
+        return CO_SDOcli_wrongArguments;
+    }
+    return CO_SDOclientDownloadInitiateInt(SDO_C, index, subIndex, NULL,
+                                           pFunctSource, object, dataSize, blockEnable);
+}
+
+
+/*
+ * Update round-trip time statistics with the received server response.
+ */
+static void CO_SDOclient_rttUpdate(CO_SDOclient_t *SDO_C, uint32_t timeDifference_us){
+    CO_SDOclientRtt_t *rtt = &SDO_C->rtt;
+    uint32_t t;
+
+    switch(SDO_C->state){
+        case SDO_STATE_DOWNLOAD_INITIATE:
+        case SDO_STATE_DOWNLOAD_RESPONSE:
+        case SDO_STATE_UPLOAD_INITIATED:
+        case SDO_STATE_UPLOAD_RESPONSE:
+            break;
+        default:
+            return;
+    }
+
+    t = SDO_C->timeoutTimer + timeDifference_us;
+    rtt->last_us = t;
+    if(rtt->count == 0 || t < rtt->min_us){
+        rtt->min_us = t;
+    }
+    if(t > rtt->max_us){
+        rtt->max_us = t;
+    }
+    rtt->sum_us += t;
+    rtt->count++;
+}
+
+
 /******************************************************************************/
 CO_SDOclient_return_t CO_SDOclientDownload(
         CO_SDOclient_t         *SDO_C,
         uint16_t                timeDifference_ms,
         uint16_t                SDOtimeoutTime,
         uint32_t               *pSDOabortCode)
+{
+    return CO_SDOclientDownload_us(SDO_C, (uint32_t)timeDifference_ms * 1000,
+                                   (uint32_t)SDOtimeoutTime * 1000, pSDOabortCode);
+}
+
+
+/******************************************************************************/
+CO_SDOclient_return_t CO_SDOclientDownload_us(
+        CO_SDOclient_t         *SDO_C,
+        uint32_t                timeDifference_us,
+        uint32_t                SDOtimeoutTime_us,
+        uint32_t               *pSDOabortCode)
 {
     CO_SDOclient_return_t ret = CO_SDOcli_waitingServerResponse;
 
@@ -437,8 +569,20 @@ CO_SDOclient_return_t CO_SDOclientDownload(
             return CO_SDOcli_endedWithServerAbort;
         }
 
-        /* set buffer */
-        SDO_C->SDO->ODF_arg.data = SDO_C->buffer;
+        /* set buffer, source must provide all data at once */
+        if(SDO_C->pFunctSource != NULL){
+            uint32_t size = 0;
+            const uint8_t *window = SDO_C->pFunctSource(SDO_C->sourceObject, 0, &size);
+
+            if(window == NULL || size < SDO_C->bufferSize){
+                *pSDOabortCode = CO_SDO_AB_OUT_OF_MEM;
+                return CO_SDOcli_endedWithClientAbort;
+            }
+            SDO_C->SDO->ODF_arg.data = (uint8_t *)window;
+        }
+        else{
+            SDO_C->SDO->ODF_arg.data = SDO_C->buffer;
+        }
 
         /* write data to the Object dictionary */
         *pSDOabortCode = CO_SDO_writeOD(SDO_C->SDO, SDO_C->bufferSize);
@@ -454,6 +598,8 @@ CO_SDOclient_return_t CO_SDOclientDownload(
     if(IS_CANrxNew(SDO_C->CANrxNew)){
         uint8_t SCS = SDO_C->CANrxData[0]>>5;    /* Client command specifier */
 
+        CO_SDOclient_rttUpdate(SDO_C, timeDifference_us);
+
         /* ABORT */
         if (SDO_C->CANrxData[0] == (SCS_ABORT<<5)){
             SDO_C->state = SDO_STATE_NOTDEFINED;
@@ -555,6 +701,10 @@ CO_SDOclient_return_t CO_SDOclientDownload(
                         SDO_C->state = SDO_STATE_ABORT;
                         break;
                     }
+                    /*  statistics only, block size is determined by server */
+                    CO_SDO_blkAdaptStats(&SDO_C->blkAdapt, SDO_C->block_seqno, SDO_C->CANrxData[1],
+                                         (SDO_C->bufferOffset >= SDO_C->bufferSize) ? true : false);
+
                     /*  check number of segments */
                     if(SDO_C->CANrxData[1] != SDO_C->block_blksize){
                         /*  NOT all segments transferred successfully */
@@ -612,10 +762,13 @@ CO_SDOclient_return_t CO_SDOclientDownload(
     }
 
 /*  TMO *********************************************************************************************** */
-    if(SDO_C->timeoutTimer < SDOtimeoutTime){
-        SDO_C->timeoutTimer += timeDifference_ms;
+    if(SDO_C->state != SDO_STATE_NOTDEFINED){
+        SDO_C->blkAdapt.time_us += timeDifference_us;
+    }
+    if(SDO_C->timeoutTimer < SDOtimeoutTime_us){
+        SDO_C->timeoutTimer += timeDifference_us;
     }
-    if(SDO_C->timeoutTimer >= SDOtimeoutTime){ /*  communication TMO */
+    if(SDO_C->timeoutTimer >= SDOtimeoutTime_us){ /*  communication TMO */
         *pSDOabortCode = CO_SDO_AB_TIMEOUT;
         CO_SDOclient_abort(SDO_C, *pSDOabortCode);
         return CO_SDOcli_endedWithTimeout;
@@ -641,9 +794,17 @@ CO_SDOclient_return_t CO_SDOclientDownload(
             /* calculate length to be sent */
             j = SDO_C->bufferSize - SDO_C->bufferOffset;
             if(j > 7) j = 7;
-            /* fill data bytes */
-            for(i=0; i<j; i++)
-                SDO_C->CANtxBuff->data[i+1] = SDO_C->buffer[SDO_C->bufferOffset + i];
+            /* fill data bytes, wait if source is not ready */
+            if(SDO_C->pFunctSource != NULL){
+                if(!CO_SDOclient_sourceRead(SDO_C, SDO_C->bufferOffset, &SDO_C->CANtxBuff->data[1], j)){
+                    break;
+                }
+                i = j;
+            }
+            else{
+                for(i=0; i<j; i++)
+                    SDO_C->CANtxBuff->data[i+1] = SDO_C->buffer[SDO_C->bufferOffset + i];
+            }
 
             for(; i<7; i++)
                 SDO_C->CANtxBuff->data[i+1] = 0;
@@ -663,6 +824,21 @@ CO_SDOclient_return_t CO_SDOclientDownload(
 
         /*  BLOCK */
         case SDO_STATE_BLOCKDOWNLOAD_INPROGRES:{
+            /*  source mode, fetch data first and wait if they are not ready */
+            if(SDO_C->pFunctSource != NULL){
+                uint32_t len = SDO_C->bufferSize - SDO_C->bufferOffset;
+
+                if(len > 7) len = 7;
+                if(!CO_SDOclient_sourceRead(SDO_C, SDO_C->bufferOffset, &SDO_C->CANtxBuff->data[1], len)){
+                    break;
+                }
+                /*  CRC is calculated, when segment is sent the first time */
+                if(SDO_C->bufferOffset == SDO_C->srcCrcOffset){
+                    SDO_C->srcCrc = crc16_ccitt_CO(&SDO_C->CANtxBuff->data[1], len, SDO_C->srcCrc);
+                    SDO_C->srcCrcOffset += len;
+                }
+            }
+
             SDO_C->block_seqno += 1;
             SDO_C->CANtxBuff->data[0] = SDO_C->block_seqno;
 
@@ -675,7 +851,8 @@ CO_SDOclient_return_t CO_SDOclientDownload(
             uint8_t i;
             for(i = 1; i < 8; i++){
                 if(SDO_C->bufferOffset < SDO_C->bufferSize){
-                    SDO_C->CANtxBuff->data[i] = *(SDO_C->buffer + SDO_C->bufferOffset);
+                    if(SDO_C->pFunctSource == NULL)
+                        SDO_C->CANtxBuff->data[i] = *(SDO_C->buffer + SDO_C->bufferOffset);
                 }
                 else{
                     SDO_C->CANtxBuff->data[i] = 0;
@@ -703,10 +880,14 @@ CO_SDOclient_return_t CO_SDOclientDownload(
 
             uint16_t tmp16;
 
-            tmp16 = crc16_ccitt_CO((unsigned char *)SDO_C->buffer, (unsigned int)SDO_C->bufferSize, 0);
+            if(SDO_C->pFunctSource != NULL)
+                tmp16 = SDO_C->srcCrc;
+            else
+                tmp16 = crc16_ccitt_CO((unsigned char *)SDO_C->buffer, (unsigned int)SDO_C->bufferSize, 0);
 
             SDO_C->CANtxBuff->data[1] = (uint8_t) tmp16;
             SDO_C->CANtxBuff->data[2] = (uint8_t) (tmp16>>8);
+            SDO_C->blkAdapt.bytes -= SDO_C->block_noData;
 
             /*  set state */
             SDO_C->state = SDO_STATE_BLOCKDOWNLOAD_CRC_ACK;
@@ -735,35 +916,83 @@ CO_SDOclient_return_t CO_SDOclientDownload(
  * UPLOAD
  *
  ******************************************************************************/
-CO_SDOclient_return_t CO_SDOclientUploadInitiate(
+/*
+ * Pass data from the beginning of the buffer to the sink and move the rest.
+ *
+ * @param fill Number of bytes in the buffer, updated.
+ * @param last True, if buffer contains the last byte of the object.
+ * @param crc True, if CRC should be calculated on passed data.
+ *
+ * @return true, if buffer is empty (and sink was informed about the end).
+ */
+static bool_t CO_SDOclient_sinkFlush(CO_SDOclient_t *SDO_C, uint32_t *fill, bool_t last, bool_t crc){
+    uint32_t n, i;
+
+    if(*fill == 0 && !last){
+        return true;
+    }
+
+    n = SDO_C->pFunctSink(SDO_C->sinkObject, SDO_C->buffer, *fill, last);
+    if(n > *fill){
+        n = *fill;
+    }
+    if(crc){
+        SDO_C->sinkCrc = crc16_ccitt_CO(SDO_C->buffer, n, SDO_C->sinkCrc);
+    }
+    if(n > 0){
+        for(i=n; i<*fill; i++){
+            SDO_C->buffer[i-n] = SDO_C->buffer[i];
+        }
+        *fill -= n;
+        SDO_C->sinkOffset += n;
+    }
+
+    return (*fill == 0) ? true : false;
+}
+
+
+static CO_SDOclient_return_t CO_SDOclientUploadInitiateInt(
         CO_SDOclient_t         *SDO_C,
         uint16_t                index,
         uint8_t                 subIndex,
         uint8_t                *dataRx,
         uint32_t                dataRxSize,
-        uint8_t                 blockEnable)
+        uint32_t              (*pFunctSink)(void *object, const uint8_t *data, uint32_t length, bool_t last),
+        void                   *object,
+        uint8_t                 blockEnable,
+        bool_t                  completeAccess)
 {
     /* verify parameters */
-    if(SDO_C == NULL || dataRx == 0 || dataRxSize < 4) {
+    if(SDO_C == NULL || dataRx == 0 || dataRxSize < 4 || (pFunctSink != NULL && dataRxSize < 7)) {
         return CO_SDOcli_wrongArguments;
     }
 
     /* save parameters */
     SDO_C->buffer = dataRx;
     SDO_C->bufferSize = dataRxSize;
+    SDO_C->pFunctSink = pFunctSink;
+    SDO_C->sinkObject = object;
+    SDO_C->sinkOffset = 0;
+    SDO_C->sinkCrc = 0;
+    CO_SDO_blkAdaptStart(&SDO_C->blkAdapt);
 
     /* prepare CAN tx message */
     CO_SDOTxBufferClear(SDO_C);
 
     SDO_C->index = index;
     SDO_C->subIndex = subIndex;
+    SDO_C->completeAccess = completeAccess;
 
     SDO_C->CANtxBuff->data[1] = index & 0xFF;
     SDO_C->CANtxBuff->data[2] = index >> 8;
     SDO_C->CANtxBuff->data[3] = subIndex;
 
 
-    if(blockEnable == 0){
+    if(completeAccess){
+        SDO_C->state = SDO_STATE_UPLOAD_INITIATED;
+        SDO_C->CANtxBuff->data[0] = (CCS_UPLOAD_INITIATE<<5) | 0x10;
+    }
+    else if(blockEnable == 0){
         SDO_C->state = SDO_STATE_UPLOAD_INITIATED;
         SDO_C->CANtxBuff->data[0] = (CCS_UPLOAD_INITIATE<<5);
     }
@@ -776,11 +1005,19 @@ CO_SDOclient_return_t CO_SDOclientUploadInitiate(
         /*  set CRC */
         SDO_C->CANtxBuff->data[0] |= 0x04;
 
-        /*  set number of segments in block */
-        SDO_C->block_blksize = SDO_C->block_size_max;
-        if ((SDO_C->block_blksize *7) > SDO_C->bufferSize){
+        /*  set number of segments in block, adapted from previous transfers */
+        if ((SDO_C->block_size_max *7) > SDO_C->bufferSize && pFunctSink == NULL){
             return CO_SDOcli_wrongArguments;
         }
+        SDO_C->blkAdapt.blksizeMax = SDO_C->block_size_max;
+        if (SDO_C->blkAdapt.blksize > SDO_C->block_size_max){
+            SDO_C->blkAdapt.blksize = SDO_C->block_size_max;
+        }
+        SDO_C->block_blksize = SDO_C->blkAdapt.blksize;
+        if ((SDO_C->block_blksize *7) > SDO_C->bufferSize){
+            /* sink mode, limit to buffer */
+            SDO_C->block_blksize = SDO_C->bufferSize / 7;
+        }
 
         SDO_C->CANtxBuff->data[4] = SDO_C->block_blksize;
         SDO_C->CANtxBuff->data[5] = SDO_C->pst;
@@ -810,6 +1047,104 @@ CO_SDOclient_return_t CO_SDOclientUploadInitiate(
 }
 
 
+/******************************************************************************/
+CO_SDOclient_return_t CO_SDOclientUploadInitiate(
+        CO_SDOclient_t         *SDO_C,
+        uint16_t                index,
+        uint8_t                 subIndex,
+        uint8_t                *dataRx,
+        uint32_t                dataRxSize,
+        uint8_t                 blockEnable)
+{
+    return CO_SDOclientUploadInitiateInt(SDO_C, index, subIndex, dataRx,
+                                         dataRxSize, NULL, NULL, blockEnable, false);
+}
+
+
+/******************************************************************************/
+CO_SDOclient_return_t CO_SDOclientUploadInitiateSink(
+        CO_SDOclient_t         *SDO_C,
+        uint16_t                index,
+        uint8_t                 subIndex,
+        uint8_t                *buffer,
+        uint32_t                bufferSize,
+        uint32_t              (*pFunctSink)(void *object, const uint8_t *data, uint32_t length, bool_t last),
+        void                   *object,
+        uint8_t                 blockEnable)
+{
+    if(pFunctSink == NULL){
+        return CO_SDOcli_wrongArguments;
+    }
+    return CO_SDOclientUploadInitiateInt(SDO_C, index, subIndex, buffer,
+                                         bufferSize, pFunctSink, object, blockEnable, false);
+}
+
+
+/******************************************************************************/
+CO_SDOclient_return_t CO_SDOclientUploadInitiateComplete(
+        CO_SDOclient_t         *SDO_C,
+        uint16_t                index,
+        uint8_t                 subIndex,
+        uint8_t                *dataRx,
+        uint32_t                dataRxSize)
+{
+    if(subIndex > 1){
+        return CO_SDOcli_wrongArguments;
+    }
+
+    return CO_SDOclientUploadInitiateInt(SDO_C, index, subIndex, dataRx,
+                                         dataRxSize, NULL, NULL, 0, true);
+}
+
+
+/*
+ * Complete access upload from this node: read all sub-indexes of the array or
+ * record into the buffer.
+ *
+ * @return 0 or SDO abort code.
+ */
+static uint32_t CO_SDOclient_uploadLocalComplete(CO_SDOclient_t *SDO_C, uint32_t *pDataSize){
+    CO_SDO_t *SDO = SDO_C->SDO;
+    uint8_t subIndex = SDO_C->subIndex;
+    uint32_t offset = 0;
+    uint32_t abortCode;
+
+    abortCode = CO_SDO_initTransfer(SDO, SDO_C->index, subIndex);
+    if(abortCode == CO_SDO_AB_NONE && (SDO->OD[SDO->entryNo].maxSubIndex == 0 || subIndex > 1)){
+        abortCode = CO_SDO_AB_UNSUPPORTED_ACCESS;
+    }
+
+    while(abortCode == CO_SDO_AB_NONE){
+        uint32_t space = SDO_C->bufferSize - offset;
+
+        if(SDO->ODF_arg.ODdataStorage == 0){
+            abortCode = CO_SDO_AB_UNSUPPORTED_ACCESS;   /* domain has no fixed length */
+            break;
+        }
+        if(SDO->ODF_arg.dataLength > space){
+            abortCode = CO_SDO_AB_OUT_OF_MEM;
+            break;
+        }
+
+        SDO->ODF_arg.data = &SDO_C->buffer[offset];
+        abortCode = CO_SDO_readOD(SDO, (space > 0xFFFF) ? 0xFFFF : (uint16_t)space);
+        if(abortCode != CO_SDO_AB_NONE){
+            break;
+        }
+        offset += SDO->ODF_arg.dataLength;
+
+        if(subIndex >= SDO->OD[SDO->entryNo].maxSubIndex){
+            break;
+        }
+        subIndex++;
+        abortCode = CO_SDO_initTransfer(SDO, SDO_C->index, subIndex);
+    }
+
+    *pDataSize = offset;
+    return abortCode;
+}
+
+
 /******************************************************************************/
 CO_SDOclient_return_t CO_SDOclientUpload(
         CO_SDOclient_t         *SDO_C,
@@ -817,6 +1152,19 @@ CO_SDOclient_return_t CO_SDOclientUpload(
         uint16_t                SDOtimeoutTime,
         uint32_t               *pDataSize,
         uint32_t               *pSDOabortCode)
+{
+    return CO_SDOclientUpload_us(SDO_C, (uint32_t)timeDifference_ms * 1000,
+                                 (uint32_t)SDOtimeoutTime * 1000, pDataSize, pSDOabortCode);
+}
+
+
+/******************************************************************************/
+CO_SDOclient_return_t CO_SDOclientUpload_us(
+        CO_SDOclient_t         *SDO_C,
+        uint32_t                timeDifference_us,
+        uint32_t                SDOtimeoutTime_us,
+        uint32_t               *pDataSize,
+        uint32_t               *pSDOabortCode)
 {
     uint16_t indexTmp;
     uint32_t tmp32;
@@ -841,6 +1189,15 @@ CO_SDOclient_return_t CO_SDOclientUpload(
             return CO_SDOcli_endedWithClientAbort;
         }
 
+        /* read all sub-indexes */
+        if(SDO_C->completeAccess){
+            *pSDOabortCode = CO_SDOclient_uploadLocalComplete(SDO_C, pDataSize);
+            if((*pSDOabortCode) != CO_SDO_AB_NONE){
+                return CO_SDOcli_endedWithServerAbort;
+            }
+            return CO_SDOcli_ok_communicationEnd;
+        }
+
         /* init ODF_arg */
         *pSDOabortCode = CO_SDO_initTransfer(SDO_C->SDO, SDO_C->index, SDO_C->subIndex);
         if((*pSDOabortCode) != CO_SDO_AB_NONE){
@@ -867,6 +1224,16 @@ CO_SDOclient_return_t CO_SDOclientUpload(
             return CO_SDOcli_endedWithServerAbort;
         }
 
+        /* pass data to the sink at once */
+        if(SDO_C->pFunctSink != NULL){
+            uint32_t fill = *pDataSize;
+
+            if(!CO_SDOclient_sinkFlush(SDO_C, &fill, true, false)){
+                *pSDOabortCode = CO_SDO_AB_OUT_OF_MEM;    /* Out of memory */
+                return CO_SDOcli_endedWithClientAbort;
+            }
+        }
+
         return CO_SDOcli_ok_communicationEnd;
     }
 
@@ -875,6 +1242,8 @@ CO_SDOclient_return_t CO_SDOclientUpload(
     if(IS_CANrxNew(SDO_C->CANrxNew)){
         uint8_t SCS = SDO_C->CANrxData[0]>>5;    /* Client command specifier */
 
+        CO_SDOclient_rttUpdate(SDO_C, timeDifference_us);
+
         /*  ABORT */
         if (SDO_C->CANrxData[0] == (SCS_ABORT<<5)){
             SDO_C->state = SDO_STATE_NOTDEFINED;
@@ -900,6 +1269,13 @@ CO_SDOclient_return_t CO_SDOclientUpload(
 
                         /* copy data */
                         while(size--) SDO_C->buffer[size] = SDO_C->CANrxData[4+size];
+
+                        /* pass data to the sink */
+                        if(SDO_C->pFunctSink != NULL){
+                            SDO_C->bufferOffset = *pDataSize;
+                            SDO_C->state = SDO_STATE_UPLOAD_SINK_END;
+                            break;
+                        }
                         SDO_C->state = SDO_STATE_NOTDEFINED;
                         CLEAR_CANrxNew(SDO_C->CANrxNew);
 
@@ -943,6 +1319,10 @@ CO_SDOclient_return_t CO_SDOclientUpload(
                     SDO_C->buffer[SDO_C->bufferOffset + i] = SDO_C->CANrxData[1 + i];
                     SDO_C->bufferOffset += size;
                     /* If no more segments to be uploaded, finish communication */
+                    if((SDO_C->CANrxData[0] & 0x01) && SDO_C->pFunctSink != NULL){
+                        SDO_C->state = SDO_STATE_UPLOAD_SINK_END;
+                        break;
+                    }
                     if(SDO_C->CANrxData[0] & 0x01){
                         *pDataSize = SDO_C->bufferOffset;
                         SDO_C->state = SDO_STATE_NOTDEFINED;
@@ -992,7 +1372,7 @@ CO_SDOclient_return_t CO_SDOclientUpload(
                     }
 
                     /*  check available buffer size */
-                    if (SDO_C->dataSize > SDO_C->bufferSize){
+                    if (SDO_C->dataSize > SDO_C->bufferSize && SDO_C->pFunctSink == NULL){
                         *pSDOabortCode = CO_SDO_AB_OUT_OF_MEM;
                         SDO_C->state = SDO_STATE_ABORT;
                     }
@@ -1012,6 +1392,13 @@ CO_SDOclient_return_t CO_SDOclientUpload(
 
                         /* copy data */
                         while(size--) SDO_C->buffer[size] = SDO_C->CANrxData[4+size];
+
+                        /* pass data to the sink */
+                        if(SDO_C->pFunctSink != NULL){
+                            SDO_C->bufferOffset = *pDataSize;
+                            SDO_C->state = SDO_STATE_UPLOAD_SINK_END;
+                            break;
+                        }
                         SDO_C->state = SDO_STATE_NOTDEFINED;
                         CLEAR_CANrxNew(SDO_C->CANrxNew);
 
@@ -1043,7 +1430,7 @@ CO_SDOclient_return_t CO_SDOclientUpload(
                 /* Is last segment? */
                 if(SDO_C->CANrxData[0] & 0x80) {
                     /* Is data size indicated and wrong? */
-                    if((SDO_C->dataSize != 0) && (SDO_C->dataSize > SDO_C->dataSizeTransfered)) {
+                    if((SDO_C->dataSize != 0) && (SDO_C->dataSize > (SDO_C->sinkOffset + SDO_C->dataSizeTransfered))) {
                         *pSDOabortCode = CO_SDO_AB_TYPE_MISMATCH;
                         SDO_C->state = SDO_STATE_ABORT;
                     }
@@ -1052,8 +1439,8 @@ CO_SDOclient_return_t CO_SDOclientUpload(
                     }
                 }
                 else {
-                    /* Is SDO buffer overflow? */
-                    if(SDO_C->dataSizeTransfered >= SDO_C->bufferSize) {
+                    /* Is SDO buffer overflow? (sink is emptied before acknowledge) */
+                    if(SDO_C->dataSizeTransfered >= SDO_C->bufferSize && SDO_C->pFunctSink == NULL) {
                         *pSDOabortCode = CO_SDO_AB_OUT_OF_MEM;
                         SDO_C->state = SDO_STATE_ABORT;
                     }
@@ -1068,13 +1455,14 @@ CO_SDOclient_return_t CO_SDOclientUpload(
                 if (SCS == SCS_UPLOAD_BLOCK){
                     tmp32 = ((SDO_C->CANrxData[0]>>2) & 0x07);
                     SDO_C->dataSizeTransfered -= tmp32;
+                    SDO_C->blkAdapt.bytes -= tmp32;
 
                     SDO_C->state = SDO_STATE_BLOCKUPLOAD_BLOCK_END;
                     if (SDO_C->crcEnabled){
                         uint16_t tmp16;
                         CO_memcpySwap2(&tmp16, &SDO_C->CANrxData[1]);
 
-                        if (tmp16 != crc16_ccitt_CO((unsigned char *)SDO_C->buffer, (unsigned int)SDO_C->dataSizeTransfered, 0)){
+                        if (tmp16 != crc16_ccitt_CO((unsigned char *)SDO_C->buffer, (unsigned int)SDO_C->dataSizeTransfered, SDO_C->sinkCrc)){
                             *pSDOabortCode = CO_SDO_AB_CRC;
                             SDO_C->state = SDO_STATE_ABORT;
                         }
@@ -1105,17 +1493,20 @@ CO_SDOclient_return_t CO_SDOclientUpload(
     }
 
 /*  TMO *************************************************************************************************** */
-    if(SDO_C->timeoutTimer < SDOtimeoutTime){
-        SDO_C->timeoutTimer += timeDifference_ms;
+    if(SDO_C->state != SDO_STATE_NOTDEFINED){
+        SDO_C->blkAdapt.time_us += timeDifference_us;
+    }
+    if(SDO_C->timeoutTimer < SDOtimeoutTime_us){
+        SDO_C->timeoutTimer += timeDifference_us;
         if (SDO_C->state == SDO_STATE_BLOCKUPLOAD_INPROGRES)
-            SDO_C->timeoutTimerBLOCK += timeDifference_ms;
+            SDO_C->timeoutTimerBLOCK += timeDifference_us;
     }
-    if(SDO_C->timeoutTimer >= SDOtimeoutTime){ /*  communication TMO */
+    if(SDO_C->timeoutTimer >= SDOtimeoutTime_us){ /*  communication TMO */
         *pSDOabortCode = CO_SDO_AB_TIMEOUT;
         CO_SDOclient_abort(SDO_C, *pSDOabortCode);
         return CO_SDOcli_endedWithTimeout;
     }
-    if(SDO_C->timeoutTimerBLOCK >= (SDOtimeoutTime/2)){ /*  block TMO */
+    if(SDO_C->timeoutTimerBLOCK >= (SDOtimeoutTime_us/2)){ /*  block TMO */
         SDO_C->state = SDO_STATE_BLOCKUPLOAD_BLOCK_ACK;
     }
 
@@ -1136,6 +1527,14 @@ CO_SDOclient_return_t CO_SDOclientUpload(
 
         /*  SEGMENTED UPLOAD */
         case SDO_STATE_UPLOAD_REQUEST:{
+            /* sink mode, wait for space for the next segment */
+            if(SDO_C->pFunctSink != NULL){
+                CO_SDOclient_sinkFlush(SDO_C, &SDO_C->bufferOffset, false, false);
+                if((SDO_C->bufferSize - SDO_C->bufferOffset) < 7){
+                    break;
+                }
+            }
+
             SDO_C->CANtxBuff->data[0] = (CCS_UPLOAD_SEGMENT<<5) | (SDO_C->toggle & 0x10);
             CO_CANsend(SDO_C->CANdevTx, SDO_C->CANtxBuff);
 
@@ -1161,6 +1560,7 @@ CO_SDOclient_return_t CO_SDOclientUpload(
             /*  header */
             SDO_C->CANtxBuff->data[0] = (CCS_UPLOAD_BLOCK<<5) | 0x02;
             SDO_C->CANtxBuff->data[1] = SDO_C->block_seqno;
+            CO_SDO_blkAdaptUpdate(&SDO_C->blkAdapt, SDO_C->block_blksize, SDO_C->block_seqno, true);
 
             SDO_C->block_seqno = 0;
             SDO_C->timeoutTimerBLOCK = 0;
@@ -1174,23 +1574,36 @@ CO_SDOclient_return_t CO_SDOclientUpload(
         }
 
         case SDO_STATE_BLOCKUPLOAD_BLOCK_ACK:{
+            /*  sink mode, wait for space for at least one segment */
+            if(SDO_C->pFunctSink != NULL){
+                CO_SDOclient_sinkFlush(SDO_C, &SDO_C->dataSizeTransfered, false, SDO_C->crcEnabled ? true : false);
+                if((SDO_C->bufferSize - SDO_C->dataSizeTransfered) < 7){
+                    break;
+                }
+            }
+
             /*  header */
             SDO_C->CANtxBuff->data[0] = (CCS_UPLOAD_BLOCK<<5) | 0x02;
             SDO_C->CANtxBuff->data[1] = SDO_C->block_seqno;
 
+            /*  adapt block size to the number of segments received */
+            CO_SDO_blkAdaptUpdate(&SDO_C->blkAdapt, SDO_C->block_blksize, SDO_C->block_seqno, false);
+
             /*  set next block size */
             if (SDO_C->dataSize != 0){
-                if(SDO_C->dataSizeTransfered >= SDO_C->dataSize){
+                uint32_t received = SDO_C->sinkOffset + SDO_C->dataSizeTransfered;
+
+                if(received >= SDO_C->dataSize){
                     SDO_C->block_blksize = 0;
                     SDO_C->state = SDO_STATE_BLOCKUPLOAD_BLOCK_CRC;
                 }
                 else{
-                    tmp32 = ((SDO_C->dataSize - SDO_C->dataSizeTransfered) / 7);
-                    if(tmp32 >= SDO_C->block_size_max){
-                        SDO_C->block_blksize = SDO_C->block_size_max;
+                    tmp32 = ((SDO_C->dataSize - received) / 7);
+                    if(tmp32 >= SDO_C->blkAdapt.blksize){
+                        SDO_C->block_blksize = SDO_C->blkAdapt.blksize;
                     }
                     else{
-                        if((SDO_C->dataSize - SDO_C->dataSizeTransfered) % 7 == 0)
+                        if((SDO_C->dataSize - received) % 7 == 0)
                             SDO_C->block_blksize = tmp32;
                         else
                             SDO_C->block_blksize = tmp32 + 1;
@@ -1201,11 +1614,20 @@ CO_SDOclient_return_t CO_SDOclientUpload(
                 }
             }
             else{
+                SDO_C->block_blksize = SDO_C->blkAdapt.blksize;
                 SDO_C->block_seqno = 0;
                 SDO_C->timeoutTimerBLOCK = 0;
 
                 SDO_C->state = SDO_STATE_BLOCKUPLOAD_INPROGRES;
             }
+
+            /*  sink mode, limit block to free space in the buffer */
+            if(SDO_C->pFunctSink != NULL){
+                tmp32 = (SDO_C->bufferSize - SDO_C->dataSizeTransfered) / 7;
+                if(SDO_C->block_blksize > tmp32){
+                    SDO_C->block_blksize = tmp32;
+                }
+            }
             SDO_C->CANtxBuff->data[2] = SDO_C->block_blksize;
             CO_CANsend(SDO_C->CANdevTx, SDO_C->CANtxBuff);
 
@@ -1217,6 +1639,13 @@ CO_SDOclient_return_t CO_SDOclientUpload(
 
             CO_CANsend(SDO_C->CANdevTx, SDO_C->CANtxBuff);
 
+            /* sink mode, pass the rest of the data (CRC was verified) */
+            if(SDO_C->pFunctSink != NULL){
+                SDO_C->bufferOffset = SDO_C->dataSizeTransfered;
+                SDO_C->state = SDO_STATE_UPLOAD_SINK_END;
+                break;
+            }
+
             *pDataSize = SDO_C->dataSizeTransfered;
 
             SDO_C->state = SDO_STATE_NOTDEFINED;
@@ -1225,6 +1654,15 @@ CO_SDOclient_return_t CO_SDOclientUpload(
             break;
         }
 
+        case SDO_STATE_UPLOAD_SINK_END:{
+            if(CO_SDOclient_sinkFlush(SDO_C, &SDO_C->bufferOffset, true, false)){
+                *pDataSize = SDO_C->sinkOffset;
+                SDO_C->state = SDO_STATE_NOTDEFINED;
+                ret = CO_SDOcli_ok_communicationEnd;
+            }
+            break;
+        }
+
         default:
             break;
     }
@@ -1243,3 +1681,267 @@ void CO_SDOclientClose(CO_SDOclient_t *SDO_C){
         SDO_C->state = SDO_STATE_NOTDEFINED;
     }
 }
+
+
+/*******************************************************************************
+ *
+ * SCHEDULER
+ *
+ ******************************************************************************/
+CO_ReturnError_t CO_SDOclientSched_init(
+        CO_SDOclientSched_t    *sched,
+        CO_SDOclient_t         *SDOclients[],
+        uint8_t                 numClients,
+        uint16_t                SDOtimeoutTime)
+{
+    uint8_t i;
+
+    /* verify arguments */
+    if(sched==NULL || SDOclients==NULL || numClients==0 || SDOtimeoutTime==0){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    for(i=0; i<numClients; i++){
+        if(SDOclients[i] == NULL){
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+    }
+
+    /* Configure object variables */
+    sched->SDOclients = SDOclients;
+    sched->numClients = numClients;
+    sched->SDOtimeoutTime = SDOtimeoutTime;
+    sched->first = NULL;
+    sched->last = NULL;
+    sched->completed = 0;
+    sched->failed = 0;
+    sched->retried = 0;
+    sched->busyTime_ms = 0;
+
+    for(i=0; i<numClients; i++){
+        SDOclients[i]->schedReq = NULL;
+    }
+
+    return CO_ERROR_NO;
+}
+
+
+/*
+ * Return true, if any client of the scheduler is processing request for nodeId
+ * (or any request, if nodeId is 0).
+ */
+static bool_t CO_SDOclientSched_active(CO_SDOclientSched_t *sched, uint8_t nodeId){
+    uint8_t i;
+
+    for(i=0; i<sched->numClients; i++){
+        CO_SDOclientReq_t *req = sched->SDOclients[i]->schedReq;
+
+        if(req != NULL && (nodeId == 0 || req->nodeId == nodeId)){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_SDOclientSched_submit(
+        CO_SDOclientSched_t    *sched,
+        CO_SDOclientReq_t       reqs[],
+        uint16_t                numReqs)
+{
+    uint16_t i;
+
+    /* verify arguments */
+    if(sched==NULL || reqs==NULL){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    for(i=0; i<numReqs; i++){
+        CO_SDOclientReq_t *req = &reqs[i];
+
+        if(req->nodeId == 0 || req->nodeId > 127 || req->buffer == NULL ||
+           req->bufferSize == 0 || (req->upload && req->bufferSize < 4))
+        {
+            return CO_ERROR_ILLEGAL_ARGUMENT;
+        }
+    }
+
+    /* new batch into idle scheduler, restart measurement */
+    if(sched->first == NULL && !CO_SDOclientSched_active(sched, 0)){
+        sched->busyTime_ms = 0;
+    }
+
+    /* append to the queue */
+    for(i=0; i<numReqs; i++){
+        CO_SDOclientReq_t *req = &reqs[i];
+
+        req->next = NULL;
+        req->retriesLeft = req->retries;
+        req->dataSize = 0;
+        req->result = CO_SDOcli_waitingServerResponse;
+        req->abortCode = CO_SDO_AB_NONE;
+
+        if(sched->first == NULL){
+            sched->first = req;
+        }
+        else{
+            sched->last->next = req;
+        }
+        sched->last = req;
+    }
+
+    return CO_ERROR_NO;
+}
+
+
+/*
+ * Configure SDO client for the node and initiate transfer.
+ */
+static CO_SDOclient_return_t CO_SDOclientSched_start(CO_SDOclient_t *SDO_C, CO_SDOclientReq_t *req){
+    CO_SDOclient_return_t ret;
+
+    ret = CO_SDOclient_setup(SDO_C, 0, 0, req->nodeId);
+    if(ret != CO_SDOcli_ok_communicationEnd){
+        return ret;
+    }
+
+    if(req->upload && req->completeAccess){
+        return CO_SDOclientUploadInitiateComplete(SDO_C, req->index, req->subIndex,
+                    req->buffer, req->bufferSize);
+    }
+    else if(req->upload){
+        return CO_SDOclientUploadInitiate(SDO_C, req->index, req->subIndex,
+                    req->buffer, req->bufferSize, req->blockEnable ? 1 : 0);
+    }
+    else{
+        return CO_SDOclientDownloadInitiate(SDO_C, req->index, req->subIndex,
+                    req->buffer, req->bufferSize, req->blockEnable ? 1 : 0);
+    }
+}
+
+
+/*
+ * Release SDO client and inform application.
+ */
+static void CO_SDOclientSched_finish(
+        CO_SDOclientSched_t    *sched,
+        CO_SDOclient_t         *SDO_C,
+        CO_SDOclient_return_t   ret)
+{
+    CO_SDOclientReq_t *req = SDO_C->schedReq;
+
+    CO_SDOclientClose(SDO_C);
+    SDO_C->schedReq = NULL;
+
+    req->result = ret;
+    if(ret == CO_SDOcli_ok_communicationEnd){
+        sched->completed++;
+    }
+    else{
+        sched->failed++;
+    }
+
+    if(req->pFunctDone != NULL){
+        req->pFunctDone(req->object, req);
+    }
+}
+
+
+/******************************************************************************/
+bool_t CO_SDOclientSched_process(
+        CO_SDOclientSched_t    *sched,
+        uint16_t                timeDifference_ms,
+        uint16_t               *timerNext_ms)
+{
+    bool_t busy = false;
+    uint8_t i;
+
+    if(sched == NULL){
+        return true;
+    }
+
+    for(i=0; i<sched->numClients; i++){
+        CO_SDOclient_t *SDO_C = sched->SDOclients[i];
+        CO_SDOclientReq_t *req = SDO_C->schedReq;
+
+        /* continue with active request */
+        if(req != NULL){
+            CO_SDOclient_return_t ret;
+
+            if(req->upload){
+                ret = CO_SDOclientUpload(SDO_C, timeDifference_ms,
+                        sched->SDOtimeoutTime, &req->dataSize, &req->abortCode);
+            }
+            else{
+                ret = CO_SDOclientDownload(SDO_C, timeDifference_ms,
+                        sched->SDOtimeoutTime, &req->abortCode);
+            }
+
+            /* repeat after timeout */
+            if(ret == CO_SDOcli_endedWithTimeout && req->retriesLeft > 0){
+                req->retriesLeft--;
+                sched->retried++;
+                ret = CO_SDOclientSched_start(SDO_C, req);
+                if(ret == CO_SDOcli_ok_communicationEnd){
+                    ret = CO_SDOcli_waitingServerResponse;
+                }
+            }
+
+            if(ret <= CO_SDOcli_ok_communicationEnd){
+                CO_SDOclientSched_finish(sched, SDO_C, ret);
+            }
+            else if(ret != CO_SDOcli_waitingServerResponse && timerNext_ms != NULL){
+                /* block transfer or full transmit buffer */
+                *timerNext_ms = 0;
+            }
+        }
+
+        /* take the first request for the node, which is not accessed by other client */
+        if(SDO_C->schedReq == NULL){
+            CO_SDOclientReq_t *prev = NULL;
+
+            req = sched->first;
+            while(req != NULL && CO_SDOclientSched_active(sched, req->nodeId)){
+                prev = req;
+                req = req->next;
+            }
+
+            if(req != NULL){
+                CO_SDOclient_return_t ret;
+
+                /* remove from queue */
+                if(prev == NULL){
+                    sched->first = req->next;
+                }
+                else{
+                    prev->next = req->next;
+                }
+                if(sched->last == req){
+                    sched->last = prev;
+                }
+                req->next = NULL;
+
+                SDO_C->schedReq = req;
+                ret = CO_SDOclientSched_start(SDO_C, req);
+                if(ret != CO_SDOcli_ok_communicationEnd){
+                    CO_SDOclientSched_finish(sched, SDO_C, ret);
+                }
+                else if(timerNext_ms != NULL){
+                    *timerNext_ms = 0;
+                }
+            }
+        }
+
+        if(SDO_C->schedReq != NULL){
+            busy = true;
+        }
+    }
+
+    if(sched->first != NULL){
+        busy = true;
+    }
+    if(busy){
+        sched->busyTime_ms += timeDifference_ms;
+    }
+
+    return busy ? false : true;
+}
@@ -89,6 +89,31 @@ typedef struct{
 }CO_SDOclientPar_t;
 
 
+/**
+ * SDO client request, see CO_SDOclientSched_t.
+ */
+typedef struct CO_SDOclientReq CO_SDOclientReq_t;
+
+
+/**
+ * Round-trip time statistics of SDO client.
+ *
+ * Time is measured from the transmitted request to the processed server
+ * response in expedited and segmented transfers. Resolution is given by the
+ * calls of the client process function, so for a latency benchmark client
+ * should be processed by CO_SDOclientDownload_us() or CO_SDOclientUpload_us()
+ * from a thread woken by the receive callback. Statistics are cleared by
+ * CO_SDOclient_init() and may be cleared by application.
+ */
+typedef struct{
+    uint32_t            last_us;    /**< Last round-trip time */
+    uint32_t            min_us;     /**< Minimum round-trip time */
+    uint32_t            max_us;     /**< Maximum round-trip time */
+    uint32_t            sum_us;     /**< Sum of round-trip times, for average */
+    uint32_t            count;      /**< Number of measured round trips */
+}CO_SDOclientRtt_t;
+
+
 /**
  * SDO client object
  */
@@ -112,14 +137,18 @@ typedef struct{
     uint32_t            dataSize;
     /** Data length transferred in block transfer */
     uint32_t            dataSizeTransfered;
-    /** Timeout timer for SDO communication */
-    uint16_t            timeoutTimer;
-    /** Timeout timer for SDO block transfer */
-    uint16_t            timeoutTimerBLOCK;
+    /** Timeout timer for SDO communication in microseconds */
+    uint32_t            timeoutTimer;
+    /** Timeout timer for SDO block transfer in microseconds */
+    uint32_t            timeoutTimerBLOCK;
+    /** Round-trip time of expedited and segmented transfers */
+    CO_SDOclientRtt_t   rtt;
     /** Index of current object in Object Dictionary */
     uint16_t            index;
     /** Subindex of current object in Object Dictionary */
     uint8_t             subIndex;
+    /** True, if all sub-indexes are uploaded, see CO_SDOclientUploadInitiateComplete() */
+    bool_t              completeAccess;
     /** From CO_SDOclient_init() */
     CO_CANmodule_t     *CANdevRx;
     /** From CO_SDOclient_init() */
@@ -153,14 +182,121 @@ typedef struct{
     uint8_t             block_noData;
     /** Server CRC support in block transfer */
     uint8_t             crcEnabled;
+    /** Block size adaptation in block upload (limited by block_size_max) and
+    statistics of the current or last transfer */
+    CO_SDO_blkAdapt_t   blkAdapt;
     /** Previous value of the COB_IDClientToServer */
     uint32_t            COB_IDClientToServerPrev;
     /** Previous value of the COB_IDServerToClient */
     uint32_t            COB_IDServerToClientPrev;
+    /** Request from CO_SDOclientSched_t, which is processed by this client, or NULL */
+    CO_SDOclientReq_t  *schedReq;
+    /** From CO_SDOclientUploadInitiateSink() or NULL */
+    uint32_t          (*pFunctSink)(void *object, const uint8_t *data, uint32_t length, bool_t last);
+    /** From CO_SDOclientUploadInitiateSink() */
+    void               *sinkObject;
+    /** Number of bytes passed to pFunctSink */
+    uint32_t            sinkOffset;
+    /** CRC of bytes passed to pFunctSink in block upload */
+    uint16_t            sinkCrc;
+    /** From CO_SDOclientDownloadInitiateSource() or NULL */
+    const uint8_t*    (*pFunctSource)(void *object, uint32_t offset, uint32_t *length);
+    /** From CO_SDOclientDownloadInitiateSource() */
+    void               *sourceObject;
+    /** Current window returned from pFunctSource */
+    const uint8_t      *srcWindow;
+    /** Offset of srcWindow in the object */
+    uint32_t            srcWindowOffset;
+    /** Size of srcWindow */
+    uint32_t            srcWindowSize;
+    /** Number of bytes from the source included in srcCrc */
+    uint32_t            srcCrcOffset;
+    /** CRC of bytes from the source in block download */
+    uint16_t            srcCrc;
 
 }CO_SDOclient_t;
 
 
+/**
+ * SDO client request.
+ *
+ * Request is prepared by application and passed to CO_SDOclientSched_submit().
+ * Object must stay valid until pFunctDone is called.
+ */
+struct CO_SDOclientReq{
+    /** Node-ID of the SDO server, 1 to 127 */
+    uint8_t             nodeId;
+    /** Index of the object in the Object Dictionary of the server */
+    uint16_t            index;
+    /** Subindex of the object in the Object Dictionary of the server */
+    uint8_t             subIndex;
+    /** True for upload (read from server), false for download */
+    bool_t              upload;
+    /** If true, block transfer is used, if possible */
+    bool_t              blockEnable;
+    /** If true, upload reads the whole array or record, see
+    CO_SDOclientUploadInitiateComplete(). blockEnable is then ignored. */
+    bool_t              completeAccess;
+    /** Data to download or buffer for upload */
+    uint8_t            *buffer;
+    /** Size of data to download or size of the buffer for upload */
+    uint32_t            bufferSize;
+    /** Number of repeats after timeout, not changed by the scheduler */
+    uint8_t             retries;
+    /** Callback called after request is finished (successfully or not). It is
+    called from CO_SDOclientSched_process(). May be NULL. */
+    void              (*pFunctDone)(void *object, CO_SDOclientReq_t *req);
+    /** Object passed to pFunctDone */
+    void               *object;
+    /** Result: number of uploaded bytes */
+    uint32_t            dataSize;
+    /** Result: CO_SDOcli_ok_communicationEnd or error, valid after pFunctDone */
+    CO_SDOclient_return_t result;
+    /** Result: #CO_SDO_abortCode_t */
+    uint32_t            abortCode;
+    /** Internal: next request in the queue */
+    CO_SDOclientReq_t  *next;
+    /** Internal: remaining repeats, set from retries by CO_SDOclientSched_submit() */
+    uint8_t             retriesLeft;
+};
+
+
+/**
+ * Scheduler of SDO client requests.
+ *
+ * Scheduler executes queued requests concurrently on all SDO client objects
+ * (#CO_NO_SDO_CLIENT). Each free client takes the first request from the queue,
+ * whose server is not being accessed by other client (SDO server has only one
+ * default channel), configures COB-IDs for its node and starts the transfer.
+ * Requests ended with timeout are repeated up to _retries_ times.
+ *
+ * All functions must be called from the same thread. SDO clients used by the
+ * scheduler must not be used by the application directly.
+ */
+typedef struct{
+    /** From CO_SDOclientSched_init() */
+    CO_SDOclient_t    **SDOclients;
+    /** From CO_SDOclientSched_init() */
+    uint8_t             numClients;
+    /** From CO_SDOclientSched_init() */
+    uint16_t            SDOtimeoutTime;
+    /** First request in the queue */
+    CO_SDOclientReq_t  *first;
+    /** Last request in the queue */
+    CO_SDOclientReq_t  *last;
+    /** Statistics: number of requests finished successfully */
+    uint32_t            completed;
+    /** Statistics: number of requests finished with error */
+    uint32_t            failed;
+    /** Statistics: number of repeated requests */
+    uint32_t            retried;
+    /** Statistics: time from submission into empty scheduler until all
+    requests are finished, in milliseconds. For example total commissioning
+    time of the network. */
+    uint32_t            busyTime_ms;
+}CO_SDOclientSched_t;
+
+
 /**
  * Initialize SDO client object.
  *
@@ -259,6 +395,46 @@ CO_SDOclient_return_t CO_SDOclientDownloadInitiate(
         uint8_t                 blockEnable);
 
 
+/**
+ * Initiate SDO download communication from source.
+ *
+ * Same as CO_SDOclientDownloadInitiate(), but data are not taken from
+ * contiguous buffer. They are fetched on demand from the source function,
+ * just before segment is sent, so large objects (firmware image, for
+ * example) need not be copied into RAM. Source is accessed only by offset
+ * and is not written, so the same source (memory mapped image file, for
+ * example) may be shared by multiple SDO clients, which download to different
+ * nodes in parallel.
+ *
+ * If source returns no data, client waits and asks again in the next call
+ * of CO_SDOclientDownload(). In block download CRC is calculated on data,
+ * when they are sent the first time. Repeated segments are fetched again.
+ *
+ * If server is this node, source must return all data in one window.
+ *
+ * @param SDO_C This object.
+ * @param index Index of object in object dictionary in remote node.
+ * @param subIndex Subindex of object in object dictionary in remote node.
+ * @param pFunctSource Function, which returns pointer to data at _offset_
+ * and writes number of contiguous bytes available there into _length_. It
+ * returns NULL, if data are not available yet. Data must stay valid until
+ * the next call of the function or until end of communication.
+ * @param object Pointer to object passed to pFunctSource.
+ * @param dataSize Total size of data.
+ * @param blockEnable Try to initiate block transfer.
+ *
+ * @return #CO_SDOclient_return_t
+ */
+CO_SDOclient_return_t CO_SDOclientDownloadInitiateSource(
+        CO_SDOclient_t         *SDO_C,
+        uint16_t                index,
+        uint8_t                 subIndex,
+        const uint8_t*        (*pFunctSource)(void *object, uint32_t offset, uint32_t *length),
+        void                   *object,
+        uint32_t                dataSize,
+        uint8_t                 blockEnable);
+
+
 /**
  * Process SDO download communication.
  *
@@ -281,6 +457,28 @@ CO_SDOclient_return_t CO_SDOclientDownload(
         uint32_t               *pSDOabortCode);
 
 
+/**
+ * Process SDO download communication with microsecond time base.
+ *
+ * Same as CO_SDOclientDownload(), which calls this function. It may be called
+ * from a thread woken by the callback from CO_SDOclient_initCallback(), so the next
+ * request is sent immediately after the response is received. Time is then
+ * taken from a monotonic clock.
+ *
+ * @param SDO_C This object.
+ * @param timeDifference_us Time difference from previous function call in [microseconds].
+ * @param SDOtimeoutTime_us Timeout time for SDO communication in microseconds.
+ * @param pSDOabortCode See CO_SDOclientDownload().
+ *
+ * @return #CO_SDOclient_return_t
+ */
+CO_SDOclient_return_t CO_SDOclientDownload_us(
+        CO_SDOclient_t         *SDO_C,
+        uint32_t                timeDifference_us,
+        uint32_t                SDOtimeoutTime_us,
+        uint32_t               *pSDOabortCode);
+
+
 /**
  * Initiate SDO upload communication.
  *
@@ -309,6 +507,81 @@ CO_SDOclient_return_t CO_SDOclientUploadInitiate(
         uint8_t                 blockEnable);
 
 
+/**
+ * Initiate SDO upload communication into sink.
+ *
+ * Same as CO_SDOclientUploadInitiate(), but received data are passed
+ * incrementally to the sink function (into ring buffer or file, for example),
+ * so size of the object is not limited by the size of the buffer. Buffer is
+ * used only for data not yet accepted by the sink. In block upload data are
+ * passed to the sink after each sub-block, which was acknowledged, and CRC is
+ * calculated on the passed data. The last part of the data is passed after
+ * the CRC was verified.
+ *
+ * If sink accepts less data than offered, client does not request next segment
+ * or sub-block until there is space for it in the buffer (flow control). Sink
+ * should not delay the transfer longer than SDO timeout of the server.
+ *
+ * If server is this node, object is read in one piece, which must fit into the
+ * buffer and must be accepted by the sink completely.
+ *
+ * CO_SDOclientUpload() returns the total number of bytes passed to the sink.
+ *
+ * @param SDO_C This object.
+ * @param index Index of object in object dictionary in remote node.
+ * @param subIndex Subindex of object in object dictionary in remote node.
+ * @param buffer Pointer to the working buffer, valid until end of communication.
+ * @param bufferSize Size of the buffer, at least 7 bytes. Block size is
+ * limited to bufferSize / 7 segments.
+ * @param pFunctSink Function, which receives the data. It is called from
+ * CO_SDOclientUpload(). It returns number of accepted bytes from 0 to _length_.
+ * _last_ is true, if _data_ end with the last byte of the object. With the
+ * last call, _last_ is true and all data are accepted.
+ * @param object Pointer to object passed to pFunctSink.
+ * @param blockEnable Try to initiate block transfer.
+ *
+ * @return #CO_SDOclient_return_t
+ */
+CO_SDOclient_return_t CO_SDOclientUploadInitiateSink(
+        CO_SDOclient_t         *SDO_C,
+        uint16_t                index,
+        uint8_t                 subIndex,
+        uint8_t                *buffer,
+        uint32_t                bufferSize,
+        uint32_t              (*pFunctSink)(void *object, const uint8_t *data, uint32_t length, bool_t last),
+        void                   *object,
+        uint8_t                 blockEnable);
+
+
+/**
+ * Initiate SDO upload of the whole array or record (complete access).
+ *
+ * Same as CO_SDOclientUploadInitiate(), but all sub-indexes of the object are
+ * read in one segmented transfer. Values are packed back-to-back in the
+ * dataRx, each with its length from the Object dictionary of the server,
+ * subIndex 0 is one byte. Block transfer is not used, because block protocol
+ * has no complete access flag.
+ *
+ * To read several objects concurrently over multiple SDO channels, submit
+ * requests with _completeAccess_ set to CO_SDOclientSched_submit().
+ *
+ * @param SDO_C This object.
+ * @param index Index of array or record in object dictionary in remote node.
+ * @param subIndex 0 to include subIndex 0 in the data or 1 to start with
+ * the first element.
+ * @param dataRx Pointer to data buffer, into which received data will be written.
+ * @param dataRxSize Size of dataRx.
+ *
+ * @return #CO_SDOclient_return_t
+ */
+CO_SDOclient_return_t CO_SDOclientUploadInitiateComplete(
+        CO_SDOclient_t         *SDO_C,
+        uint16_t                index,
+        uint8_t                 subIndex,
+        uint8_t                *dataRx,
+        uint32_t                dataRxSize);
+
+
 /**
  * Process SDO upload communication.
  *
@@ -334,6 +607,28 @@ CO_SDOclient_return_t CO_SDOclientUpload(
         uint32_t               *pSDOabortCode);
 
 
+/**
+ * Process SDO upload communication with microsecond time base.
+ *
+ * Same as CO_SDOclientUpload(), which calls this function. See
+ * CO_SDOclientDownload_us().
+ *
+ * @param SDO_C This object.
+ * @param timeDifference_us Time difference from previous function call in [microseconds].
+ * @param SDOtimeoutTime_us Timeout time for SDO communication in microseconds.
+ * @param pDataSize See CO_SDOclientUpload().
+ * @param pSDOabortCode See CO_SDOclientUpload().
+ *
+ * @return #CO_SDOclient_return_t
+ */
+CO_SDOclient_return_t CO_SDOclientUpload_us(
+        CO_SDOclient_t         *SDO_C,
+        uint32_t                timeDifference_us,
+        uint32_t                SDOtimeoutTime_us,
+        uint32_t               *pDataSize,
+        uint32_t               *pSDOabortCode);
+
+
 /**
  * Close SDO communication temporary.
  *
@@ -343,6 +638,56 @@ CO_SDOclient_return_t CO_SDOclientUpload(
  */
 void CO_SDOclientClose(CO_SDOclient_t *SDO_C);
 
+
+/**
+ * Initialize SDO client scheduler.
+ *
+ * @param sched This object will be initialized.
+ * @param SDOclients Array of pointers to initialized SDO client objects.
+ * @param numClients Number of SDO client objects.
+ * @param SDOtimeoutTime Timeout time for SDO communication in milliseconds.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_SDOclientSched_init(
+        CO_SDOclientSched_t    *sched,
+        CO_SDOclient_t         *SDOclients[],
+        uint8_t                 numClients,
+        uint16_t                SDOtimeoutTime);
+
+
+/**
+ * Add requests to the end of the queue.
+ *
+ * @param sched This object.
+ * @param reqs Array of requests.
+ * @param numReqs Number of requests.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT. If
+ * any request is invalid, none is added.
+ */
+CO_ReturnError_t CO_SDOclientSched_submit(
+        CO_SDOclientSched_t    *sched,
+        CO_SDOclientReq_t       reqs[],
+        uint16_t                numReqs);
+
+
+/**
+ * Process SDO client scheduler.
+ *
+ * Function must be called cyclically, for example from mainline.
+ *
+ * @param sched This object.
+ * @param timeDifference_ms Time difference from previous function call in [milliseconds].
+ * @param [out] timerNext_ms info to OS - see CO_process().
+ *
+ * @return true, if there are no queued or active requests.
+ */
+bool_t CO_SDOclientSched_process(
+        CO_SDOclientSched_t    *sched,
+        uint16_t                timeDifference_ms,
+        uint16_t               *timerNext_ms);
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
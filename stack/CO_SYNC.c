@@ -30,6 +30,17 @@
 #include "CO_NMT_Heartbeat.h"
 #include "CO_SYNC.h"
 
+/*
+ * Current time from time source or from software clock.
+ */
+static uint32_t CO_SYNC_time(CO_SYNC_t *SYNC){
+    if(SYNC->getTime_us != NULL){
+        return SYNC->getTime_us(SYNC->timeSourceObject);
+    }
+    return SYNC->timeNow_us;
+}
+
+
 /*
  * Read received message from CAN module.
  *
@@ -45,9 +56,13 @@ static void CO_SYNC_receive(void *object, const CO_CANrxMsg_t *msg){
     operState = *SYNC->operatingState;
 
     if((operState == CO_NMT_OPERATIONAL) || (operState == CO_NMT_PRE_OPERATIONAL)){
+        /* timestamp is taken before anything else */
+        uint32_t timestamp = CO_SYNC_time(SYNC);
+        bool_t received = false;
+
         if(SYNC->counterOverflowValue == 0){
             if(msg->DLC == 0U){
-                SET_CANrxNew(SYNC->CANrxNew);
+                received = true;
             }
             else{
                 SYNC->receiveError = (uint16_t)msg->DLC | 0x0100U;
@@ -56,15 +71,22 @@ static void CO_SYNC_receive(void *object, const CO_CANrxMsg_t *msg){
         else{
             if(msg->DLC == 1U){
                 SYNC->counter = msg->data[0];
-                SET_CANrxNew(SYNC->CANrxNew);
+                received = true;
             }
             else{
                 SYNC->receiveError = (uint16_t)msg->DLC | 0x0200U;
             }
         }
+        if(received){
+            SYNC->rxTimestamp_us = timestamp;
+            SET_CANrxNew(SYNC->CANrxNew);
+        }
         if(IS_CANrxNew(SYNC->CANrxNew)) {
             SYNC->CANrxToggle = SYNC->CANrxToggle ? false : true;
         }
+        if(received && SYNC->pFunctSignalPre != NULL){
+            SYNC->pFunctSignalPre(SYNC->functSignalObjectPre);
+        }
     }
 }
 
@@ -113,6 +135,7 @@ static CO_SDO_abortCode_t CO_ODF_1005(CO_ODF_arg_t *ODF_arg){
                     SYNC->counter = 0U;
                     SYNC->timer = 0U;
                 }
+                SYNC->producerTimer = 0U;
                 SYNC->CANtxBuff = CO_CANtxBufferInit(
                         SYNC->CANdevTx,         /* CAN device */
                         SYNC->CANdevTxIdx,      /* index of specific buffer inside CAN module */
@@ -168,6 +191,7 @@ static CO_SDO_abortCode_t CO_ODF_1006(CO_ODF_arg_t *ODF_arg){
         }
 
         SYNC->timer = 0;
+        SYNC->producerTimer = 0;
     }
 
     return ret;
@@ -216,6 +240,174 @@ static CO_SDO_abortCode_t CO_ODF_1019(CO_ODF_arg_t *ODF_arg){
 }
 
 
+/*
+ * Access jitter statistics from SDO server, common for CO_ODF_SYNCjitter()
+ * and CO_ODF_SYNClatency().
+ */
+static CO_SDO_abortCode_t CO_SYNC_ODFjitter(CO_ODF_arg_t *ODF_arg, CO_SYNC_t *SYNC, const CO_SYNC_jitter_t *jitter){
+    CO_SDO_abortCode_t ret = CO_SDO_AB_NONE;
+    uint8_t sub = ODF_arg->subIndex;
+
+    if(sub == 0U){
+        /* number of sub-indexes is read from OD */
+        if(!ODF_arg->reading){
+            ret = CO_SDO_AB_READONLY;
+        }
+    }
+    else if(ODF_arg->reading){
+        uint32_t value;
+
+        if(sub <= CO_SYNC_JITTER_BUCKETS){
+            value = jitter->hist[sub - 1U];
+        }
+        else if(sub == (CO_SYNC_JITTER_BUCKETS + 1U)){
+            value = jitter->maxLateness_us;
+        }
+        else if(sub == (CO_SYNC_JITTER_BUCKETS + 2U)){
+            value = jitter->count;
+        }
+        else if(sub == (CO_SYNC_JITTER_BUCKETS + 3U)){
+            value = jitter->missedCount;
+        }
+        else{
+            value = 0U;
+        }
+        CO_setUint32(ODF_arg->data, value);
+    }
+    else{
+        if(CO_getUint32(ODF_arg->data) == 0U){
+            CO_SYNC_clearJitter(SYNC);
+        }
+        else{
+            ret = CO_SDO_AB_INVALID_VALUE;
+        }
+    }
+
+    return ret;
+}
+
+
+/*
+ * Function for accessing SYNC producer jitter statistics from SDO server.
+ *
+ * OD entry is configured by CO_SYNC_configureJitter().
+ */
+static CO_SDO_abortCode_t CO_ODF_SYNCjitter(CO_ODF_arg_t *ODF_arg){
+    CO_SYNC_t *SYNC = (CO_SYNC_t*) ODF_arg->object;
+
+    return CO_SYNC_ODFjitter(ODF_arg, SYNC, &SYNC->jitter);
+}
+
+
+/*
+ * Function for accessing SYNC to TPDO latency statistics from SDO server.
+ *
+ * OD entry is configured by CO_SYNC_configureTPDOlatency().
+ */
+static CO_SDO_abortCode_t CO_ODF_SYNClatency(CO_ODF_arg_t *ODF_arg){
+    CO_SYNC_t *SYNC = (CO_SYNC_t*) ODF_arg->object;
+
+    return CO_SYNC_ODFjitter(ODF_arg, SYNC, &SYNC->tpdoLatency);
+}
+
+
+/*
+ * Clear statistics of one histogram.
+ */
+static void CO_SYNC_clearHist(CO_SYNC_jitter_t *jitter){
+    uint8_t i;
+
+    for(i=0U; i<CO_SYNC_JITTER_BUCKETS; i++){
+        jitter->hist[i] = 0U;
+    }
+    jitter->maxLateness_us = 0U;
+    jitter->count = 0U;
+    jitter->missedCount = 0U;
+}
+
+
+/*
+ * Clear jitter statistics, called from CO_SYNC_process() and init.
+ */
+static void CO_SYNC_resetJitter(CO_SYNC_t *SYNC){
+    CO_SYNC_clearHist(&SYNC->jitter);
+    CO_SYNC_clearHist(&SYNC->tpdoLatency);
+    SYNC->jitterClear = false;
+}
+
+
+/*
+ * Record lateness of the produced SYNC or TPDO latency into histogram.
+ */
+static void CO_SYNC_recordJitter(CO_SYNC_jitter_t *jitter, uint32_t lateness_us){
+    uint32_t limit = CO_SYNC_JITTER_RESOLUTION_US;
+    uint8_t i;
+
+    for(i=0U; i<(CO_SYNC_JITTER_BUCKETS - 1U); i++){
+        if(lateness_us < limit){
+            break;
+        }
+        limit <<= 1;
+    }
+    jitter->hist[i]++;
+    jitter->count++;
+    if(lateness_us > jitter->maxLateness_us){
+        jitter->maxLateness_us = lateness_us;
+    }
+}
+
+
+/*
+ * Estimate SYNC period, phase and jitter from the timestamp of received SYNC.
+ *
+ * Interval is compared with the nearest multiple of the estimated period, so
+ * missed SYNC messages do not disturb the estimation. Other irregular
+ * intervals restart it.
+ */
+static void CO_SYNC_estimate(CO_SYNC_t *SYNC, uint32_t timestamp){
+    const int32_t div = (int32_t)(1UL << CO_SYNC_EST_SHIFT);
+
+    if(SYNC->rxPrevValid){
+        uint32_t interval = timestamp - SYNC->rxPrev_us;
+        uint32_t period = SYNC->periodEst_us;
+        uint32_t n = 0U;
+        int32_t err = 0;
+        uint32_t errAbs = 0xFFFFFFFFUL;
+
+        if(period != 0U){
+            n = (interval + period / 2U) / period;
+            err = (int32_t)(interval - n * period);
+            errAbs = (err < 0) ? (uint32_t)(-err) : (uint32_t)err;
+        }
+
+        if((n != 0U) && (errAbs <= (period / 4U))){
+            uint32_t predicted = SYNC->phaseEst_us + n * period;
+            int32_t jitterErr = (int32_t)errAbs - (int32_t)SYNC->jitterEst_us;
+
+            SYNC->tpdoLatency.missedCount += n - 1U;
+            SYNC->periodEst_us = (uint32_t)((int32_t)period + (err / (int32_t)n) / div);
+            SYNC->phaseEst_us = predicted + (uint32_t)((int32_t)(timestamp - predicted) / div);
+            SYNC->jitterEst_us = (uint32_t)((int32_t)SYNC->jitterEst_us + jitterErr / div);
+            if(SYNC->lockCount < CO_SYNC_EST_LOCK_COUNT){
+                SYNC->lockCount++;
+            }
+            SYNC->locked = (SYNC->lockCount >= CO_SYNC_EST_LOCK_COUNT) ? true : false;
+        }
+        else{
+            /* first interval or irregular SYNC, restart */
+            SYNC->periodEst_us = interval;
+            SYNC->phaseEst_us = timestamp;
+            SYNC->jitterEst_us = 0U;
+            SYNC->lockCount = 0U;
+            SYNC->locked = false;
+        }
+    }
+    else{
+        SYNC->phaseEst_us = timestamp;
+    }
+}
+
+
 /******************************************************************************/
 CO_ReturnError_t CO_SYNC_init(
         CO_SYNC_t              *SYNC,
@@ -255,8 +447,26 @@ CO_ReturnError_t CO_SYNC_init(
     CLEAR_CANrxNew(SYNC->CANrxNew);
     SYNC->CANrxToggle = false;
     SYNC->timer = 0;
+    SYNC->producerTimer = 0;
     SYNC->counter = 0;
     SYNC->receiveError = 0U;
+    CO_SYNC_resetJitter(SYNC);
+    SYNC->syncTimestamp_us = 0U;
+    SYNC->getTime_us = NULL;
+    SYNC->timeSourceObject = NULL;
+    SYNC->timeNow_us = 0U;
+    SYNC->rxTimestamp_us = 0U;
+    SYNC->rxPrev_us = 0U;
+    SYNC->rxPrevValid = false;
+    SYNC->periodEst_us = 0U;
+    SYNC->phaseEst_us = 0U;
+    SYNC->jitterEst_us = 0U;
+    SYNC->lockCount = 0U;
+    SYNC->locked = false;
+    SYNC->phaseOffset_us = 0U;
+    SYNC->syncPending = false;
+    SYNC->pFunctSignalPre = NULL;
+    SYNC->functSignalObjectPre = NULL;
 
     SYNC->em = em;
     SYNC->operatingState = operatingState;
@@ -298,10 +508,19 @@ CO_ReturnError_t CO_SYNC_init(
 uint8_t CO_SYNC_process(
         CO_SYNC_t              *SYNC,
         uint32_t                timeDifference_us,
-        uint32_t                ObjDict_synchronousWindowLength)
+        uint32_t                ObjDict_synchronousWindowLength,
+        uint32_t               *timerNext_us)
 {
     uint8_t ret = 0;
     uint32_t timerNew;
+    uint32_t now;
+
+    if(SYNC->jitterClear){
+        CO_SYNC_resetJitter(SYNC);
+    }
+
+    SYNC->timeNow_us += timeDifference_us;
+    now = CO_SYNC_time(SYNC);
 
     if(*SYNC->operatingState == CO_NMT_OPERATIONAL || *SYNC->operatingState == CO_NMT_PRE_OPERATIONAL){
         /* update sync timer, no overflow */
@@ -310,14 +529,53 @@ uint8_t CO_SYNC_process(
 
         /* was SYNC just received */
         if(IS_CANrxNew(SYNC->CANrxNew)){
-            SYNC->timer = 0;
-            ret = 1;
+            uint32_t timestamp = SYNC->rxTimestamp_us;
             CLEAR_CANrxNew(SYNC->CANrxNew);
+
+            /* SYNC may be received after now was read */
+            if((int32_t)(now - timestamp) < 0){
+                now = timestamp;
+            }
+            CO_SYNC_estimate(SYNC, timestamp);
+            SYNC->rxPrev_us = timestamp;
+            SYNC->rxPrevValid = true;
+            SYNC->syncPending = true;
+            SYNC->timer = now - timestamp;
+        }
+
+        /* signal SYNC after phase offset from its reception */
+        if(SYNC->syncPending){
+            uint32_t elapsed = now - SYNC->rxPrev_us;
+
+            if(elapsed >= SYNC->phaseOffset_us){
+                SYNC->syncPending = false;
+                SYNC->syncTimestamp_us = SYNC->rxPrev_us;
+                ret = 1;
+            }
+            else if(timerNext_us != NULL){
+                if(*timerNext_us > (SYNC->phaseOffset_us - elapsed)){
+                    *timerNext_us = SYNC->phaseOffset_us - elapsed;
+                }
+            }
         }
 
         /* SYNC producer */
         if(SYNC->isProducer && SYNC->periodTime){
-            if(SYNC->timer >= SYNC->periodTime){
+            /* time since the ideal moment of the last SYNC, no overflow */
+            timerNew = SYNC->producerTimer + timeDifference_us;
+            SYNC->producerTimer = (timerNew >= SYNC->producerTimer) ? timerNew : 0xFFFFFFFFUL;
+
+            if(SYNC->producerTimer >= SYNC->periodTime){
+                uint32_t lateness = SYNC->producerTimer - SYNC->periodTime;
+
+                /* carry lateness over, skip missed periods */
+                if(lateness >= SYNC->periodTime){
+                    SYNC->jitter.missedCount += lateness / SYNC->periodTime;
+                }
+                SYNC->producerTimer = lateness % SYNC->periodTime;
+                CO_SYNC_recordJitter(&SYNC->jitter, lateness);
+                SYNC->syncTimestamp_us = now;
+
                 if(++SYNC->counter > SYNC->counterOverflowValue) SYNC->counter = 1;
                 SYNC->timer = 0;
                 ret = 1;
@@ -325,6 +583,14 @@ uint8_t CO_SYNC_process(
                 SYNC->CANtxBuff->data[0] = SYNC->counter;
                 CO_CANsend(SYNC->CANdevTx, SYNC->CANtxBuff);
             }
+
+            /* time to the next ideal SYNC moment */
+            if(timerNext_us != NULL){
+                uint32_t diff = SYNC->periodTime - SYNC->producerTimer;
+                if(*timerNext_us > diff){
+                    *timerNext_us = diff;
+                }
+            }
         }
 
         /* Synchronous PDOs are allowed only inside time window */
@@ -349,6 +615,8 @@ uint8_t CO_SYNC_process(
     }
     else {
         CLEAR_CANrxNew(SYNC->CANrxNew);
+        SYNC->syncPending = false;
+        SYNC->rxPrevValid = false;
     }
 
     /* verify error from receive function */
@@ -359,3 +627,67 @@ uint8_t CO_SYNC_process(
 
     return ret;
 }
+
+
+/******************************************************************************/
+void CO_SYNC_initTimeSource(
+        CO_SYNC_t              *SYNC,
+        void                   *object,
+        uint32_t              (*getTime_us)(void *object))
+{
+    if(SYNC != NULL){
+        SYNC->timeSourceObject = object;
+        SYNC->getTime_us = getTime_us;
+    }
+}
+
+
+/******************************************************************************/
+void CO_SYNC_initCallbackPre(
+        CO_SYNC_t              *SYNC,
+        void                   *object,
+        void                  (*pFunctSignal)(void *object))
+{
+    if(SYNC != NULL){
+        SYNC->functSignalObjectPre = object;
+        SYNC->pFunctSignalPre = pFunctSignal;
+    }
+}
+
+
+/******************************************************************************/
+void CO_SYNC_setPhaseOffset(CO_SYNC_t *SYNC, uint32_t phaseOffset_us){
+    SYNC->phaseOffset_us = phaseOffset_us;
+}
+
+
+/******************************************************************************/
+void CO_SYNC_configureJitter(
+        CO_SYNC_t              *SYNC,
+        CO_SDO_t               *SDO,
+        uint16_t                index)
+{
+    CO_OD_configure(SDO, index, CO_ODF_SYNCjitter, (void*)SYNC, 0, 0);
+}
+
+
+/******************************************************************************/
+void CO_SYNC_configureTPDOlatency(
+        CO_SYNC_t              *SYNC,
+        CO_SDO_t               *SDO,
+        uint16_t                index)
+{
+    CO_OD_configure(SDO, index, CO_ODF_SYNClatency, (void*)SYNC, 0, 0);
+}
+
+
+/******************************************************************************/
+void CO_SYNC_clearJitter(CO_SYNC_t *SYNC){
+    SYNC->jitterClear = true;
+}
+
+
+/******************************************************************************/
+void CO_SYNC_recordTPDO(CO_SYNC_t *SYNC){
+    CO_SYNC_recordJitter(&SYNC->tpdoLatency, CO_SYNC_time(SYNC) - SYNC->syncTimestamp_us);
+}
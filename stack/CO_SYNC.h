@@ -58,9 +58,93 @@ extern "C" {
  * transmitted, internal variable CANrxToggle toggles. That variable is then
  * used by synchronous RPDO to determine, which of the two buffers is used for
  * RPDO reception and which for RPDO processing.
+ *
+ * ####SYNC producer timing
+ * SYNC producer is scheduled against the ideal SYNC moments, which are spaced
+ * exactly by _Communication cycle period_. If SYNC is transmitted late, the
+ * lateness is carried over to the next period instead of restarting the
+ * period, so late ticks of the calling thread do not accumulate into drift.
+ * If more than one period is missed, missed SYNC messages are not sent, but
+ * are counted. CO_SYNC_process() returns the time to the next SYNC moment in
+ * timerNext_us, so the calling thread can arm an absolute monotonic timer
+ * (for example timerfd with TFD_TIMER_ABSTIME on Linux or Timeout on mbed).
+ *
+ * Lateness of each produced SYNC is recorded into a histogram with
+ * #CO_SYNC_JITTER_BUCKETS buckets. Histogram may be mapped to the Object
+ * Dictionary with CO_SYNC_configureJitter().
+ *
+ * ####SYNC consumer timing
+ * Receive function timestamps each SYNC with the time source from
+ * CO_SYNC_initTimeSource() or, if there is none, with the software clock
+ * advanced by CO_SYNC_process(). CO_SYNC_process() estimates SYNC period,
+ * phase and jitter from the timestamps. Missed SYNC messages are detected
+ * and counted in tpdoLatency.missedCount, other outliers restart the
+ * estimation.
+ *
+ * Callback from CO_SYNC_initCallbackPre() is called from the receive function,
+ * so the application can run CO_process_SYNC(), CO_process_RPDO() and
+ * CO_process_TPDO() immediately after the SYNC instead of on the next timer
+ * tick. If phase offset is configured with CO_SYNC_setPhaseOffset(),
+ * CO_SYNC_process() signals the SYNC that much after its reception and
+ * returns remaining time in timerNext_us.
+ *
+ * ####SYNC to TPDO latency
+ * CO_TPDO_process() calls CO_SYNC_recordTPDO() for each synchronous TPDO
+ * passed to CO_CANsend(). Time from the last received or produced SYNC is
+ * recorded into separate histogram, which may be mapped to the Object
+ * Dictionary with CO_SYNC_configureTPDOlatency(). Time is meaningful only
+ * with time source from CO_SYNC_initTimeSource(), software clock advances
+ * only between calls to CO_SYNC_process().
  */
 
 
+/**
+ * Number of buckets in the SYNC producer jitter histogram.
+ *
+ * Bucket 0 counts SYNC messages, which were late less than
+ * #CO_SYNC_JITTER_RESOLUTION_US, bucket i counts lateness less than
+ * (#CO_SYNC_JITTER_RESOLUTION_US << i) and the last bucket counts all larger.
+ */
+#ifndef CO_SYNC_JITTER_BUCKETS
+#define CO_SYNC_JITTER_BUCKETS          8U
+#endif
+
+/** Width of the first bucket of the jitter histogram in [microseconds]. */
+#ifndef CO_SYNC_JITTER_RESOLUTION_US
+#define CO_SYNC_JITTER_RESOLUTION_US    25U
+#endif
+
+/**
+ * Filter constant of the SYNC consumer estimation. Each new SYNC changes
+ * estimated period, phase and jitter by 1/(2^CO_SYNC_EST_SHIFT) of the error.
+ */
+#ifndef CO_SYNC_EST_SHIFT
+#define CO_SYNC_EST_SHIFT               3U
+#endif
+
+/** Number of consecutive regular SYNC intervals, before estimation is locked. */
+#ifndef CO_SYNC_EST_LOCK_COUNT
+#define CO_SYNC_EST_LOCK_COUNT          8U
+#endif
+
+
+/**
+ * Jitter statistics of the SYNC producer or SYNC to TPDO latency.
+ */
+typedef struct{
+    /** Histogram of SYNC lateness or TPDO latency, see #CO_SYNC_JITTER_BUCKETS */
+    uint32_t            hist[CO_SYNC_JITTER_BUCKETS];
+    /** Largest recorded value in [microseconds] */
+    uint32_t            maxLateness_us;
+    /** Number of recorded values */
+    uint32_t            count;
+    /** Number of missed SYNC messages. In jitter it counts produced messages
+    not sent, because more than one period was missed. In tpdoLatency it counts
+    received messages missing, as detected by the consumer estimation. */
+    uint32_t            missedCount;
+}CO_SYNC_jitter_t;
+
+
 /**
  * SYNC producer and consumer object.
  */
@@ -94,6 +178,48 @@ typedef struct{
     /** Timer for the SYNC message in [microseconds].
     Set to zero after received or transmitted SYNC message */
     uint32_t            timer;
+    /** Time since the ideal moment of the last produced SYNC in [microseconds].
+    Lateness is carried over, so it is not reset on transmission. */
+    uint32_t            producerTimer;
+    /** Jitter statistics of the SYNC producer, lateness of transmission and
+    messages not sent. Not used by the consumer. */
+    CO_SYNC_jitter_t    jitter;
+    /** Latency between the last SYNC and transmission of synchronous TPDOs,
+    see CO_SYNC_recordTPDO(). missedCount counts SYNC messages missed by the
+    consumer, as detected by the estimation. */
+    CO_SYNC_jitter_t    tpdoLatency;
+    /** Time of the last received or produced SYNC in [microseconds] */
+    uint32_t            syncTimestamp_us;
+    /** Set by CO_SYNC_clearJitter(), statistics are cleared in CO_SYNC_process() */
+    volatile bool_t     jitterClear;
+    /** From CO_SYNC_initTimeSource() or NULL */
+    uint32_t          (*getTime_us)(void *object);
+    void               *timeSourceObject;/**< From CO_SYNC_initTimeSource() */
+    /** Software clock in [microseconds], advanced by CO_SYNC_process() */
+    volatile uint32_t   timeNow_us;
+    /** Time of the last received SYNC in [microseconds], written by receive function */
+    volatile uint32_t   rxTimestamp_us;
+    /** Time of the previous SYNC used by estimation in [microseconds] */
+    uint32_t            rxPrev_us;
+    /** True, if rxPrev_us is valid */
+    bool_t              rxPrevValid;
+    /** Estimated SYNC period in [microseconds], 0 if unknown */
+    uint32_t            periodEst_us;
+    /** Estimated time of the last SYNC in [microseconds], filtered arrival time */
+    uint32_t            phaseEst_us;
+    /** Estimated mean deviation of the SYNC interval in [microseconds] */
+    uint32_t            jitterEst_us;
+    /** Number of consecutive regular SYNC intervals */
+    uint8_t             lockCount;
+    /** True, if estimation of SYNC period and phase is reliable */
+    bool_t              locked;
+    /** From CO_SYNC_setPhaseOffset(), in [microseconds] */
+    uint32_t            phaseOffset_us;
+    /** True, if received SYNC waits for phase offset to expire */
+    bool_t              syncPending;
+    /** From CO_SYNC_initCallbackPre() or NULL */
+    void              (*pFunctSignalPre)(void *object);
+    void               *functSignalObjectPre;/**< From CO_SYNC_initCallbackPre() */
     /** Set to nonzero value, if SYNC with wrong data length is received from CAN */
     uint16_t            receiveError;
     CO_CANmodule_t     *CANdevRx;       /**< From CO_SYNC_init() */
@@ -146,6 +272,9 @@ CO_ReturnError_t CO_SYNC_init(
  * @param timeDifference_us Time difference from previous function call in [microseconds].
  * @param ObjDict_synchronousWindowLength _Synchronous window length_ variable from
  * Object dictionary (index 0x1007).
+ * @param timerNext_us Return value - info to OS - time to the next SYNC moment
+ * in [microseconds], if device is SYNC producer. Value is only lowered. May be
+ * NULL.
  *
  * @return 0: No special meaning.
  * @return 1: New SYNC message recently received or was just transmitted.
@@ -154,7 +283,116 @@ CO_ReturnError_t CO_SYNC_init(
 uint8_t CO_SYNC_process(
         CO_SYNC_t              *SYNC,
         uint32_t                timeDifference_us,
-        uint32_t                ObjDict_synchronousWindowLength);
+        uint32_t                ObjDict_synchronousWindowLength,
+        uint32_t               *timerNext_us);
+
+
+/**
+ * Initialize SYNC time source.
+ *
+ * Time source is used for timestamps of received SYNC messages and for the
+ * time inside CO_SYNC_process(). It must be monotonic, free running 32-bit
+ * counter in microseconds, which may be read from interrupt. Without time
+ * source, software clock is used, with resolution of the CO_SYNC_process()
+ * calls. CO_init() calls this function, if driver defines #CO_GET_TIME_US.
+ *
+ * @param SYNC This object.
+ * @param object Pointer to object, which will be passed to getTime_us(). Can be NULL.
+ * @param getTime_us Pointer to the function or NULL for software clock.
+ */
+void CO_SYNC_initTimeSource(
+        CO_SYNC_t              *SYNC,
+        void                   *object,
+        uint32_t              (*getTime_us)(void *object));
+
+
+/**
+ * Initialize SYNC callback function.
+ *
+ * Function initializes optional callback function, which is called from
+ * receive function after SYNC is received. Callback should immediately wake
+ * the thread, which calls CO_process_SYNC() and processes PDOs. Callback is
+ * called from interrupt, so it must be short.
+ *
+ * @param SYNC This object.
+ * @param object Pointer to object, which will be passed to pFunctSignal(). Can be NULL.
+ * @param pFunctSignal Pointer to the callback function. Not called if NULL.
+ */
+void CO_SYNC_initCallbackPre(
+        CO_SYNC_t              *SYNC,
+        void                   *object,
+        void                  (*pFunctSignal)(void *object));
+
+
+/**
+ * Set phase offset of the synchronous PDO processing.
+ *
+ * CO_SYNC_process() signals received SYNC after offset from its reception.
+ * Offset must be inside synchronous window. Zero (default) signals SYNC
+ * immediately.
+ *
+ * @param SYNC This object.
+ * @param phaseOffset_us Offset in [microseconds].
+ */
+void CO_SYNC_setPhaseOffset(CO_SYNC_t *SYNC, uint32_t phaseOffset_us);
+
+
+/**
+ * Map SYNC jitter statistics to the Object Dictionary.
+ *
+ * OD entry is manufacturer specific ARRAY of UNSIGNED32. Sub-indexes from 1
+ * to #CO_SYNC_JITTER_BUCKETS contain histogram, next sub-index contains
+ * maxLateness_us, next count and next missedCount, produced SYNC messages
+ * not sent. Writing zero to any sub-index clears statistics. If OD entry does not exist, function does
+ * nothing.
+ *
+ * @param SYNC This object.
+ * @param SDO SDO server object.
+ * @param index Index of the OD entry.
+ */
+void CO_SYNC_configureJitter(
+        CO_SYNC_t              *SYNC,
+        CO_SDO_t               *SDO,
+        uint16_t                index);
+
+
+/**
+ * Map SYNC to TPDO latency statistics to the Object Dictionary.
+ *
+ * OD entry has the same structure as in CO_SYNC_configureJitter(). Here
+ * missedCount contains number of received SYNC messages missed by the consumer.
+ *
+ * @param SYNC This object.
+ * @param SDO SDO server object.
+ * @param index Index of the OD entry.
+ */
+void CO_SYNC_configureTPDOlatency(
+        CO_SYNC_t              *SYNC,
+        CO_SDO_t               *SDO,
+        uint16_t                index);
+
+
+/**
+ * Clear SYNC jitter and SYNC to TPDO latency statistics.
+ *
+ * Statistics are cleared on the next call to CO_SYNC_process(), so function
+ * may be called from any thread.
+ *
+ * @param SYNC This object.
+ */
+void CO_SYNC_clearJitter(CO_SYNC_t *SYNC);
+
+
+/**
+ * Record latency of synchronous TPDO from the last SYNC.
+ *
+ * Function is called by CO_TPDO_process() after synchronous TPDO was passed
+ * to CO_CANsend(). It must be called from the same thread as
+ * CO_SYNC_process().
+ *
+ * @param SYNC This object.
+ */
+void CO_SYNC_recordTPDO(CO_SYNC_t *SYNC);
 
 #ifdef __cplusplus
 }
@@ -25,6 +25,141 @@
 
 #include "CANopen.h"
 
+/*
+ * Local time from time source or from software clock.
+ */
+static uint32_t CO_TIME_local(CO_TIME_t *TIME){
+    if(TIME->getTime_us != NULL){
+        return TIME->getTime_us(TIME->timeSourceObject);
+    }
+    return TIME->timeNow_us;
+}
+
+
+/*
+ * Decode TIME_OF_DAY from message data into microseconds since 1984.
+ */
+static uint64_t CO_TIME_decode(const uint8_t data[]){
+    uint32_t ms;
+    uint16_t days;
+
+    ms = (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+         ((uint32_t)data[2] << 16) | ((uint32_t)(data[3] & 0x0FU) << 24);
+    days = (uint16_t)data[4] | (uint16_t)((uint16_t)data[5] << 8);
+
+    return ((uint64_t)days * 86400000ULL + ms) * 1000ULL;
+}
+
+
+/*
+ * Convert microseconds since 1984 into TIME_OF_DAY.
+ */
+static void CO_TIME_toTimeOfDay(TIME_OF_DAY *tod, uint64_t time_us){
+    uint64_t msTotal = time_us / 1000ULL;
+
+    tod->ullValue = 0;
+    tod->ms = (uint32_t)(msTotal % 86400000ULL);
+    tod->days = (uint16_t)(msTotal / 86400000ULL);
+}
+
+
+/*
+ * Encode TIME_OF_DAY into message data.
+ */
+static void CO_TIME_encode(uint8_t data[], const TIME_OF_DAY *tod){
+    uint32_t ms = tod->ms;
+    uint16_t days = tod->days;
+
+    data[0] = (uint8_t)ms;
+    data[1] = (uint8_t)(ms >> 8);
+    data[2] = (uint8_t)(ms >> 16);
+    data[3] = (uint8_t)((ms >> 24) & 0x0FU);
+    data[4] = (uint8_t)days;
+    data[5] = (uint8_t)(days >> 8);
+}
+
+
+/*
+ * CANopen time at local time, calculated from the clock mapping. Local time
+ * may be slightly before the reference.
+ */
+static uint64_t CO_TIME_project(const CO_TIME_t *TIME, uint32_t local){
+    int32_t elapsed = (int32_t)(local - TIME->refLocal_us);
+    int64_t correction = ((int64_t)elapsed * TIME->drift_ppb) / 1000000000LL;
+
+    return TIME->refTime_us + (uint64_t)((int64_t)elapsed + correction);
+}
+
+
+/*
+ * Change clock mapping, enclosed by sequence counter.
+ */
+static void CO_TIME_setRef(CO_TIME_t *TIME, uint32_t local, uint64_t time_us){
+    TIME->seq++;
+    CO_TIME_BARRIER();
+    TIME->refLocal_us = local;
+    TIME->refTime_us = time_us;
+    TIME->clockValid = true;
+    CO_TIME_BARRIER();
+    TIME->seq++;
+}
+
+
+/*
+ * Discipline local clock with received TIME.
+ */
+static void CO_TIME_discipline(CO_TIME_t *TIME, uint32_t local, uint64_t received){
+    int64_t offset = 0;
+
+    if(TIME->clockValid){
+        offset = (int64_t)(received - CO_TIME_project(TIME, local));
+    }
+
+    if(!TIME->clockValid || offset > CO_TIME_STEP_US || offset < -CO_TIME_STEP_US){
+        /* step the clock, restart drift measurement */
+        if(TIME->clockValid){
+            TIME->stepCount++;
+        }
+        CO_TIME_setRef(TIME, local, received);
+    }
+    else{
+        int32_t off = (int32_t)offset;
+        uint32_t offAbs = (off < 0) ? (uint32_t)(-off) : (uint32_t)off;
+        uint32_t interval = local - TIME->rxPrevLocal_us;
+        int32_t drift = TIME->drift_ppb;
+
+        /* rate error since previous TIME */
+        if(TIME->rxPrevValid && interval != 0U){
+            int64_t rateErr = ((int64_t)off * 1000000000LL) / (int64_t)interval;
+            drift += (int32_t)(rateErr / (int64_t)(1UL << CO_TIME_DRIFT_SHIFT));
+            if(drift > CO_TIME_MAX_DRIFT_PPB){
+                drift = CO_TIME_MAX_DRIFT_PPB;
+            }
+            else if(drift < -CO_TIME_MAX_DRIFT_PPB){
+                drift = -CO_TIME_MAX_DRIFT_PPB;
+            }
+        }
+
+        TIME->seq++;
+        CO_TIME_BARRIER();
+        TIME->refTime_us = CO_TIME_project(TIME, local)
+                         + (uint64_t)(int64_t)(off / (int32_t)(1UL << CO_TIME_PHASE_SHIFT));
+        TIME->refLocal_us = local;
+        TIME->drift_ppb = drift;
+        CO_TIME_BARRIER();
+        TIME->seq++;
+
+        TIME->offset_us = off;
+        TIME->jitterEst_us = (uint32_t)((int32_t)TIME->jitterEst_us +
+            ((int32_t)offAbs - (int32_t)TIME->jitterEst_us) / (int32_t)(1UL << CO_TIME_PHASE_SHIFT));
+    }
+
+    TIME->rxPrevLocal_us = local;
+    TIME->rxPrevValid = true;
+    TIME->rxCount++;
+}
+
+
 /*
  * Read received message from CAN module.
  *
@@ -39,12 +174,15 @@ static void CO_TIME_receive(void *object, const CO_CANrxMsg_t *msg){
     operState = *TIME->operatingState;
 
     if((operState == CO_NMT_OPERATIONAL) || (operState == CO_NMT_PRE_OPERATIONAL)){
-        SET_CANrxNew(TIME->CANrxNew);
-        // Process Time from msg buffer
-        CO_memcpy((uint8_t*)&TIME->Time.ullValue, msg->data, msg->DLC);
-    }
-    else{
-        TIME->receiveError = (uint16_t)msg->DLC;
+        if(msg->DLC != TIME_MSG_LENGTH){
+            TIME->receiveError = (uint16_t)msg->DLC | 0x0100U;
+        }
+        /* previous message is not processed yet, keep it */
+        else if(!IS_CANrxNew(TIME->CANrxNew)){
+            TIME->rxTimestamp_us = CO_TIME_local(TIME);
+            CO_memcpy(TIME->rxData, msg->data, TIME_MSG_LENGTH);
+            SET_CANrxNew(TIME->CANrxNew);
+        }
     }
 }
 
@@ -81,6 +219,22 @@ CO_ReturnError_t CO_TIME_init(
     CLEAR_CANrxNew(TIME->CANrxNew);
     TIME->timer = 0;
     TIME->receiveError = 0U;
+    TIME->getTime_us = NULL;
+    TIME->timeSourceObject = NULL;
+    TIME->timeNow_us = 0U;
+    TIME->rxTimestamp_us = 0U;
+    TIME->seq = 0U;
+    TIME->refLocal_us = 0U;
+    TIME->refTime_us = 0U;
+    TIME->drift_ppb = 0;
+    TIME->clockValid = false;
+    TIME->rxPrevLocal_us = 0U;
+    TIME->rxPrevValid = false;
+    TIME->offset_us = 0;
+    TIME->jitterEst_us = 0U;
+    TIME->rxCount = 0U;
+    TIME->stepCount = 0U;
+    TIME->readFailures = 0U;
 
     TIME->em = em;
     TIME->operatingState = operatingState;
@@ -122,6 +276,15 @@ uint8_t CO_TIME_process(
 {
     uint8_t ret = 0;
     uint32_t timerNew;
+    uint32_t local;
+
+    TIME->timeNow_us += timeDifference_ms * 1000U;
+    local = CO_TIME_local(TIME);
+
+    /* move reference before elapsed time overflows */
+    if(TIME->clockValid && (local - TIME->refLocal_us) >= 0x40000000UL){
+        CO_TIME_setRef(TIME, local, CO_TIME_project(TIME, local));
+    }
 
     if(*TIME->operatingState == CO_NMT_OPERATIONAL || *TIME->operatingState == CO_NMT_PRE_OPERATIONAL){
         /* update TIME timer, no overflow */
@@ -130,18 +293,29 @@ uint8_t CO_TIME_process(
             TIME->timer = timerNew;
 
         /* was TIME just received */
-        if(TIME->CANrxNew){
+        if(IS_CANrxNew(TIME->CANrxNew)){
+            uint32_t timestamp = TIME->rxTimestamp_us;
+            uint64_t received = CO_TIME_decode(TIME->rxData);
+            CLEAR_CANrxNew(TIME->CANrxNew);
+
+            CO_TIME_discipline(TIME, timestamp, received);
+            CO_TIME_toTimeOfDay(&TIME->Time, received);
             TIME->timer = 0;
             ret = 1;
-            CLEAR_CANrxNew(TIME->CANrxNew);
         }
 
         /* TIME producer */
         if(TIME->isProducer && TIME->periodTime){
             if(TIME->timer >= TIME->periodTime){
-                TIME->timer = 0;
+                /* carry lateness over to the next period */
+                TIME->timer -= TIME->periodTime;
+                if(TIME->timer >= TIME->periodTime)
+                    TIME->timer = 0;
                 ret = 1;
-                CO_memcpy(TIME->TXbuff->data, (const uint8_t*)&TIME->Time.ullValue, TIME_MSG_LENGTH);
+                if(TIME->clockValid){
+                    CO_TIME_toTimeOfDay(&TIME->Time, CO_TIME_project(TIME, local));
+                }
+                CO_TIME_encode(TIME->TXbuff->data, &TIME->Time);
                 CO_CANsend(TIME->CANdevTx, TIME->TXbuff);
             }
         }
@@ -153,6 +327,7 @@ uint8_t CO_TIME_process(
     }
     else {
         CLEAR_CANrxNew(TIME->CANrxNew);
+        TIME->rxPrevValid = false;
     }
 
     /* verify error from receive function */
@@ -163,3 +338,53 @@ uint8_t CO_TIME_process(
 
     return ret;
 }
+
+
+/******************************************************************************/
+void CO_TIME_initTimeSource(
+        CO_TIME_t              *TIME,
+        void                   *object,
+        uint32_t              (*getTime_us)(void *object))
+{
+    if(TIME != NULL){
+        TIME->timeSourceObject = object;
+        TIME->getTime_us = getTime_us;
+    }
+}
+
+
+/******************************************************************************/
+void CO_TIME_set(CO_TIME_t *TIME, uint64_t time_us){
+    CO_TIME_setRef(TIME, CO_TIME_local(TIME), time_us);
+    TIME->rxPrevValid = false;
+}
+
+
+/******************************************************************************/
+bool_t CO_TIME_now(CO_TIME_t *TIME, uint64_t *time_us){
+    uint8_t retry;
+
+    if(TIME == NULL || time_us == NULL){
+        return false;
+    }
+
+    for(retry = 0U; retry < CO_TIME_RETRIES; retry++){
+        uint32_t seq = TIME->seq;
+        bool_t valid;
+        uint64_t t;
+
+        CO_TIME_BARRIER();
+        if((seq & 1U) != 0U){
+            continue;
+        }
+        valid = TIME->clockValid;
+        t = CO_TIME_project(TIME, CO_TIME_local(TIME));
+        CO_TIME_BARRIER();
+        if(TIME->seq == seq){
+            *time_us = t;
+            return valid;
+        }
+    }
+    TIME->readFailures++;
+    return false;
+}
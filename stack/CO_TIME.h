@@ -68,9 +68,66 @@ extern "C" {
  * - COB_ID_TIME : 0x40000100L -> TIME producer with TIME_COB_ID = 0x100
  * - TIMECyclePeriod : Time transmit period in ms
  *
- * Write time value in \p CO->TIME->Time variable, this will be sent at TIMECyclePeriod.
+ * Set time with CO_TIME_set(), current time from the local clock will be sent
+ * at TIMECyclePeriod. If time was never set, value of \p CO->TIME->Time
+ * variable is sent.
+ *
+ *
+ * ###LOCAL CLOCK
+ *
+ * TIME object keeps mapping from the local monotonic clock to CANopen time, so
+ * CO_TIME_now() returns current time between TIME messages, with resolution
+ * of the local clock. Local clock is the time source from
+ * CO_TIME_initTimeSource() or the software clock advanced by CO_TIME_process().
+ * Software clock has resolution of the CO_TIME_process() calls, usually 1 ms.
+ * socketCAN driver registers its time source in CO_Linux_tasks.c, mbed driver
+ * provides co_getTime_us(), which CO_init() registers through #CO_GET_TIME_US.
+ *
+ * Consumer timestamps received TIME messages with the local clock and
+ * compares them with the mapping. Offset is corrected gradually
+ * (#CO_TIME_PHASE_SHIFT), so arrival jitter is filtered, and rate of the
+ * local clock is corrected by estimated drift (#CO_TIME_DRIFT_SHIFT). Offsets
+ * larger than #CO_TIME_STEP_US step the clock. Mapping is protected by a
+ * sequence counter, so CO_TIME_now() may be called from any thread, for
+ * example to timestamp trace or emergency data.
  */
 
+
+/** Number of repeated reads in CO_TIME_now(), before reader gives up. */
+#ifndef CO_TIME_RETRIES
+#define CO_TIME_RETRIES         10U
+#endif
+
+/** Memory barrier between sequence counter and clock mapping access.
+ * CO_SEQLOCK_BARRIER() is from CO_SDO.h, CANrxMemoryBarrier() may be empty. */
+#ifndef CO_TIME_BARRIER
+#define CO_TIME_BARRIER()       CO_SEQLOCK_BARRIER()
+#endif
+
+/** Each received TIME corrects 1/(2^CO_TIME_PHASE_SHIFT) of the offset. */
+#ifndef CO_TIME_PHASE_SHIFT
+#define CO_TIME_PHASE_SHIFT     3U
+#endif
+
+/**
+ * Each received TIME corrects 1/(2^CO_TIME_DRIFT_SHIFT) of the rate error.
+ * Rate error of a single interval contains arrival jitter, so it must be
+ * filtered much more than offset.
+ */
+#ifndef CO_TIME_DRIFT_SHIFT
+#define CO_TIME_DRIFT_SHIFT     8U
+#endif
+
+/** Offset in [microseconds], above which local clock is stepped. */
+#ifndef CO_TIME_STEP_US
+#define CO_TIME_STEP_US         100000L
+#endif
+
+/** Limit of the estimated drift in [ppb]. */
+#ifndef CO_TIME_MAX_DRIFT_PPB
+#define CO_TIME_MAX_DRIFT_PPB   500000L
+#endif
+
 #define TIME_MSG_LENGTH 6U
 
 #ifndef timeOfDay_t
@@ -120,6 +177,39 @@ typedef struct{
     uint16_t            CANdevTxIdx;    /**< From CO_TIME_init() */
     CO_CANtx_t         *TXbuff;         /**< CAN transmit buffer */
     TIME_OF_DAY         Time;
+    /** From CO_TIME_initTimeSource() or NULL */
+    uint32_t          (*getTime_us)(void *object);
+    void               *timeSourceObject;/**< From CO_TIME_initTimeSource() */
+    /** Software clock in [microseconds], advanced by CO_TIME_process() */
+    volatile uint32_t   timeNow_us;
+    /** Local time of the last received TIME in [microseconds], written by receive function */
+    volatile uint32_t   rxTimestamp_us;
+    /** Data of the last received TIME, written by receive function */
+    uint8_t             rxData[TIME_MSG_LENGTH];
+    /** Sequence counter of the clock mapping, odd while it is being changed */
+    volatile uint32_t   seq;
+    /** Local time of the clock mapping reference in [microseconds] */
+    uint32_t            refLocal_us;
+    /** CANopen time at refLocal_us in [microseconds] since January 1, 1984 */
+    uint64_t            refTime_us;
+    /** Estimated rate error of the local clock in [ppb], added to its rate */
+    int32_t             drift_ppb;
+    /** True, if clock mapping was set by CO_TIME_set() or received TIME */
+    bool_t              clockValid;
+    /** Local time of the previous received TIME in [microseconds] */
+    uint32_t            rxPrevLocal_us;
+    /** True, if rxPrevLocal_us is valid */
+    bool_t              rxPrevValid;
+    /** Last measured offset between received TIME and local clock in [microseconds] */
+    int32_t             offset_us;
+    /** Estimated mean absolute offset of received TIME messages in [microseconds] */
+    uint32_t            jitterEst_us;
+    /** Number of received TIME messages used for the local clock */
+    uint32_t            rxCount;
+    /** Number of steps of the local clock */
+    uint32_t            stepCount;
+    /** Number of CO_TIME_now() calls abandoned after CO_TIME_RETRIES */
+    uint32_t            readFailures;
 }CO_TIME_t;
 
 /**
@@ -165,6 +255,50 @@ uint8_t CO_TIME_process(
         CO_TIME_t              *TIME,
         uint32_t                timeDifference_ms);
 
+
+/**
+ * Initialize TIME time source.
+ *
+ * Time source is used as the local clock. It must be monotonic, free running
+ * 32-bit counter in microseconds, which may be read from interrupt and from
+ * any thread, which calls CO_TIME_now(). Without time source, software clock
+ * is used, with resolution of the CO_TIME_process() calls. CO_init() calls
+ * this function, if driver defines #CO_GET_TIME_US.
+ *
+ * @param TIME This object.
+ * @param object Pointer to object, which will be passed to getTime_us(). Can be NULL.
+ * @param getTime_us Pointer to the function or NULL for software clock.
+ */
+void CO_TIME_initTimeSource(
+        CO_TIME_t              *TIME,
+        void                   *object,
+        uint32_t              (*getTime_us)(void *object));
+
+
+/**
+ * Set current time of the local clock.
+ *
+ * Used by TIME producer. Estimated drift is kept.
+ *
+ * @param TIME This object.
+ * @param time_us Time in [microseconds] since January 1, 1984.
+ */
+void CO_TIME_set(CO_TIME_t *TIME, uint64_t time_us);
+
+
+/**
+ * Get current time from the local clock.
+ *
+ * Function may be called from any thread.
+ *
+ * @param TIME This object.
+ * @param [out] time_us Time in [microseconds] since January 1, 1984.
+ *
+ * @return True, if time is valid. False, if clock was never set or received,
+ * or if consistent mapping could not be read.
+ */
+bool_t CO_TIME_now(CO_TIME_t *TIME, uint64_t *time_us);
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
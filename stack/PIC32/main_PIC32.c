@@ -281,7 +281,7 @@ void __ISR(_TIMER_2_VECTOR, IPL3SOFT) CO_TimerInterruptHandler(void){
         int i;
 
         /* Process Sync */
-        syncWas = CO_process_SYNC(CO, 1000);
+        syncWas = CO_process_SYNC(CO, 1000, NULL);
 
         /* Read inputs */
         CO_process_RPDO(CO, syncWas);
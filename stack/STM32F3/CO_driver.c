@@ -50,6 +50,7 @@
 #include "stm32f30x.h"
 #include "CO_driver.h"
 #include "CO_Emergency.h"
+#include "crc16-ccitt.h"
 #include <string.h>
 
 /* Private macro -------------------------------------------------------------*/
@@ -485,6 +486,38 @@ static uint8_t CO_CANsendToModule(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer)
     return 0;
 }
 
+#ifdef CO_CRC16_HW
+/******************************************************************************/
+unsigned short crc16_ccitt_hw(
+        const unsigned char     block[],
+        unsigned int            blockLength,
+        unsigned short          crc)
+{
+    unsigned int i = 0U;
+
+    /* CRC unit: 16 bit polynomial 0x1021, no reflection, initial value crc */
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_CRC, ENABLE);
+    CRC_PolynomialSizeSelect(CRC_PolSize_16);
+    CRC_SetPolynomial(0x1021);
+    CRC_ReverseInputDataSelect(CRC_ReverseInputData_No);
+    CRC_ReverseOutputDataCmd(DISABLE);
+    CRC_SetInitRegister(crc);
+    CRC_ResetDR();
+
+    /* Word is processed from the most significant byte */
+    for(; (i + 4U) <= blockLength; i += 4U){
+        CRC_CalcCRC(((uint32_t)block[i] << 24) | ((uint32_t)block[i+1] << 16) |
+                    ((uint32_t)block[i+2] << 8) | (uint32_t)block[i+3]);
+    }
+    for(; i < blockLength; i++){
+        CRC_CalcCRC8bits(block[i]);
+    }
+
+    return (unsigned short)CRC_GetCRC();
+}
+#endif
+
+
 /******************************************************************************/
 static void CO_CANClkSetting (void)
 {
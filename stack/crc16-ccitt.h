@@ -45,9 +45,37 @@ extern "C" {
  */
 
 
+/**
+ * CRC engine, calculates CRC sum on block of data.
+ *
+ * Engine must give the same result as crc16_ccitt_bytewise() and must accept
+ * any initial value, as blocks may be split into multiple segments.
+ */
+typedef unsigned short (*crc16_ccitt_engine_t)(
+        const unsigned char     block[],
+        unsigned int            blockLength,
+        unsigned short          crc);
+
+
 /**
  * Calculate CRC sum on block of data.
  *
+ * Function is used by the stack (SDO block transfer, OD storage). By default
+ * it calculates CRC byte by byte with 256 entry table (512 bytes of ROM).
+ * Other engine is selected at compile time:
+ *  - CO_CRC16_SLICE_BY_8: slice-by-8 algorithm, which processes eight bytes
+ *    per iteration and needs additional 3584 bytes of ROM.
+ *  - CO_CRC16_PCLMUL: carry-less multiplication on x86 (Linux gateways),
+ *    which folds 16 bytes per iteration. Compiler flags -mpclmul -mssse3 are
+ *    required.
+ *  - CO_CRC16_HW: hardware CRC unit of the microcontroller, provided by the
+ *    target driver as crc16_ccitt_hw() (stack/STM32F3/CO_driver.c).
+ *
+ * Engine may also be selected at run time with crc16_ccitt_setEngine(). If
+ * CO_USE_OWN_CRC16 is defined, this file is not compiled and application
+ * must provide this function. Throughput of the engines may be compared
+ * with tools/crc16_bench.c.
+ *
  * @param block Pointer to block of data.
  * @param blockLength Length of data in bytes;
  * @param crc Initial value (zero for xmodem). If block is split into
@@ -63,6 +91,92 @@ unsigned short crc16_ccitt_CO(
         unsigned int            blockLength,
         unsigned short          crc);
 
+
+#ifndef CO_USE_OWN_CRC16
+/**
+ * Calculate CRC sum on block of data, one byte per iteration.
+ *
+ * Parameters and return value are the same as in crc16_ccitt_CO().
+ */
+unsigned short crc16_ccitt_bytewise(
+        const unsigned char     block[],
+        unsigned int            blockLength,
+        unsigned short          crc);
+
+
+#if defined CO_CRC16_SLICE_BY_8 || defined CO_DOXYGEN
+/**
+ * Calculate CRC sum on block of data, eight bytes per iteration.
+ *
+ * Available, if CO_CRC16_SLICE_BY_8 is defined. Parameters and return value
+ * are the same as in crc16_ccitt_CO().
+ */
+unsigned short crc16_ccitt_sliceBy8(
+        const unsigned char     block[],
+        unsigned int            blockLength,
+        unsigned short          crc);
+#endif
+
+
+#if defined CO_CRC16_PCLMUL || defined CO_DOXYGEN
+/**
+ * Calculate CRC sum on block of data with x86 PCLMULQDQ instruction.
+ *
+ * Available, if CO_CRC16_PCLMUL is defined. Blocks shorter than 32 bytes
+ * and remaining bytes are calculated with software engine. Parameters and return value are the same as in
+ * crc16_ccitt_CO().
+ */
+unsigned short crc16_ccitt_pclmul(
+        const unsigned char     block[],
+        unsigned int            blockLength,
+        unsigned short          crc);
+#endif
+
+
+#if defined CO_CRC16_HW || defined CO_DOXYGEN
+/**
+ * Calculate CRC sum on block of data with hardware CRC unit.
+ *
+ * Used, if CO_CRC16_HW is defined. Function is implemented by the target
+ * driver, which configures CRC unit for polynomial 0x1021 without reflection
+ * and final xor on each call. It must not be used from other threads.
+ * Parameters and return value are the same as in crc16_ccitt_CO().
+ */
+unsigned short crc16_ccitt_hw(
+        const unsigned char     block[],
+        unsigned int            blockLength,
+        unsigned short          crc);
+#endif
+
+
+/**
+ * Select CRC engine used by crc16_ccitt_CO().
+ *
+ * Function should be called before CANopen communication starts, for example
+ * to use hardware CRC unit of the microcontroller, configured for polynomial
+ * 0x1021 without reflection and final xor. Hardware engine must load its
+ * initial value from argument _crc_ and must not be used from other threads.
+ *
+ * @param engine Pointer to engine or NULL for built-in software engine.
+ */
+void crc16_ccitt_setEngine(crc16_ccitt_engine_t engine);
+
+
+#if defined CO_CRC16_STATISTICS || defined CO_DOXYGEN
+/**
+ * Get usage of crc16_ccitt_CO().
+ *
+ * Available, if CO_CRC16_STATISTICS is defined. Together with a timer,
+ * values may be used to measure throughput of the selected engine. Counters
+ * are not protected, if function is used from multiple threads.
+ *
+ * @param [out] calls Number of calls, may be NULL.
+ * @param [out] bytes Number of processed bytes, may be NULL.
+ */
+void crc16_ccitt_getStatistics(unsigned long *calls, unsigned long *bytes);
+#endif
+#endif /* CO_USE_OWN_CRC16 */
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
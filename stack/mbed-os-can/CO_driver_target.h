@@ -150,6 +150,11 @@
  * variables as timer thread. This care must also take the application. Note
  * that not all variables are allowed to be mapped to PDOs, so they may not need
  * to be protected. SDO server protects sections with access to OD variables.
+ * Timer thread does not use CO_LOCK_OD(), so long SDO transfers can not delay
+ * it. Variables mapped to PDOs are protected by sequence lock of each PDO
+ * instead, see CO_PDOseqlock_t in CO_PDO.h. Sequence locks use their own
+ * barrier, CO_SEQLOCK_BARRIER() in CO_SDO.h, because CANrxMemoryBarrier() is
+ * empty here.
  *
  * ####CAN receive thread.
  * It partially processes received CAN data and puts them into appropriate
@@ -180,6 +185,23 @@ void co_unlock_od();
 #define CO_UNLOCK_OD()              co_unlock_od();
 
 
+/**
+ * Time source for CO_SYNC_initTimeSource() and CO_TIME_initTimeSource().
+ *
+ * Returns free running counter of the mbed us_ticker, which may be read from
+ * interrupt and from any thread. CO_init() registers it through
+ * #CO_GET_TIME_US, so SYNC and TIME timestamps have microsecond resolution
+ * instead of resolution of the CO_process() calls.
+ *
+ * @param object Not used.
+ *
+ * @return Time in [microseconds], overflows after 2^32.
+ */
+uint32_t co_getTime_us(void *object);
+/** Time source, which CO_init() registers to SYNC and TIME objects */
+#define CO_GET_TIME_US              co_getTime_us
+
+
 /**
  * @name Synchronization functions
  * synchronization for message buffer for communication between CAN receive and
@@ -46,6 +46,7 @@
 #include "mbed.h"
 #include "CANbus.h"
 #include "platform/PlatformMutex.h"
+#include "hal/us_ticker_api.h"
 
 extern "C" {
 #include "CO_driver.h"
@@ -119,6 +120,13 @@ void co_unlock_od()
 }
 
 
+uint32_t co_getTime_us(void *object)
+{
+    (void)object;
+    return us_ticker_read();
+}
+
+
 #if MBED_CONF_CANOPENNODE_TRACE
 static void printCANMessage(mbed::CANMessage& msg, CANCmdDirection dir)
 {
@@ -143,16 +143,16 @@ void CANrx_threadTmr_process(void)
   if (result < 0) {
     result = read(threadRT.interval_fd, &missed, sizeof(missed));
     if (result > 0) {
-      /* at least one timer interval occured */
-      CO_LOCK_OD();
-
+      /* at least one timer interval occured. No CO_LOCK_OD() here, so SDO
+       * transfers can not delay this thread. Data of each PDO is protected
+       * by its sequence lock, see CO_PDOseqlock_t. */
       if(CO->CANmodule[0]->CANnormal) {
 
         for (i = 0; i <= missed; i++) {
 
 #if CO_NO_SYNC == 1
           /* Process Sync */
-          syncWas = CO_process_SYNC(CO, threadRT.us_interval);
+          syncWas = CO_process_SYNC(CO, threadRT.us_interval, NULL);
 #else
           syncWas = false;
 #endif
@@ -163,8 +163,6 @@ void CANrx_threadTmr_process(void)
           CO_process_TPDO(CO, syncWas, threadRT.us_interval);
         }
       }
-
-      CO_UNLOCK_OD();
     }
   }
 }
@@ -183,12 +183,63 @@ static struct {
     int                 fdTmr;          /* file descriptor for taskTmr */
     struct itimerspec   tmrSpec;
     struct timespec    *tmrVal;
+    struct timespec     tmrGrid;        /* next shot of the periodic interval */
+    struct timespec     tmrPrev;        /* time of previous processing */
     long                intervalns;
     long                intervalus;
+    long                remainderns;    /* time not yet passed to processing */
+    volatile bool_t     syncReceived;   /* set by SYNC callback */
     uint16_t           *maxTime;
 } taskRT;
 
 
+/* Compare two timespec values, return true if a is before b. */
+static bool_t timespec_before(const struct timespec *a, const struct timespec *b) {
+    return (a->tv_sec < b->tv_sec) ||
+           (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+
+/* Add nanoseconds (less than one second) to timespec. */
+static void timespec_add(struct timespec *t, long ns) {
+    t->tv_nsec += ns;
+    if(t->tv_nsec >= NSEC_PER_SEC) {
+        t->tv_nsec -= NSEC_PER_SEC;
+        t->tv_sec++;
+    }
+}
+
+
+/* Time source for SYNC and TIME timestamps, monotonic clock in microseconds. */
+static uint32_t taskRT_getTime_us(void *object) {
+    struct timespec t;
+    (void)object;
+    if(clock_gettime(CLOCK_MONOTONIC, &t) == -1)
+        return 0;
+    return (uint32_t)t.tv_sec * 1000000UL + (uint32_t)(t.tv_nsec / 1000);
+}
+
+
+#if CO_NO_SYNC == 1
+/* Called from CAN receive (inside CO_CANrxWait) after SYNC is received. */
+static void taskRT_cbSync(void *object) {
+    (void)object;
+    taskRT.syncReceived = true;
+}
+#endif
+
+
+void CANrx_taskTmr_initSync(void) {
+#if CO_NO_SYNC == 1
+    CO_SYNC_initTimeSource(CO->SYNC, NULL, taskRT_getTime_us);
+    CO_SYNC_initCallbackPre(CO->SYNC, NULL, taskRT_cbSync);
+#endif
+#if CO_NO_TIME == 1
+    CO_TIME_initTimeSource(CO->TIME, NULL, taskRT_getTime_us);
+#endif
+}
+
+
 void CANrx_taskTmr_init(int fdEpoll, long intervalns, uint16_t *maxTime) {
     struct epoll_event ev;
 
@@ -222,6 +273,11 @@ void CANrx_taskTmr_init(int fdEpoll, long intervalns, uint16_t *maxTime) {
     if(timerfd_settime(taskRT.fdTmr, TFD_TIMER_ABSTIME, &taskRT.tmrSpec, NULL) != 0)
         CO_errExit("CANrx_taskTmr_init - timerfd_settime failed");
 
+    taskRT.tmrGrid = *taskRT.tmrVal;
+    taskRT.tmrPrev = *taskRT.tmrVal;
+    taskRT.remainderns = 0;
+    taskRT.syncReceived = false;
+    CANrx_taskTmr_initSync();
     taskRT.intervalns = intervalns;
     taskRT.intervalus = intervalns / 1000;
     taskRT.maxTime = maxTime;
@@ -233,12 +289,78 @@ void CANrx_taskTmr_close(void) {
 }
 
 
+/* Process SYNC and PDOs, then arm the timer for the next shot. Called on
+ * timer expiration and immediately after SYNC reception. */
+static void taskRT_process(void) {
+    struct timespec tmrNow;
+    long long diffns;
+    uint32_t timeDifference_us;
+    uint32_t timerNext_us = (uint32_t)taskRT.intervalus;
+
+    /* Measure time difference on monotonic clock, so late shots of the
+     * timer do not accumulate into drift of the SYNC producer. */
+    if(clock_gettime(CLOCK_MONOTONIC, &tmrNow) == -1)
+        CO_error(0x22200000L + errno);
+    diffns = (long long)(tmrNow.tv_sec - taskRT.tmrPrev.tv_sec) * NSEC_PER_SEC
+           + (tmrNow.tv_nsec - taskRT.tmrPrev.tv_nsec) + taskRT.remainderns;
+    if(diffns < 0) {
+        diffns = 0;
+    }
+    timeDifference_us = (diffns / 1000 > 0xFFFFFFFFLL) ?
+                        0xFFFFFFFFUL : (uint32_t)(diffns / 1000);
+    taskRT.remainderns = (long)(diffns % 1000);
+    taskRT.tmrPrev = tmrNow;
+
+    /* Advance the grid of intervals past current time */
+    while(!timespec_before(&tmrNow, &taskRT.tmrGrid)) {
+        timespec_add(&taskRT.tmrGrid, taskRT.intervalns);
+    }
+
+
+    /* No CO_LOCK_OD() here, so SDO transfers can not delay this thread. Data
+     * of each PDO is protected by its sequence lock, see CO_PDOseqlock_t. */
+    if(CO->CANmodule[0]->CANnormal) {
+        bool_t syncWas;
+
+        /* Process Sync */
+        syncWas = CO_process_SYNC(CO, timeDifference_us, &timerNext_us);
+
+        /* Read inputs */
+        CO_process_RPDO(CO, syncWas);
+
+        /* Further I/O or nonblocking application code may go here. */
+
+        /* Write outputs */
+        CO_process_TPDO(CO, syncWas, timeDifference_us);
+    }
+
+    /* Calculate next shot for the timer: next interval or next SYNC
+     * moment, if it is earlier. It is absolute, so it does not slide. */
+    *taskRT.tmrVal = taskRT.tmrGrid;
+    if(timerNext_us < (uint32_t)taskRT.intervalus) {
+        struct timespec tmrSync = tmrNow;
+        timespec_add(&tmrSync, (long)timerNext_us * 1000);
+        if(timespec_before(&tmrSync, taskRT.tmrVal)) {
+            *taskRT.tmrVal = tmrSync;
+        }
+    }
+    if(timerfd_settime(taskRT.fdTmr, TFD_TIMER_ABSTIME, &taskRT.tmrSpec, NULL) == -1)
+        CO_error(0x22300000L + errno);
+}
+
+
 bool_t CANrx_taskTmr_process(int fd) {
     bool_t wasProcessed = true;
 
     /* Get received CAN message. */
     if(fd == taskRT.fdRx0) {
         CO_CANrxWait(CO->CANmodule[0]);
+
+        /* Process synchronous PDOs immediately after the SYNC */
+        if(taskRT.syncReceived) {
+            taskRT.syncReceived = false;
+            taskRT_process();
+        }
     }
 
     /* Execute taskTmr */
@@ -266,41 +388,159 @@ bool_t CANrx_taskTmr_process(int fd) {
             }
         }
 
-        /* Calculate next shot for the timer */
-        taskRT.tmrVal->tv_nsec += taskRT.intervalns;
-        if(taskRT.tmrVal->tv_nsec >= NSEC_PER_SEC) {
-            taskRT.tmrVal->tv_nsec -= NSEC_PER_SEC;
-            taskRT.tmrVal->tv_sec++;
-        }
-        if(timerfd_settime(taskRT.fdTmr, TFD_TIMER_ABSTIME, &taskRT.tmrSpec, NULL) == -1)
-            CO_error(0x22300000L + errno);
+        taskRT_process();
+    }
 
+    else {
+        wasProcessed = false;
+    }
 
-        /* Lock PDOs and OD */
-        CO_LOCK_OD();
+    return wasProcessed;
+}
 
-        if(CO->CANmodule[0]->CANnormal) {
-            bool_t syncWas;
 
-            /* Process Sync */
-            syncWas = CO_process_SYNC(CO, taskRT.intervalus);
+#ifdef CO_SDO_PROCESS_SEPARATE
+/* SDO server task (taskSDO) **************************************************/
+static struct {
+    int                 fdTmr;          /* file descriptor for timeout timer */
+    int                 fdPipe[2];      /* file descriptors for pipe [0]=read, [1]=write */
+    struct itimerspec   tmrSpec;
+    struct timespec     tmrPrev;        /* time of previous processing */
+} taskSDO;
 
-            /* Read inputs */
-            CO_process_RPDO(CO, syncWas);
 
-            /* Further I/O or nonblocking application code may go here. */
+void taskSDO_cbSignal(void) {
+    if(write(taskSDO.fdPipe[1], "x", 1) == -1)
+        CO_error(0x24500000L + errno);
+}
 
-            /* Write outputs */
-            CO_process_TPDO(CO, syncWas, taskRT.intervalus);
-        }
 
-        /* Unlock */
-        CO_UNLOCK_OD();
+void taskSDO_initCallback(void) {
+    int16_t i;
+
+    for(i=0; i<CO_NO_SDO_SERVER; i++) {
+        CO_SDO_initCallback(CO->SDO[i], taskSDO_cbSignal);
+    }
+}
+
+
+void taskSDO_init(int fdEpoll) {
+    struct epoll_event ev;
+    int flags;
+
+    /* Pipe is written by CANrx callback of the SDO servers, so request is
+     * processed immediately after reception, see taskMain_init(). */
+    if(pipe(taskSDO.fdPipe) == -1)
+        CO_errExit("taskSDO_init - pipe failed");
+
+    flags = fcntl(taskSDO.fdPipe[0], F_GETFL);
+    if(flags == -1)
+        CO_errExit("taskSDO_init - fcntl-F_GETFL[0] failed");
+    flags |= O_NONBLOCK;
+    if(fcntl(taskSDO.fdPipe[0], F_SETFL, flags) == -1)
+        CO_errExit("taskSDO_init - fcntl-F_SETFL[0] failed");
+
+    flags = fcntl(taskSDO.fdPipe[1], F_GETFL);
+    if(flags == -1)
+        CO_errExit("taskSDO_init - fcntl-F_GETFL[1] failed");
+    flags |= O_NONBLOCK;
+    if(fcntl(taskSDO.fdPipe[1], F_SETFL, flags) == -1)
+        CO_errExit("taskSDO_init - fcntl-F_SETFL[1] failed");
+
+    taskSDO.fdTmr = timerfd_create(CLOCK_MONOTONIC, 0);
+    if(taskSDO.fdTmr == -1)
+        CO_errExit("taskSDO_init - timerfd_create failed");
+
+    /* add events for epoll */
+    ev.events = EPOLLIN;
+    ev.data.fd = taskSDO.fdPipe[0];
+    if(epoll_ctl(fdEpoll, EPOLL_CTL_ADD, taskSDO.fdPipe[0], &ev) == -1)
+        CO_errExit("taskSDO_init - epoll_ctl pipe failed");
+
+    ev.events = EPOLLIN;
+    ev.data.fd = taskSDO.fdTmr;
+    if(epoll_ctl(fdEpoll, EPOLL_CTL_ADD, taskSDO.fdTmr, &ev) == -1)
+        CO_errExit("taskSDO_init - epoll_ctl taskTmr failed");
+
+    /* One shot timer, delay is set after each processing. */
+    taskSDO.tmrSpec.it_interval.tv_sec = 0;
+    taskSDO.tmrSpec.it_interval.tv_nsec = 0;
+    taskSDO.tmrSpec.it_value.tv_sec = 0;
+    taskSDO.tmrSpec.it_value.tv_nsec = 1;
+
+    if(timerfd_settime(taskSDO.fdTmr, 0, &taskSDO.tmrSpec, NULL) != 0)
+        CO_errExit("taskSDO_init - timerfd_settime failed");
+
+    if(clock_gettime(CLOCK_MONOTONIC, &taskSDO.tmrPrev) != 0)
+        CO_errExit("taskSDO_init - clock_gettime failed");
+
+    taskSDO_initCallback();
+}
+
+
+void taskSDO_close(void) {
+    close(taskSDO.fdPipe[0]);
+    close(taskSDO.fdPipe[1]);
+    close(taskSDO.fdTmr);
+}
+
+
+bool_t taskSDO_process(int fd) {
+    struct timespec tmrNow;
+    long long diffns;
+    uint32_t timeDifference_us;
+    uint32_t timerNext_us = 50000;
+
+    /* Signal from pipe, consume all bytes. */
+    if(fd == taskSDO.fdPipe[0]) {
+        for(;;) {
+            char ch;
+            if(read(taskSDO.fdPipe[0], &ch, 1) == -1) {
+                if (errno == EAGAIN)
+                    break;  /* No more bytes. */
+                else
+                    CO_error(0x24100000L + errno);
+            }
+        }
     }
 
+    /* Timer expired. */
+    else if(fd == taskSDO.fdTmr) {
+        uint64_t tmrExp;
+        if(read(taskSDO.fdTmr, &tmrExp, sizeof(tmrExp)) != sizeof(uint64_t))
+            CO_error(0x24200000L + errno);
+    }
     else {
-        wasProcessed = false;
+        return false;
     }
 
-    return wasProcessed;
+    /* Time difference on monotonic clock in microseconds */
+    if(clock_gettime(CLOCK_MONOTONIC, &tmrNow) == -1)
+        CO_error(0x24300000L + errno);
+    diffns = (long long)(tmrNow.tv_sec - taskSDO.tmrPrev.tv_sec) * NSEC_PER_SEC
+           + (tmrNow.tv_nsec - taskSDO.tmrPrev.tv_nsec);
+    if(diffns < 0) {
+        diffns = 0;
+    }
+    timeDifference_us = (diffns / 1000 > 0xFFFFFFFFLL) ?
+                        0xFFFFFFFFUL : (uint32_t)(diffns / 1000);
+
+    /* Part below one microsecond is passed to the next call. */
+    tmrNow.tv_nsec -= (long)(diffns % 1000);
+    if(tmrNow.tv_nsec < 0) {
+        tmrNow.tv_nsec += NSEC_PER_SEC;
+        tmrNow.tv_sec--;
+    }
+    taskSDO.tmrPrev = tmrNow;
+
+    CO_process_SDO(CO, timeDifference_us, &timerNext_us);
+
+    /* Set delay for next timeout check, zero means immediately. */
+    taskSDO.tmrSpec.it_value.tv_sec = timerNext_us / 1000000UL;
+    taskSDO.tmrSpec.it_value.tv_nsec = (long)(timerNext_us % 1000000UL) * 1000 + 1;
+    if(timerfd_settime(taskSDO.fdTmr, 0, &taskSDO.tmrSpec, NULL) == -1)
+        CO_error(0x24400000L + errno);
+
+    return true;
 }
+#endif /* CO_SDO_PROCESS_SEPARATE */
@@ -67,6 +67,55 @@ bool_t taskMain_process(int fd, CO_NMT_reset_cmd_t *reset, uint16_t timer1ms);
 void taskMain_cbSignal(void);
 
 
+#if defined CO_SDO_PROCESS_SEPARATE || defined CO_DOXYGEN
+/**
+ * Initialize SDO server task.
+ *
+ * Available, if CO_SDO_PROCESS_SEPARATE is defined, so CO_process() does not
+ * process SDO servers. taskSDO calls CO_process_SDO() immediately after SDO
+ * request is received (CANrx callback writes into pipe) and on expiration of
+ * its timer, which is set from SDO timeouts in microseconds. So expedited SDO
+ * response is sent with driver latency, not at the next mainline cycle.
+ * taskSDO must use the same epoll as taskMain, so CO_process_SDO() and
+ * CO_process() are not called concurrently.
+ *
+ * @param fdEpoll File descriptor for Linux epoll API.
+ */
+void taskSDO_init(int fdEpoll);
+
+/**
+ * Attach SDO servers to taskSDO.
+ *
+ * Function is called by taskSDO_init() and must be called again after each
+ * communication reset (CO_init()).
+ */
+void taskSDO_initCallback(void);
+
+/**
+ * Cleanup SDO server task.
+ */
+void taskSDO_close(void);
+
+/**
+ * Process SDO server task.
+ *
+ * Function must be called after epoll.
+ *
+ * @param fd Available file descriptor from epoll().
+ *
+ * @return True, if fd was matched.
+ */
+bool_t taskSDO_process(int fd);
+
+/**
+ * Signal function, which triggers SDO server task.
+ *
+ * It is used as callback from CO_SDO_initCallback().
+ */
+void taskSDO_cbSignal(void);
+#endif
+
+
 /**
  * Initialize realtime task.
  *
@@ -77,6 +126,12 @@ void taskMain_cbSignal(void);
  * realtime application code.
  * CANrx_taskTmr uses Linux epoll, CAN socket form CO_driver.c and timerfd for
  * interval.
+ * CANrx_taskTmr does not use CO_LOCK_OD(), data of each PDO is protected by
+ * its sequence lock (CO_PDOseqlock_t). Realtime application code, which
+ * writes variables mapped to TPDO, encloses the write with
+ * CO_TPDO_writeBegin() and CO_TPDO_writeEnd(). SDO writes of such
+ * variables are applied by CO_TPDO_process() in this task, so the sequence
+ * lock has single writer.
  *
  *
  * @param fdEpoll File descriptor for Linux epoll API.
@@ -86,6 +141,17 @@ void taskMain_cbSignal(void);
  */
 void CANrx_taskTmr_init(int fdEpoll, long intervalns, uint16_t *maxTime);
 
+/**
+ * Attach realtime task to the SYNC and TIME objects.
+ *
+ * SYNC is timestamped with monotonic clock and SYNC reception immediately
+ * triggers processing of SYNC and PDOs, so synchronous TPDOs are sent without
+ * waiting for the next interval. Monotonic clock is also the local clock of
+ * the TIME object. Function is called by CANrx_taskTmr_init()
+ * and must be called again after each communication reset (CO_init()).
+ */
+void CANrx_taskTmr_initSync(void);
+
 /**
  * Cleanup realtime task.
  */
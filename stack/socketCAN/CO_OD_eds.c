@@ -0,0 +1,860 @@
+/*
+ * CANopen Object Dictionary loader from EDS file for Linux.
+ *
+ * @file        CO_OD_eds.c
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "CO_driver.h"
+#include "CO_SDO.h"
+#include "CO_OD_eds.h"
+
+#include <stdio.h>
+#include <string.h>     /* for memcpy, strlen */
+#include <strings.h>    /* for strncasecmp */
+#include <stdlib.h>     /* for malloc, free, qsort, strtoxx */
+
+
+/* Alignment of the regions inside arena */
+#define CO_OD_EDS_ALIGN(size)   (((size) + 7U) & ~(size_t)7U)
+
+
+/* Section of the EDS with object ([1000]) or sub-object ([1003sub1]) */
+typedef struct{
+    char               *body;       /* first line after section header */
+    uint32_t            line;       /* line number of section header */
+    uint16_t            index;
+    uint16_t            subKey;     /* 0 for object, subIndex + 1 for sub-object */
+}CO_OD_edsSection_t;
+
+
+/* Properties of one variable from EDS section */
+typedef struct{
+    const char         *defaultValue;
+    uint16_t            dataType;
+    uint16_t            length;
+    uint16_t            attribute;
+}CO_OD_edsVar_t;
+
+
+/* Parser state. Object Dictionary is built twice by CO_OD_eds_build(), first
+ * to calculate sizes (data is NULL), then to fill the arena. */
+typedef struct{
+    CO_OD_eds_t        *eds;
+    const char         *textEnd;
+    CO_OD_edsSection_t *sec;
+    uint32_t            noOfSec;
+    uint16_t            entryNo;
+    uint32_t            memberNo;
+    uint16_t            recordNo;
+    uint32_t            dataSize;
+    CO_OD_entryRecord_t *members;
+#if CO_OD_PACKED
+    CO_OD_record_t     *records;
+#endif
+    uint8_t            *data;
+}CO_OD_edsParser_t;
+
+
+/* Next line of the text, lines are zero terminated */
+static char *CO_OD_eds_next(const CO_OD_edsParser_t *p, char *line){
+    line += strlen(line) + 1;
+    return (line < p->textEnd) ? line : NULL;
+}
+
+
+/* Skip spaces and tabs */
+static char *CO_OD_eds_skip(const char *str){
+    while(*str == ' ' || *str == '\t'){
+        str++;
+    }
+    return (char*)str;
+}
+
+
+/* Compare value with str, ignore case and trailing spaces */
+static bool_t CO_OD_eds_equals(const char *value, const char *str){
+    size_t len = strlen(str);
+
+    return strncasecmp(value, str, len) == 0 && *CO_OD_eds_skip(value + len) == '\0';
+}
+
+
+/* Value of the key in section or NULL, if key does not exist */
+static const char *CO_OD_eds_key(const CO_OD_edsParser_t *p,
+                                 const CO_OD_edsSection_t *sec, const char *key)
+{
+    size_t len = strlen(key);
+    char *line = sec->body;
+
+    while(line != NULL){
+        char *l = CO_OD_eds_skip(line);
+
+        if(*l == '['){
+            break;
+        }
+        if(strncasecmp(l, key, len) == 0){
+            l = CO_OD_eds_skip(l + len);
+            if(*l == '='){
+                return CO_OD_eds_skip(l + 1);
+            }
+        }
+        line = CO_OD_eds_next(p, line);
+    }
+    return NULL;
+}
+
+
+/* Numeric value of the key, defaultValue if key does not exist */
+static bool_t CO_OD_eds_keyUint(const CO_OD_edsParser_t *p,
+                                const CO_OD_edsSection_t *sec, const char *key,
+                                uint32_t defaultValue, uint32_t *value)
+{
+    const char *str = CO_OD_eds_key(p, sec, key);
+    char *end;
+
+    if(str == NULL || *str == '\0'){
+        *value = defaultValue;
+        return true;
+    }
+    *value = strtoul(str, &end, 0);
+    return end != str && *CO_OD_eds_skip(end) == '\0';
+}
+
+
+/* Parse integer, "$NODEID+" prefix and "+$NODEID" suffix are ignored. */
+static bool_t CO_OD_eds_parseInt(const char *str, uint64_t *value){
+    char *end;
+
+    str = CO_OD_eds_skip(str);
+    if(strncasecmp(str, "$NODEID", 7) == 0){
+        str = CO_OD_eds_skip(str + 7);
+        if(*str == '+'){
+            str = CO_OD_eds_skip(str + 1);
+        }
+    }
+    if(*str == '\0'){
+        *value = 0;
+        return true;
+    }
+    if(*str == '-'){
+        *value = (uint64_t)strtoll(str, &end, 0);
+    }
+    else{
+        *value = strtoull(str, &end, 0);
+    }
+    if(end == str){
+        return false;
+    }
+    while(*end == 'u' || *end == 'U' || *end == 'l' || *end == 'L'){
+        end++;
+    }
+    end = CO_OD_eds_skip(end);
+    if(*end == '+'){
+        end = CO_OD_eds_skip(end + 1);
+        if(strncasecmp(end, "$NODEID", 7) != 0){
+            return false;
+        }
+        end = CO_OD_eds_skip(end + 7);
+    }
+    return *end == '\0';
+}
+
+
+/* Number of bytes in OCTET_STRING value, -1 if invalid */
+static int32_t CO_OD_eds_octetLength(const char *str){
+    int32_t digits = 0;
+
+    for(; *str != '\0'; str++){
+        if((*str >= '0' && *str <= '9') || (*str >= 'a' && *str <= 'f') || (*str >= 'A' && *str <= 'F')){
+            digits++;
+        }
+        else if(*str != ' ' && *str != '\t'){
+            return -1;
+        }
+    }
+    return ((digits & 1) != 0) ? -1 : digits / 2;
+}
+
+
+/* Get properties of the variable from EDS section */
+static bool_t CO_OD_eds_var(const CO_OD_edsParser_t *p,
+                            const CO_OD_edsSection_t *sec, CO_OD_edsVar_t *var)
+{
+    const char *access;
+    uint32_t dataType, pdoMapping;
+    bool_t numeric = true;
+    uint16_t attr = CO_ODA_MEM_RAM;
+
+    p->eds->errorLine = sec->line;
+    var->defaultValue = CO_OD_eds_key(p, sec, "DefaultValue");
+    if(var->defaultValue == NULL){
+        var->defaultValue = "";
+    }
+    if(!CO_OD_eds_keyUint(p, sec, "DataType", 0xFFFFFFFFUL, &dataType) ||
+       !CO_OD_eds_keyUint(p, sec, "PDOMapping", 0, &pdoMapping))
+    {
+        return false;
+    }
+
+    switch(dataType){
+        case 0x01:  /* BOOLEAN */
+        case 0x02:  /* INTEGER8 */
+        case 0x05:  /* UNSIGNED8 */
+            var->length = 1; break;
+        case 0x03:  /* INTEGER16 */
+        case 0x06:  /* UNSIGNED16 */
+            var->length = 2; break;
+        case 0x04:  /* INTEGER32 */
+        case 0x07:  /* UNSIGNED32 */
+        case 0x08:  /* REAL32 */
+            var->length = 4; break;
+        case 0x11:  /* REAL64 */
+        case 0x15:  /* INTEGER64 */
+        case 0x1B:  /* UNSIGNED64 */
+            var->length = 8; break;
+        case 0x09: {/* VISIBLE_STRING */
+            size_t len = strlen(var->defaultValue);
+            if(len > 0xFFFFU){
+                return false;
+            }
+            var->length = (len > 0U) ? (uint16_t)len : 1U;
+            numeric = false;
+            break;
+        }
+        case 0x0A: {/* OCTET_STRING */
+            int32_t len = CO_OD_eds_octetLength(var->defaultValue);
+            if(len < 0 || len > 0xFFFF){
+                return false;
+            }
+            var->length = (len > 0) ? (uint16_t)len : 1U;
+            numeric = false;
+            break;
+        }
+        case 0x0F:  /* DOMAIN */
+            var->length = 0;
+            numeric = false;
+            break;
+        default:
+            return false;
+    }
+    var->dataType = (uint16_t)dataType;
+
+    access = CO_OD_eds_key(p, sec, "AccessType");
+    if(access == NULL){
+        return false;
+    }
+    else if(CO_OD_eds_equals(access, "ro") || CO_OD_eds_equals(access, "const")){
+        attr |= CO_ODA_READABLE;
+    }
+    else if(CO_OD_eds_equals(access, "wo")){
+        attr |= CO_ODA_WRITEABLE;
+    }
+    else if(CO_OD_eds_equals(access, "rw") || CO_OD_eds_equals(access, "rwr") ||
+            CO_OD_eds_equals(access, "rww"))
+    {
+        attr |= CO_ODA_READABLE | CO_ODA_WRITEABLE;
+    }
+    else{
+        return false;
+    }
+
+    /* Same as Object Dictionary Editor, CO_PDO.c verifies direction */
+    if(pdoMapping != 0U){
+        attr |= CO_ODA_TPDO_MAPABLE | CO_ODA_RPDO_MAPABLE;
+    }
+    if(numeric && var->length > 1U){
+        attr |= CO_ODA_MB_VALUE;
+    }
+    var->attribute = attr;
+
+    return true;
+}
+
+
+/* Write default value into variable */
+static bool_t CO_OD_eds_setValue(uint8_t *data, const CO_OD_edsVar_t *var){
+    const char *str = var->defaultValue;
+    char *end;
+    uint64_t value;
+
+    switch(var->dataType){
+        case 0x0F:  /* DOMAIN */
+            return true;
+        case 0x09:  /* VISIBLE_STRING, arena is zeroed */
+            memcpy(data, str, strlen(str));
+            return true;
+        case 0x0A: {/* OCTET_STRING, already verified */
+            uint16_t i;
+            for(i = 0; i < var->length && *str != '\0'; i++){
+                char hex[3];
+                str = CO_OD_eds_skip(str);
+                hex[0] = str[0]; hex[1] = str[1]; hex[2] = '\0';
+                data[i] = (uint8_t)strtoul(hex, NULL, 16);
+                str += 2;
+            }
+            return true;
+        }
+        case 0x08:  /* REAL32 */
+            *((float32_t*)data) = (float32_t)strtod(str, &end);
+            return *CO_OD_eds_skip(end) == '\0';
+        case 0x11:  /* REAL64, CANopen uses 64-bit IEEE 754 */
+            *((double*)data) = strtod(str, &end);
+            return *CO_OD_eds_skip(end) == '\0';
+        default:
+            break;
+    }
+
+    if(!CO_OD_eds_parseInt(str, &value)){
+        return false;
+    }
+    switch(var->length){
+        case 1: *data = (uint8_t)value; break;
+        case 2: *((uint16_t*)data) = (uint16_t)value; break;
+        case 4: *((uint32_t*)data) = (uint32_t)value; break;
+        default: *((uint64_t*)data) = value; break;
+    }
+    return true;
+}
+
+
+/* Reserve aligned space for variable(s), return offset in data region */
+static uint32_t CO_OD_eds_alloc(CO_OD_edsParser_t *p, uint32_t size, uint16_t align){
+    uint32_t offset = (p->dataSize + align - 1U) & ~(uint32_t)(align - 1U);
+
+    p->dataSize = offset + size;
+    return offset;
+}
+
+
+/* Alignment of the variable */
+static uint16_t CO_OD_eds_varAlign(const CO_OD_edsVar_t *var){
+    if(var->dataType == 0x09 || var->dataType == 0x0A || var->dataType == 0x0F){
+        return 1;
+    }
+    return var->length;
+}
+
+
+/* Build object with sections sec[0] ... sec[noOfSub] */
+static bool_t CO_OD_eds_object(CO_OD_edsParser_t *p, const CO_OD_edsSection_t *sec,
+                               uint32_t noOfSub, CO_OD_entry_t *entry)
+{
+    uint32_t objectType, i, offset;
+    CO_OD_edsVar_t var;
+
+    if(!CO_OD_eds_keyUint(p, sec, "ObjectType", 7, &objectType)){
+        return false;
+    }
+    if(CO_OD_eds_key(p, sec, "CompactSubObj") != NULL){
+        return false;
+    }
+
+    if(objectType == 7U){          /* VAR */
+        if(noOfSub != 0U || !CO_OD_eds_var(p, sec, &var)){
+            return false;
+        }
+        offset = CO_OD_eds_alloc(p, var.length, CO_OD_eds_varAlign(&var));
+        if(entry != NULL){
+            entry->index = sec->index;
+            entry->maxSubIndex = 0;
+            entry->attribute = var.attribute;
+            entry->length = var.length;
+            entry->pData = (var.dataType == 0x0F) ? NULL : (void*)&p->data[offset];
+            if(!CO_OD_eds_setValue(&p->data[offset], &var)){
+                return false;
+            }
+        }
+    }
+    else if(objectType == 8U){     /* ARRAY, sub0 is entry->maxSubIndex */
+        CO_OD_edsVar_t var0;
+        uint16_t attribute;
+
+        if(noOfSub < 2U || noOfSub > 256U || !CO_OD_eds_var(p, &sec[1], &var0) ||
+           !CO_OD_eds_var(p, &sec[2], &var))
+        {
+            return false;
+        }
+        attribute = var.attribute | (var0.attribute & (CO_ODA_READABLE | CO_ODA_WRITEABLE));
+        offset = CO_OD_eds_alloc(p, (uint32_t)var.length * (noOfSub - 1U), CO_OD_eds_varAlign(&var));
+        for(i = 1; i < noOfSub; i++){
+            CO_OD_edsVar_t varI;
+
+            if(!CO_OD_eds_var(p, &sec[i + 1U], &varI) ||
+               varI.dataType != var.dataType || varI.length != var.length)
+            {
+                return false;
+            }
+            if(entry != NULL && !CO_OD_eds_setValue(&p->data[offset + (i - 1U) * var.length], &varI)){
+                return false;
+            }
+        }
+        if(entry != NULL){
+            entry->index = sec->index;
+            entry->maxSubIndex = (uint8_t)(noOfSub - 1U);
+            entry->attribute = attribute;
+            entry->length = var.length;
+            entry->pData = (var.dataType == 0x0F) ? NULL : (void*)&p->data[offset];
+        }
+    }
+    else if(objectType == 9U){     /* RECORD */
+        CO_OD_entryRecord_t *members = (entry != NULL) ? &p->members[p->memberNo] : NULL;
+#if CO_OD_PACKED
+        uint32_t base;
+#endif
+
+        if(noOfSub < 2U || noOfSub > 256U){
+            return false;
+        }
+#if CO_OD_PACKED
+        base = CO_OD_eds_alloc(p, 0, 8);
+#else
+        (void)CO_OD_eds_alloc(p, 0, 8);
+#endif
+        for(i = 0; i < noOfSub; i++){
+            if(!CO_OD_eds_var(p, &sec[i + 1U], &var)){
+                return false;
+            }
+            offset = CO_OD_eds_alloc(p, var.length, CO_OD_eds_varAlign(&var));
+#if CO_OD_PACKED
+            if(var.length > 0xFFU || offset - base >= 0xFFFFU){
+                return false;
+            }
+#endif
+            if(members != NULL){
+                if(!CO_OD_eds_setValue(&p->data[offset], &var)){
+                    return false;
+                }
+                members[i].attribute = var.attribute;
+                members[i].length = var.length;
+#if CO_OD_PACKED
+                members[i].offset = (var.dataType == 0x0F) ? 0xFFFFU : (uint16_t)(offset - base);
+#else
+                members[i].pData = (var.dataType == 0x0F) ? NULL : (void*)&p->data[offset];
+#endif
+            }
+        }
+        if(entry != NULL){
+            entry->index = sec->index;
+            entry->maxSubIndex = (uint8_t)(noOfSub - 1U);
+            entry->attribute = 0;
+            entry->length = 0;
+#if CO_OD_PACKED
+            p->records[p->recordNo].pBase = (void*)&p->data[base];
+            p->records[p->recordNo].pMembers = members;
+            entry->pData = (void*)&p->records[p->recordNo];
+#else
+            entry->pData = (void*)members;
+#endif
+        }
+        p->memberNo += noOfSub;
+        p->recordNo++;
+    }
+    else{
+        return false;
+    }
+
+    return true;
+}
+
+
+/* Walk over sorted sections and build Object Dictionary */
+static bool_t CO_OD_eds_build(CO_OD_edsParser_t *p){
+    uint32_t i, j;
+
+    p->entryNo = 0;
+    p->memberNo = 0;
+    p->recordNo = 0;
+    p->dataSize = 0;
+
+    for(i = 0; i < p->noOfSec; i = j){
+        const CO_OD_edsSection_t *sec = &p->sec[i];
+
+        p->eds->errorLine = sec->line;
+        if(sec->subKey != 0U || p->entryNo == 0xFFFFU){
+            return false;           /* sub-object without object */
+        }
+        for(j = i + 1U; j < p->noOfSec && p->sec[j].index == sec->index; j++){
+            if(p->sec[j].subKey != j - i){
+                p->eds->errorLine = p->sec[j].line;
+                return false;       /* sub-indexes must be 0, 1, 2, ... */
+            }
+        }
+        if(!CO_OD_eds_object(p, sec, j - i - 1U,
+                             (p->data != NULL) ? &p->eds->OD[p->entryNo] : NULL))
+        {
+            return false;
+        }
+        p->entryNo++;
+    }
+    p->eds->errorLine = 0;
+
+    return p->entryNo > 0U;
+}
+
+
+/* Order sections by index and sub-index */
+static int CO_OD_eds_compare(const void *a, const void *b){
+    const CO_OD_edsSection_t *sa = (const CO_OD_edsSection_t*)a;
+    const CO_OD_edsSection_t *sb = (const CO_OD_edsSection_t*)b;
+    uint32_t ka = ((uint32_t)sa->index << 16) | sa->subKey;
+    uint32_t kb = ((uint32_t)sb->index << 16) | sb->subKey;
+
+    return (ka < kb) ? -1 : ((ka > kb) ? 1 : 0);
+}
+
+
+/* Parse section header "[1003]" or "[1003sub1]", return false for others */
+static bool_t CO_OD_eds_header(const char *line, uint16_t *index, uint16_t *subKey){
+    char *end;
+    unsigned long idx, sub;
+
+    if(strlen(line) < 6){
+        return false;
+    }
+    idx = strtoul(&line[1], &end, 16);
+    if(end != &line[5] || idx == 0U){
+        return false;
+    }
+    if(*end == ']'){
+        *index = (uint16_t)idx;
+        *subKey = 0;
+        return true;
+    }
+    if(strncasecmp(end, "sub", 3) != 0){
+        return false;
+    }
+    sub = strtoul(end + 3, &end, 16);
+    if(*end != ']' || sub > 0xFFU){
+        return false;
+    }
+    *index = (uint16_t)idx;
+    *subKey = (uint16_t)(sub + 1U);
+    return true;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_OD_eds_parse(CO_OD_eds_t *eds, char *text){
+    CO_OD_edsParser_t p;
+    uint32_t capacity = 0, line = 0, i;
+    size_t size, offExt, offLookup, offMembers, offRecords, offData;
+    uint16_t mask;
+    char *pos;
+
+    if(eds == NULL || text == NULL){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    memset(eds, 0, sizeof(*eds));
+    memset(&p, 0, sizeof(p));
+    p.eds = eds;
+    eds->stats.fileSize = (uint32_t)strlen(text);
+    p.textEnd = text + eds->stats.fileSize;
+
+    /* Split text into zero terminated lines and find object sections */
+    for(pos = text; pos < p.textEnd; ){
+        char *eol = strchr(pos, '\n');
+        char *l;
+        uint16_t index, subKey;
+
+        if(eol == NULL){
+            eol = (char*)p.textEnd;
+        }
+        *eol = '\0';
+        if(eol > pos && eol[-1] == '\r'){
+            eol[-1] = '\0';
+        }
+        line++;
+
+        l = CO_OD_eds_skip(pos);
+        if(*l == '[' && CO_OD_eds_header(l, &index, &subKey)){
+            if(p.noOfSec == capacity){
+                CO_OD_edsSection_t *sec;
+
+                capacity = (capacity == 0U) ? 256U : capacity * 2U;
+                sec = (CO_OD_edsSection_t*)realloc(p.sec, capacity * sizeof(CO_OD_edsSection_t));
+                if(sec == NULL){
+                    free(p.sec);
+                    return CO_ERROR_OUT_OF_MEMORY;
+                }
+                p.sec = sec;
+            }
+            p.sec[p.noOfSec].body = eol + 1;
+            p.sec[p.noOfSec].line = line;
+            p.sec[p.noOfSec].index = index;
+            p.sec[p.noOfSec].subKey = subKey;
+            p.noOfSec++;
+        }
+        pos = eol + 1;
+    }
+    eds->stats.noOfSections = p.noOfSec;
+    eds->stats.tempSize += capacity * sizeof(CO_OD_edsSection_t);
+
+    /* Sort sections, verify duplicates */
+    if(p.noOfSec > 0U){
+        qsort(p.sec, p.noOfSec, sizeof(CO_OD_edsSection_t), CO_OD_eds_compare);
+    }
+    for(i = 1; i < p.noOfSec; i++){
+        if(CO_OD_eds_compare(&p.sec[i - 1U], &p.sec[i]) == 0){
+            eds->errorLine = p.sec[i].line;
+            free(p.sec);
+            return CO_ERROR_DATA_CORRUPT;
+        }
+    }
+
+    /* First pass, calculate sizes */
+    if(!CO_OD_eds_build(&p)){
+        if(eds->errorLine == 0U){
+            eds->errorLine = line;
+        }
+        free(p.sec);
+        return CO_ERROR_DATA_CORRUPT;
+    }
+
+    /* Lookup table has at least twice as much slots as entries */
+    mask = 0x0FU;
+    while(mask < 0xFFFFU && (uint32_t)mask + 1U < (uint32_t)p.entryNo * 2U){
+        mask = (uint16_t)((mask << 1) | 1U);
+    }
+
+    /* Arena layout */
+    offExt = CO_OD_EDS_ALIGN(p.entryNo * sizeof(CO_OD_entry_t));
+    offLookup = CO_OD_EDS_ALIGN(offExt + p.entryNo * sizeof(CO_OD_extension_t));
+    offMembers = CO_OD_EDS_ALIGN(offLookup + ((size_t)mask + 1U) * sizeof(uint16_t));
+    offRecords = CO_OD_EDS_ALIGN(offMembers + p.memberNo * sizeof(CO_OD_entryRecord_t));
+#if CO_OD_PACKED
+    offData = CO_OD_EDS_ALIGN(offRecords + p.recordNo * sizeof(CO_OD_record_t));
+#else
+    offData = offRecords;
+#endif
+    size = offData + p.dataSize;
+
+    eds->arena = calloc(1, size);
+    if(eds->arena == NULL){
+        free(p.sec);
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    eds->OD = (CO_OD_entry_t*)eds->arena;
+    eds->ODExtensions = (CO_OD_extension_t*)((uint8_t*)eds->arena + offExt);
+    eds->lookup = (uint16_t*)((uint8_t*)eds->arena + offLookup);
+    eds->lookupMask = mask;
+    p.members = (CO_OD_entryRecord_t*)((uint8_t*)eds->arena + offMembers);
+#if CO_OD_PACKED
+    p.records = (CO_OD_record_t*)((uint8_t*)eds->arena + offRecords);
+#endif
+    p.data = (uint8_t*)eds->arena + offData;
+
+    /* Second pass, fill the arena */
+    if(!CO_OD_eds_build(&p)){
+        free(p.sec);
+        CO_OD_eds_free(eds);
+        return CO_ERROR_DATA_CORRUPT;
+    }
+    free(p.sec);
+    eds->ODSize = p.entryNo;
+
+    /* Index lookup table, entries are already sorted */
+    for(i = 0; i < eds->ODSize; i++){
+        uint16_t slot = CO_OD_LOOKUP_SLOT(eds->OD[i].index, mask);
+
+        while(eds->lookup[slot] != 0U){
+            slot = (slot + 1U) & mask;
+        }
+        eds->lookup[slot] = (uint16_t)(i + 1U);
+    }
+
+    eds->stats.noOfEntries = p.entryNo;
+    eds->stats.noOfMembers = (uint16_t)p.memberNo;
+    eds->stats.dataSize = p.dataSize;
+    eds->stats.arenaSize = (uint32_t)size;
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_OD_eds_load(CO_OD_eds_t *eds, const char *filename){
+    CO_ReturnError_t ret;
+    FILE *fp;
+    long size;
+    char *text;
+
+    if(eds == NULL || filename == NULL){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    fp = fopen(filename, "rb");
+    if(fp == NULL){
+        return CO_ERROR_SYSCALL;
+    }
+    if(fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET) != 0){
+        fclose(fp);
+        return CO_ERROR_SYSCALL;
+    }
+    text = (char*)malloc((size_t)size + 1U);
+    if(text == NULL){
+        fclose(fp);
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    if(fread(text, 1, (size_t)size, fp) != (size_t)size){
+        free(text);
+        fclose(fp);
+        return CO_ERROR_SYSCALL;
+    }
+    fclose(fp);
+    text[size] = '\0';
+
+    ret = CO_OD_eds_parse(eds, text);
+    eds->stats.tempSize += (uint32_t)size + 1U;
+    free(text);
+
+    return ret;
+}
+
+
+/******************************************************************************/
+uint16_t CO_OD_eds_find(const CO_OD_eds_t *eds, uint16_t index){
+    uint16_t slot;
+
+    if(eds->lookup == NULL){
+        return 0xFFFFU;
+    }
+    slot = CO_OD_LOOKUP_SLOT(index, eds->lookupMask);
+    while(eds->lookup[slot] != 0U){
+        uint16_t entryNo = eds->lookup[slot] - 1U;
+
+        if(eds->OD[entryNo].index == index){
+            return entryNo;
+        }
+        slot = (slot + 1U) & eds->lookupMask;
+    }
+    return 0xFFFFU;
+}
+
+
+/* Copy variable from loaded entry into compiled storage */
+static bool_t CO_OD_eds_bindData(void **pData, void *target, uint16_t length, uint16_t targetLength){
+    if(length != targetLength || (*pData == NULL) != (target == NULL)){
+        return false;
+    }
+    if(target != NULL && length > 0U){
+        memcpy(target, *pData, length);
+        *pData = target;
+    }
+    return true;
+}
+
+
+/* Use storage of the compiled entry for the loaded entry */
+static bool_t CO_OD_eds_bindEntry(CO_OD_entry_t *entry, const CO_OD_entry_t *compiled){
+    uint16_t i;
+
+    if(entry->maxSubIndex != compiled->maxSubIndex ||
+       (entry->maxSubIndex != 0U && (entry->attribute == 0U) != (compiled->attribute == 0U)))
+    {
+        return false;
+    }
+
+    if(entry->maxSubIndex == 0U){       /* VAR */
+        return CO_OD_eds_bindData(&entry->pData, compiled->pData,
+                                  entry->length, compiled->length);
+    }
+    else if(entry->attribute != 0U){    /* ARRAY */
+        if(entry->length != compiled->length){
+            return false;
+        }
+        return CO_OD_eds_bindData(&entry->pData, compiled->pData,
+                                  (uint16_t)(entry->length * entry->maxSubIndex),
+                                  (uint16_t)(compiled->length * compiled->maxSubIndex));
+    }
+    else{                               /* RECORD */
+#if CO_OD_PACKED
+        CO_OD_record_t *rec = (CO_OD_record_t*)entry->pData;
+        const CO_OD_record_t *recC = (const CO_OD_record_t*)compiled->pData;
+
+        /* members are addressed from the base, so layout must be the same */
+        for(i = 0; i <= entry->maxSubIndex; i++){
+            const CO_OD_entryRecord_t *m = &rec->pMembers[i];
+            const CO_OD_entryRecord_t *mC = &recC->pMembers[i];
+
+            if(m->offset != mC->offset || m->length != mC->length){
+                return false;
+            }
+        }
+        for(i = 0; i <= entry->maxSubIndex; i++){
+            const CO_OD_entryRecord_t *m = &rec->pMembers[i];
+
+            if(m->offset != 0xFFFFU){
+                memcpy((uint8_t*)recC->pBase + m->offset,
+                       (uint8_t*)rec->pBase + m->offset, m->length);
+            }
+        }
+        rec->pBase = recC->pBase;
+#else
+        CO_OD_entryRecord_t *m = (CO_OD_entryRecord_t*)entry->pData;
+        const CO_OD_entryRecord_t *mC = (const CO_OD_entryRecord_t*)compiled->pData;
+
+        for(i = 0; i <= entry->maxSubIndex; i++){
+            if(m[i].length != mC[i].length || (m[i].pData == NULL) != (mC[i].pData == NULL)){
+                return false;
+            }
+        }
+        for(i = 0; i <= entry->maxSubIndex; i++){
+            (void)CO_OD_eds_bindData(&m[i].pData, mC[i].pData, m[i].length, mC[i].length);
+        }
+#endif
+    }
+
+    return true;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_OD_eds_bind(CO_OD_eds_t *eds, const CO_OD_entry_t *OD, uint16_t ODSize){
+    uint16_t i;
+
+    if(eds == NULL || eds->OD == NULL || OD == NULL){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    eds->errorIndex = 0;
+    for(i = 0; i < ODSize; i++){
+        uint16_t entryNo = CO_OD_eds_find(eds, OD[i].index);
+
+        if(entryNo != 0xFFFFU && !CO_OD_eds_bindEntry(&eds->OD[entryNo], &OD[i])){
+            eds->errorIndex = OD[i].index;
+            return CO_ERROR_DATA_CORRUPT;
+        }
+    }
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+void CO_OD_eds_free(CO_OD_eds_t *eds){
+    if(eds != NULL){
+        free(eds->arena);
+        eds->arena = NULL;
+        eds->OD = NULL;
+        eds->ODSize = 0;
+        eds->ODExtensions = NULL;
+        eds->lookup = NULL;
+    }
+}
@@ -0,0 +1,166 @@
+/*
+ * CANopen Object Dictionary loader from EDS file for Linux.
+ *
+ * @file        CO_OD_eds.h
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CO_OD_EDS_H
+#define CO_OD_EDS_H
+
+
+#include "CO_driver.h"
+#include "CO_SDO.h"
+
+
+/*
+ * Object Dictionary, loaded at runtime from Electronic Data Sheet.
+ *
+ * Instead of compile time CO_OD[] from CO_OD.c, Object Dictionary is built
+ * from EDS file (for example example/IO.eds), which is useful for gateways,
+ * simulated nodes and test benches with many device variants.
+ *
+ * CO_OD_entry_t table, CO_OD_extension_t table, index lookup table, record
+ * tables and all variables are placed in a single memory allocation (arena).
+ * Variables are initialized to DefaultValue. "$NODEID+" is ignored, as in
+ * generated CO_OD.c, stack adds node-ID itself. All variables are in RAM and
+ * have attribute CO_ODA_MEM_RAM.
+ *
+ * Communication objects of the stack (SYNC, PDO, heartbeat, ...) use
+ * variables OD_* from CO_OD.c. CO_OD_eds_bind() places the loaded entries,
+ * which also exist in CO_OD[], on the same variables, so values from EDS and
+ * SDO access are seen by the stack. Loaded Object Dictionary is then passed
+ * to CO_init() with CO_setOD(), for example:
+ *
+ * ~~~{.c}
+ * CO_OD_eds_t eds;
+ *
+ * if(CO_OD_eds_load(&eds, "IO.eds") != CO_ERROR_NO) {
+ *     printf("error in line %u\n", eds.errorLine);
+ * }
+ * if(CO_OD_eds_bind(&eds, CO_OD, CO_OD_NoOfElements) != CO_ERROR_NO) {
+ *     printf("object %04X differs from CO_OD\n", eds.errorIndex);
+ * }
+ * CO_setOD(eds.OD, eds.ODSize, eds.ODExtensions, eds.lookup, eds.lookupMask);
+ * CO_init(CANdriverState, nodeId, bitRate);
+ * ~~~
+ *
+ * Supported are VAR, ARRAY and RECORD objects with basic data types (BOOLEAN,
+ * INTEGERxx, UNSIGNEDxx, REALxx, VISIBLE_STRING, OCTET_STRING and DOMAIN).
+ * Objects with CompactSubObj are not supported.
+ */
+
+
+/**
+ * Statistics of the loaded Object Dictionary.
+ */
+typedef struct{
+    uint32_t            fileSize;       /**< Size of the EDS in bytes */
+    uint32_t            noOfSections;   /**< Number of object sections in EDS */
+    uint16_t            noOfEntries;    /**< Number of Object Dictionary entries */
+    uint16_t            noOfMembers;    /**< Number of record members */
+    uint32_t            dataSize;       /**< Size of all variables in bytes */
+    uint32_t            arenaSize;      /**< Size of the arena in bytes */
+    uint32_t            tempSize;       /**< Temporary memory used during loading */
+}CO_OD_edsStats_t;
+
+
+/**
+ * Object Dictionary loaded from EDS.
+ */
+typedef struct{
+    void               *arena;          /**< Single allocation for all below */
+    CO_OD_entry_t      *OD;             /**< Sorted Object Dictionary */
+    uint16_t            ODSize;         /**< Number of entries in OD */
+    CO_OD_extension_t  *ODExtensions;   /**< For CO_SDO_init(), ODSize elements */
+    /** Hash table for CO_OD_setIndexLookup(), (lookupMask + 1) elements */
+    uint16_t           *lookup;
+    uint16_t            lookupMask;     /**< See CO_OD_setIndexLookup() */
+    uint32_t            errorLine;      /**< Line in EDS with error or 0 */
+    uint16_t            errorIndex;     /**< From CO_OD_eds_bind(), index of object with error or 0 */
+    CO_OD_edsStats_t    stats;          /**< Statistics */
+}CO_OD_eds_t;
+
+
+/**
+ * Load Object Dictionary from EDS file.
+ *
+ * @param eds This object.
+ * @param filename Name of the EDS file.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT,
+ * CO_ERROR_SYSCALL (file can not be read), CO_ERROR_OUT_OF_MEMORY or
+ * CO_ERROR_DATA_CORRUPT (error in EDS, see errorLine).
+ */
+CO_ReturnError_t CO_OD_eds_load(CO_OD_eds_t *eds, const char *filename);
+
+
+/**
+ * Load Object Dictionary from EDS in memory.
+ *
+ * @param eds This object.
+ * @param text EDS file contents, terminated with zero. It is modified during
+ * parsing and may be released after function returns.
+ *
+ * @return Same as CO_OD_eds_load().
+ */
+CO_ReturnError_t CO_OD_eds_parse(CO_OD_eds_t *eds, char *text);
+
+
+/**
+ * Find entry in loaded Object Dictionary in constant time.
+ *
+ * @param eds This object.
+ * @param index Index of the object.
+ *
+ * @return Sequence number of the entry, 0xFFFF if not found.
+ */
+uint16_t CO_OD_eds_find(const CO_OD_eds_t *eds, uint16_t index);
+
+
+/**
+ * Place loaded entries on variables of compiled Object Dictionary.
+ *
+ * For each entry of compiled OD (usually CO_OD[]), which exists in loaded OD,
+ * value from EDS is copied into compiled variable and loaded entry then
+ * points to it. Entries must have the same structure (object type, number
+ * of sub-objects and their lengths). Function must be called before
+ * CO_init() and before stored parameters are restored into OD variables.
+ *
+ * @param eds This object.
+ * @param OD Compiled Object Dictionary.
+ * @param ODSize Number of entries in OD.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or
+ * CO_ERROR_DATA_CORRUPT (structure differs, see errorIndex).
+ */
+CO_ReturnError_t CO_OD_eds_bind(CO_OD_eds_t *eds, const CO_OD_entry_t *OD, uint16_t ODSize);
+
+
+/**
+ * Release memory of the loaded Object Dictionary.
+ *
+ * SDO servers, which use it, must not be processed any more.
+ *
+ * @param eds This object.
+ */
+void CO_OD_eds_free(CO_OD_eds_t *eds);
+
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * Throughput benchmark of CRC 16 CCITT engines from stack/crc16-ccitt.c.
+ *
+ * @file        crc16_bench.c
+ *
+ * Each engine is first verified against crc16_ccitt_bytewise() on random
+ * blocks, also split into segments. Then throughput is measured on blocks
+ * of the size of SDO block transfer (889 bytes) and of the OD image.
+ *
+ * Build on Linux host, from the root of the repository:
+ *
+ *     gcc -O2 -DCO_CRC16_SLICE_BY_8 -DCO_CRC16_PCLMUL -mpclmul -mssse3 \
+ *         -Istack tools/crc16_bench.c stack/crc16-ccitt.c -o crc16_bench
+ *
+ * Omit -DCO_CRC16_PCLMUL on non x86 hosts. Hardware engine (CO_CRC16_HW)
+ * must be measured on target, for example with CO_CRC16_STATISTICS.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "crc16-ccitt.h"
+
+
+#define BENCH_BUF_SIZE      65536U
+#define BENCH_TOTAL_BYTES   (256UL * 1024UL * 1024UL)
+
+
+typedef struct{
+    const char             *name;
+    crc16_ccitt_engine_t    engine;
+}bench_engine_t;
+
+
+static const bench_engine_t engines[] = {
+    {"bytewise", crc16_ccitt_bytewise},
+#ifdef CO_CRC16_SLICE_BY_8
+    {"slice-by-8", crc16_ccitt_sliceBy8},
+#endif
+#ifdef CO_CRC16_PCLMUL
+    {"pclmul", crc16_ccitt_pclmul},
+#endif
+};
+
+static const unsigned int blockSizes[] = {7U, 127U, 889U, 4096U, BENCH_BUF_SIZE};
+
+static unsigned char buf[BENCH_BUF_SIZE];
+
+
+/* Verify engine against bytewise reference, whole and segmented. */
+static int verify(const bench_engine_t *e){
+    unsigned int n;
+
+    for(n=0U; n<2000U; n++){
+        unsigned int len = (unsigned int)rand() % 1500U;
+        unsigned int split = (len != 0U) ? (unsigned int)rand() % len : 0U;
+        unsigned short init = (unsigned short)rand();
+        unsigned short ref = crc16_ccitt_bytewise(buf, len, init);
+        unsigned short crc = e->engine(buf, len, init);
+        unsigned short seg = e->engine(buf, split, init);
+
+        seg = e->engine(&buf[split], len - split, seg);
+        if(crc != ref || seg != ref){
+            printf("%s: mismatch, length %u, split %u\n", e->name, len, split);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+static double now_s(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+int main(void){
+    unsigned int i, j;
+    int ret = 0;
+
+    srand(1);
+    for(i=0U; i<BENCH_BUF_SIZE; i++){
+        buf[i] = (unsigned char)rand();
+    }
+
+    /* check value of CRC-16/XMODEM */
+    if(crc16_ccitt_CO((const unsigned char *)"123456789", 9U, 0U) != 0x31C3U){
+        printf("crc16_ccitt_CO: wrong check value\n");
+        return 1;
+    }
+
+    printf("%-12s", "block [B]");
+    for(j=0U; j<sizeof(blockSizes)/sizeof(blockSizes[0]); j++){
+        printf("%10u", blockSizes[j]);
+    }
+    printf("   [MB/s]\n");
+
+    for(i=0U; i<sizeof(engines)/sizeof(engines[0]); i++){
+        const bench_engine_t *e = &engines[i];
+
+        if(!verify(e)){
+            ret = 1;
+            continue;
+        }
+        printf("%-12s", e->name);
+        for(j=0U; j<sizeof(blockSizes)/sizeof(blockSizes[0]); j++){
+            unsigned int size = blockSizes[j];
+            unsigned long loops = BENCH_TOTAL_BYTES / size;
+            volatile unsigned short sink;
+            unsigned short crc = 0U;
+            unsigned long l;
+            double t;
+
+            t = now_s();
+            for(l=0UL; l<loops; l++){
+                crc = e->engine(&buf[(l * 64U) % (BENCH_BUF_SIZE - size + 1U)], size, crc);
+            }
+            t = now_s() - t;
+            sink = crc;
+            (void)sink;
+            printf("%10.0f", (double)loops * size / t / 1e6);
+        }
+        printf("\n");
+    }
+
+    return ret;
+}
@@ -0,0 +1,730 @@
+#!/usr/bin/env python3
+#
+# CANopen Object Dictionary generator.
+#
+# @file        eds2od.py
+# @ingroup     CO_SDO
+#
+# This file is part of CANopenNode, an opensource CANopen Stack.
+# Project home page is <https://github.com/CANopenNode/CANopenNode>.
+# For more information on CANopen see <http://www.can-cia.org/>.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Generate CO_OD.h and CO_OD.c from CANopen Electronic Data Sheet (EDS).
+
+Objects are sorted by index, as required by CO_OD_find(). Variables are
+grouped into structures by storage class: CO_OD_RAM, CO_OD_EEPROM and
+CO_OD_ROM. Storage class is taken from 'StorageLocation' key of the object in
+EDS, from 'memoryType' in the project file of the Object Dictionary Editor
+(--project) or from --storage default. Variables with 'const' access type are
+placed into 'const' structure CO_OD_CONST, which stays in flash.
+
+With --packed, tables are generated for CO_OD_PACKED=1 (see CO_SDO.h):
+attribute is one byte and members of records are described by offsets instead
+of pointers.
+
+With --report, RAM and flash footprint of both layouts is printed.
+
+Example:
+    tools/eds2od.py example/IO.eds --project example/_project.xml -o build/ --report
+"""
+
+import argparse
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+
+# CANopen data types: code -> (C type, size, multibyte numeric)
+DATA_TYPES = {
+    0x01: ("UNSIGNED8", 1, False),     # BOOLEAN
+    0x02: ("INTEGER8", 1, False),
+    0x03: ("INTEGER16", 2, True),
+    0x04: ("INTEGER32", 4, True),
+    0x05: ("UNSIGNED8", 1, False),
+    0x06: ("UNSIGNED16", 2, True),
+    0x07: ("UNSIGNED32", 4, True),
+    0x08: ("REAL32", 4, True),
+    0x09: ("VISIBLE_STRING", 1, False),
+    0x0A: ("OCTET_STRING", 1, False),
+    0x0F: ("DOMAIN", 0, False),
+    0x11: ("REAL64", 8, True),
+    0x15: ("INTEGER64", 8, True),
+    0x1B: ("UNSIGNED64", 8, True),
+}
+
+# CO_SDO_OD_attributes_t
+ODA_MEM_ROM = 0x01
+ODA_MEM_RAM = 0x02
+ODA_MEM_EEPROM = 0x03
+ODA_READABLE = 0x04
+ODA_WRITEABLE = 0x08
+ODA_RPDO_MAPABLE = 0x10
+ODA_TPDO_MAPABLE = 0x20
+ODA_TPDO_DETECT_COS = 0x40
+ODA_MB_VALUE = 0x80
+
+STORAGE_CLASSES = ("RAM", "EEPROM", "ROM", "CONST")
+STORAGE_ATTR = {"RAM": ODA_MEM_RAM, "EEPROM": ODA_MEM_EEPROM,
+                "ROM": ODA_MEM_ROM, "CONST": ODA_MEM_ROM}
+
+# Index ranges, where records are grouped into arrays of records, and
+# features counted from them
+RECORD_ARRAYS = ((0x1200, 0x127F), (0x1280, 0x12FF), (0x1400, 0x15FF),
+                 (0x1600, 0x17FF), (0x1800, 0x19FF), (0x1A00, 0x1BFF),
+                 (0x2301, 0x2320), (0x2401, 0x2420))
+
+
+class GenError(Exception):
+    pass
+
+
+def read_eds(path):
+    """Parse EDS into {section: {key: value}}. Keys are lower case, trailing
+    spaces of values are preserved (they are part of string default values)."""
+    sections = {}
+    cur = None
+    with open(path, encoding="latin-1") as f:
+        for line in f:
+            line = line.rstrip("\r\n")
+            s = line.strip()
+            if not s or s.startswith(";"):
+                continue
+            if s.startswith("[") and s.endswith("]"):
+                cur = sections.setdefault(s[1:-1].strip().upper(), {})
+                continue
+            if cur is None or "=" not in line:
+                continue
+            key, value = line.split("=", 1)
+            cur[key.strip().lower()] = value.lstrip()
+    return sections
+
+
+def read_project(path):
+    """Read storage class, disabled and TPDOdetectCOS flags from Object
+    Dictionary Editor project file."""
+    info = {}
+    root = ET.parse(path).getroot()
+    for obj in root.iter("CANopenObject"):
+        index = int(obj.get("index"), 16)
+        info[index] = (obj.get("memoryType"), obj.get("disabled") == "true",
+                       obj.get("TPDOdetectCOS") == "true")
+    return info
+
+
+def c_name(text):
+    """Convert parameter name to C identifier: 'COB-ID SYNC message' ->
+    'COB_ID_SYNCMessage', 'Pre-defined error field' -> 'preDefinedErrorField'."""
+    tokens = [re.sub(r"[^0-9A-Za-z_]", "", t) for t in re.split(r"[\s\-]+", text.strip())]
+    tokens = [t for t in tokens if t]
+    if not tokens:
+        raise GenError("empty parameter name")
+    name = ""
+    for i, tok in enumerate(tokens):
+        if i == 0:
+            if len(tok) > 1 and tok[1].islower():
+                tok = tok[0].lower() + tok[1:]
+            elif len(tok) == 1:
+                tok = tok.lower()
+        else:
+            if name[-1].isupper() and tok.isupper() and tok[0].isalpha():
+                name += "_"
+            tok = tok[0].upper() + tok[1:]
+        name += tok
+    if name[0].isdigit():
+        name = "_" + name
+    return name
+
+
+def parse_int(text, node_id):
+    text = text.strip()
+    m = re.match(r"\$NODEID\s*\+\s*(.*)$", text, re.I) or re.match(r"(.*)\+\s*\$NODEID$", text, re.I)
+    if m:
+        text = m.group(1).strip()  # stack adds node-ID at runtime
+    text = re.sub(r"[uUlL]+$", "", text)  # C suffixes are accepted
+    if text == "":
+        return 0
+    neg = text.startswith("-")
+    if neg:
+        text = text[1:]
+    value = int(text, 16) if text.lower().startswith("0x") else int(text, 10)
+    return -value if neg else value
+
+
+class Var:
+    """Single variable (VAR or member of ARRAY or RECORD)."""
+
+    def __init__(self, sec, name, sub_index):
+        self.name = name
+        self.sub_index = sub_index
+        self.param_name = sec.get("parametername", name)
+        try:
+            self.data_type = int(sec.get("datatype", "0"), 0)
+        except ValueError:
+            raise GenError("invalid DataType of '%s'" % self.param_name)
+        if self.data_type not in DATA_TYPES:
+            raise GenError("unsupported DataType 0x%04X of '%s'" % (self.data_type, self.param_name))
+        self.c_type, self.size, self.multibyte = DATA_TYPES[self.data_type]
+        self.access = sec.get("accesstype", "rw").strip().lower()
+        self.pdo = sec.get("pdomapping", "0").strip() not in ("0", "")
+        self.default = sec.get("defaultvalue", "")
+        self.count = 1  # number of elements for strings
+        if self.data_type == 0x09:
+            self.count = max(len(self.default), 1)
+            self.size = self.count
+        elif self.data_type == 0x0A:
+            hexstr = re.sub(r"\s", "", self.default)
+            self.count = max(len(hexstr) // 2, 1)
+            self.size = self.count
+
+    @property
+    def is_domain(self):
+        return self.data_type == 0x0F
+
+    @property
+    def is_string(self):
+        return self.data_type in (0x09, 0x0A)
+
+    def attribute(self, storage, cos=False):
+        attr = STORAGE_ATTR[storage]
+        readable = self.access in ("ro", "rw", "rwr", "rww", "const")
+        writeable = self.access in ("wo", "rw", "rwr", "rww")
+        if readable:
+            attr |= ODA_READABLE
+        if writeable:
+            attr |= ODA_WRITEABLE
+        if self.pdo:
+            # Same as Object Dictionary Editor, CO_PDO.c verifies direction
+            attr |= ODA_TPDO_MAPABLE | ODA_RPDO_MAPABLE
+            if cos:
+                attr |= ODA_TPDO_DETECT_COS
+        if self.multibyte:
+            attr |= ODA_MB_VALUE
+        return attr
+
+    def initializer(self, node_id):
+        if self.is_domain:
+            return "0"
+        if self.data_type == 0x09:
+            chars = self.default.ljust(self.count, "\0")[:self.count]
+            return "{" + ", ".join(c_char(c) for c in chars) + "}"
+        if self.data_type == 0x0A:
+            hexstr = re.sub(r"\s", "", self.default).ljust(self.count * 2, "0")
+            return "{" + ", ".join("0x%s" % hexstr[i:i+2].upper() for i in range(0, self.count * 2, 2)) + "}"
+        if self.data_type in (0x08, 0x11):
+            text = self.default.strip() or "0"
+            float(text)
+            return text
+        try:
+            value = parse_int(self.default, node_id)
+        except ValueError:
+            raise GenError("invalid DefaultValue '%s' of '%s'" % (self.default, self.param_name))
+        if self.c_type.startswith("UNSIGNED"):
+            suffix = {1: "", 2: "", 4: "L", 8: "LL"}[self.size]
+            return "0x%X%s" % (value & ((1 << (8 * self.size)) - 1), suffix)
+        suffix = {1: "", 2: "", 4: "L", 8: "LL"}[self.size]
+        return "%d%s" % (value, suffix)
+
+
+def c_char(c):
+    if c == "\0":
+        return "0"
+    if c in "'\\":
+        return "'\\%s'" % c
+    if 32 <= ord(c) < 127:
+        return "'%s'" % c
+    return "0x%02X" % ord(c)
+
+
+class Object:
+    """Object Dictionary entry: VAR (7), ARRAY (8) or RECORD (9)."""
+
+    def __init__(self, index, sections, storage, cos):
+        sec = sections["%X" % index]
+        self.index = index
+        self.param_name = sec.get("parametername", "")
+        self.name = c_name(self.param_name)
+        self.object_type = int(sec.get("objecttype", "7"), 0)
+        self.storage = storage
+        self.cos = cos
+        self.array_of = None      # first Object of the array of records
+        self.array_len = 1
+        self.subs = []
+        if self.object_type == 7:
+            self.var = Var(sec, self.name, 0)
+            if self.var.access == "const" and storage == "ROM":
+                self.storage = "CONST"
+        elif self.object_type in (8, 9):
+            for sub in range(256):
+                key = "%XSUB%X" % (index, sub)
+                if key not in sections:
+                    continue
+                if sub != len(self.subs):
+                    raise GenError("0x%04X: sub-indexes must be contiguous" % index)
+                s = sections[key]
+                self.subs.append(Var(s, c_name(s.get("parametername", "sub%d" % sub)), sub))
+            if len(self.subs) < 2:
+                raise GenError("0x%04X: array or record without members" % index)
+            if self.object_type == 8:
+                first = self.subs[1]
+                for v in self.subs[2:]:
+                    if v.data_type != first.data_type or v.size != first.size:
+                        raise GenError("0x%04X: array members must have the same type" % index)
+        else:
+            raise GenError("0x%04X: unsupported ObjectType %d" % (index, self.object_type))
+
+    @property
+    def max_sub_index(self):
+        return 0 if self.object_type == 7 else len(self.subs) - 1
+
+    def attribute(self):
+        """Attribute of CO_OD_entry_t for VAR or ARRAY. Array attribute is
+        common for all members, access of sub-index 0 is included, because
+        CO_OD_getAttribute() may need it (0x1003)."""
+        if self.object_type == 7:
+            return self.var.attribute(self.storage, self.cos)
+        attr = self.subs[1].attribute(self.storage, self.cos)
+        return attr | (self.subs[0].attribute(self.storage) & (ODA_READABLE | ODA_WRITEABLE))
+
+    def structure(self):
+        return [(v.data_type, v.size) for v in self.subs]
+
+    @property
+    def type_name(self):
+        return "OD_%s_t" % self.name
+
+
+class OD:
+    def __init__(self, args):
+        self.args = args
+        self.sections = read_eds(args.eds)
+        project = read_project(args.project) if args.project else {}
+        indexes = sorted(int(k, 16) for k in self.sections if re.fullmatch(r"[0-9A-F]{4}", k))
+        self.objects = []
+        for index in indexes:
+            sec = self.sections["%X" % index]
+            storage = sec.get("storagelocation", "").strip().upper()
+            cos = False
+            if index in project:
+                cos = project[index][2]
+                if project[index][1]:
+                    continue  # disabled in project
+                storage = storage or (project[index][0] or "").upper()
+            storage = storage or args.storage
+            if storage not in ("RAM", "EEPROM", "ROM"):
+                raise GenError("0x%04X: unknown storage class '%s'" % (index, storage))
+            self.objects.append(Object(index, self.sections, storage, cos))
+        self.group_record_arrays()
+
+    def group_record_arrays(self):
+        """Records in communication ranges with the same structure become
+        arrays of records, as expected by the stack (OD_RPDOCommunicationParameter[i])."""
+        prev = None
+        for obj in self.objects:
+            if obj.object_type != 9:
+                prev = None
+                continue
+            rng = [r for r in RECORD_ARRAYS if r[0] <= obj.index <= r[1]]
+            if not rng:
+                prev = None
+                continue
+            head = prev.array_of if prev is not None else None
+            if (head is not None and prev.index + 1 == obj.index and
+                    head.index >= rng[0][0] and head.structure() == obj.structure() and
+                    head.storage == obj.storage):
+                obj.array_of = head
+                obj.name = head.name
+                head.array_len += 1
+            elif obj.index == rng[0][0]:
+                obj.array_of = obj
+            else:
+                raise GenError("0x%04X: record must follow 0x%04X with the same structure"
+                               % (obj.index, obj.index - 1))
+            prev = obj
+
+    def count(self, first, last):
+        return len([o for o in self.objects if first <= o.index <= last])
+
+    def features(self):
+        return [
+            ("CO_NO_SYNC", 1 if self.count(0x1005, 0x1005) else 0, "1005, 1006, 1007"),
+            ("CO_NO_TIME", 1 if self.count(0x1012, 0x1012) else 0, "1012, 1013"),
+            ("CO_NO_EMERGENCY", 1 if self.count(0x1014, 0x1014) else 0, "1014, 1015"),
+            ("CO_NO_SDO_SERVER", self.count(0x1200, 0x127F), "1200-127F"),
+            ("CO_NO_SDO_CLIENT", self.count(0x1280, 0x12FF), "1280-12FF"),
+            ("CO_NO_RPDO", self.count(0x1400, 0x15FF), "1400-15FF, 1600-17FF"),
+            ("CO_NO_TPDO", self.count(0x1800, 0x19FF), "1800-19FF, 1A00-1BFF"),
+            ("CO_NO_NMT_MASTER", 1 if self.args.nmt_master else 0, ""),
+            ("CO_NO_TRACE", self.count(0x2301, 0x2320), "2301-2320, 2400, 2401-2420"),
+            ("CO_NO_LSS_SERVER", 1 if self.args.lss_server else 0, ""),
+            ("CO_NO_LSS_CLIENT", 1 if self.args.lss_client else 0, ""),
+        ]
+
+    def heads(self, storage=None):
+        """Objects, which define a variable in storage structure."""
+        return [o for o in self.objects if (o.array_of is None or o.array_of is o) and
+                (storage is None or o.storage == storage)]
+
+    # ------------------------------------------------------------------ C code
+    def member_decl(self, obj):
+        if obj.object_type == 7:
+            v = obj.var
+            if v.is_string:
+                return v.c_type, "%s[%d]" % (obj.name, v.count)
+            return v.c_type, obj.name
+        if obj.object_type == 8:
+            v = obj.subs[1]
+            n = obj.max_sub_index
+            if v.is_string:
+                raise GenError("0x%04X: arrays of strings are not supported" % obj.index)
+            return v.c_type, "%s[%d]" % (obj.name, n)
+        if obj.array_of is obj:
+            return obj.type_name, "%s[%d]" % (obj.name, obj.array_len)
+        return obj.type_name, obj.name
+
+    def initializer(self, obj):
+        node_id = self.args.node_id
+        if obj.object_type == 7:
+            return obj.var.initializer(node_id)
+        if obj.object_type == 8:
+            return "{" + ", ".join(v.initializer(node_id) for v in obj.subs[1:]) + "}"
+        return "{" + ", ".join(v.initializer(node_id) for v in obj.subs) + "}"
+
+    def gen_h(self):
+        a = self.args
+        out = [file_header("CO_OD.h", a.eds), "", "",
+               "#ifndef CO_OD_H", "#define CO_OD_H", ""]
+        if a.packed:
+            out += ["#if !CO_OD_PACKED",
+                    "#error Object Dictionary was generated with --packed, set CO_OD_PACKED to 1.",
+                    "#endif", ""]
+        else:
+            out += ["#if CO_OD_PACKED",
+                    "#error Object Dictionary was generated without --packed, set CO_OD_PACKED to 0.",
+                    "#endif", ""]
+        out += [banner("CANopen DATA TYPES"),
+                "   typedef uint8_t      UNSIGNED8;",
+                "   typedef uint16_t     UNSIGNED16;",
+                "   typedef uint32_t     UNSIGNED32;",
+                "   typedef uint64_t     UNSIGNED64;",
+                "   typedef int8_t       INTEGER8;",
+                "   typedef int16_t      INTEGER16;",
+                "   typedef int32_t      INTEGER32;",
+                "   typedef int64_t      INTEGER64;",
+                "   typedef float32_t    REAL32;",
+                "   typedef float64_t    REAL64;",
+                "   typedef char_t       VISIBLE_STRING;",
+                "   typedef oChar_t      OCTET_STRING;",
+                "   typedef domain_t     DOMAIN;", "", ""]
+        fi = self.sections.get("FILEINFO", {})
+        di = self.sections.get("DEVICEINFO", {})
+        out += [banner("FILE INFO:\n      FileName:     %s\n      FileVersion:  %s\n"
+                       "      CreationTime: %s\n      CreationDate: %s\n      CreatedBy:    %s" %
+                       (fi.get("filename", "").strip(), fi.get("fileversion", "").strip(),
+                        fi.get("creationtime", "").strip(), fi.get("creationdate", "").strip(),
+                        fi.get("createdby", "").strip())), "", ""]
+        out += [banner("DEVICE INFO:\n      VendorName:     %s\n      VendorNumber:   %s\n"
+                       "      ProductName:    %s\n      ProductNumber:  %s" %
+                       (di.get("vendorname", "").strip(), di.get("vendornumber", "").strip(),
+                        di.get("productname", "").strip(), di.get("productnumber", "").strip())), "", ""]
+        out.append(banner("FEATURES"))
+        for name, value, assoc in self.features():
+            line = "   #define %-30s %d" % (name, value)
+            if value and assoc:
+                line += "   //Associated objects: " + assoc
+            out.append(line)
+        out += ["", banner("OBJECT DICTIONARY"),
+                "   #define CO_OD_NoOfElements             %d" % len(self.objects), "", ""]
+
+        out.append(banner("TYPE DEFINITIONS FOR RECORDS"))
+        for obj in self.heads():
+            if obj.object_type != 9:
+                continue
+            tag = "%04X" % obj.index + ("[%d]" % obj.array_len if obj.array_of is obj else "")
+            out.append("/*%-10s*/ typedef struct{" % tag)
+            for v in obj.subs:
+                decl = "%s[%d]" % (v.name, v.count) if v.is_string else v.name
+                out.append("               %-14s %s;" % (v.c_type, decl))
+            out += ["               }              %s;" % obj.type_name, ""]
+
+        out += ["", banner("STRUCTURES FOR VARIABLES IN DIFFERENT MEMORY LOCATIONS"),
+                "#define  CO_OD_FIRST_LAST_WORD     0x55 //Any value from 0x01 to 0xFE. If changed, EEPROM will be reinitialized.",
+                ""]
+        for storage in STORAGE_CLASSES:
+            out.append(("/***** Structure for %s variables " % storage).ljust(79, "*") + "/")
+            out += ["struct sCO_OD_%s{" % storage, "               UNSIGNED32     FirstWord;", ""]
+            for obj in self.heads(storage):
+                t, d = self.member_decl(obj)
+                tag = "%04X" % obj.index + ("[%d]" % obj.array_len if obj.array_of is obj else "")
+                out.append("/*%-10s*/ %-14s %s;" % (tag, t, d))
+            out += ["", "               UNSIGNED32     LastWord;", "};", ""]
+
+        out += ["", "/***** Declaration of Object Dictionary variables *****************************/"]
+        for storage in STORAGE_CLASSES:
+            const = "const " if storage == "CONST" else ""
+            out += ["extern %sstruct sCO_OD_%s CO_OD_%s;" % (const, storage, storage), ""]
+
+        out += ["", banner("ALIASES FOR OBJECT DICTIONARY VARIABLES")]
+        for obj in self.heads():
+            t, d = self.member_decl(obj)
+            tag = "%04X" % obj.index + ("[%d]" % obj.array_len if obj.array_of is obj else "")
+            desc = "/*%s, Data Type: %s" % (tag, t)
+            if obj.object_type == 8:
+                desc += ", Array[%d]" % obj.max_sub_index
+            elif obj.object_type == 7 and obj.var.is_string:
+                desc += ", Array[%d]" % obj.var.count
+            elif obj.array_of is obj:
+                desc += ", Array[%d]" % obj.array_len
+            out.append(desc + " */")
+            out.append("      #define %-42s %s" % ("OD_" + obj.name, "CO_OD_%s.%s" % (obj.storage, obj.name)))
+            if obj.object_type == 7 and obj.var.is_string:
+                out.append("      #define %-42s %d" % ("ODL_%s_stringLength" % obj.name, obj.var.count))
+            elif obj.object_type == 8:
+                out.append("      #define %-42s %d" % ("ODL_%s_arrayLength" % obj.name, obj.max_sub_index))
+                names = [v.name for v in obj.subs[1:]]
+                if len(set(names)) == len(names):
+                    for i, n in enumerate(names):
+                        out.append("      #define %-42s %d" % ("ODA_%s_%s" % (obj.name, n), i))
+            out.append("")
+        out += ["", "#endif", ""]
+        return "\n".join(out)
+
+    def record_table_name(self, obj):
+        return "OD_record%04X" % obj.index
+
+    def record_ref(self, obj):
+        """C expression of the record variable."""
+        ref = "CO_OD_%s.%s" % (obj.storage, obj.name)
+        if obj.array_of is not None:
+            ref += "[%d]" % (obj.index - obj.array_of.index)
+        return ref
+
+    def gen_c(self):
+        a = self.args
+        out = [file_header("CO_OD.c", a.eds), "", "",
+               '#include "CO_driver.h"', '#include "CO_OD.h"', '#include "CO_SDO.h"']
+        if a.packed:
+            out.append("#include <stddef.h>         /* for offsetof */")
+        out += ["", "",
+               banner("DEFINITION AND INITIALIZATION OF OBJECT DICTIONARY VARIABLES"), ""]
+        for storage in STORAGE_CLASSES:
+            const = "const " if storage == "CONST" else ""
+            out.append(("/***** Definition for %s variables " % storage).ljust(79, "*") + "/")
+            out += ["%sstruct sCO_OD_%s CO_OD_%s = {" % (const, storage, storage),
+                    "           CO_OD_FIRST_LAST_WORD,", ""]
+            for obj in self.heads(storage):
+                if obj.array_of is obj:
+                    members = [o for o in self.objects if o.array_of is obj]
+                    for i, o in enumerate(members):
+                        pre = "{" if i == 0 else " "
+                        post = "}," if i == len(members) - 1 else ","
+                        out.append("/*%04X*/%s%s%s" % (o.index, pre, self.initializer(o), post))
+                else:
+                    out.append("/*%04X*/ %s," % (obj.index, self.initializer(obj)))
+            out += ["", "           CO_OD_FIRST_LAST_WORD,", "};", "", ""]
+
+        out.append(banner("STRUCTURES FOR RECORD TYPE OBJECTS"))
+        members_tables = {}  # packed: records with equal type share members
+        for obj in self.objects:
+            if obj.object_type != 9:
+                continue
+            base = self.record_ref(obj)
+            tname = self.record_table_name(obj)
+            attrs = tuple(v.attribute(obj.storage, obj.cos) for v in obj.subs)
+            if a.packed:
+                key = (obj.type_name, attrs)
+                if key not in members_tables:
+                    members_tables[key] = tname + "Members"
+                    rows = []
+                    for v, attr in zip(obj.subs, attrs):
+                        if v.is_domain:
+                            rows.append("{0xFFFF, 0x%02X, %2d}" % (attr, 0))
+                        elif v.size > 255:
+                            raise GenError("0x%04X: member longer than 255 bytes can not be packed" % obj.index)
+                        else:
+                            rows.append("{offsetof(%s, %s), 0x%02X, %2d}" % (obj.type_name, v.name, attr, v.size))
+                    out.append("/*0x%04X*/ static const CO_OD_entryRecord_t %s[%d] = {"
+                               % (obj.index, members_tables[key], len(rows)))
+                    out.append(",\n".join("           " + r for r in rows) + "};")
+                out.append("/*0x%04X*/ static const CO_OD_record_t %s = {(void*)&%s, %s};"
+                           % (obj.index, tname, base, members_tables[key]))
+            else:
+                rows = []
+                for v, attr in zip(obj.subs, attrs):
+                    if v.is_domain:
+                        rows.append("{0, 0x%02X, %2d}" % (attr, 0))
+                    else:
+                        member = "%s.%s%s" % (base, v.name, "[0]" if v.is_string else "")
+                        rows.append("{(void*)&%s, 0x%02X, %2d}" % (member, attr, v.size))
+                out.append("/*0x%04X*/ const CO_OD_entryRecord_t %s[%d] = {" % (obj.index, tname, len(rows)))
+                out.append(",\n".join("           " + r for r in rows) + "};")
+        out += ["", "", banner("OBJECT DICTIONARY"),
+                "const CO_OD_entry_t CO_OD[CO_OD_NoOfElements] = {"]
+        for obj in self.objects:
+            if obj.object_type == 9:
+                attr, length, ptr = 0, 0, "(void*)&%s" % self.record_table_name(obj)
+            else:
+                v = obj.var if obj.object_type == 7 else obj.subs[1]
+                attr, length = obj.attribute(), v.size
+                if v.is_domain:
+                    ptr = "0"
+                else:
+                    ptr = "(void*)&CO_OD_%s.%s" % (obj.storage, obj.name)
+                    if obj.object_type == 8 or v.is_string:
+                        ptr += "[0]"
+            if a.packed:
+                out.append("{%s, 0x%04X, %2d, 0x%02X, 0x%02X}," % (ptr, obj.index, length, obj.max_sub_index, attr))
+            else:
+                out.append("{0x%04X, 0x%02X, 0x%02X, %2d, %s}," % (obj.index, obj.max_sub_index, attr, length, ptr))
+        out += ["};", ""]
+        return "\n".join(out)
+
+    # ------------------------------------------------------------- footprint
+    def report(self):
+        p = self.args.ptr_size
+        al64 = self.args.align64
+
+        def align(x, a):
+            return (x + a - 1) // a * a
+
+        def struct_size(vars_):
+            off, amax = 0, 1
+            for size, a in vars_:
+                off = align(off, a) + size
+                amax = max(amax, a)
+            return align(off, amax), amax
+
+        def var_layout(v):
+            if v.is_string or v.is_domain:
+                return (max(v.size, 1), 1)  # domain_t is one byte
+            return (v.size, min(v.size, al64))
+
+        def member_layout(obj):
+            if obj.object_type == 7:
+                return var_layout(obj.var)
+            if obj.object_type == 8:
+                size, a = var_layout(obj.subs[1])
+                return (size * obj.max_sub_index, a)
+            rec, a = struct_size([var_layout(v) for v in obj.subs])
+            return (rec * obj.array_len, a)
+
+        def data_size(storages):
+            heads = [o for o in self.heads() if o.storage in storages]
+            if not heads:
+                return 0
+            return struct_size([(4, 4)] + [member_layout(o) for o in heads] + [(4, 4)])[0]
+
+        n_entries = len(self.objects)
+        records = [o for o in self.objects if o.object_type == 9]
+        n_members = sum(len(o.subs) for o in records)
+        entry = struct_size([(2, 2), (1, 1), (2, 2), (2, 2), (p, p)])[0]
+        member = struct_size([(p, p), (2, 2), (2, 2)])[0]
+        if self.args.packed:
+            entry_gen = struct_size([(p, p), (2, 2), (2, 2), (1, 1), (1, 1)])[0]
+            types = set((o.type_name, tuple(v.attribute(o.storage, o.cos) for v in o.subs)) for o in records)
+            records_gen = sum(len(t[1]) for t in types) * 4 + len(records) * 2 * p
+        else:
+            entry_gen = entry
+            records_gen = n_members * member
+
+        # Before, const variables were part of RAM resident CO_OD_ROM
+        rows = [
+            ("flash: CO_OD[] entries", n_entries * entry, n_entries * entry_gen),
+            ("flash: record tables", n_members * member, records_gen),
+            ("flash: CO_OD_CONST", 0, data_size(("CONST",))),
+            ("RAM: CO_OD_RAM", data_size(("RAM",)), data_size(("RAM",))),
+            ("RAM: CO_OD_EEPROM", data_size(("EEPROM",)), data_size(("EEPROM",))),
+            ("RAM: CO_OD_ROM", data_size(("ROM", "CONST")), data_size(("ROM",))),
+        ]
+        lines = ["Object Dictionary footprint in bytes, pointer size %d, 64-bit alignment %d:" % (p, al64),
+                 "  entries: %d, records: %d, record members: %d" % (n_entries, len(records), n_members),
+                 "",
+                 "  %-30s %10s %10s" % ("", "current", "generated")]
+        for name, before, after in rows:
+            lines.append("  %-30s %10d %10d" % (name, before, after))
+        lines += ["",
+                  "  %-30s %10d %10d" % ("total flash", sum(r[1] for r in rows[:3]), sum(r[2] for r in rows[:3])),
+                  "  %-30s %10d %10d" % ("total RAM", sum(r[1] for r in rows[3:]), sum(r[2] for r in rows[3:]))]
+        return "\n".join(lines)
+
+
+def banner(text):
+    return ("/" + "*" * 79 + "\n   " + text + "\n" + "*" * 79 + "/")
+
+
+def file_header(name, eds):
+    return """/*
+ * CANopen Object Dictionary.
+ *
+ * This file was automatically generated with tools/eds2od.py from
+ * %s. DON'T EDIT THIS FILE MANUALLY !!!!
+ * For more information on CANopen Object Dictionary see <CO_SDO.h>.
+ *
+ * @file        %s
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */""" % (os.path.basename(eds), name)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("eds", help="Electronic Data Sheet")
+    ap.add_argument("-o", "--output", help="directory for CO_OD.h and CO_OD.c")
+    ap.add_argument("--project", help="project file of Object Dictionary Editor (_project.xml)")
+    ap.add_argument("--storage", default="RAM", choices=("RAM", "EEPROM", "ROM"),
+                    help="default storage class (default RAM)")
+    ap.add_argument("--packed", action="store_true", help="generate tables for CO_OD_PACKED=1")
+    ap.add_argument("--node-id", type=int, default=0, help=argparse.SUPPRESS)
+    ap.add_argument("--nmt-master", action="store_true", help="set CO_NO_NMT_MASTER")
+    ap.add_argument("--lss-server", action="store_true", help="set CO_NO_LSS_SERVER")
+    ap.add_argument("--lss-client", action="store_true", help="set CO_NO_LSS_CLIENT")
+    ap.add_argument("--report", action="store_true", help="print RAM and flash footprint")
+    ap.add_argument("--ptr-size", type=int, default=4, choices=(2, 4, 8),
+                    help="target pointer size for --report (default 4)")
+    ap.add_argument("--align64", type=int, default=8, choices=(2, 4, 8),
+                    help="target alignment of 64-bit types for --report (default 8)")
+    args = ap.parse_args()
+
+    try:
+        od = OD(args)
+        if args.output:
+            os.makedirs(args.output, exist_ok=True)
+            with open(os.path.join(args.output, "CO_OD.h"), "w") as f:
+                f.write(od.gen_h())
+            with open(os.path.join(args.output, "CO_OD.c"), "w") as f:
+                f.write(od.gen_c())
+        if args.report:
+            print(od.report())
+    except GenError as e:
+        sys.exit("eds2od: %s" % e)
+
+
+if __name__ == "__main__":
+    main()
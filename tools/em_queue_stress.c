@@ -0,0 +1,226 @@
+/*
+ * Stress test of the lock-free emergency queue from stack/CO_Emergency.c.
+ *
+ * @file        em_queue_stress.c
+ *
+ * Several producer threads call CO_errorReport() as fast as possible, each
+ * with its own error code and increasing info code. Main thread is the only
+ * consumer, it calls CO_EM_process(). Program replaces CAN driver with the
+ * recording one and verifies, that every queued message was sent exactly
+ * once, that messages of each producer kept their order and that sent plus
+ * dropped messages of the producers match the number of reports.
+ *
+ * Build and run on Linux host, from the root of the repository:
+ *
+ *     gcc -O2 -pthread -DCO_EM_DROP_STATS=1 -I. -Istack -Istack/drvTemplate \
+ *         -Iexample tools/em_queue_stress.c stack/CO_Emergency.c \
+ *         stack/CO_SDO.c stack/crc16-ccitt.c -o em_queue_stress
+ *     ./em_queue_stress 4 200000
+ *
+ * Arguments: number of producers (default 4, max 16), number of reports
+ * of each producer (default 200000) and busy loop between two reports
+ * (default 0, queue is then mostly full).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "CO_driver.h"
+#include "CO_SDO.h"
+#include "CO_Emergency.h"
+
+#if !CO_EM_DROP_STATS
+    #error Build with -DCO_EM_DROP_STATS=1
+#endif
+
+
+#define MAX_PRODUCERS       16U
+#define PRODUCER_CODE       0x1000U
+
+
+static CO_EM_t em;
+static CO_EMpr_t emPr;
+static CO_CANtx_t txBuff;
+static unsigned int noOfReports;
+static unsigned int pause;
+
+/* recorded by CO_CANsend() */
+static unsigned long sentTotal;
+static unsigned long sent[MAX_PRODUCERS];
+static unsigned long lastInfo[MAX_PRODUCERS];
+static unsigned long orderErrors;
+
+
+/* Recording CAN driver, only functions used by emergency and SDO ***********/
+uint16_t CO_CANrxMsg_readIdent(const CO_CANrxMsg_t *rxMsg){
+    return (uint16_t)rxMsg->ident;
+}
+
+CO_ReturnError_t CO_CANrxBufferInit(
+        CO_CANmodule_t         *CANmodule,
+        uint16_t                index,
+        uint16_t                ident,
+        uint16_t                mask,
+        bool_t                  rtr,
+        void                   *object,
+        void                  (*pFunct)(void *object, const CO_CANrxMsg_t *message))
+{
+    (void)CANmodule; (void)index; (void)ident; (void)mask; (void)rtr; (void)object; (void)pFunct;
+    return CO_ERROR_NO;
+}
+
+CO_CANtx_t *CO_CANtxBufferInit(
+        CO_CANmodule_t         *CANmodule,
+        uint16_t                index,
+        uint16_t                ident,
+        bool_t                  rtr,
+        uint8_t                 noOfBytes,
+        bool_t                  syncFlag)
+{
+    (void)CANmodule; (void)index; (void)ident; (void)rtr; (void)noOfBytes; (void)syncFlag;
+    return &txBuff;
+}
+
+CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
+    unsigned int code = (unsigned int)buffer->data[0] | ((unsigned int)buffer->data[1] << 8);
+    unsigned long info = (unsigned long)buffer->data[4] | ((unsigned long)buffer->data[5] << 8) |
+                         ((unsigned long)buffer->data[6] << 16) | ((unsigned long)buffer->data[7] << 24);
+
+    (void)CANmodule;
+    sentTotal++;
+    if(code >= PRODUCER_CODE && code < PRODUCER_CODE + MAX_PRODUCERS && buffer->data[3] == 0U){
+        unsigned int p = code - PRODUCER_CODE;
+
+        if(info <= lastInfo[p]){
+            orderErrors++;
+        }
+        lastInfo[p] = info;
+        sent[p]++;
+    }
+
+    return CO_ERROR_NO;
+}
+
+void CO_CANverifyErrors(CO_CANmodule_t *CANmodule){
+    (void)CANmodule;
+}
+
+
+/* Producer thread, error bit 0 (no error) is queued on every report */
+static void *producer(void *arg){
+    uint16_t code = (uint16_t)(PRODUCER_CODE + (uintptr_t)arg);
+    unsigned int i;
+
+    for(i=1U; i<=noOfReports; i++){
+        volatile unsigned int p;
+
+        CO_errorReport(&em, CO_EM_NO_ERROR, code, i);
+        for(p=0U; p<pause; p++){
+        }
+    }
+
+    return NULL;
+}
+
+
+int main(int argc, char *argv[]){
+    unsigned int noOfProducers = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 0) : 4U;
+    pthread_t thread[MAX_PRODUCERS];
+    static uint32_t deviceType;
+    static const CO_OD_entry_t OD[1] = {{0x1000, 0x00, 0x85, 4, (void*)&deviceType}};
+    static CO_OD_extension_t ODExtensions[1];
+    static CO_SDO_t SDO;
+    static CO_CANmodule_t CANmodule;
+    uint8_t errorStatusBits[10];
+    uint8_t errorRegister = 0U;
+    uint32_t preDefErr[8];
+    unsigned long sentProducers = 0UL, droppedOther = 0UL, droppedProducers;
+    unsigned int i;
+    int ret = 0;
+
+    noOfReports = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : 200000U;
+    pause = (argc > 3) ? (unsigned int)strtoul(argv[3], NULL, 0) : 0U;
+    if(noOfProducers == 0U || noOfProducers > MAX_PRODUCERS || noOfReports == 0U){
+        fprintf(stderr, "Usage: %s [producers 1...%u] [reports] [pause]\n", argv[0], MAX_PRODUCERS);
+        return 1;
+    }
+
+    /* Object Dictionary is needed only by CO_OD_configure() */
+    SDO.OD = OD;
+    SDO.ODSize = 1U;
+    SDO.ODExtensions = ODExtensions;
+
+    if(CO_EM_init(&em, &emPr, &SDO, errorStatusBits, sizeof(errorStatusBits), &errorRegister,
+                  preDefErr, 8U, &CANmodule, 0U, &CANmodule, 0U, 0x81U) != CO_ERROR_NO)
+    {
+        printf("CO_EM_init failed\n");
+        return 1;
+    }
+
+    for(i=0U; i<noOfProducers; i++){
+        pthread_create(&thread[i], NULL, producer, (void *)(uintptr_t)i);
+    }
+    for(;;){
+        uint32_t queued = em.queuedCount + em.droppedCount + em.coalescedCount;
+
+        CO_EM_process(&emPr, true, 0U, 0U, NULL);
+        for(i=0U, sentProducers=0UL; i<noOfProducers; i++){
+            sentProducers += sent[i];
+        }
+        if(sentProducers + em.droppedCount >= (unsigned long)noOfProducers * noOfReports &&
+           em.bufReadPos == em.bufWritePos && queued == em.queuedCount + em.droppedCount + em.coalescedCount)
+        {
+            break;
+        }
+    }
+    for(i=0U; i<noOfProducers; i++){
+        pthread_join(thread[i], NULL);
+    }
+    CO_EM_process(&emPr, true, 0U, 0U, NULL);
+
+    /* drops of own messages of CO_EM_process() are counted per error bit */
+    for(i=1U; i<256U; i++){
+        droppedOther += em.droppedBits[i];
+    }
+    droppedProducers = em.droppedCount - droppedOther;
+    for(i=0U, sentProducers=0UL; i<noOfProducers; i++){
+        sentProducers += sent[i];
+    }
+
+    printf("producers %u x %u reports, queue %u slots\n", noOfProducers, noOfReports,
+           (unsigned int)CO_EM_INTERNAL_BUFFER_SIZE);
+    printf("queued %u, dropped %u, coalesced %u, sent %lu, max level %u\n",
+           (unsigned int)em.queuedCount, (unsigned int)em.droppedCount,
+           (unsigned int)em.coalescedCount, sentTotal, (unsigned int)em.bufMaxLevel);
+
+    if(sentTotal != em.queuedCount){
+        printf("FAIL: sent %lu, queued %u\n", sentTotal, (unsigned int)em.queuedCount);
+        ret = 1;
+    }
+    if(orderErrors != 0UL){
+        printf("FAIL: %lu messages out of order\n", orderErrors);
+        ret = 1;
+    }
+    if(sentProducers + droppedProducers != (unsigned long)noOfProducers * noOfReports){
+        printf("FAIL: sent %lu + dropped %lu of producers, reported %lu\n", sentProducers,
+               droppedProducers, (unsigned long)noOfProducers * noOfReports);
+        ret = 1;
+    }
+    if(ret == 0){
+        printf("OK\n");
+    }
+
+    return ret;
+}
@@ -0,0 +1,194 @@
+/*
+ * Startup time and memory benchmark of the Object Dictionary loaded from EDS.
+ *
+ * @file        od_eds_bench.c
+ *
+ * Program generates synthetic EDS with given number of objects (VAR, ARRAY
+ * of 8 and RECORD of 4 sub-objects in turn), loads it with CO_OD_eds_parse()
+ * and prints load time, arena and temporary memory. Then it measures
+ * CO_OD_find() with binary search and with index lookup table. If EDS file
+ * is given as second argument (for example example/IO.eds), it is loaded and
+ * bound to the compiled CO_OD[] with CO_OD_eds_bind() too.
+ *
+ * Build and run on Linux host, from the root of the repository:
+ *
+ *     gcc -O2 -DCO_OD_INDEX_LOOKUP=1 -I. -Istack -Istack/drvTemplate -Iexample \
+ *         tools/od_eds_bench.c stack/socketCAN/CO_OD_eds.c stack/CO_SDO.c \
+ *         stack/CO_Emergency.c stack/crc16-ccitt.c stack/drvTemplate/CO_driver.c \
+ *         example/CO_OD.c -o od_eds_bench
+ *     ./od_eds_bench 20000 example/IO.eds
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "CO_driver.h"
+#include "CO_SDO.h"
+#include "CO_OD.h"
+#include "socketCAN/CO_OD_eds.h"
+
+
+#define FIND_LOOPS      10000000UL
+
+
+extern const CO_OD_entry_t CO_OD[CO_OD_NoOfElements];  /* Object Dictionary array */
+
+
+static double now_s(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+/* Append formatted text to the growing buffer */
+static void put(char **buf, size_t *len, size_t *cap, const char *fmt, unsigned int a, unsigned int b){
+    int n;
+
+    if(*len + 256U > *cap){
+        *cap = *cap * 2U + 4096U;
+        *buf = (char *)realloc(*buf, *cap);
+        if(*buf == NULL){
+            exit(1);
+        }
+    }
+    n = sprintf(*buf + *len, fmt, a, b);
+    *len += (size_t)n;
+}
+
+
+/* Synthetic EDS with noOfObjects objects from index 0x2000 */
+static char *generate(unsigned int noOfObjects){
+    char *buf = NULL;
+    size_t len = 0U, cap = 0U;
+    unsigned int i, s;
+
+    put(&buf, &len, &cap, "[FileInfo]\nFileName=bench.eds%.0u%.0u\n", 0U, 0U);
+    for(i=0U; i<noOfObjects; i++){
+        unsigned int index = 0x2000U + i;
+
+        switch(i % 3U){
+        case 0:
+            put(&buf, &len, &cap, "\n[%X]\nParameterName=Var%u\nObjectType=7\n"
+                "DataType=0x0007\nAccessType=rw\nDefaultValue=0x12345678\nPDOMapping=1\n", index, i);
+            break;
+        case 1:
+            put(&buf, &len, &cap, "\n[%X]\nParameterName=Array%u\nObjectType=8\nSubNumber=9\n", index, i);
+            put(&buf, &len, &cap, "\n[%Xsub0]\nParameterName=Highest%u\nObjectType=7\n"
+                "DataType=0x0005\nAccessType=ro\nDefaultValue=8\n", index, 0U);
+            for(s=1U; s<=8U; s++){
+                put(&buf, &len, &cap, "\n[%Xsub%X]\nParameterName=Element\nObjectType=7\n"
+                    "DataType=0x0006\nAccessType=rw\nDefaultValue=1\n", index, s);
+            }
+            break;
+        default:
+            put(&buf, &len, &cap, "\n[%X]\nParameterName=Record%u\nObjectType=9\nSubNumber=5\n", index, i);
+            put(&buf, &len, &cap, "\n[%Xsub0]\nParameterName=Highest%u\nObjectType=7\n"
+                "DataType=0x0005\nAccessType=ro\nDefaultValue=4\n", index, 0U);
+            for(s=1U; s<=4U; s++){
+                put(&buf, &len, &cap, "\n[%Xsub%X]\nParameterName=Member\nObjectType=7\n"
+                    "DataType=0x0007\nAccessType=rw\nDefaultValue=0\n", index, s);
+            }
+            break;
+        }
+    }
+
+    return buf;
+}
+
+
+/* Average time of CO_OD_find() in nanoseconds */
+static double findTime(CO_SDO_t *SDO, unsigned int noOfObjects, unsigned int *found){
+    unsigned long l;
+    unsigned int f = 0U;
+    uint32_t x = 1U;
+    double t;
+
+    t = now_s();
+    for(l=0UL; l<FIND_LOOPS; l++){
+        x = x * 1103515245U + 12345U;
+        if(CO_OD_find(SDO, (uint16_t)(0x2000U + (x >> 8) % noOfObjects)) != 0xFFFFU){
+            f++;
+        }
+    }
+    t = now_s() - t;
+    *found = f;
+
+    return t * 1e9 / (double)FIND_LOOPS;
+}
+
+
+int main(int argc, char *argv[]){
+    unsigned int noOfObjects = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 0) : 20000U;
+    CO_OD_eds_t eds;
+    CO_SDO_t SDO;
+    unsigned int found;
+    char *text;
+    double t;
+
+    if(noOfObjects == 0U || noOfObjects > 0xDFFFU){
+        fprintf(stderr, "Number of objects must be 1 ... %u\n", 0xDFFFU);
+        return 1;
+    }
+
+    text = generate(noOfObjects);
+    t = now_s();
+    if(CO_OD_eds_parse(&eds, text) != CO_ERROR_NO){
+        printf("synthetic EDS: error in line %u\n", (unsigned int)eds.errorLine);
+        return 1;
+    }
+    t = now_s() - t;
+    free(text);
+
+    printf("synthetic EDS: %u objects, %u bytes, %u sections\n", noOfObjects,
+           (unsigned int)eds.stats.fileSize, (unsigned int)eds.stats.noOfSections);
+    printf("  load %.1f ms, arena %u bytes (data %u), temporary %u bytes\n", t * 1e3,
+           (unsigned int)eds.stats.arenaSize, (unsigned int)eds.stats.dataSize,
+           (unsigned int)eds.stats.tempSize);
+
+    memset(&SDO, 0, sizeof(SDO));
+    SDO.OD = eds.OD;
+    SDO.ODSize = eds.ODSize;
+    SDO.ODExtensions = eds.ODExtensions;
+    SDO.ODlookup = NULL;
+    t = findTime(&SDO, noOfObjects, &found);
+    printf("  CO_OD_find: binary search %.1f ns", t);
+    CO_OD_setIndexLookup(&SDO, eds.lookup, eds.lookupMask);
+    t = findTime(&SDO, noOfObjects, &found);
+    printf(", lookup table %.1f ns (%u found)\n", t, found);
+    CO_OD_eds_free(&eds);
+
+    if(argc > 2){
+        CO_ReturnError_t err = CO_OD_eds_load(&eds, argv[2]);
+
+        if(err != CO_ERROR_NO){
+            printf("%s: error %d in line %u\n", argv[2], (int)err, (unsigned int)eds.errorLine);
+            return 1;
+        }
+        printf("%s: %u entries, arena %u bytes\n", argv[2],
+               (unsigned int)eds.ODSize, (unsigned int)eds.stats.arenaSize);
+        err = CO_OD_eds_bind(&eds, CO_OD, CO_OD_NoOfElements);
+        if(err != CO_ERROR_NO){
+            printf("  bind to CO_OD: object %04X differs\n", (unsigned int)eds.errorIndex);
+            return 1;
+        }
+        printf("  bound to CO_OD (%u entries)\n", (unsigned int)CO_OD_NoOfElements);
+        CO_OD_eds_free(&eds);
+    }
+
+    return 0;
+}
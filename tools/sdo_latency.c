@@ -0,0 +1,163 @@
+/*
+ * Round-trip latency benchmark of the SDO server on Linux SocketCAN.
+ *
+ * @file        sdo_latency.c
+ *
+ * Program sends expedited SDO upload requests to the CANopen device and
+ * measures time to the response on the monotonic clock. Requests are sent
+ * one after another with random pause, so they are not aligned with the
+ * mainline cycle of the device. Results show the difference between device
+ * with SDO processed by CO_process() and device built with
+ * CO_SDO_PROCESS_SEPARATE, where taskSDO responds from the receive event.
+ *
+ * Build and run on Linux host:
+ *
+ *     gcc -O2 tools/sdo_latency.c -o sdo_latency
+ *     ./sdo_latency can0 4 1000 0x1000 0
+ *
+ * Arguments: CAN interface, node-ID, number of requests (default 1000),
+ * index (default 0x1000) and subindex (default 0) of the uploaded object.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+
+
+#define SDO_TIMEOUT_MS      1000
+
+
+static double now_us(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec * 1e-3;
+}
+
+
+static int compare(const void *a, const void *b){
+    double d = *(const double *)a - *(const double *)b;
+
+    return (d > 0) - (d < 0);
+}
+
+
+int main(int argc, char *argv[]){
+    struct sockaddr_can addr;
+    struct can_filter filter;
+    struct ifreq ifr;
+    struct can_frame req;
+    unsigned int nodeId, count, index, subIndex;
+    unsigned int i, n = 0U, timeouts = 0U, aborts = 0U;
+    double *rtt, sum = 0.0;
+    int s;
+
+    if(argc < 3){
+        fprintf(stderr, "Usage: %s <CAN interface> <node-ID> [count] [index] [subindex]\n", argv[0]);
+        return 1;
+    }
+    nodeId = (unsigned int)strtoul(argv[2], NULL, 0);
+    count = (argc > 3) ? (unsigned int)strtoul(argv[3], NULL, 0) : 1000U;
+    index = (argc > 4) ? (unsigned int)strtoul(argv[4], NULL, 0) : 0x1000U;
+    subIndex = (argc > 5) ? (unsigned int)strtoul(argv[5], NULL, 0) : 0U;
+    if(nodeId < 1U || nodeId > 127U || count == 0U){
+        fprintf(stderr, "Wrong arguments\n");
+        return 1;
+    }
+
+    s = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if(s < 0){
+        perror("socket");
+        return 1;
+    }
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, argv[1], IFNAMSIZ - 1);
+    if(ioctl(s, SIOCGIFINDEX, &ifr) < 0){
+        perror("SIOCGIFINDEX");
+        return 1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if(bind(s, (struct sockaddr *)&addr, sizeof(addr)) < 0){
+        perror("bind");
+        return 1;
+    }
+
+    /* receive only SDO responses of the device */
+    filter.can_id = 0x580U + nodeId;
+    filter.can_mask = CAN_SFF_MASK;
+    setsockopt(s, SOL_CAN_RAW, CAN_RAW_FILTER, &filter, sizeof(filter));
+
+    rtt = (double *)malloc(count * sizeof(double));
+    if(rtt == NULL){
+        return 1;
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.can_id = 0x600U + nodeId;
+    req.can_dlc = 8;
+    req.data[0] = 0x40;
+    req.data[1] = (unsigned char)index;
+    req.data[2] = (unsigned char)(index >> 8);
+    req.data[3] = (unsigned char)subIndex;
+
+    srand((unsigned int)time(NULL));
+    for(i=0U; i<count; i++){
+        struct pollfd pfd = {s, POLLIN, 0};
+        struct can_frame resp;
+        double t0;
+
+        usleep(1000U + (unsigned int)rand() % 10000U);
+
+        t0 = now_us();
+        if(write(s, &req, sizeof(req)) != sizeof(req)){
+            perror("write");
+            return 1;
+        }
+        if(poll(&pfd, 1, SDO_TIMEOUT_MS) <= 0 ||
+           read(s, &resp, sizeof(resp)) != sizeof(resp))
+        {
+            timeouts++;
+            continue;
+        }
+        if(resp.data[0] == 0x80){
+            aborts++;
+            continue;
+        }
+        rtt[n] = now_us() - t0;
+        sum += rtt[n];
+        n++;
+    }
+    close(s);
+
+    printf("requests %u, responses %u, aborts %u, timeouts %u\n", count, n, aborts, timeouts);
+    if(n > 0U){
+        qsort(rtt, n, sizeof(double), compare);
+        printf("round trip [us]: min %.0f, avg %.0f, median %.0f, p99 %.0f, max %.0f\n",
+               rtt[0], sum / n, rtt[n / 2], rtt[(n * 99U) / 100U], rtt[n - 1U]);
+    }
+    free(rtt);
+
+    return (n == 0U) ? 1 : 0;
+}
@@ -0,0 +1,425 @@
+/*
+ * Network commissioning time with the SDO client scheduler.
+ *
+ * @file        sdo_sched_bench.c
+ *
+ * Program simulates CAN bus with N SDO servers (CO_SDO_t from
+ * stack/CO_SDO.c) and the master with CO_SDOclientSched_t from
+ * stack/CO_SDOmaster.c. Bus has the given bit rate and arbitration by CAN
+ * identifier, each server is processed in its own mainline cycle with random
+ * phase. Master processes the scheduler every millisecond and immediately
+ * after SDO client receives response. Each node is commissioned with 11
+ * requests: upload of device type and serial number, download of 8 UNSIGNED32
+ * parameters and segmented download of 28 byte string. Missing nodes get one
+ * upload request each, which ends after timeout and retries.
+ *
+ * For 1, 2, 4, ... clients program prints busyTime_ms of the scheduler,
+ * which is the commissioning time of the network, and the bus load. When the
+ * bus is saturated, requests to the nodes with higher CAN identifiers may lose
+ * arbitration for longer than SDO timeout. They end with timeout and are
+ * counted as failed, so the useful number of clients is below that point.
+ *
+ * Build and run on Linux host, from the root of the repository:
+ *
+ *     gcc -O2 -I. -Istack -Istack/drvTemplate -Iexample \
+ *         tools/sdo_sched_bench.c stack/CO_SDOmaster.c stack/CO_SDO.c \
+ *         stack/crc16-ccitt.c -o sdo_sched_bench
+ *     ./sdo_sched_bench 32 8 500 1000 0
+ *
+ * Arguments: number of servers (default 32, max 120), maximum number of
+ * clients (default 8, max 16), bit rate in kbit/s (default 500), mainline
+ * cycle of the servers in microseconds (default 1000) and number of missing
+ * nodes (default 0).
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CO_driver.h"
+#include "CO_SDO.h"
+#include "CO_SDOmaster.h"
+
+
+#define MAX_SERVERS         120U
+#define MAX_CLIENTS         16U
+#define MAX_NODES           126U
+#define REQS_PER_NODE       11U
+#define MASTER_NODE_ID      1U
+#define FRAME_BITS          125U    /* 8 data bytes, with average bit stuffing */
+#define BUS_QUEUE           1024U
+#define STEP_US             50U
+#define SDO_TIMEOUT_MS      100U
+#define SDO_RETRIES         2U
+#define SIM_LIMIT_US        (600UL * 1000000UL)
+
+
+typedef struct{
+    uint16_t            ident;
+    uint8_t             data[8];
+    CO_CANmodule_t     *src;
+    CO_CANtx_t         *buffer;
+}frame_t;
+
+
+/* simulated bus */
+static frame_t queue[BUS_QUEUE];
+static unsigned int queueLen;
+static frame_t onBus;
+static bool_t busBusy;
+static unsigned long busEnd_us;
+static unsigned long busBusy_us;
+static unsigned long now_us;
+static unsigned int bitTime_ns;
+
+/* CAN modules: master and one for each server */
+static CO_CANmodule_t *modules[MAX_SERVERS + 1U];
+static unsigned int noOfModules;
+static CO_CANmodule_t masterModule;
+static CO_CANrx_t masterRx[MAX_CLIENTS + 1U];
+static CO_CANtx_t masterTx[MAX_CLIENTS + 1U];
+static CO_CANmodule_t serverModule[MAX_SERVERS];
+static CO_CANrx_t serverRx[MAX_SERVERS];
+static CO_CANtx_t serverTx[MAX_SERVERS];
+
+/* Object Dictionary, shared by all servers */
+static uint32_t deviceType = 0x000F0191UL;
+static uint32_t identity[4] = {0x1234UL, 0x42UL, 0x10001UL, 0x5EA1UL};
+static uint32_t parameters[8];
+static uint8_t name[28];
+static const CO_OD_entry_t OD[] = {
+    {0x1000, 0x00, 0x85,  4, (void*)&deviceType},
+    {0x1018, 0x04, 0x85,  4, (void*)&identity[0]},
+    {0x2000, 0x08, 0x8E,  4, (void*)&parameters[0]},
+    {0x2100, 0x00, 0x0E, 28, (void*)&name[0]},
+};
+#define OD_SIZE (sizeof(OD) / sizeof(OD[0]))
+static CO_OD_extension_t ODExtensions[MAX_SERVERS + 1U][OD_SIZE];
+
+/* nodes */
+static CO_SDO_t SDOserver[MAX_SERVERS];
+static unsigned long serverPhase_us[MAX_SERVERS];
+static CO_SDO_t SDOmaster;
+static CO_SDOclient_t SDOclient[MAX_CLIENTS];
+static CO_SDOclient_t *SDOclients[MAX_CLIENTS];
+static CO_SDOclientPar_t SDOclientPar[MAX_CLIENTS];
+static CO_SDOclientSched_t sched;
+static CO_SDOclientReq_t reqs[MAX_NODES * REQS_PER_NODE];
+static uint8_t buffers[MAX_NODES * REQS_PER_NODE][28];
+
+
+/* CAN driver, only functions used by SDO server and client ******************/
+uint16_t CO_CANrxMsg_readIdent(const CO_CANrxMsg_t *rxMsg){
+    return (uint16_t)rxMsg->ident;
+}
+
+CO_ReturnError_t CO_CANrxBufferInit(
+        CO_CANmodule_t         *CANmodule,
+        uint16_t                index,
+        uint16_t                ident,
+        uint16_t                mask,
+        bool_t                  rtr,
+        void                   *object,
+        void                  (*pFunct)(void *object, const CO_CANrxMsg_t *message))
+{
+    CO_CANrx_t *rx;
+
+    (void)rtr;
+    if(index >= CANmodule->rxSize){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    rx = &CANmodule->rxArray[index];
+    rx->ident = ident;
+    rx->mask = mask;
+    rx->object = object;
+    rx->pFunct = pFunct;
+
+    return CO_ERROR_NO;
+}
+
+CO_CANtx_t *CO_CANtxBufferInit(
+        CO_CANmodule_t         *CANmodule,
+        uint16_t                index,
+        uint16_t                ident,
+        bool_t                  rtr,
+        uint8_t                 noOfBytes,
+        bool_t                  syncFlag)
+{
+    CO_CANtx_t *tx;
+
+    (void)rtr; (void)syncFlag;
+    if(index >= CANmodule->txSize){
+        return NULL;
+    }
+    tx = &CANmodule->txArray[index];
+    tx->ident = ident;
+    tx->DLC = noOfBytes;
+    tx->bufferFull = false;
+
+    return tx;
+}
+
+/* As drvTemplate: one pending frame per buffer, new one is lost on overflow */
+CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
+    frame_t *f;
+
+    if(buffer->bufferFull || queueLen >= BUS_QUEUE){
+        return CO_ERROR_TX_OVERFLOW;
+    }
+    buffer->bufferFull = true;
+    f = &queue[queueLen++];
+    f->ident = (uint16_t)buffer->ident;
+    memcpy(f->data, buffer->data, 8);
+    f->src = CANmodule;
+    f->buffer = buffer;
+
+    return CO_ERROR_NO;
+}
+
+
+/* Finish the frame on the bus and start the next one, lowest identifier wins */
+static void busProcess(void){
+    unsigned int i, win;
+
+    if(busBusy && now_us >= busEnd_us){
+        CO_CANrxMsg_t msg;
+
+        busBusy = false;
+        onBus.buffer->bufferFull = false;
+        msg.ident = onBus.ident;
+        msg.DLC = 8;
+        memcpy(msg.data, onBus.data, 8);
+        for(i=0; i<noOfModules; i++){
+            CO_CANmodule_t *m = modules[i];
+            uint16_t j;
+
+            if(m == onBus.src){
+                continue;
+            }
+            for(j=0; j<m->rxSize; j++){
+                CO_CANrx_t *rx = &m->rxArray[j];
+
+                if(rx->pFunct != NULL && ((msg.ident ^ rx->ident) & rx->mask) == 0U){
+                    rx->pFunct(rx->object, &msg);
+                }
+            }
+        }
+    }
+
+    if(!busBusy && queueLen > 0U){
+        unsigned long frame_us = ((unsigned long)FRAME_BITS * bitTime_ns + 999UL) / 1000UL;
+
+        for(i=1U, win=0U; i<queueLen; i++){
+            if(queue[i].ident < queue[win].ident){
+                win = i;
+            }
+        }
+        onBus = queue[win];
+        queueLen--;
+        for(i=win; i<queueLen; i++){
+            queue[i] = queue[i + 1U];
+        }
+        busBusy = true;
+        busEnd_us = now_us + frame_us;
+        busBusy_us += frame_us;
+    }
+}
+
+
+/* Commissioning requests for all nodes */
+static unsigned int prepareRequests(unsigned int noOfServers, unsigned int noOfMissing){
+    unsigned int n, r = 0U;
+
+    for(n=0U; n<noOfServers + noOfMissing; n++){
+        uint8_t nodeId = (uint8_t)(MASTER_NODE_ID + 1U + n);
+        unsigned int k, first = r;
+
+        memset(&reqs[r], 0, sizeof(reqs[0]) * ((n < noOfServers) ? REQS_PER_NODE : 1U));
+        reqs[r].index = 0x1000; reqs[r].upload = true; reqs[r].bufferSize = 4; r++;
+        if(n < noOfServers){
+            reqs[r].index = 0x1018; reqs[r].subIndex = 4; reqs[r].upload = true; reqs[r].bufferSize = 4; r++;
+            for(k=1U; k<=8U; k++){
+                reqs[r].index = 0x2000; reqs[r].subIndex = (uint8_t)k; reqs[r].bufferSize = 4;
+                CO_setUint32(buffers[r], (uint32_t)nodeId << 8 | k);
+                r++;
+            }
+            reqs[r].index = 0x2100; reqs[r].bufferSize = 28;
+            memset(buffers[r], 'A' + (n % 26U), 28);
+            r++;
+        }
+        for(k=first; k<r; k++){
+            reqs[k].nodeId = nodeId;
+            reqs[k].buffer = buffers[k];
+            reqs[k].retries = SDO_RETRIES;
+        }
+    }
+
+    return r;
+}
+
+
+/* Simulate commissioning of the network with given number of SDO clients */
+static int run(unsigned int noOfServers, unsigned int noOfClients, unsigned int noOfMissing,
+               unsigned long serverCycle_us)
+{
+    unsigned int noOfReqs, i;
+    unsigned long lastMs = 0UL;
+    bool_t idle = false;
+
+    now_us = 0UL; queueLen = 0U; busBusy = false; busBusy_us = 0UL;
+    memset(masterRx, 0, sizeof(masterRx));
+    memset(masterTx, 0, sizeof(masterTx));
+    memset(serverRx, 0, sizeof(serverRx));
+    memset(serverTx, 0, sizeof(serverTx));
+    memset(ODExtensions, 0, sizeof(ODExtensions));
+
+    noOfModules = 0U;
+    masterModule.rxArray = masterRx; masterModule.rxSize = (uint16_t)(noOfClients + 1U);
+    masterModule.txArray = masterTx; masterModule.txSize = (uint16_t)(noOfClients + 1U);
+    modules[noOfModules++] = &masterModule;
+
+    for(i=0U; i<noOfServers; i++){
+        uint8_t nodeId = (uint8_t)(MASTER_NODE_ID + 1U + i);
+
+        serverModule[i].rxArray = &serverRx[i]; serverModule[i].rxSize = 1U;
+        serverModule[i].txArray = &serverTx[i]; serverModule[i].txSize = 1U;
+        modules[noOfModules++] = &serverModule[i];
+        if(CO_SDO_init(&SDOserver[i], 0x600U + nodeId, 0x580U + nodeId, 0x1200, NULL,
+                       OD, OD_SIZE, ODExtensions[i + 1U], nodeId,
+                       &serverModule[i], 0, &serverModule[i], 0) != CO_ERROR_NO)
+        {
+            return -1;
+        }
+        serverPhase_us[i] = (unsigned long)rand() % serverCycle_us;
+    }
+
+    if(CO_SDO_init(&SDOmaster, 0x600U + MASTER_NODE_ID, 0x580U + MASTER_NODE_ID, 0x1200, NULL,
+                   OD, OD_SIZE, ODExtensions[0], MASTER_NODE_ID,
+                   &masterModule, (uint16_t)noOfClients, &masterModule, (uint16_t)noOfClients) != CO_ERROR_NO)
+    {
+        return -1;
+    }
+    for(i=0U; i<noOfClients; i++){
+        SDOclientPar[i].maxSubIndex = 3;
+        SDOclientPar[i].COB_IDClientToServer = 0x80000000UL;
+        SDOclientPar[i].COB_IDServerToClient = 0x80000000UL;
+        SDOclientPar[i].nodeIDOfTheSDOServer = 0;
+        if(CO_SDOclient_init(&SDOclient[i], &SDOmaster, &SDOclientPar[i],
+                             &masterModule, (uint16_t)i, &masterModule, (uint16_t)i) != CO_ERROR_NO)
+        {
+            return -1;
+        }
+        SDOclients[i] = &SDOclient[i];
+    }
+
+    if(CO_SDOclientSched_init(&sched, SDOclients, (uint8_t)noOfClients, SDO_TIMEOUT_MS) != CO_ERROR_NO){
+        return -1;
+    }
+    noOfReqs = prepareRequests(noOfServers, noOfMissing);
+    if(CO_SDOclientSched_submit(&sched, reqs, (uint16_t)noOfReqs) != CO_ERROR_NO){
+        return -1;
+    }
+
+    while(!idle && now_us < SIM_LIMIT_US){
+        unsigned long ms;
+        bool_t woken = false;
+
+        now_us += STEP_US;
+        busProcess();
+
+        /* servers in their mainline cycles */
+        for(i=0U; i<noOfServers; i++){
+            if((now_us + serverPhase_us[i]) % serverCycle_us < STEP_US){
+                CO_SDO_process_us(&SDOserver[i], true, (uint32_t)serverCycle_us,
+                                  SDO_TIMEOUT_MS * 1000UL, NULL);
+            }
+        }
+
+        /* scheduler every millisecond and when client is woken by response */
+        for(i=0U; i<noOfClients; i++){
+            if(IS_CANrxNew(SDOclient[i].CANrxNew)){
+                woken = true;
+            }
+        }
+        ms = now_us / 1000UL;
+        if(ms != lastMs || woken){
+            idle = CO_SDOclientSched_process(&sched, (uint16_t)(ms - lastMs), NULL);
+            lastMs = ms;
+        }
+    }
+
+    printf("%7u %10u %9u %6u %7u %7.0f %%\n", noOfClients, (unsigned int)sched.busyTime_ms,
+           (unsigned int)sched.completed, (unsigned int)sched.failed, (unsigned int)sched.retried,
+           (now_us > 0UL) ? (double)busBusy_us * 100.0 / (double)now_us : 0.0);
+
+    /* On saturated bus requests to nodes with higher CAN identifier may lose
+     * arbitration for longer than SDO timeout, so failed may exceed noOfMissing */
+    if(!idle || sched.completed + sched.failed != noOfReqs || sched.failed < noOfMissing){
+        printf("FAIL: %u requests, %u missing nodes\n", noOfReqs, noOfMissing);
+        return -1;
+    }
+    for(i=0U; i<noOfReqs; i++){
+        if(reqs[i].nodeId > MASTER_NODE_ID + noOfServers && reqs[i].result == CO_SDOcli_ok_communicationEnd){
+            printf("FAIL: response from missing node %u\n", (unsigned int)reqs[i].nodeId);
+            return -1;
+        }
+        if(reqs[i].retries != SDO_RETRIES){
+            printf("FAIL: retries of request %u changed by scheduler\n", i);
+            return -1;
+        }
+        if(reqs[i].upload && reqs[i].index == 0x1000 && reqs[i].result == CO_SDOcli_ok_communicationEnd &&
+           CO_getUint32(reqs[i].buffer) != deviceType)
+        {
+            printf("FAIL: wrong device type from node %u\n", (unsigned int)reqs[i].nodeId);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+int main(int argc, char *argv[]){
+    unsigned int noOfServers = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 0) : 32U;
+    unsigned int maxClients = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : 8U;
+    unsigned int bitRate = (argc > 3) ? (unsigned int)strtoul(argv[3], NULL, 0) : 500U;
+    unsigned long serverCycle_us = (argc > 4) ? strtoul(argv[4], NULL, 0) : 1000UL;
+    unsigned int noOfMissing = (argc > 5) ? (unsigned int)strtoul(argv[5], NULL, 0) : 0U;
+    unsigned int c;
+    int ret = 0;
+
+    if(noOfServers == 0U || noOfServers > MAX_SERVERS || maxClients == 0U || maxClients > MAX_CLIENTS ||
+       bitRate < 10U || bitRate > 1000U || serverCycle_us < STEP_US || noOfServers + noOfMissing > MAX_NODES)
+    {
+        fprintf(stderr, "Usage: %s [servers 1...%u] [clients 1...%u] [kbit/s] [server cycle us] [missing]\n",
+                argv[0], MAX_SERVERS, MAX_CLIENTS);
+        return 1;
+    }
+    bitTime_ns = 1000000U / bitRate;
+
+    printf("%u servers x %u requests, %u missing nodes, %u kbit/s, server cycle %lu us\n",
+           noOfServers, REQS_PER_NODE, noOfMissing, bitRate, serverCycle_us);
+    printf("clients  busy [ms] completed failed retried bus load\n");
+    for(c=1U; c<=maxClients; c*=2U){
+        srand(1);
+        if(run(noOfServers, c, noOfMissing, serverCycle_us) != 0){
+            ret = 1;
+        }
+        if(c < maxClients && c * 2U > maxClients){
+            c = maxClients / 2U;
+        }
+    }
+
+    return ret;
+}